@@ -15,6 +15,7 @@
 #pragma once
 
 #include <nanogui/vector.h>
+#include <string>
 
 #if defined(NANOGUI_USE_METAL)
 NAMESPACE_BEGIN(nanogui)
@@ -58,6 +59,23 @@ extern NANOGUI_EXPORT void metal_present_and_release_drawable(void *drawable);
 /// Check whether any connected display supports 10-bit or EDR mode
 extern NANOGUI_EXPORT std::pair<bool, bool> metal_10bit_edr_support();
 
+/**
+ * \brief Use a persistent pipeline archive (MTLBinaryArchive) for every Shader created afterwards
+ *
+ * Pipelines found in the archive skip GPU code generation; misses compile as usual and are
+ * added to it. A missing, unreadable or incompatible file starts an empty archive.
+ */
+extern NANOGUI_EXPORT bool metal_pipeline_cache_open(const std::string &path);
+
+/// Write pipelines added since the archive was opened back to its file
+extern NANOGUI_EXPORT bool metal_pipeline_cache_save();
+
+/// Number of pipelines loaded from and added to the archive since it was opened
+extern NANOGUI_EXPORT std::pair<size_t, size_t> metal_pipeline_cache_stats();
+
+/// Device name and OS version, identifying the driver that produced compiled GPU code
+extern NANOGUI_EXPORT std::string metal_device_identity();
+
 // Create a new autorelease pool
 extern NANOGUI_EXPORT void *autorelease_init();
 
@@ -175,10 +175,15 @@ public:
 	 *     Render indexed geometry? In this case, an
 	 *     \c uint32_t valued buffer with name \c indices
 	 *     must have been uploaded using \ref set().
+	 *
+	 * \param instance_count
+	 *     Number of instances to render. Shaders tell them apart
+	 *     through \c gl_InstanceID or \c [[instance_id]].
 	 */
 	void draw_array(PrimitiveType primitive_type,
 					size_t offset, size_t count,
-					bool indexed = false);
+					bool indexed = false,
+					size_t instance_count = 1);
 	
 #if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
 	uint32_t shader_handle() const { return m_shader_handle; }
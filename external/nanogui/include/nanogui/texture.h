@@ -109,6 +109,10 @@ public:
      *   using \ref pixel_format() and \ref component_format().
      *   Some caution must be exercised in this case, since \ref upload() will
      *   need to provide the data in a different storage format.
+     *
+     * \param layers
+     *   Number of layers of a 2D array texture, sampled as \c texture2d_array
+     *   or \c sampler2DArray. The default of 0 creates a plain 2D texture.
      */
     Texture(PixelFormat pixel_format,
             ComponentFormat component_format,
@@ -118,7 +122,8 @@ public:
 			WrapMode wrap_mode = WrapMode::Repeat,
             uint8_t samples = 1,
             uint8_t flags = (uint8_t) TextureFlags::ShaderRead,
-            bool mipmap_manual = false);
+            bool mipmap_manual = false,
+            int layers = 0);
     
 	Texture(const unsigned char* data, int size,
 			int raw_width,
@@ -166,6 +171,9 @@ public:
     /// Return the size of this texture
     const Vector2i &size() const { return m_size; }
 
+    /// Return the number of layers of a 2D array texture, 0 for a plain 2D texture
+    int layers() const { return m_layers; }
+
     /// Return the number of bytes consumed per pixel of this texture
     size_t bytes_per_pixel() const;
 
@@ -178,8 +186,11 @@ public:
     /// Upload packed pixel data to a rectangular sub-region of the texture from the CPU to the GPU
     void upload_sub_region(const uint8_t *data, const Vector2i& origin, const Vector2i& size);
 
-    /// Download packed pixel data from the GPU to the CPU
-    void download(uint8_t *data);
+    /// Upload packed pixel data for one mip level of one layer, each level halving the previous one (for manual mipmapping)
+    void upload_level(const uint8_t *data, int level, int layer = 0);
+
+    /// Download packed pixel data of one layer from the GPU to the CPU
+    void download(uint8_t *data, int layer = 0);
 
     /// Resize the texture (discards the current contents)
     void resize(const Vector2i &size);
@@ -221,6 +232,7 @@ protected:
     uint8_t m_flags;
     Vector2i m_size;
     bool m_mipmap_manual;
+    int m_layers = 0;
 
     #if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
         uint32_t m_texture_handle = 0;
@@ -617,7 +617,7 @@ void Shader::end() {
 
 void Shader::draw_array(PrimitiveType primitive_type,
 						size_t offset, size_t count,
-						bool indexed) {
+						bool indexed, size_t instance_count) {
 	GLenum primitive_type_gl;
 	switch (primitive_type) {
 		case PrimitiveType::Point:
@@ -639,11 +639,26 @@ void Shader::draw_array(PrimitiveType primitive_type,
 			throw std::runtime_error("Shader::draw_array(): invalid primitive type!");
 	}
 	
+	if (instance_count == 1) {
+		if (!indexed)
+			CHK(glDrawArrays(primitive_type_gl, (GLint)offset, (GLsizei)count));
+		else
+			CHK(glDrawElements(primitive_type_gl, (GLsizei)count, GL_UNSIGNED_INT,
+							   (const void *)(offset * sizeof(uint32_t))));
+		return;
+	}
+
+#if defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2
+	throw std::runtime_error("Shader::draw_array(): instancing requires GLES 3!");
+#else
 	if (!indexed)
-		CHK(glDrawArrays(primitive_type_gl, (GLint)offset, (GLsizei)count));
+		CHK(glDrawArraysInstanced(primitive_type_gl, (GLint)offset, (GLsizei)count,
+								  (GLsizei)instance_count));
 	else
-		CHK(glDrawElements(primitive_type_gl, (GLsizei)count, GL_UNSIGNED_INT,
-						   (const void *)(offset * sizeof(uint32_t))));
+		CHK(glDrawElementsInstanced(primitive_type_gl, (GLsizei)count, GL_UNSIGNED_INT,
+									(const void *)(offset * sizeof(uint32_t)),
+									(GLsizei)instance_count));
+#endif
 }
 
 NAMESPACE_END(nanogui)
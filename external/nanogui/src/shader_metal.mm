@@ -4,6 +4,8 @@
 #include <nanogui/texture.h>
 #include <nanogui/renderpass.h>
 #include <iostream>
+#include <cstdio>
+#include <mutex>
 
 #import <Metal/Metal.h>
 #import <QuartzCore/CAMetalLayer.h>
@@ -12,6 +14,98 @@
 
 NAMESPACE_BEGIN(nanogui)
 
+// Pipeline archive shared by all shaders; shaders may be created from several threads
+static std::mutex s_pipeline_archive_mutex;
+static void *s_pipeline_archive = nullptr;
+static std::string s_pipeline_archive_path;
+static bool s_pipeline_archive_dirty = false;
+static size_t s_pipeline_archive_hits = 0;
+static size_t s_pipeline_archive_misses = 0;
+
+bool metal_pipeline_cache_open(const std::string &path) {
+	if (@available(macOS 11.0, *)) {
+		std::lock_guard<std::mutex> lock(s_pipeline_archive_mutex);
+		
+		id<MTLDevice> device = (__bridge id<MTLDevice>) metal_device();
+		NSURL *url = [NSURL fileURLWithPath: [NSString stringWithUTF8String: path.c_str()]];
+		bool exists = [[NSFileManager defaultManager] fileExistsAtPath: url.path];
+		
+		MTLBinaryArchiveDescriptor *desc = [MTLBinaryArchiveDescriptor new];
+		desc.url = exists ? url : nil;
+		
+		NSError *error = nil;
+		id<MTLBinaryArchive> archive = [device newBinaryArchiveWithDescriptor: desc error: &error];
+		
+		if (!archive && exists) {
+			// Truncated or written by another driver: start over, the file is replaced on save
+			desc.url = nil;
+			error = nil;
+			archive = [device newBinaryArchiveWithDescriptor: desc error: &error];
+		}
+		
+		if (!archive)
+			return false;
+		
+		if (s_pipeline_archive)
+			(void) (__bridge_transfer id<MTLBinaryArchive>) s_pipeline_archive;
+		
+		s_pipeline_archive = (__bridge_retained void *) archive;
+		s_pipeline_archive_path = path;
+		s_pipeline_archive_dirty = false;
+		s_pipeline_archive_hits = 0;
+		s_pipeline_archive_misses = 0;
+		return true;
+	}
+	
+	return false;
+}
+
+bool metal_pipeline_cache_save() {
+	if (@available(macOS 11.0, *)) {
+		std::lock_guard<std::mutex> lock(s_pipeline_archive_mutex);
+		
+		if (!s_pipeline_archive)
+			return false;
+		
+		if (!s_pipeline_archive_dirty)
+			return true;
+		
+		// Serialized next to the target and renamed, so readers never see a partial archive
+		std::string temporary_path = s_pipeline_archive_path + ".tmp";
+		std::remove(temporary_path.c_str());
+		
+		id<MTLBinaryArchive> archive = (__bridge id<MTLBinaryArchive>) s_pipeline_archive;
+		NSURL *url = [NSURL fileURLWithPath: [NSString stringWithUTF8String: temporary_path.c_str()]];
+		NSError *error = nil;
+		
+		if (![archive serializeToURL: url error: &error]) {
+			std::cerr << "metal_pipeline_cache_save(): " << [[error description] UTF8String] << std::endl;
+			return false;
+		}
+		
+		if (std::rename(temporary_path.c_str(), s_pipeline_archive_path.c_str()) != 0) {
+			std::remove(temporary_path.c_str());
+			return false;
+		}
+		
+		s_pipeline_archive_dirty = false;
+		return true;
+	}
+	
+	return false;
+}
+
+std::pair<size_t, size_t> metal_pipeline_cache_stats() {
+	std::lock_guard<std::mutex> lock(s_pipeline_archive_mutex);
+	return { s_pipeline_archive_hits, s_pipeline_archive_misses };
+}
+
+std::string metal_device_identity() {
+	id<MTLDevice> device = (__bridge id<MTLDevice>) metal_device();
+	NSString *os_version = [[NSProcessInfo processInfo] operatingSystemVersionString];
+	return std::string([device.name UTF8String]) + " / " + [os_version UTF8String];
+}
+
 id<MTLFunction> compile_metal_shader(id<MTLDevice> device,
 									 const std::string &name,
 									 const std::string &type_str,
@@ -126,11 +220,44 @@ Shader::Shader(RenderPass& render_pass,
 	
 	NSError *error = nil;
 	MTLRenderPipelineReflection *reflection = nil;
-	id<MTLRenderPipelineState> pipeline_state =
-	[device newRenderPipelineStateWithDescriptor: pipeline_desc
-										 options: MTLPipelineOptionArgumentInfo
-									  reflection: &reflection
-										   error: &error];
+	id<MTLRenderPipelineState> pipeline_state = nil;
+	bool archive_miss = false;
+	
+	if (@available(macOS 11.0, *)) {
+		id<MTLBinaryArchive> archive = nil;
+		{
+			std::lock_guard<std::mutex> lock(s_pipeline_archive_mutex);
+			archive = (__bridge id<MTLBinaryArchive>) s_pipeline_archive;
+		}
+		
+		if (archive) {
+			pipeline_desc.binaryArchives = @[archive];
+			
+			// Probe the archive first so misses can be told apart and recorded
+			pipeline_state =
+			[device newRenderPipelineStateWithDescriptor: pipeline_desc
+												 options: MTLPipelineOptionArgumentInfo | MTLPipelineOptionFailOnBinaryArchiveMiss
+											  reflection: &reflection
+												   error: &error];
+			
+			std::lock_guard<std::mutex> lock(s_pipeline_archive_mutex);
+			if (pipeline_state) {
+				s_pipeline_archive_hits++;
+			} else {
+				s_pipeline_archive_misses++;
+				archive_miss = true;
+				error = nil;
+			}
+		}
+	}
+	
+	if (!pipeline_state) {
+		pipeline_state =
+		[device newRenderPipelineStateWithDescriptor: pipeline_desc
+											 options: MTLPipelineOptionArgumentInfo
+										  reflection: &reflection
+											   error: &error];
+	}
 	
 	if (error) {
 		const char *error_pipeline = [[error description] UTF8String];
@@ -141,6 +268,17 @@ Shader::Shader(RenderPass& render_pass,
 	
 	m_pipeline_state = (__bridge_retained void *) pipeline_state;
 	
+	if (archive_miss) {
+		if (@available(macOS 11.0, *)) {
+			std::lock_guard<std::mutex> lock(s_pipeline_archive_mutex);
+			id<MTLBinaryArchive> archive = (__bridge id<MTLBinaryArchive>) s_pipeline_archive;
+			NSError *archive_error = nil;
+			
+			if (archive && [archive addRenderPipelineFunctionsWithDescriptor: pipeline_desc error: &archive_error])
+				s_pipeline_archive_dirty = true;
+		}
+	}
+	
 	// Initialize buffer definitions
 	for (MTLArgument *arg in [reflection vertexArguments]) {
 		std::string name = [arg.name UTF8String];
@@ -500,7 +638,7 @@ void Shader::end() {
 
 void Shader::draw_array(PrimitiveType primitive_type,
 						size_t offset, size_t count,
-						bool indexed) {
+						bool indexed, size_t instance_count) {
 	MTLPrimitiveType primitive_type_mtl;
 	switch (primitive_type) {
 		case PrimitiveType::Point:         primitive_type_mtl = MTLPrimitiveTypePoint;         break;
@@ -517,7 +655,8 @@ void Shader::draw_array(PrimitiveType primitive_type,
 	if (!indexed) {
 		[command_enc drawPrimitives: primitive_type_mtl
 						vertexStart: offset
-						vertexCount: count];
+						vertexCount: count
+					  instanceCount: instance_count];
 	} else {
 		id<MTLBuffer> index_buffer;
 		
@@ -532,7 +671,8 @@ void Shader::draw_array(PrimitiveType primitive_type,
 								indexCount: count
 								 indexType: MTLIndexTypeUInt32
 							   indexBuffer: index_buffer
-						 indexBufferOffset: offset * 4];
+						 indexBufferOffset: offset * 4
+							 instanceCount: instance_count];
 	}
 }
 
@@ -12,7 +12,8 @@ Texture::Texture(PixelFormat pixel_format,
 				 WrapMode wrap_mode,
 				 uint8_t samples,
 				 uint8_t flags,
-				 bool mipmap_manual)
+				 bool mipmap_manual,
+				 int layers)
 : m_pixel_format(pixel_format),
 m_component_format(component_format),
 m_min_interpolation_mode(min_interpolation_mode),
@@ -21,7 +22,8 @@ m_wrap_mode(wrap_mode),
 m_samples(samples),
 m_flags(flags),
 m_size(size),
-m_mipmap_manual(mipmap_manual) {
+m_mipmap_manual(mipmap_manual),
+m_layers(layers) {
 	
 	init();
 }
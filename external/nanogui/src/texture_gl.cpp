@@ -1,6 +1,7 @@
 #include <nanogui/texture.h>
 #include <nanogui/opengl.h>
 #include "opengl_check.h"
+#include <algorithm>
 #include <memory>
 
 #if !defined(GL_HALF_FLOAT)
@@ -56,6 +57,12 @@ static void gl_map_texture_format(Texture::PixelFormat &pixel_format,
                                   GLenum &component_format_gl,
                                   GLenum &internal_format_gl);
 
+static GLenum gl_texture_target(const Texture &texture) {
+    if (texture.samples() > 1)
+        return GL_TEXTURE_2D_MULTISAMPLE;
+    return texture.layers() > 0 ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D;
+}
+
 void Texture::init() {
 #if defined(NANOGUI_USE_GLES)
     m_samples = 1;
@@ -101,7 +108,7 @@ void Texture::init() {
 
     (void) pixel_format_gl; (void) component_format_gl;
 
-    GLenum tex_mode = m_samples > 1 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+    GLenum tex_mode = gl_texture_target(*this);
 
     if (m_flags & (uint8_t) TextureFlags::ShaderRead) {
         CHK(glGenTextures(1, &m_texture_handle));
@@ -111,7 +118,8 @@ void Texture::init() {
         CHK(glTexParameteri(tex_mode, GL_TEXTURE_WRAP_S, wrap_mode_gl));
         CHK(glTexParameteri(tex_mode, GL_TEXTURE_WRAP_T, wrap_mode_gl));
 
-        if (m_flags & (uint8_t) TextureFlags::RenderTarget)
+        // Array layers are filled by upload_level(), into storage allocated up front
+        if ((m_flags & (uint8_t) TextureFlags::RenderTarget) || m_layers > 0)
             upload(nullptr);
     } else if (m_flags & (uint8_t) TextureFlags::RenderTarget) {
         CHK(glGenRenderbuffers(1, &m_renderbuffer_handle));
@@ -153,7 +161,7 @@ void Texture::upload(const uint8_t *data) {
                           internal_format_gl);
 
     if (m_texture_handle != 0) {
-        GLenum tex_mode = m_samples > 1 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+        GLenum tex_mode = gl_texture_target(*this);
         CHK(glBindTexture(tex_mode, m_texture_handle));
 
         if (data)
@@ -166,7 +174,20 @@ void Texture::upload(const uint8_t *data) {
             CHK(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
         }
 
-        if (m_samples == 1)
+        if (m_layers > 0) {
+            // Every layer at once; with manual mipmapping, every level is allocated as well
+            int levels = 1;
+            if (m_mipmap_manual && m_min_interpolation_mode == InterpolationMode::Trilinear)
+                while ((std::max(m_size.x(), m_size.y()) >> levels) > 0)
+                    ++levels;
+
+            for (int level = 0; level < levels; ++level)
+                CHK(glTexImage3D(tex_mode, level, internal_format_gl,
+                                 (GLsizei) std::max(1, m_size.x() >> level),
+                                 (GLsizei) std::max(1, m_size.y() >> level),
+                                 (GLsizei) m_layers, 0, pixel_format_gl, component_format_gl,
+                                 level == 0 ? data : nullptr));
+        } else if (m_samples == 1)
             CHK(glTexImage2D(tex_mode, 0, internal_format_gl, (GLsizei) m_size.x(),
                              (GLsizei) m_size.y(), 0, pixel_format_gl, component_format_gl, data));
         else
@@ -213,10 +234,13 @@ void Texture::upload_sub_region(const uint8_t *data, const Vector2i& origin, con
     if (m_texture_handle == 0)
         throw std::runtime_error("Texture::upload_sub_region(): not implemented for render targets!");
 
+    if (m_layers > 0)
+        throw std::runtime_error("Texture::upload_sub_region(): not implemented for array textures!");
+
     if (origin.x() + size.x() > m_size.x() || origin.y() + size.y() > m_size.y())
         throw std::runtime_error("Texture::upload_sub_region(): out of bounds!");
 
-    GLenum tex_mode = m_samples > 1 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+    GLenum tex_mode = gl_texture_target(*this);
     CHK(glBindTexture(tex_mode, m_texture_handle));
 
     if (data)
@@ -238,9 +262,55 @@ void Texture::upload_sub_region(const uint8_t *data, const Vector2i& origin, con
         generate_mipmap();
 }
 
-void Texture::download(uint8_t *data) {
+void Texture::upload_level(const uint8_t *data, int level, int layer) {
+    if (m_texture_handle == 0 || m_samples > 1)
+        throw std::runtime_error("Texture::upload_level(): only implemented for sampled textures!");
+
+    if (level < 0)
+        throw std::runtime_error("Texture::upload_level(): level out of range!");
+
+    if (layer < 0 || layer >= std::max(1, m_layers))
+        throw std::runtime_error("Texture::upload_level(): layer out of range!");
+
+    GLenum pixel_format_gl,
+           component_format_gl,
+           internal_format_gl;
+
+    gl_map_texture_format(m_pixel_format,
+                          m_component_format,
+                          pixel_format_gl,
+                          component_format_gl,
+                          internal_format_gl);
+
+    GLenum tex_mode = gl_texture_target(*this);
+    CHK(glBindTexture(tex_mode, m_texture_handle));
+    CHK(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+
+#if defined(NANOGUI_USE_OPENGL)
+    CHK(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+    CHK(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
+    CHK(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
+#endif
+
+    // The array's storage was allocated in init()
+    if (m_layers > 0) {
+        CHK(glTexSubImage3D(tex_mode, level, 0, 0, layer,
+                            (GLsizei) std::max(1, m_size.x() >> level),
+                            (GLsizei) std::max(1, m_size.y() >> level), 1,
+                            pixel_format_gl, component_format_gl, data));
+        return;
+    }
+
+    CHK(glTexImage2D(GL_TEXTURE_2D, level, internal_format_gl,
+                     (GLsizei) std::max(1, m_size.x() >> level),
+                     (GLsizei) std::max(1, m_size.y() >> level), 0,
+                     pixel_format_gl, component_format_gl, data));
+}
+
+void Texture::download(uint8_t *data, int layer) {
 #if defined(NANOGUI_USE_GLES)
     (void) data;
+    (void) layer;
     throw std::runtime_error("Texture::download(): not supported on GLES 2!");
 #else
     if (m_texture_handle == 0)
@@ -259,6 +329,21 @@ void Texture::download(uint8_t *data) {
                           internal_format_gl);
 
     (void) internal_format_gl;
+
+    if (layer < 0 || layer >= std::max(1, m_layers))
+        throw std::runtime_error("Texture::download(): layer out of range!");
+
+    if (m_layers > 0) {
+        // glGetTexImage returns every layer
+        size_t image_bytes = bytes_per_pixel() * m_size.x() * m_size.y();
+        std::unique_ptr<uint8_t[]> layers(new uint8_t[image_bytes * m_layers]);
+
+        CHK(glBindTexture(GL_TEXTURE_2D_ARRAY, m_texture_handle));
+        CHK(glGetTexImage(GL_TEXTURE_2D_ARRAY, 0, pixel_format_gl, component_format_gl, layers.get()));
+        memcpy(data, layers.get() + image_bytes * layer, image_bytes);
+        return;
+    }
+
     CHK(glBindTexture(GL_TEXTURE_2D, m_texture_handle));
     CHK(glGetTexImage(GL_TEXTURE_2D, 0, pixel_format_gl, component_format_gl, data));
 
@@ -286,7 +371,7 @@ void Texture::resize(const Vector2i &size) {
 }
 
 void Texture::generate_mipmap() {
-    GLenum tex_mode = m_samples > 1 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+    GLenum tex_mode = gl_texture_target(*this);
     CHK(glBindTexture(tex_mode, m_texture_handle));
     CHK(glGenerateMipmap(tex_mode));
 }
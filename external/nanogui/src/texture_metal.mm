@@ -1,5 +1,6 @@
 #include <nanogui/texture.h>
 #include <nanogui/metal.h>
+#include <algorithm>
 #import <Metal/Metal.h>
 
 NAMESPACE_BEGIN(nanogui)
@@ -136,7 +137,55 @@ void Texture::upload_sub_region(const uint8_t *data, const Vector2i& origin, con
         generate_mipmap();
 }
 
-void Texture::download(uint8_t *data) {
+void Texture::upload_level(const uint8_t *data, int level, int layer) {
+    id<MTLTexture> texture = (__bridge id<MTLTexture>) m_texture_handle;
+
+    if (level < 0 || (NSUInteger) level >= texture.mipmapLevelCount)
+        throw std::runtime_error("Texture::upload_level(): level out of range!");
+
+    if (layer < 0 || layer >= std::max(1, m_layers))
+        throw std::runtime_error("Texture::upload_level(): layer out of range!");
+
+    NSUInteger width = std::max<NSUInteger>(1, (NSUInteger) m_size.x() >> level),
+               height = std::max<NSUInteger>(1, (NSUInteger) m_size.y() >> level);
+
+    MTLTextureDescriptor *texture_desc =
+        [MTLTextureDescriptor texture2DDescriptorWithPixelFormat: texture.pixelFormat
+                                                           width: width
+                                                          height: height
+                                                       mipmapped: NO];
+
+    id<MTLDevice> device = (__bridge id<MTLDevice>) metal_device();
+    id<MTLCommandQueue> command_queue = (__bridge id<MTLCommandQueue>) metal_command_queue();
+    id<MTLCommandBuffer> command_buffer = [command_queue commandBuffer];
+    id<MTLBlitCommandEncoder> command_encoder = [command_buffer blitCommandEncoder];
+    id<MTLTexture> temp_texture = [device newTextureWithDescriptor:texture_desc];
+
+    [temp_texture replaceRegion: MTLRegionMake2D(0, 0, width, height)
+                  mipmapLevel: 0
+                  withBytes: data
+                  bytesPerRow: (NSUInteger) bytes_per_pixel() * width];
+
+    [command_encoder
+                 copyFromTexture: temp_texture
+                     sourceSlice: 0
+                     sourceLevel: 0
+                    sourceOrigin: MTLOriginMake(0, 0, 0)
+                      sourceSize: MTLSizeMake(width, height, 1)
+                       toTexture: texture
+                destinationSlice: (NSUInteger) layer
+                destinationLevel: (NSUInteger) level
+               destinationOrigin: MTLOriginMake(0, 0, 0)];
+
+    [command_encoder endEncoding];
+    [command_buffer commit];
+    [command_buffer waitUntilCompleted];
+}
+
+void Texture::download(uint8_t *data, int layer) {
+    if (layer < 0 || layer >= std::max(1, m_layers))
+        throw std::runtime_error("Texture::download(): layer out of range!");
+
     id<MTLCommandQueue> command_queue =
         (__bridge id<MTLCommandQueue>) metal_command_queue();
     id<MTLCommandBuffer> command_buffer = [command_queue commandBuffer];
@@ -154,7 +203,7 @@ void Texture::download(uint8_t *data) {
 
     [command_encoder
                  copyFromTexture: texture
-                     sourceSlice: 0
+                     sourceSlice: (NSUInteger) layer
                      sourceLevel: 0
                     sourceOrigin: MTLOriginMake(0, 0, 0)
                       sourceSize: MTLSizeMake(texture.width, texture.height, 1)
@@ -301,6 +350,9 @@ void Texture::resize(const Vector2i &size) {
     if (m_samples > 1) {
         texture_desc.textureType = MTLTextureType2DMultisample;
         texture_desc.sampleCount = m_samples;
+    } else if (m_layers > 0) {
+        texture_desc.textureType = MTLTextureType2DArray;
+        texture_desc.arrayLength = (NSUInteger) m_layers;
     }
 
     if (m_flags & (uint8_t) TextureFlags::ShaderRead)
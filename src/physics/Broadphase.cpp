@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <cmath>
+
+#include "Broadphase.h"
+
+using namespace physics;
+
+namespace {
+// Proxies covering more cells than this are tested directly instead of being bucketed
+constexpr int64_t kMaxCellsPerProxy = 64;
+
+uint64_t cellKey(int32_t x, int32_t y) {
+	return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+bool overlaps(const BroadphaseProxy& a, const BroadphaseProxy& b) {
+	// Touching edges count, as in GeometryExtensions::rectIntersectsRect
+	return !(a.maxX < b.minX || b.maxX < a.minX || a.maxY < b.minY || b.maxY < a.minY);
+}
+}
+
+Broadphase::Broadphase(float cellSize)
+: _cellSize(cellSize) {
+}
+
+void Broadphase::clear() {
+	_proxies.clear();
+	_pairs.clear();
+}
+
+uint32_t Broadphase::addProxy(const windy::Rect& bounds, uint32_t body, uint32_t shape, bool isStatic) {
+	_proxies.push_back({ bounds.getMinX(), bounds.getMinY(), bounds.getMaxX(), bounds.getMaxY(), body, shape, isStatic });
+	return static_cast<uint32_t>(_proxies.size() - 1);
+}
+
+const std::vector<BroadphasePair>& Broadphase::findPairs() {
+	_pairs.clear();
+	_entries.clear();
+	_largeProxies.clear();
+	_ranges.resize(_proxies.size());
+	_candidateTests = 0;
+
+	if (_proxies.empty()) {
+		return _pairs;
+	}
+
+	_activeCellSize = _cellSize;
+
+	if (_activeCellSize <= 0.0f) {
+		double extent = 0.0;
+
+		for (const auto& proxy : _proxies) {
+			extent += std::max(proxy.maxX - proxy.minX, proxy.maxY - proxy.minY);
+		}
+
+		_activeCellSize = std::max(1.0f, static_cast<float>(extent / _proxies.size()));
+	}
+
+	float inverseCellSize = 1.0f / _activeCellSize;
+
+	for (uint32_t i = 0; i < _proxies.size(); ++i) {
+		const auto& proxy = _proxies[i];
+		CellRange& range = _ranges[i];
+
+		range.minX = static_cast<int32_t>(std::floor(proxy.minX * inverseCellSize));
+		range.minY = static_cast<int32_t>(std::floor(proxy.minY * inverseCellSize));
+		range.maxX = static_cast<int32_t>(std::floor(proxy.maxX * inverseCellSize));
+		range.maxY = static_cast<int32_t>(std::floor(proxy.maxY * inverseCellSize));
+
+		int64_t cells = (static_cast<int64_t>(range.maxX) - range.minX + 1) * (static_cast<int64_t>(range.maxY) - range.minY + 1);
+
+		if (cells > kMaxCellsPerProxy) {
+			_largeProxies.push_back(i);
+			continue;
+		}
+
+		for (int32_t x = range.minX; x <= range.maxX; ++x) {
+			for (int32_t y = range.minY; y <= range.maxY; ++y) {
+				_entries.push_back({ cellKey(x, y), i });
+			}
+		}
+	}
+
+	std::sort(_entries.begin(), _entries.end());
+
+	for (size_t begin = 0; begin < _entries.size();) {
+		size_t end = begin + 1;
+
+		while (end < _entries.size() && _entries[end].cell == _entries[begin].cell) {
+			++end;
+		}
+
+		uint64_t cell = _entries[begin].cell;
+
+		for (size_t i = begin; i < end; ++i) {
+			uint32_t first = _entries[i].proxy;
+			const CellRange& firstRange = _ranges[first];
+
+			for (size_t j = i + 1; j < end; ++j) {
+				uint32_t second = _entries[j].proxy;
+				const CellRange& secondRange = _ranges[second];
+
+				// Report from the lowest shared cell only, so pairs spanning several cells are not repeated
+				if (cellKey(std::max(firstRange.minX, secondRange.minX), std::max(firstRange.minY, secondRange.minY)) != cell) {
+					continue;
+				}
+
+				testPair(first, second);
+			}
+		}
+
+		begin = end;
+	}
+
+	for (size_t i = 0; i < _largeProxies.size(); ++i) {
+		uint32_t large = _largeProxies[i];
+
+		for (uint32_t other = 0; other < _proxies.size(); ++other) {
+			// Large against large is visited once, from the earlier entry
+			bool otherIsLarge = std::binary_search(_largeProxies.begin(), _largeProxies.end(), other);
+
+			if (other == large || (otherIsLarge && other < large)) {
+				continue;
+			}
+
+			testPair(large, other);
+		}
+	}
+
+	return _pairs;
+}
+
+void Broadphase::testPair(uint32_t first, uint32_t second) {
+	const auto& a = _proxies[first];
+	const auto& b = _proxies[second];
+
+	if (a.body == b.body || (a.isStatic && b.isStatic)) {
+		return;
+	}
+
+	++_candidateTests;
+
+	if (!overlaps(a, b)) {
+		return;
+	}
+
+	if (a.isStatic) {
+		_pairs.push_back({ second, first });
+	} else {
+		_pairs.push_back({ first, second });
+	}
+}
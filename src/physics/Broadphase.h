@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Geometry.h"
+
+namespace physics {
+struct BroadphaseProxy {
+	float minX;
+	float minY;
+	float maxX;
+	float maxY;
+	uint32_t body;
+	uint32_t shape; // collision box index within the body
+	bool isStatic;
+};
+
+struct BroadphasePair {
+	uint32_t a; // always a dynamic proxy
+	uint32_t b;
+};
+
+/**
+ * @brief Uniform grid pair finder for collision boxes.
+ *
+ * Proxies are bucketed into grid cells, the cell list is sorted, and only proxies
+ * sharing a cell are tested, so the cost follows local density instead of the
+ * product of body counts. A pair is reported once, from the lowest cell both
+ * proxies share. Proxies spanning too many cells (whole landscapes) skip the grid
+ * and are tested against everything. Storage is reused between steps.
+ */
+class Broadphase {
+public:
+	// A cell size of zero derives one from the average proxy extent at each findPairs()
+	explicit Broadphase(float cellSize = 0.0f);
+
+	void clear();
+
+	uint32_t addProxy(const windy::Rect& bounds, uint32_t body, uint32_t shape, bool isStatic);
+
+	// Overlapping proxies of different bodies where at least one side is dynamic
+	const std::vector<BroadphasePair>& findPairs();
+
+	const BroadphaseProxy& getProxy(uint32_t index) const { return _proxies[index]; }
+	size_t getProxyCount() const { return _proxies.size(); }
+
+	float getCellSize() const { return _activeCellSize; }
+
+	// Narrow overlap tests performed by the last findPairs(), for profiling
+	size_t getCandidateTests() const { return _candidateTests; }
+
+private:
+	struct CellRange {
+		int32_t minX;
+		int32_t minY;
+		int32_t maxX;
+		int32_t maxY;
+	};
+
+	struct CellEntry {
+		uint64_t cell;
+		uint32_t proxy;
+
+		bool operator<(const CellEntry& other) const {
+			return cell < other.cell || (cell == other.cell && proxy < other.proxy);
+		}
+	};
+
+	void testPair(uint32_t first, uint32_t second);
+
+	float _cellSize;
+	float _activeCellSize = 0.0f;
+	size_t _candidateTests = 0;
+
+	std::vector<BroadphaseProxy> _proxies;
+	std::vector<CellRange> _ranges;
+	std::vector<CellEntry> _entries;
+	std::vector<uint32_t> _largeProxies;
+	std::vector<BroadphasePair> _pairs;
+};
+}
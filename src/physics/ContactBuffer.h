@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace windy {
+enum class Contact {
+	Up,
+	Down,
+	Left,
+	Right
+};
+}
+
+namespace physics {
+struct BodyContact {
+	uint32_t body;
+	uint32_t other;
+	windy::Contact type;
+};
+
+/**
+ * @brief Contacts of one physics step, stored by value in reused storage.
+ *
+ * reset() keeps the capacity, so steady-state steps do not allocate. Contacts are
+ * grouped per body by finalize(); hasContact() is available at any time.
+ */
+class ContactBuffer {
+public:
+	void reset(size_t bodyCount) {
+		_contacts.clear();
+		_sorted.clear();
+		_flags.assign(bodyCount, 0);
+		_offsets.assign(bodyCount + 1, 0);
+	}
+
+	void add(uint32_t body, uint32_t other, windy::Contact type) {
+		_contacts.push_back({ body, other, type });
+		_flags[body] |= flag(type);
+	}
+
+	bool hasContact(uint32_t body, windy::Contact type) const {
+		return body < _flags.size() && (_flags[body] & flag(type)) != 0;
+	}
+
+	// Counting sort by body; afterwards getContacts() returns each body's contacts in insertion order
+	void finalize() {
+		std::fill(_offsets.begin(), _offsets.end(), 0);
+
+		for (const auto& contact : _contacts) {
+			++_offsets[contact.body + 1];
+		}
+
+		for (size_t i = 1; i < _offsets.size(); ++i) {
+			_offsets[i] += _offsets[i - 1];
+		}
+
+		_sorted.resize(_contacts.size());
+		_cursor.assign(_offsets.begin(), _offsets.end() - 1);
+
+		for (const auto& contact : _contacts) {
+			_sorted[_cursor[contact.body]++] = contact;
+		}
+	}
+
+	std::pair<const BodyContact*, const BodyContact*> getContacts(uint32_t body) const {
+		if (body + 1 >= _offsets.size() || _sorted.empty()) {
+			return { nullptr, nullptr };
+		}
+
+		return { _sorted.data() + _offsets[body], _sorted.data() + _offsets[body + 1] };
+	}
+
+	size_t size() const { return _contacts.size(); }
+
+private:
+	static uint8_t flag(windy::Contact type) {
+		return static_cast<uint8_t>(1u << static_cast<uint32_t>(type));
+	}
+
+	std::vector<BodyContact> _contacts;
+	std::vector<BodyContact> _sorted;
+	std::vector<uint8_t> _flags;
+	std::vector<uint32_t> _offsets;
+	std::vector<uint32_t> _cursor;
+};
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "Geometry.h"
+
+namespace physics {
+/**
+ * @brief What PhysicsWorld needs from a simulated object.
+ *
+ * Entities take part in the simulation through an implementation of this
+ * interface, so the world does not depend on any entity or component types.
+ */
+class PhysicsBody {
+public:
+	virtual ~PhysicsBody() = default;
+
+	// Dynamic bodies fall and are pushed out of static ones
+	virtual bool isDynamic() const = 0;
+
+	virtual int getCollisionSize() const = 0;
+	virtual windy::Rect& getCollisionBox(int index) = 0;
+
+	virtual glm::vec3& getSpeed() = 0;
+
+	virtual glm::vec3 getTranslation() const = 0;
+	virtual void setTranslation(const glm::vec3& translation) = 0;
+};
+}
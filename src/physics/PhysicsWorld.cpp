@@ -1,15 +1,11 @@
+#include <algorithm>
 #include <cmath>
 
 #include "PhysicsWorld.h"
 
 #include "Geometry.h"
 #include "GeometryExtensions.h"
-
-#include "entity/entity.h"
-
-
-#include "components/transform_component.h"
-#include "components/renderable/physics_component.h"
+#include "SliceCollision.h"
 
 using namespace windy;
 
@@ -47,270 +43,119 @@ void PhysicsWorld::setUnderwater(bool underwater) {
 	}
 }
 
-void PhysicsWorld::alignCollisions(std::shared_ptr<anim::Entity> a, std::shared_ptr<anim::Entity> b, bool clearContacts) {
-	auto entity = a->get_component<anim::PhysicsComponent>();
-	auto landscapeEntity = b->get_component<anim::PhysicsComponent>();
-	auto transform = a->get_component<anim::TransformComponent>();
+void PhysicsWorld::alignCollisions(const BroadphaseProxy& body, const BroadphaseProxy& landscape) {
+	auto& entity = _entities[body.body];
+	
+	auto& collisionBox = entity->getCollisionBox(body.shape);
+	const auto& landscapeCollisionBox = _entities[landscape.body]->getCollisionBox(landscape.shape);
+	
+	auto offset = physics::resolveSliceCollisions(collisionBox, landscapeCollisionBox, _contacts, body.body, landscape.body);
 	
-	for (int x = 0; x < entity->get_collision_size(); ++x) {
-		auto collisionBox = entity->get_collision_box(x);
+	if (offset.x != 0 || offset.y != 0) {
+		auto transformTranslation = entity->getTranslation();
 		
-		for (int y = 0; y < landscapeEntity->get_collision_size(); ++y) {
-			auto landscapeEntityCollisionBox = landscapeEntity->get_collision_box(y);
-			
-			for (int k = 0; k < 8; k++) {
-				windy::Rect collisionBoxTiles[9];
-				
-				for (int j = 0; j < 9; ++j) {
-					int column = j % 3;
-					int row = static_cast<int>(std::floor(j / 3));
-					
-					float tileW = collisionBox->size.x / 3.0f;
-					float tileH = collisionBox->size.y / 3.0f;
-					
-					float collisionBoxLeft = collisionBox->getMinX();
-					float collisionBoxTop = collisionBox->getMaxY();
-					
-					auto tileOrigin = glm::vec2(collisionBoxLeft + (tileW * column), collisionBoxTop - (tileH * row));
-					
-					collisionBoxTiles[j] = windy::Rect(tileOrigin.x, tileOrigin.y - tileH, tileW, tileH);
-				}
-				
-				windy::Rect slicedCollisionBox[8];
-				
-				slicedCollisionBox[0] = collisionBoxTiles[7];
-				slicedCollisionBox[1] = collisionBoxTiles[1];
-				slicedCollisionBox[2] = collisionBoxTiles[3];
-				slicedCollisionBox[3] = collisionBoxTiles[5];
-				slicedCollisionBox[4] = collisionBoxTiles[0];
-				slicedCollisionBox[5] = collisionBoxTiles[2];
-				slicedCollisionBox[6] = collisionBoxTiles[6];
-				slicedCollisionBox[7] = collisionBoxTiles[8];
-				
-				if (windy::GeometryExtensions::rectIntersectsRect(*landscapeEntityCollisionBox, slicedCollisionBox[k])) {
-					auto intersection = GeometryExtensions::rectIntersection(*landscapeEntityCollisionBox, slicedCollisionBox[k]);
-					
-					bool hasOffsetX = false;
-					bool hasOffsetY = false;
-					
-					windy::Contact contactType;
-					
-					switch (k) {
-						case 0:
-							contactType = windy::Contact::Up;
-							hasOffsetY = true;
-							break;
-						case 1:
-							contactType = windy::Contact::Down;
-							hasOffsetY = true;
-							intersection.size.y *= -1;
-							break;
-						case 2:
-							contactType = windy::Contact::Left;
-							hasOffsetX = true;
-							break;
-						case 3:
-							contactType = windy::Contact::Right;
-							hasOffsetX = true;
-							intersection.size.x *= -1;
-							break;
-						default:
-							if (intersection.size.x >= intersection.size.y) {
-								if (k == 4 || k == 5) {
-									contactType = windy::Contact::Down;
-									hasOffsetY = true;
-									intersection.size.y = -intersection.size.y;
-								} else {
-									contactType = windy::Contact::Up;
-									hasOffsetY = true;
-								}
-							} else {
-								if (k == 7 || k == 5) {
-									contactType = windy::Contact::Right;
-									hasOffsetX = true;
-									intersection.size.x *= -1;
-								} else {
-									contactType = windy::Contact::Left;
-									hasOffsetX = true;
-								}
-								
-							}
-					}
-					
-					auto contact = std::make_shared<windy::CollisionContact>();
-					contact->type = contactType;
-					contact->contact = true;
-					contact->entity = b;
-					entity->get_contacts_internal().push_back(contact);
-					
-					if (hasOffsetX) {
-						auto transformTranslation = transform->get_translation();
-						
-						transformTranslation.x += intersection.size.x;
-						
-						transform->set_translation(transformTranslation);
-						collisionBox->origin.x += intersection.size.x;
-					}
-					
-					if (hasOffsetY) {
-						
-						auto transformTranslation = transform->get_translation();
-						
-						transformTranslation.y += intersection.size.y;
-
-						transform->set_translation(transformTranslation);
-
-						collisionBox->origin.y += intersection.size.y;
-					}
-				}
-			}
-		}
+		transformTranslation.x += offset.x;
+		transformTranslation.y += offset.y;
+		
+		entity->setTranslation(transformTranslation);
 	}
 }
 
 void PhysicsWorld::update(float dt)
 {
-	std::vector<std::shared_ptr<anim::Entity>> landscapeEntities;
-	std::vector<std::shared_ptr<anim::Entity>> specialLandscapeEntities;
-	std::vector<std::shared_ptr<anim::Entity>> collidingEntities;
+	std::vector<std::shared_ptr<PhysicsBody>> collidingEntities;
+	
+	_broadphase.clear();
+	_contacts.reset(_entities.size());
+	_bodyIndices.clear();
 	
-	for (int i = 0; i < _entities.size(); ++i) {
+	for (uint32_t i = 0; i < _entities.size(); ++i) {
 		auto entity = _entities.at(i);
 		
-		auto physics = entity->get_component<anim::PhysicsComponent>();
+		_bodyIndices[entity.get()] = i;
 		
-		if(physics->is_dynamic()){
+		if(entity->isDynamic()){
 			collidingEntities.push_back(entity);
-		} else {
-			landscapeEntities.push_back(entity);
+		}
+		
+		for (int x = 0; x < entity->getCollisionSize(); ++x) {
+			_broadphase.addProxy(entity->getCollisionBox(x), i, x, !entity->isDynamic());
 		}
 	}
 	
-	for (int i = 0; i < collidingEntities.size(); ++i) {
-		auto entity = collidingEntities.at(i);
-		auto physics = entity->get_component<anim::PhysicsComponent>();
-		
-		physics->recreate_contacts();
+	// Only overlapping dynamic/static box pairs reach the slice resolution
+	for (const auto& pair : _broadphase.findPairs()) {
+		const auto& landscape = _broadphase.getProxy(pair.b);
 		
-		for (int j = 0; j < landscapeEntities.size(); ++j) {
-			auto landscapeEntity = landscapeEntities.at(j);
-			
-			if(entity != landscapeEntity){
-				PhysicsWorld::alignCollisions(entity, landscapeEntity);
-			}
+		if (landscape.isStatic) {
+			alignCollisions(_broadphase.getProxy(pair.a), landscape);
 		}
 	}
 	
+	_contacts.finalize();
+	
 	// Apply speed and gravity
 	for (int i = 0; i < collidingEntities.size(); ++i) {
 		auto entity = collidingEntities.at(i);
-		auto physics = entity->get_component<anim::PhysicsComponent>();
-		if(physics->is_dynamic()){
-			auto transform = entity->get_component<anim::TransformComponent>();
-			
-			auto entityPosition = transform->get_translation();
+		uint32_t body = _bodyIndices[entity.get()];
+		if(entity->isDynamic()){
+			auto entityPosition = entity->getTranslation();
 			
-			physics->get_speed().y  -= this->_gravity * dt;
+			entity->getSpeed().y  -= this->_gravity * dt;
 			
-			if (physics->get_speed().y >= this->_maxFallSpeed) {
-				physics->get_speed().y = this->_maxFallSpeed;
+			if (entity->getSpeed().y >= this->_maxFallSpeed) {
+				entity->getSpeed().y = this->_maxFallSpeed;
 			}
 			
 			// Cap speed
-			if (physics->get_contact(windy::Contact::Down)  || physics->get_contact(windy::Contact::Up) ) {
-				physics->get_speed().y = 0;
+			if (_contacts.hasContact(body, windy::Contact::Down)  || _contacts.hasContact(body, windy::Contact::Up) ) {
+				entity->getSpeed().y = 0;
 			}
 			
-			if (physics->get_contact(windy::Contact::Left)  || physics->get_contact(windy::Contact::Right) ) {
-				physics->get_speed().x = 0;
+			if (_contacts.hasContact(body, windy::Contact::Left)  || _contacts.hasContact(body, windy::Contact::Right) ) {
+				entity->getSpeed().x = 0;
 			}
 			
 			
-			entityPosition += physics->get_speed() * dt;
+			entityPosition += entity->getSpeed() * dt;
 			
-			transform->set_translation(entityPosition);
+			entity->setTranslation(entityPosition);
 		}
 		
 	}
 	
+	// Boxes moved during resolution, so dynamic bodies are paired again for the contact events
+	_broadphase.clear();
+	
 	for (int i = 0; i < collidingEntities.size(); ++i) {
-		auto entity = collidingEntities.at(i);
+		auto& entity = collidingEntities.at(i);
 		
-		auto entityPhysics = entity->get_component<anim::PhysicsComponent>();
+		for (int x = 0; x < entity->getCollisionSize(); ++x) {
+			_broadphase.addProxy(entity->getCollisionBox(x), static_cast<uint32_t>(i), x, false);
+		}
+	}
+	
+	for (const auto& pair : _broadphase.findPairs()) {
+		const auto& first = _broadphase.getProxy(pair.a);
+		const auto& second = _broadphase.getProxy(pair.b);
 		
-		for (int j = 0; j < collidingEntities.size(); ++j) {
-			auto collidingEntity = collidingEntities.at(j);
-			
-			auto collidingPhysics = collidingEntity->get_component<anim::PhysicsComponent>();
-			
-			if (entity == collidingEntity) {
-				continue;
-			}
-			
-			for(int x = 0; x < entityPhysics->get_collision_size(); ++x){
-				
-				auto entityCollisionBox = entityPhysics->get_collision_box(x);
-				auto collidingCollisionBox = collidingPhysics->get_collision_box(x);
-				
-				if (GeometryExtensions::rectIntersectsRect(*entityCollisionBox, *collidingCollisionBox)) {
-					
-					
-					auto iterator =
-					std::find_if(this->_contactEventCollisions.begin(),
-								 this->_contactEventCollisions.end(), [=](const std::pair<long long, std::pair<std::shared_ptr<anim::Entity>, std::shared_ptr<anim::Entity>>> contact) {
-						return contact.second.first == entity && contact.second.second == collidingEntity;
-					});
-					
-					if (iterator == _contactEventCollisions.end()) {
-						
-						long long contactIndex = 0;
-						long long emptyIndex = 0;
-						
-						bool indexFound = false;
-						
-						for (long long k = 0; k <= this->_contactEventCollisionIndex; ++k) {
-							
-							indexFound = false;
-							
-							for (unsigned int l = 0; l < this->_contactEventCollisions.size(); ++l) {
-								auto contact = this->_contactEventCollisions.at(l);
-								
-								if (contact.first == k) {
-									indexFound = true;
-									break;
-								}
-							}
-							
-							if (!indexFound) {
-								emptyIndex = k;
-								break;
-							}
-							
-						}
-						
-						if (!indexFound) {
-							contactIndex = emptyIndex;
-						}
-						else {
-							contactIndex = this->_contactEventCollisionIndex + 1;
-							this->_contactEventCollisionIndex += 1;
-						}
-						
-						this->_contactEventCollisions.push_back({ contactIndex, { entity, collidingEntity } });
-						//                    entity->onCollisionEnter(collidingEntity);
-						
-					}
-				}
-			}
-			
+		// Events compare boxes of the same index on both bodies
+		if (first.shape != second.shape) {
+			continue;
 		}
+		
+		auto& entity = collidingEntities.at(first.body);
+		auto& collidingEntity = collidingEntities.at(second.body);
+		
+		registerContactEvent(entity, collidingEntity);
+		registerContactEvent(collidingEntity, entity);
 	}
 	
 	
 	this->_contactEventCollisions.erase(
 										std::remove_if(this->_contactEventCollisions.begin(),
 													   this->_contactEventCollisions.end(),
-													   [=](const std::pair<long long, std::pair<std::shared_ptr<anim::Entity>, std::shared_ptr<anim::Entity>>> contact) {
+													   [=](const std::pair<long long, std::pair<std::shared_ptr<PhysicsBody>, std::shared_ptr<PhysicsBody>>> contact) {
 														   
 														   bool entityExists = std::find(_entities.begin(), _entities.end(),contact.second.first) != _entities.end();
 														   bool collisionExists = std::find(_entities.begin(), _entities.end(), contact.second.second) != _entities.end();
@@ -319,7 +164,7 @@ void PhysicsWorld::update(float dt)
 													   }),
 										this->_contactEventCollisions.end());
 	
-	std::vector<std::pair<long long, std::pair<std::shared_ptr<anim::Entity>, std::shared_ptr<anim::Entity>>>> contactExitCollisions;
+	std::vector<std::pair<long long, std::pair<std::shared_ptr<PhysicsBody>, std::shared_ptr<PhysicsBody>>>> contactExitCollisions;
 	
 	for (unsigned int i = 0; i < this->_contactEventCollisions.size(); ++i) {
 		auto contact = this->_contactEventCollisions.at(i);
@@ -327,11 +172,8 @@ void PhysicsWorld::update(float dt)
 		auto entity = contact.second.first;
 		auto collidingEntity = contact.second.second;
 		
-		auto entityPhysics = entity->get_component<anim::PhysicsComponent>();
-		auto collidingPhysics = collidingEntity->get_component<anim::PhysicsComponent>();
-		
-		for(int x = 0; x < entityPhysics->get_collision_size(); ++x){
-			if (GeometryExtensions::rectIntersectsRect(*entityPhysics->get_collision_box(x), *collidingPhysics->get_collision_box(x))) {
+		for(int x = 0; x < entity->getCollisionSize(); ++x){
+			if (GeometryExtensions::rectIntersectsRect(entity->getCollisionBox(x), collidingEntity->getCollisionBox(x))) {
 				
 				//            entity->onCollision(collidingEntity);
 			}
@@ -345,7 +187,7 @@ void PhysicsWorld::update(float dt)
 	this->_contactEventCollisions.erase(
 										std::remove_if(this->_contactEventCollisions.begin(),
 													   this->_contactEventCollisions.end(),
-													   [=](const std::pair<long long, std::pair<std::shared_ptr<anim::Entity>, std::shared_ptr<anim::Entity>>> contact) {
+													   [=](const std::pair<long long, std::pair<std::shared_ptr<PhysicsBody>, std::shared_ptr<PhysicsBody>>> contact) {
 														   
 														   bool shouldRemove = false;
 														   for (unsigned int i = 0; i < contactExitCollisions.size(); ++i) {
@@ -377,11 +219,75 @@ void PhysicsWorld::update(float dt)
 	
 }
 
-void PhysicsWorld::addEntity(std::shared_ptr<anim::Entity> entity) {
+void PhysicsWorld::registerContactEvent(const std::shared_ptr<PhysicsBody>& entity, const std::shared_ptr<PhysicsBody>& collidingEntity) {
+	auto iterator =
+	std::find_if(this->_contactEventCollisions.begin(),
+				 this->_contactEventCollisions.end(), [&](const std::pair<long long, std::pair<std::shared_ptr<PhysicsBody>, std::shared_ptr<PhysicsBody>>>& contact) {
+		return contact.second.first == entity && contact.second.second == collidingEntity;
+	});
+	
+	if (iterator != _contactEventCollisions.end()) {
+		return;
+	}
+	
+	long long contactIndex = 0;
+	long long emptyIndex = 0;
+	
+	bool indexFound = false;
+	
+	for (long long k = 0; k <= this->_contactEventCollisionIndex; ++k) {
+		
+		indexFound = false;
+		
+		for (unsigned int l = 0; l < this->_contactEventCollisions.size(); ++l) {
+			auto& contact = this->_contactEventCollisions.at(l);
+			
+			if (contact.first == k) {
+				indexFound = true;
+				break;
+			}
+		}
+		
+		if (!indexFound) {
+			emptyIndex = k;
+			break;
+		}
+		
+	}
+	
+	if (!indexFound) {
+		contactIndex = emptyIndex;
+	}
+	else {
+		contactIndex = this->_contactEventCollisionIndex + 1;
+		this->_contactEventCollisionIndex += 1;
+	}
+	
+	this->_contactEventCollisions.push_back({ contactIndex, { entity, collidingEntity } });
+	//                    entity->onCollisionEnter(collidingEntity);
+}
+
+bool PhysicsWorld::hasContact(const std::shared_ptr<PhysicsBody>& entity, windy::Contact type) const {
+	auto it = _bodyIndices.find(entity.get());
+	
+	return it != _bodyIndices.end() && _contacts.hasContact(it->second, type);
+}
+
+std::pair<const BodyContact*, const BodyContact*> PhysicsWorld::getContacts(const std::shared_ptr<PhysicsBody>& entity) const {
+	auto it = _bodyIndices.find(entity.get());
+	
+	if (it == _bodyIndices.end()) {
+		return { nullptr, nullptr };
+	}
+	
+	return _contacts.getContacts(it->second);
+}
+
+void PhysicsWorld::addEntity(std::shared_ptr<PhysicsBody> entity) {
 	_entities.push_back(entity);
 }
 
-void PhysicsWorld::removeEntity(std::shared_ptr<anim::Entity> entity) {
+void PhysicsWorld::removeEntity(std::shared_ptr<PhysicsBody> entity) {
 	auto it = std::find(_entities.begin(), _entities.end(), entity);
 	
 	if(it != _entities.end()){
@@ -390,11 +296,11 @@ void PhysicsWorld::removeEntity(std::shared_ptr<anim::Entity> entity) {
 }
 
 
-void PhysicsWorld::unregisterContact(std::shared_ptr<anim::Entity> a, std::shared_ptr<anim::Entity> b) {
+void PhysicsWorld::unregisterContact(std::shared_ptr<PhysicsBody> a, std::shared_ptr<PhysicsBody> b) {
 	this->_contactEventCollisions.erase(
 										std::remove_if(this->_contactEventCollisions.begin(),
 													   this->_contactEventCollisions.end(),
-													   [=](const std::pair<long long, std::pair<std::shared_ptr<anim::Entity>, std::shared_ptr<anim::Entity>>> contact) {
+													   [=](const std::pair<long long, std::pair<std::shared_ptr<PhysicsBody>, std::shared_ptr<PhysicsBody>>> contact) {
 														   
 														   bool shouldRemove = false;
 														   shouldRemove = (contact.second.first == a &&
@@ -408,11 +314,11 @@ void PhysicsWorld::unregisterContact(std::shared_ptr<anim::Entity> a, std::share
 	
 }
 
-void PhysicsWorld::unregisterContact(std::shared_ptr<anim::Entity> a) {
+void PhysicsWorld::unregisterContact(std::shared_ptr<PhysicsBody> a) {
 	this->_contactEventCollisions.erase(
 										std::remove_if(this->_contactEventCollisions.begin(),
 													   this->_contactEventCollisions.end(),
-													   [=](const std::pair<long long, std::pair<std::shared_ptr<anim::Entity>, std::shared_ptr<anim::Entity>>> contact) {
+													   [=](const std::pair<long long, std::pair<std::shared_ptr<PhysicsBody>, std::shared_ptr<PhysicsBody>>> contact) {
 														   
 														   bool shouldRemove = false;
 														   shouldRemove = (contact.second.first == a || contact.second.second == a);
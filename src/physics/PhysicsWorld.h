@@ -4,27 +4,21 @@
 #include <map>
 #include <memory>
 #include <tuple>
+#include <unordered_map>
 
 #include <glm/glm.hpp>
 
-namespace anim{
-class Entity;
-}
+#include "Broadphase.h"
+#include "ContactBuffer.h"
+#include "PhysicsBody.h"
 
 
 namespace windy {
-enum class Contact {
-	Up,
-	Down,
-	Left,
-	Right
-};
-
 struct CollisionContact {
 	Contact type;
 	bool contact;
 	
-	std::shared_ptr<anim::Entity> entity;
+	std::shared_ptr<physics::PhysicsBody> entity;
 };
 }
 
@@ -40,32 +34,42 @@ namespace physics {
 
         virtual void update(float dt);
 
-        static void alignCollisions(std::shared_ptr<anim::Entity> entity, std::shared_ptr<anim::Entity> landscapeEntity, bool clearContacts = false);
-
-        void addEntity(std::shared_ptr<anim::Entity> entity);
-        void removeEntity(std::shared_ptr<anim::Entity> entity);
+        void addEntity(std::shared_ptr<physics::PhysicsBody> entity);
+        void removeEntity(std::shared_ptr<physics::PhysicsBody> entity);
 
-        std::vector<std::shared_ptr<anim::Entity>>& getEntities() { return _entities; }
+        std::vector<std::shared_ptr<physics::PhysicsBody>>& getEntities() { return _entities; }
 
 
-        void unregisterContact(std::shared_ptr<anim::Entity> a, std::shared_ptr<anim::Entity> b);
-        void unregisterContact(std::shared_ptr<anim::Entity> a);
+        void unregisterContact(std::shared_ptr<physics::PhysicsBody> a, std::shared_ptr<physics::PhysicsBody> b);
+        void unregisterContact(std::shared_ptr<physics::PhysicsBody> a);
 
         void resetContactEventCollisions();
 
+        // Contacts found by the last update(); empty for entities that were not simulated
+        bool hasContact(const std::shared_ptr<physics::PhysicsBody>& entity, windy::Contact type) const;
+        std::pair<const BodyContact*, const BodyContact*> getContacts(const std::shared_ptr<physics::PhysicsBody>& entity) const;
+
         void setGravity(float gravity) { _gravity = gravity; }
         float getGravity() { return _gravity; }
 
     private:
+        void alignCollisions(const BroadphaseProxy& body, const BroadphaseProxy& landscape);
+        void registerContactEvent(const std::shared_ptr<physics::PhysicsBody>& entity, const std::shared_ptr<physics::PhysicsBody>& collidingEntity);
+
         float _maxFallSpeed;
 
         float _gravity;
 
 
-        std::vector<std::shared_ptr<anim::Entity>> _entities;
+        std::vector<std::shared_ptr<physics::PhysicsBody>> _entities;
 
         long long _contactEventCollisionIndex;
-        std::vector<std::pair<long long, std::pair<std::shared_ptr<anim::Entity>, std::shared_ptr<anim::Entity>>>> _contactEventCollisions;
+        std::vector<std::pair<long long, std::pair<std::shared_ptr<physics::PhysicsBody>, std::shared_ptr<physics::PhysicsBody>>>> _contactEventCollisions;
+
+        // Per-step scratch, reused so that steady-state steps do not allocate
+        Broadphase _broadphase;
+        ContactBuffer _contacts;
+        std::unordered_map<const PhysicsBody*, uint32_t> _bodyIndices;
 
     };
 
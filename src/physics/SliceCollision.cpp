@@ -0,0 +1,120 @@
+#include <cmath>
+
+#include "SliceCollision.h"
+
+#include "GeometryExtensions.h"
+
+using namespace physics;
+
+namespace {
+void sliceBox(const windy::Rect& box, windy::Rect (&slices)[8]) {
+	windy::Rect tiles[9];
+
+	float tileW = box.size.x / 3.0f;
+	float tileH = box.size.y / 3.0f;
+
+	float boxLeft = box.getMinX();
+	float boxTop = box.getMaxY();
+
+	for (int j = 0; j < 9; ++j) {
+		int column = j % 3;
+		int row = j / 3;
+
+		auto tileOrigin = glm::vec2(boxLeft + (tileW * column), boxTop - (tileH * row));
+
+		tiles[j] = windy::Rect(tileOrigin.x, tileOrigin.y - tileH, tileW, tileH);
+	}
+
+	// Edges first (bottom, top, left, right), then the corners
+	slices[0] = tiles[7];
+	slices[1] = tiles[1];
+	slices[2] = tiles[3];
+	slices[3] = tiles[5];
+	slices[4] = tiles[0];
+	slices[5] = tiles[2];
+	slices[6] = tiles[6];
+	slices[7] = tiles[8];
+}
+}
+
+glm::ivec2 physics::resolveSliceCollisions(windy::Rect& box, const windy::Rect& obstacle, ContactBuffer& contacts, uint32_t body, uint32_t other) {
+	glm::ivec2 offset(0);
+
+	if (!windy::GeometryExtensions::rectIntersectsRect(obstacle, box)) {
+		return offset;
+	}
+
+	windy::Rect slices[8];
+	sliceBox(box, slices);
+
+	for (int k = 0; k < 8; k++) {
+		if (!windy::GeometryExtensions::rectIntersectsRect(obstacle, slices[k])) {
+			continue;
+		}
+
+		auto intersection = windy::GeometryExtensions::rectIntersection(obstacle, slices[k]);
+
+		bool hasOffsetX = false;
+		bool hasOffsetY = false;
+
+		windy::Contact contactType;
+
+		switch (k) {
+			case 0:
+				contactType = windy::Contact::Up;
+				hasOffsetY = true;
+				break;
+			case 1:
+				contactType = windy::Contact::Down;
+				hasOffsetY = true;
+				intersection.size.y *= -1;
+				break;
+			case 2:
+				contactType = windy::Contact::Left;
+				hasOffsetX = true;
+				break;
+			case 3:
+				contactType = windy::Contact::Right;
+				hasOffsetX = true;
+				intersection.size.x *= -1;
+				break;
+			default:
+				if (intersection.size.x >= intersection.size.y) {
+					if (k == 4 || k == 5) {
+						contactType = windy::Contact::Down;
+						hasOffsetY = true;
+						intersection.size.y = -intersection.size.y;
+					} else {
+						contactType = windy::Contact::Up;
+						hasOffsetY = true;
+					}
+				} else {
+					if (k == 7 || k == 5) {
+						contactType = windy::Contact::Right;
+						hasOffsetX = true;
+						intersection.size.x *= -1;
+					} else {
+						contactType = windy::Contact::Left;
+						hasOffsetX = true;
+					}
+				}
+		}
+
+		contacts.add(body, other, contactType);
+
+		if (hasOffsetX) {
+			box.origin.x += intersection.size.x;
+			offset.x += intersection.size.x;
+		}
+
+		if (hasOffsetY) {
+			box.origin.y += intersection.size.y;
+			offset.y += intersection.size.y;
+		}
+
+		// Later tiles are tested against the corrected box
+		sliceBox(box, slices);
+	}
+
+	return offset;
+}
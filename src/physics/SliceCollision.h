@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "ContactBuffer.h"
+#include "Geometry.h"
+
+namespace physics {
+/**
+ * Pushes box out of obstacle using the eight border tiles of its 3x3 slicing:
+ * edge tiles resolve along their own axis, corner tiles along the shallower one.
+ * Every resolving tile reports a contact for body. Returns the total offset that
+ * was applied to box, which the caller mirrors onto the body's transform.
+ */
+glm::ivec2 resolveSliceCollisions(windy::Rect& box, const windy::Rect& obstacle, ContactBuffer& contacts, uint32_t body, uint32_t other);
+}
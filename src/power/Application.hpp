@@ -1,7 +1,9 @@
 #pragma once
 
 #include "animation/AnimationTimeProvider.hpp"
+#include "profiling/MemoryTracker.hpp"
 #include "serialization/SerializationModule.hpp"
+#include "ui/ProfilerOverlay.hpp"
 
 #include <entt/entt.hpp>
 
@@ -251,6 +253,13 @@ class Application : public nanogui::DraggableScreen
 	std::unique_ptr<SimulationServer> mSimulationServer;
 	std::unique_ptr<SerializationModule> mSerializationModule;
 
+#if defined(POWER_ENGINE_PROFILER) && POWER_ENGINE_PROFILER
+	ProfilerOverlay mProfilerOverlay;
+#endif
+
+	// Previous F5 report, the baseline for the next diff
+	std::optional<MemoryTracker::Snapshot> mMemorySnapshot;
+
 	std::queue<std::tuple<bool, int, int, int, int>> mClickQueue;
 	std::vector<std::function<void(bool, int, int, int, int)>> mClickCallbacks;
 	std::vector<std::function<void()>> mEventQueue;
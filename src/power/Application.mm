@@ -29,6 +29,7 @@
 #include "execution/ExecutionManager.hpp"
 
 #include "filesystem/DirectoryNode.hpp"
+#include "filesystem/HashCache.hpp"
 
 #include "gizmo/GizmoManager.hpp"
 #include "graphics/drawing/BatchUnit.hpp"
@@ -64,6 +65,7 @@
 
 #include <cmath>
 #include <functional>
+#include <iostream>
 
 
 // === ADDED SECTION: Objective-C Category to handle menu actions ===
@@ -146,6 +148,13 @@ void Application::initialize() {
 	
 	mGizmoSkinnedMeshBatch = std::make_unique<SkinnedMeshBatch>(mRenderCommon->canvas()->render_pass());
 
+	// Gizmo batches stay unlit
+	mMeshBatch->set_light_clusters(&mActorManager->light_clusters());
+	mSkinnedMeshBatch->set_light_clusters(&mActorManager->light_clusters());
+	
+	mMeshBatch->set_render_list(&mActorManager->render_list());
+	mSkinnedMeshBatch->set_render_list(&mActorManager->render_list());
+	
 	mBatchUnit = std::make_unique<BatchUnit>(*mMeshBatch, *mSkinnedMeshBatch);
 
 	mGizmoBatchUnit = std::make_unique<BatchUnit>(*mGizmoMeshBatch, *mGizmoSkinnedMeshBatch);
@@ -162,6 +171,9 @@ void Application::initialize() {
 	
 	mGizmoManager = std::make_unique<GizmoManager>(*mRenderCommon->canvas(), mRenderCommon->shader_manager(), *mActorManager, *mGizmoActorLoader);
 	
+	mGizmoMeshBatch->set_render_list(&mGizmoManager->render_list());
+	mGizmoSkinnedMeshBatch->set_render_list(&mGizmoManager->render_list());
+	
 	mUiManager = std::make_unique<UiManager>(*this,
 											 mUiCommon->hierarchy_panel(),
 											 mUiCommon->hierarchy_panel(),
@@ -229,6 +241,12 @@ bool Application::keyboard_event(int key, int scancode, int action, int modifier
 	Screen::keyboard_event(key, scancode, action, modifiers);
 	
 	if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS) {
+		// Escape ends a running movie export before it hides the editor
+		if (mUiManager->is_movie_exporting()) {
+			mUiManager->stop_movie_export();
+			return true;
+		}
+		
 		nanogui::async([this](){
 			set_visible(false);
 		});
@@ -283,6 +301,45 @@ bool Application::keyboard_event(int key, int scancode, int action, int modifier
 		return true;
 	}
 	
+#if defined(POWER_ENGINE_PROFILER) && POWER_ENGINE_PROFILER
+	if (key == GLFW_KEY_F3 && action == GLFW_PRESS) {
+		mProfilerOverlay.set_visible(!mProfilerOverlay.visible());
+		return true;
+	}
+	
+	if (key == GLFW_KEY_F4 && action == GLFW_PRESS) {
+		auto path = mProfilerOverlay.export_trace();
+		
+		if (!path.empty()) {
+			std::cout << "Profiler trace written to " << path << std::endl;
+		}
+		return true;
+	}
+#endif
+	
+	if (key == GLFW_KEY_F5 && action == GLFW_PRESS) {
+		auto snapshot = MemoryTracker::instance().snapshot();
+		
+		std::cout << MemoryTracker::report(snapshot);
+		
+		if (mMemorySnapshot) {
+			std::cout << MemoryTracker::diff(*mMemorySnapshot, snapshot);
+		}
+		
+		mMemorySnapshot = snapshot;
+		return true;
+	}
+	
+	// Cmd+Z undoes, Cmd+Shift+Z or Cmd+Y redoes (Ctrl on other platforms)
+	if ((key == GLFW_KEY_Z || key == GLFW_KEY_Y) && action == GLFW_PRESS && (modifiers & (GLFW_MOD_SUPER | GLFW_MOD_CONTROL))) {
+		bool redo = key == GLFW_KEY_Y || (modifiers & GLFW_MOD_SHIFT);
+		
+		if (redo ? mActorManager->journal().redo() : mActorManager->journal().undo()) {
+			mCameraManager->update_from(*mActorManager);
+		}
+		return true;
+	}
+	
 	if (key == GLFW_KEY_DELETE && action == GLFW_PRESS) {
 		mBlueprintManager->commit();
 		mUiManager->remove_active_actor();
@@ -293,10 +350,21 @@ bool Application::keyboard_event(int key, int scancode, int action, int modifier
 }
 
 void Application::draw(NVGcontext *ctx) {
-    Screen::draw(ctx);
+	{
+		POWER_PROFILE_ZONE("Application::draw");
+		Screen::draw(ctx);
+	}
+
+#if defined(POWER_ENGINE_PROFILER) && POWER_ENGINE_PROFILER
+	mProfilerOverlay.draw(ctx, size());
+#endif
+
+	POWER_PROFILE_FRAME();
 }
 
 void Application::process_events() {
+	POWER_PROFILE_ZONE("Application::process_events");
+	
 	mGlobalAnimationTimeProvider.Update();
 	
 	if (mLoadedVirtualMachine.has_value()) {
@@ -359,11 +427,19 @@ bool Application::drop_event(Widget& sender, const std::vector<std::string> & fi
 			// For example, !mUiManager->some_other_panel()->contains(m_mouse_pos)
 			
 			if (path.find(".fbx") != std::string::npos) {
-				mUiCommon->hierarchy_panel()->add_actor(mMeshActorLoader->create_actor(path, mGlobalAnimationTimeProvider, *mMeshShader, *mSkinnedShader));
+				auto& actor = mMeshActorLoader->create_actor(path, mGlobalAnimationTimeProvider, *mMeshShader, *mSkinnedShader);
+				mUiCommon->hierarchy_panel()->add_actor(actor);
+				mActorManager->record_actor_added(actor);
+				
+				// Keeps the hashes of the imported textures if the session ends abruptly
+				HashCache::instance().save();
 				//				mUiCommon->scene_time_bar()->refresh_actors();
 				return; // Event handled
 			} else if (path.find(".png") != std::string::npos) {
-				mUiCommon->hierarchy_panel()->add_actor(mMeshActorLoader->create_sprite_actor("Sprite", path, *mMeshShader));
+				auto& actor = mMeshActorLoader->create_sprite_actor("Sprite", path, *mMeshShader);
+				mUiCommon->hierarchy_panel()->add_actor(actor);
+				mActorManager->record_actor_added(actor);
+				HashCache::instance().save();
 				//				mUiCommon->scene_time_bar()->refresh_actors();
 				return; // Event handled
 			}
@@ -19,13 +19,7 @@ CameraManager::~CameraManager() {
 }
 
 void CameraManager::update_from(const ActorManager& actorManager) {
-	auto cameras = actorManager.get_actors_with_component<CameraComponent>();
-	
-	mCameras.clear();
-	
-	for (auto& camera : cameras) {
-		mCameras.push_back(camera);
-	}
+	mCameras = actorManager.get_actors_with_component<CameraComponent>();
 	
 	mActiveCamera = *mEngineCamera;
 }
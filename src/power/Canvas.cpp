@@ -2,7 +2,9 @@
 
 #include "actors/ActorManager.hpp"
 #include "filesystem/ImageUtils.hpp"
+#include "graphics/capture/FrameCapture.hpp"
 #include "graphics/drawing/Drawable.hpp"
+#include "profiling/Profiler.hpp"
 
 #include <nanogui/renderpass.h>
 #include <nanogui/screen.h>
@@ -24,6 +26,9 @@ Canvas::Canvas(nanogui::Widget& parent, nanogui::Screen& screen, nanogui::Color
 }
 
 void Canvas::draw_contents() {
+	POWER_PROFILE_ZONE("Canvas::draw_contents");
+	POWER_PROFILE_GPU_ZONE("Canvas");
+	
     for (auto& callback : mDrawCallbacks) {
         callback();
     }
@@ -37,8 +42,35 @@ void Canvas::take_snapshot(std::function<void(std::vector<uint8_t>&)> onSnapshot
 	mSnapshotCallback = std::move(onSnapshotTaken);
 }
 
+void Canvas::capture_frame(FrameCapture& capture) {
+	mPendingCapture = &capture;
+}
+
+void Canvas::cancel_capture() {
+	mPendingCapture = nullptr;
+}
+
 void Canvas::process_events() {
 	
+	if (mPendingCapture) {
+		auto& scr = screen();
+		
+		float pixel_ratio = scr.pixel_ratio();
+		
+		nanogui::Vector2i fbsize = nanogui::Vector2i(nanogui::Vector2f(m_size) * pixel_ratio);
+		
+#if defined(NANOGUI_USE_METAL)
+		nanogui::Vector2i offset = nanogui::Vector2i(nanogui::Vector2f(absolute_position()) * pixel_ratio);
+		
+		mPendingCapture->capture(0, scr.nswin(), scr.metal_texture(), offset.x(), offset.y(), fbsize.x(), fbsize.y());
+#else
+		// The canvas renders into its own framebuffer, so the region starts at the origin
+		mPendingCapture->capture(render_pass().framebuffer_handle(), nullptr, nullptr, 0, 0, fbsize.x(), fbsize.y());
+#endif
+		
+		mPendingCapture = nullptr;
+	}
+	
 	// schedule here
 	if (mSnapshotCallback) {
 		auto& scr = screen();
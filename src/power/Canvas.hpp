@@ -6,6 +6,7 @@
 #include <vector>
 
 class ActorManager;
+class FrameCapture;
 
 class Canvas : public nanogui::Canvas
 {
@@ -18,6 +19,12 @@ public:
 	
 	void take_snapshot(std::function<void(std::vector<uint8_t>&)> onSnapshotTaken);
 	
+	// Queues the current contents for asynchronous capture on the next process_events()
+	void capture_frame(FrameCapture& capture);
+	
+	// Drops a queued capture, for when the capture is about to be destroyed
+	void cancel_capture();
+	
 	void process_events();
 	
 protected:
@@ -28,5 +35,7 @@ private:
 	
 	std::function<void(std::vector<uint8_t>&)> mSnapshotCallback;
 	
+	FrameCapture* mPendingCapture = nullptr;
+	
 	nanogui::Color mBackgroundColor;
 };
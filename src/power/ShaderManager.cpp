@@ -1,5 +1,18 @@
 #include "ShaderManager.hpp"
+
+#include "profiling/Profiler.hpp"
+
+#if defined(NANOGUI_USE_METAL)
+#include <nanogui/metal.h>
+#endif
+
+#include <openssl/evp.h>
+
+#include <array>
+#include <exception>
 #include <fstream>
+#include <future>
+#include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <filesystem> // For std::filesystem (C++17 and later)
@@ -7,6 +20,30 @@
 
 namespace fs = std::filesystem;
 
+namespace {
+constexpr const char* kPipelineCachePrefix = "pipelines-";
+constexpr const char* kPipelineCacheExtension = ".metalar";
+
+// Bump when pipelines change without their sources changing (e.g. new pipeline options)
+constexpr const char* kPipelineCacheVersion = "1";
+
+std::string hash_string(const std::string& data) {
+	std::array<unsigned char, EVP_MAX_MD_SIZE> digest{};
+	unsigned int digestLength = 0;
+	
+	if (EVP_Digest(data.data(), data.size(), digest.data(), &digestLength, EVP_md5(), nullptr) != 1) {
+		return "";
+	}
+	
+	std::ostringstream hex;
+	for (unsigned int i = 0; i < digestLength; ++i) {
+		hex << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(digest[i]);
+	}
+	
+	return hex.str();
+}
+} // unnamed namespace
+
 // Helper function to get the path to the Resources directory
 std::string get_resources_path() {
 	char path[1024];
@@ -46,6 +83,9 @@ std::string ShaderManager::read_file(const std::string &file_path) {
 ShaderManager::ShaderManager(nanogui::Canvas& canvas) : mRenderPass(canvas.render_pass()) {
 }
 
+ShaderManager::ShaderManager(nanogui::RenderPass& renderPass) : mRenderPass(renderPass) {
+}
+
 std::shared_ptr<nanogui::Shader> ShaderManager::load_shader(
 															const std::string &name,
 															const std::string &vertex_path,
@@ -56,12 +96,116 @@ std::shared_ptr<nanogui::Shader> ShaderManager::load_shader(
 		return mShaderCache[name];
 	}
 	
-	std::string vertex_code = read_file(vertex_path);
-	std::string fragment_code = read_file(fragment_path);
-	std::shared_ptr<nanogui::Shader> shader =
-	std::make_shared<nanogui::Shader>(mRenderPass, name, vertex_code, fragment_code, blendMode);
-	mShaderCache[name] = shader;
-	return shader;
+	load_shaders({ShaderSource{name, vertex_path, fragment_path, blendMode}});
+	return mShaderCache[name];
+}
+
+void ShaderManager::load_shaders(const std::vector<ShaderSource>& sources) {
+	POWER_PROFILE_ZONE("ShaderManager::load_shaders");
+	
+	struct PendingShader {
+		const ShaderSource& source;
+		std::string vertex_code;
+		std::string fragment_code;
+	};
+	
+	std::vector<PendingShader> pending;
+	
+	for (const auto& source : sources) {
+		if (mShaderCache.find(source.name) == mShaderCache.end()) {
+			pending.push_back({source, read_file(source.vertex_path), read_file(source.fragment_path)});
+		}
+	}
+	
+	if (pending.empty()) {
+		return;
+	}
+	
+#if defined(NANOGUI_USE_METAL)
+	if (!mPipelineCacheOpen) {
+		std::string sourceKey;
+		
+		for (const auto& shader : pending) {
+			sourceKey += shader.source.name + '\0' + shader.vertex_code + '\0' + shader.fragment_code + '\0';
+		}
+		
+		open_pipeline_cache(sourceKey);
+	}
+	
+	// MTLDevice is thread safe, so library and pipeline compilation fan out across shaders
+	std::vector<std::future<std::shared_ptr<nanogui::Shader>>> compiled;
+	
+	for (const auto& shader : pending) {
+		compiled.push_back(std::async(std::launch::async, [this, &shader]() {
+			void* pool = nanogui::autorelease_init();
+			
+			try {
+				auto result = std::make_shared<nanogui::Shader>(mRenderPass, shader.source.name, shader.vertex_code,
+																shader.fragment_code, shader.source.blendMode);
+				nanogui::autorelease_release(pool);
+				return result;
+			} catch (...) {
+				nanogui::autorelease_release(pool);
+				throw;
+			}
+		}));
+	}
+	
+	// Every compile has to finish before a failure is reported
+	std::exception_ptr failure;
+	
+	for (size_t i = 0; i < pending.size(); ++i) {
+		try {
+			mShaderCache[pending[i].source.name] = compiled[i].get();
+		} catch (...) {
+			if (!failure) {
+				failure = std::current_exception();
+			}
+		}
+	}
+	
+	if (mPipelineCacheOpen) {
+		nanogui::metal_pipeline_cache_save();
+	}
+	
+	if (failure) {
+		std::rethrow_exception(failure);
+	}
+#else
+	// GL contexts are bound to the calling thread, programs compile one by one
+	for (const auto& shader : pending) {
+		mShaderCache[shader.source.name] = std::make_shared<nanogui::Shader>(mRenderPass, shader.source.name, shader.vertex_code,
+																			  shader.fragment_code, shader.source.blendMode);
+	}
+#endif
+}
+
+void ShaderManager::open_pipeline_cache(const std::string& sourceKey) {
+#if defined(NANOGUI_USE_METAL)
+	std::error_code error;
+	fs::path directory = fs::temp_directory_path(error) / "PowerEngine" / "shaders";
+	fs::create_directories(directory, error);
+	
+	// Compiled GPU code is only valid for the driver that produced it
+	std::string key = hash_string(std::string(kPipelineCacheVersion) + '\0' + nanogui::metal_device_identity() + '\0' + sourceKey);
+	fs::path path = directory / (kPipelineCachePrefix + key + kPipelineCacheExtension);
+	
+	// Archives for older sources or other drivers would never be looked up again
+	for (fs::directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+		std::string filename = it->path().filename().string();
+		
+		if (filename.rfind(kPipelineCachePrefix, 0) == 0 && it->path() != path) {
+			std::error_code removeError;
+			fs::remove(it->path(), removeError);
+		}
+	}
+	
+	mPipelineCacheOpen = nanogui::metal_pipeline_cache_open(path.string());
+	
+	if (!mPipelineCacheOpen) {
+		std::cerr << "Shader pipeline cache unavailable, compiling every shader from source" << std::endl;
+	}
+#endif
 }
 
 std::shared_ptr<nanogui::Shader> ShaderManager::get_shader(const std::string &name) {
@@ -74,18 +218,22 @@ std::shared_ptr<nanogui::Shader> ShaderManager::get_shader(const std::string &na
 
 void ShaderManager::load_default_shaders() {
 #if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
-	load_shader("mesh", "internal/shaders/gl/diffuse.vs", "internal/shaders/gl/diffuse.fs");
-	load_shader("gizmo", "internal/shaders/gl/gizmo.vs", "internal/shaders/gl/gizmo.fs");
-	load_shader("grid", "internal/shaders/gl/grid.vs", "internal/shaders/gl/grid.fs");
+	load_shaders({
+		{"mesh", "internal/shaders/gl/diffuse.vs", "internal/shaders/gl/diffuse.fs"},
+		{"gizmo", "internal/shaders/gl/gizmo.vs", "internal/shaders/gl/gizmo.fs"},
+		{"grid", "internal/shaders/gl/grid.vs", "internal/shaders/gl/grid.fs"}
+	});
 #elif defined(NANOGUI_USE_METAL)
-	load_shader("mesh", "internal/shaders/metal/diffuse_vs.metal", "internal/shaders/metal/diffuse_fs.metal",
-				nanogui::Shader::BlendMode::AlphaBlend);
-	load_shader("skinned_mesh", "internal/shaders/metal/diffuse_skinned_vs.metal",
-				"internal/shaders/metal/diffuse_fs.metal", nanogui::Shader::BlendMode::AlphaBlend);
-	load_shader("gizmo", "internal/shaders/metal/gizmo_vs.metal", "internal/shaders/metal/gizmo_fs.metal",
-				nanogui::Shader::BlendMode::AlphaBlend);
-	load_shader("grid", "internal/shaders/metal/grid_vs.metal", "internal/shaders/metal/grid_fs.metal",
-				nanogui::Shader::BlendMode::AlphaBlend);
+	load_shaders({
+		{"mesh", "internal/shaders/metal/diffuse_vs.metal", "internal/shaders/metal/diffuse_fs.metal",
+			nanogui::Shader::BlendMode::AlphaBlend},
+		{"skinned_mesh", "internal/shaders/metal/diffuse_skinned_vs.metal",
+			"internal/shaders/metal/diffuse_fs.metal", nanogui::Shader::BlendMode::AlphaBlend},
+		{"gizmo", "internal/shaders/metal/gizmo_vs.metal", "internal/shaders/metal/gizmo_fs.metal",
+			nanogui::Shader::BlendMode::AlphaBlend},
+		{"grid", "internal/shaders/metal/grid_vs.metal", "internal/shaders/metal/grid_fs.metal",
+			nanogui::Shader::BlendMode::AlphaBlend}
+	});
 #endif
 }
 
@@ -5,6 +5,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 class Canvas;
 
@@ -12,6 +13,9 @@ class ShaderManager
 {
    public:
     ShaderManager(nanogui::Canvas& canvas);
+	
+	// Loads shaders against a pass of its own targets, e.g. for offscreen rendering
+	explicit ShaderManager(nanogui::RenderPass& renderPass);
 
     std::shared_ptr<nanogui::Shader> get_shader(const std::string &name);
 
@@ -24,9 +28,24 @@ class ShaderManager
 	std::shared_ptr<nanogui::Shader> load_shader(const std::string &name,
 											  const std::string &vertex_path,
 											  const std::string &fragment_path, nanogui::Shader::BlendMode blendMode = nanogui::Shader::BlendMode::None);
+	
+	struct ShaderSource {
+		std::string name;
+		std::string vertex_path;
+		std::string fragment_path;
+		nanogui::Shader::BlendMode blendMode = nanogui::Shader::BlendMode::None;
+	};
+	
+	// Compiles every shader not loaded yet, concurrently where the backend allows it
+	void load_shaders(const std::vector<ShaderSource>& sources);
+	
    private:
+	// Opens the on-disk pipeline cache for this device and set of sources, dropping stale ones
+	void open_pipeline_cache(const std::string& sourceKey);
+	
     std::unordered_map<std::string, std::shared_ptr<nanogui::Shader>> mShaderCache;
 	nanogui::RenderPass& mRenderPass;
+	bool mPipelineCacheOpen = false;
 
     std::string read_file(const std::string &file_path);
 };
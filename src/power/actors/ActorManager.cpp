@@ -1,6 +1,6 @@
 #include "ActorManager.hpp"
 
-#include <unordered_set>
+#include <cmath>
 
 #include "CameraManager.hpp"
 #include "MeshActorLoader.hpp"
@@ -11,79 +11,375 @@
 #include "actors/Actor.hpp"
 #include "components/CameraComponent.hpp"
 #include "components/ColorComponent.hpp"
+#include "components/DetachedComponent.hpp"
 #include "components/DrawableComponent.hpp"
+#include "components/LightComponent.hpp"
 #include "components/MeshComponent.hpp"
+#include "components/MetadataComponent.hpp"
+#include "components/SkeletonComponent.hpp"
+#include "components/SkinnedMeshComponent.hpp"
 #include "components/TransformComponent.hpp"
 #include "gizmo/GizmoManager.hpp"
 #include "graphics/drawing/Batch.hpp"
+#include "graphics/drawing/Mesh.hpp"
 #include "graphics/drawing/MeshActorBuilder.hpp"
+#include "graphics/drawing/SkinnedMesh.hpp"
 #include "import/ModelImporter.hpp"
+#include "profiling/Profiler.hpp"
 #include "ui/UiManager.hpp"
 
-ActorManager::ActorManager(entt::registry& registry, CameraManager& cameraManager) : mRegistry(registry), mCameraManager(cameraManager) {}
+namespace {
+template<typename MeshType>
+size_t flattened_bytes(const MeshType& mesh) {
+	return tracked_capacity(mesh.get_flattened_positions()) + tracked_capacity(mesh.get_flattened_normals()) +
+		tracked_capacity(mesh.get_flattened_tex_coords1()) + tracked_capacity(mesh.get_flattened_tex_coords2()) +
+		tracked_capacity(mesh.get_flattened_material_ids()) + tracked_capacity(mesh.get_flattened_colors());
+}
+
+// What a detached actor keeps alive, dominated by the vertex attributes of its meshes
+size_t retained_actor_bytes(Actor& actor) {
+	size_t bytes = sizeof(Actor);
+	
+	if (!actor.find_component<DrawableComponent>()) {
+		return bytes;
+	}
+	
+	auto& drawable = actor.get_component<DrawableComponent>().drawable();
+	
+	if (auto* meshComponent = dynamic_cast<MeshComponent*>(&drawable)) {
+		for (auto& mesh : meshComponent->get_mesh_data()) {
+			bytes += flattened_bytes(*mesh);
+		}
+	} else if (auto* skinnedComponent = dynamic_cast<SkinnedMeshComponent*>(&drawable)) {
+		for (auto& mesh : skinnedComponent->get_skinned_mesh_data()) {
+			bytes += flattened_bytes(*mesh) + tracked_capacity(mesh->get_flattened_bone_ids()) +
+				tracked_capacity(mesh->get_flattened_weights());
+		}
+	}
+	
+	return bytes;
+}
+
+class ActorTransformEdit : public UndoJournal::Entry {
+public:
+	ActorTransformEdit(entt::registry& registry, entt::entity entity, const Transform& before, const Transform& after)
+	: mRegistry(registry)
+	, mEntity(entity)
+	, mBefore(before)
+	, mAfter(after) {
+	}
+	
+	bool apply() override {
+		return assign(mAfter);
+	}
+	
+	bool revert() override {
+		return assign(mBefore);
+	}
+	
+	size_t memory_size() const override {
+		return sizeof(*this);
+	}
+	
+	bool merge(UndoJournal::Entry& next) override {
+		auto* edit = dynamic_cast<ActorTransformEdit*>(&next);
+		
+		if (!edit || edit->mEntity != mEntity) {
+			return false;
+		}
+		
+		mAfter = edit->mAfter;
+		return true;
+	}
+	
+private:
+	bool assign(const Transform& transform) {
+		if (!mRegistry.valid(mEntity) || !mRegistry.all_of<TransformComponent>(mEntity)) {
+			return false;
+		}
+		
+		// Setters rather than the raw transform so panels and animation tracks hear about it
+		auto& component = mRegistry.get<TransformComponent>(mEntity);
+		component.set_translation(transform.translation);
+		component.set_rotation(transform.rotation);
+		component.set_scale(transform.scale);
+		return true;
+	}
+	
+	entt::registry& mRegistry;
+	entt::entity mEntity;
+	Transform mBefore;
+	Transform mAfter;
+};
+} // unnamed namespace
+
+// Adds or removes a set of actors; whichever side is out of the scene is held here
+class ActorManager::ActorPresenceEdit : public UndoJournal::Entry {
+public:
+	ActorPresenceEdit(ActorManager& manager, const std::vector<Actor*>& actors, std::vector<std::unique_ptr<Actor>> detached)
+	: mManager(manager)
+	, mDetached(std::move(detached)) {
+		// The entity tells a live actor from a new one allocated where a destroyed actor was
+		for (auto* actor : actors) {
+			mActors.emplace_back(actor, actor->get_entity());
+		}
+		
+		update_retained_bytes();
+	}
+	
+	bool apply() override {
+		toggle();
+		return true;
+	}
+	
+	bool revert() override {
+		toggle();
+		return true;
+	}
+	
+	size_t memory_size() const override {
+		return sizeof(*this) + mActors.capacity() * sizeof(mActors[0]) +
+			mDetached.capacity() * sizeof(std::unique_ptr<Actor>) + mRetainedBytes;
+	}
+	
+private:
+	void toggle() {
+		if (mDetached.empty()) {
+			for (auto [actor, entity] : mActors) {
+				if (mManager.manages(actor, entity)) {
+					mDetached.push_back(mManager.detach_actor(*actor));
+				}
+			}
+		} else {
+			for (auto& actor : mDetached) {
+				mManager.attach_actor(std::move(actor));
+			}
+			
+			mDetached.clear();
+		}
+		
+		update_retained_bytes();
+		
+		if (mManager.mActorsChangedCallback) {
+			mManager.mActorsChangedCallback();
+		}
+	}
+	
+	void update_retained_bytes() {
+		mRetainedBytes = 0;
+		
+		for (auto& actor : mDetached) {
+			mRetainedBytes += retained_actor_bytes(*actor);
+		}
+	}
+	
+	ActorManager& mManager;
+	std::vector<std::pair<Actor*, entt::entity>> mActors;
+	std::vector<std::unique_ptr<Actor>> mDetached;
+	size_t mRetainedBytes = 0;
+};
+
+ActorManager::ActorManager(entt::registry& registry, CameraManager& cameraManager) : mRegistry(registry), mCameraManager(cameraManager) {
+	// Groups are kept up to date from their creation, so both exist before the first actor does
+	drawable_actors();
+	animated_actors();
+}
 
 Actor& ActorManager::create_actor() {
     // This correctly creates an Actor which in turn creates an entity and adds an IDComponent
-    mActors.push_back(std::make_unique<Actor>(mRegistry));
-    return *mActors.back();
+    return adopt_actor(std::make_unique<Actor>(mRegistry));
 }
 
 Actor& ActorManager::create_actor(entt::entity entity) {
-    // This correctly creates an Actor which in turn creates an entity and adds an IDComponent
-    mActors.push_back(std::make_unique<Actor>(mRegistry, entity));
-    return *mActors.back();
+    return adopt_actor(std::make_unique<Actor>(mRegistry, entity));
+}
+
+Actor& ActorManager::adopt_actor(std::unique_ptr<Actor> actor) {
+	Actor& adopted = *actor;
+	ActorHandle handle = mActors.insert(std::move(actor));
+	
+	mRegistry.emplace_or_replace<ActorHandleComponent>(adopted.get_entity(), adopted, handle);
+	
+	return adopted;
+}
+
+ActorHandle ActorManager::handle_of(const Actor& actor) const {
+	auto* component = mRegistry.try_get<ActorHandleComponent>(actor.get_entity());
+	
+	if (!component || mActors.get(component->handle()) != &actor) {
+		return ActorHandle{};
+	}
+	
+	return component->handle();
+}
+
+Actor* ActorManager::find_actor(ActorHandle handle) const {
+	return mActors.get(handle);
+}
+
+bool ActorManager::manages(const Actor* actor, entt::entity entity) const {
+	// The entity is checked first, the actor may have been destroyed and its address reused
+	if (!mRegistry.valid(entity)) {
+		return false;
+	}
+	
+	auto* component = mRegistry.try_get<ActorHandleComponent>(entity);
+	
+	return component && mActors.get(component->handle()) == actor;
 }
 
 void ActorManager::remove_actor(Actor& actor) {
     // The actor's destructor will handle destroying the entt::entity.
     // We just need to remove the manager's handle to it.
-    auto it = std::find_if(mActors.begin(), mActors.end(),
-                           [&actor](const std::unique_ptr<Actor>& ptr) {
-        return ptr.get() == &actor;
-    });
-    
-    if (it != mActors.end()) {
-        mActors.erase(it);
-    } else {
+	ActorHandle handle = handle_of(actor);
+	
+    if (!mActors.erase(handle)) {
         throw std::runtime_error("Attempted to remove an actor that does not exist in the manager.");
     }
 }
 
 void ActorManager::remove_actors(const std::vector<std::reference_wrapper<Actor>>& actors) {
-    std::unordered_set<Actor*> actors_to_remove;
-    for (const auto& actor_ref : actors) {
-        actors_to_remove.insert(&actor_ref.get());
-    }
-    
-    // The actors' destructors will be called automatically when they are erased,
+    // The actors' destructors will be called as they are erased,
     // which will in turn destroy their associated entt::entity.
-    std::erase_if(mActors, [&actors_to_remove](const std::unique_ptr<Actor>& ptr) {
-        return actors_to_remove.count(ptr.get());
-    });
+	// Every handle is resolved before anything is erased, a repeated entry would otherwise be read after its actor was destroyed
+	std::vector<ActorHandle> handles;
+	handles.reserve(actors.size());
+	
+	for (auto& actor : actors) {
+		handles.push_back(handle_of(actor.get()));
+	}
+	
+	remove_actors(handles);
+}
+
+void ActorManager::remove_actors(const std::vector<ActorHandle>& handles) {
+	// Stale and repeated handles are skipped
+	for (auto handle : handles) {
+		mActors.erase(handle);
+	}
+}
+
+void ActorManager::record_actor_added(Actor& actor) {
+	mJournal.record(std::make_unique<ActorPresenceEdit>(*this, std::vector<Actor*>{&actor}, std::vector<std::unique_ptr<Actor>>{}));
+}
+
+void ActorManager::record_transform_change(Actor& actor, const Transform& before) {
+	if (!actor.find_component<TransformComponent>()) {
+		return;
+	}
+	
+	const Transform& after = actor.get_component<TransformComponent>().transform;
+	
+	if (after.translation == before.translation && after.rotation == before.rotation && after.scale == before.scale) {
+		return;
+	}
+	
+	mJournal.record(std::make_unique<ActorTransformEdit>(mRegistry, actor.get_entity(), before, after));
 }
 
+void ActorManager::delete_actors(const std::vector<std::reference_wrapper<Actor>>& actors) {
+	std::vector<Actor*> deleted;
+	std::vector<std::unique_ptr<Actor>> detached;
+	
+	for (auto& actor : actors) {
+		if (auto handle = detach_actor(actor.get())) {
+			deleted.push_back(handle.get());
+			detached.push_back(std::move(handle));
+		}
+	}
+	
+	if (!detached.empty()) {
+		mJournal.record(std::make_unique<ActorPresenceEdit>(*this, deleted, std::move(detached)));
+	}
+}
+
+std::unique_ptr<Actor> ActorManager::detach_actor(Actor& actor) {
+	std::unique_ptr<Actor> detached = mActors.take(handle_of(actor));
+	
+	if (!detached) {
+		return nullptr;
+	}
+	
+	// Batches draw every registered mesh, hiding the color component takes it off screen
+	bool visible = true;
+	
+	if (actor.find_component<ColorComponent>()) {
+		auto& color = actor.get_component<ColorComponent>();
+		visible = color.get_visible();
+		color.set_visible(false);
+	}
+	
+	actor.add_component<DetachedComponent>(visible);
+	
+	return detached;
+}
+
+void ActorManager::attach_actor(std::unique_ptr<Actor> actor) {
+	if (actor->find_component<DetachedComponent>()) {
+		bool visible = actor->get_component<DetachedComponent>().was_visible();
+		actor->remove_component<DetachedComponent>();
+		
+		if (actor->find_component<ColorComponent>()) {
+			actor->get_component<ColorComponent>().set_visible(visible);
+		}
+	}
+	
+	adopt_actor(std::move(actor));
+}
 
 void ActorManager::draw() {
+	POWER_PROFILE_ZONE("ActorManager::draw");
+	
     mCameraManager.update_view();
+	
+	update_light_clusters();
 
-    // This logic is fine, but be aware it will throw an exception if an actor
-    // is missing a required component.
-    for (auto& actor : mActors) {
-        if (actor->find_component<DrawableComponent>() &&
-            actor->find_component<TransformComponent>() &&
-            actor->find_component<ColorComponent>())
-        {
-            auto& drawable = actor->get_component<DrawableComponent>();
-            auto& transform = actor->get_component<TransformComponent>();
-            auto& color = actor->get_component<ColorComponent>();
-            
-            color.set_color(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
-
-            nanogui::Matrix4f model = glm_to_nanogui(transform.get_matrix());
-
-            drawable.draw_content(model, mCameraManager.get_view(), mCameraManager.get_projection());
-        }
-    }
+	mRenderList.clear();
+	
+	drawable_actors().each<TransformComponent, ColorComponent>([this](Actor& actor, TransformComponent& transform, ColorComponent& color) {
+		color.set_color(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
+		
+		entt::entity entity = actor.get_entity();
+		auto* metadata = mRegistry.try_get<MetadataComponent>(entity);
+		
+		auto& item = mRenderList.add();
+		item.model = glm_to_nanogui(transform.get_matrix());
+		item.color = color.get_color();
+		item.pickId = color.identifier();
+		item.instance = metadata ? metadata->identifier() : color.identifier();
+		item.flags = (color.get_visible() ? RenderList::Visible : 0u) |
+			(mRegistry.all_of<SkeletonComponent>(entity) ? RenderList::Skinned : 0u);
+	});
+}
+
+void ActorManager::update_light_clusters() {
+	mLights.clear();
+	
+	auto view = mRegistry.view<LightComponent, TransformComponent>(entt::exclude<DetachedComponent>);
+	
+	for (auto entity : view) {
+		auto& light = view.get<LightComponent>(entity);
+		
+		if (!light.get_enabled()) {
+			continue;
+		}
+		
+		glm::mat4 matrix = view.get<TransformComponent>(entity).get_matrix();
+		
+		LightClusters::Light clusterLight;
+		clusterLight.position = glm::vec3(matrix[3]);
+		clusterLight.range = light.get_range();
+		clusterLight.color = light.get_color();
+		clusterLight.intensity = light.get_intensity();
+		clusterLight.direction = glm::normalize(glm::mat3(matrix) * glm::vec3(0.0f, 0.0f, -1.0f));
+		clusterLight.cosInnerAngle = std::cos(light.get_inner_angle());
+		clusterLight.cosOuterAngle = std::cos(light.get_outer_angle());
+		clusterLight.spot = light.get_type() == LightComponent::ELightType::Spot;
+		
+		mLights.push_back(clusterLight);
+	}
+	
+	mLightClusters.build(nanogui_to_glm(mCameraManager.get_view()), nanogui_to_glm(mCameraManager.get_projection()), mLights);
 }
 
 void ActorManager::visit(GizmoManager& gizmoManager) {
@@ -108,6 +404,9 @@ void ActorManager::visit(Batch& batch) {
 }
 
 void ActorManager::clear_actors() {
+	// Retained actors go first, their entities are about to be destroyed with the registry
+	mJournal.clear();
+	
     // First, clear the vector of Actor wrappers. This will call their destructors,
     // which in turn will destroy all entities in the registry.
     mActors.clear();
@@ -3,12 +3,25 @@
 #include "IActorManager.hpp"
 
 #include "actors/Actor.hpp"
+#include "actors/ActorQuery.hpp"
+#include "actors/SlotMap.hpp"
+#include "components/ActorHandleComponent.hpp"
+#include "components/ColorComponent.hpp"
+#include "components/DetachedComponent.hpp"
+#include "components/DrawableComponent.hpp"
+#include "components/SkinnedAnimationComponent.hpp"
+#include "components/TransformComponent.hpp"
+#include "graphics/drawing/RenderList.hpp"
+#include "graphics/shading/LightClusters.hpp"
+#include "history/UndoJournal.hpp"
 
 #include <entt/entt.hpp>
 
+#include <algorithm>
 #include <functional>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class CameraManager;
@@ -18,6 +31,7 @@ class GizmoManager;
 class UiManager;
 class Batch;
 class SerializationModule;
+class Transform;
 
 class ActorManager : public IActorManager {
 public:
@@ -25,28 +39,87 @@ public:
 	Actor& create_actor() override;
 	void remove_actor(Actor& actor) override;
 	void remove_actors(const std::vector<std::reference_wrapper<Actor>>& actors) override;
+	void remove_actors(const std::vector<ActorHandle>& handles);
+	
+	// Handles stay safe to hold; find_actor returns nullptr once the actor is removed or detached
+	ActorHandle handle_of(const Actor& actor) const;
+	Actor* find_actor(ActorHandle handle) const;
+	
+	size_t actor_count() const {
+		return mActors.size();
+	}
 	
 	void clear_actors();
+	
+	// Editor operations, recorded in journal() so they can be undone
+	void record_actor_added(Actor& actor);
+	void record_transform_change(Actor& actor, const Transform& before);
+	void delete_actors(const std::vector<std::reference_wrapper<Actor>>& actors);
+	
+	UndoJournal& journal() {
+		return mJournal;
+	}
+	
+	// Called after undo or redo adds or removes actors
+	void set_actors_changed_callback(std::function<void()> callback) {
+		mActorsChangedCallback = std::move(callback);
+	}
 
+	// Actors in the scene carrying every listed component, visited through an entt view without allocating
+	template<typename... Components>
+	auto query() const {
+		return ActorQuery(mRegistry.view<ActorHandleComponent, Components...>(entt::exclude<DetachedComponent>));
+	}
+	
+	// The drawn set, kept packed by an owning group on DrawableComponent
+	// Transform and color are not owned, meshes and cameras hold references into those pools
+	auto drawable_actors() const {
+		return ActorQuery(mRegistry.group<DrawableComponent>(entt::get<ActorHandleComponent, TransformComponent, ColorComponent>, entt::exclude<DetachedComponent>));
+	}
+	
+	// The animated set; non-owning, the components register callbacks on themselves and must not move
+	auto animated_actors() const {
+		return ActorQuery(mRegistry.group<>(entt::get<ActorHandleComponent, SkinnedAnimationComponent>, entt::exclude<DetachedComponent>));
+	}
+	
+	// Snapshot in the order the component was added, for callers that keep or index the result
 	template<typename T>
 	const std::vector<std::reference_wrapper<Actor>> get_actors_with_component() const {
+		auto actors = query<T>().to_vector();
 		
-		std::vector<std::reference_wrapper<Actor>> actors;
-		for (auto& actor : mActors) {
-			if (actor->find_component<T>()) {
-				actors.push_back(std::ref(*actor));
-			}
-		}
+		// Views visit the most recently added first
+		std::reverse(actors.begin(), actors.end());
 		
 		return actors;
 	}
 
+	// Render extraction: writes the drawable actors into render_list() for the batches to submit
     void draw();
 	void visit(GizmoManager& gizmoManager);
 	void visit(UiManager& uiManager);
 	void visit(Batch& batch);
+	
+	// Rebuilt by draw() every frame from the actors carrying a LightComponent
+	const LightClusters& light_clusters() const {
+		return mLightClusters;
+	}
+	
+	// Rebuilt by draw() every frame, the batches read it when they are visited
+	RenderList& render_list() {
+		return mRenderList;
+	}
 private:
+	class ActorPresenceEdit;
+	
 	Actor& create_actor(entt::entity entity);
+	Actor& adopt_actor(std::unique_ptr<Actor> actor);
+	bool manages(const Actor* actor, entt::entity entity) const;
+	void update_light_clusters();
+	
+	// Detached actors keep their entity but leave the scene until attached again
+	std::unique_ptr<Actor> detach_actor(Actor& actor);
+	void attach_actor(std::unique_ptr<Actor> actor);
+	
 	entt::registry& registry() {
 		return mRegistry;
 	}
@@ -55,7 +128,9 @@ private:
 
 		std::vector<std::reference_wrapper<Actor>> actors;
 
-		for (auto& actor : mActors) {
+		actors.reserve(mActors.size());
+		
+		for (auto* actor : mActors) {
 			actors.push_back(std::ref(*actor));
 		}
 		
@@ -65,7 +140,15 @@ private:
 
 	entt::registry& mRegistry;
     CameraManager& mCameraManager;
-    std::vector<std::unique_ptr<Actor>> mActors;
+	SlotMap<Actor> mActors;
+	
+	LightClusters mLightClusters;
+	RenderList mRenderList;
+	std::vector<LightClusters::Light> mLights;
+	
+	// Declared after mActors so retained actors are released first
+	UndoJournal mJournal;
+	std::function<void()> mActorsChangedCallback;
 
 private:
 	friend class SerializationModule;
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "components/ActorHandleComponent.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+class Actor;
+
+/**
+ * @brief Non-allocating range of actors over an entt view or group.
+ *
+ * The source must get ActorHandleComponent. Iterating visits only the entities of
+ * the source, never the whole scene. Like the view it wraps, it is invalidated by
+ * adding or removing its components on other entities while iterating.
+ */
+template<typename Source>
+class ActorQuery {
+public:
+	class iterator {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = Actor;
+		using difference_type = std::ptrdiff_t;
+		using pointer = Actor*;
+		using reference = Actor&;
+
+		iterator() = default;
+
+		iterator(typename Source::iterator it, const Source* source)
+		: mIt(it)
+		, mSource(source) {
+		}
+
+		Actor& operator*() const {
+			return mSource->template get<ActorHandleComponent>(*mIt).actor();
+		}
+
+		Actor* operator->() const {
+			return &**this;
+		}
+
+		iterator& operator++() {
+			++mIt;
+			return *this;
+		}
+
+		iterator operator++(int) {
+			iterator previous = *this;
+			++mIt;
+			return previous;
+		}
+
+		bool operator==(const iterator& other) const {
+			return mIt == other.mIt;
+		}
+
+		bool operator!=(const iterator& other) const {
+			return mIt != other.mIt;
+		}
+
+	private:
+		typename Source::iterator mIt{};
+		const Source* mSource = nullptr;
+	};
+
+	explicit ActorQuery(Source source)
+	: mSource(source) {
+	}
+
+	iterator begin() const {
+		return iterator(mSource.begin(), &mSource);
+	}
+
+	iterator end() const {
+		return iterator(mSource.end(), &mSource);
+	}
+
+	bool empty() const {
+		return begin() == end();
+	}
+
+	size_t count() const {
+		size_t count = 0;
+
+		for (auto it = begin(); it != end(); ++it) {
+			++count;
+		}
+
+		return count;
+	}
+
+	// Calls function with the actor followed by the listed components, fetched from the source's pools
+	template<typename... Components, typename Function>
+	void each(Function&& function) const {
+		for (auto entity : mSource) {
+			function(mSource.template get<ActorHandleComponent>(entity).actor(), mSource.template get<Components>(entity)...);
+		}
+	}
+
+	// For callers that keep the result across frames or index into it
+	std::vector<std::reference_wrapper<Actor>> to_vector() const {
+		std::vector<std::reference_wrapper<Actor>> actors;
+
+		for (auto& actor : *this) {
+			actors.push_back(std::ref(actor));
+		}
+
+		return actors;
+	}
+
+	const Source& source() const {
+		return mSource;
+	}
+
+private:
+	Source mSource;
+};
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+// Names a SlotMap entry; stays safe to hold after the entry is removed, lookups then fail
+struct SlotHandle {
+	static constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+	uint32_t index = kInvalidIndex;
+	uint32_t generation = 0;
+
+	bool valid() const {
+		return index != kInvalidIndex;
+	}
+
+	bool operator==(const SlotHandle& other) const = default;
+};
+
+/**
+ * @brief Owning storage with generational handles and O(1) insert, remove and lookup.
+ *
+ * Each slot counts how many times it has been vacated, and a handle only resolves
+ * while its generation matches, so handles to removed values never reach a value
+ * that reused the slot. Values are also kept in a dense array for iteration, which
+ * removal keeps packed by moving the last value into the hole.
+ */
+template<typename T>
+class SlotMap {
+public:
+	using Handle = SlotHandle;
+
+	Handle insert(std::unique_ptr<T> value) {
+		uint32_t index;
+
+		if (mFreeHead != Handle::kInvalidIndex) {
+			index = mFreeHead;
+			mFreeHead = mSlots[index].next;
+		} else {
+			index = static_cast<uint32_t>(mSlots.size());
+			mSlots.emplace_back();
+		}
+
+		Slot& slot = mSlots[index];
+		slot.value = std::move(value);
+		slot.next = static_cast<uint32_t>(mDense.size());
+
+		mDense.push_back(slot.value.get());
+		mDenseSlots.push_back(index);
+
+		return Handle{index, slot.generation};
+	}
+
+	T* get(Handle handle) const {
+		if (handle.index >= mSlots.size()) {
+			return nullptr;
+		}
+
+		const Slot& slot = mSlots[handle.index];
+		return slot.generation == handle.generation ? slot.value.get() : nullptr;
+	}
+
+	bool contains(Handle handle) const {
+		return get(handle) != nullptr;
+	}
+
+	// Removes the value and hands it over; nullptr when the handle is stale
+	std::unique_ptr<T> take(Handle handle) {
+		if (!contains(handle)) {
+			return nullptr;
+		}
+
+		Slot& slot = mSlots[handle.index];
+		uint32_t dense = slot.next;
+
+		if (dense + 1 != mDense.size()) {
+			mDense[dense] = mDense.back();
+			mDenseSlots[dense] = mDenseSlots.back();
+			mSlots[mDenseSlots[dense]].next = dense;
+		}
+
+		mDense.pop_back();
+		mDenseSlots.pop_back();
+
+		std::unique_ptr<T> value = std::move(slot.value);
+
+		++slot.generation;
+		slot.next = mFreeHead;
+		mFreeHead = handle.index;
+
+		return value;
+	}
+
+	bool erase(Handle handle) {
+		return take(handle) != nullptr;
+	}
+
+	void clear() {
+		// Generations survive, so handles from before the clear stay stale
+		for (uint32_t index = 0; index < mSlots.size(); ++index) {
+			Slot& slot = mSlots[index];
+
+			if (slot.value) {
+				slot.value.reset();
+				++slot.generation;
+				slot.next = mFreeHead;
+				mFreeHead = index;
+			}
+		}
+
+		mDense.clear();
+		mDenseSlots.clear();
+	}
+
+	void reserve(size_t count) {
+		mSlots.reserve(count);
+		mDense.reserve(count);
+		mDenseSlots.reserve(count);
+	}
+
+	size_t size() const {
+		return mDense.size();
+	}
+
+	bool empty() const {
+		return mDense.empty();
+	}
+
+	// Packed values, in no particular order
+	typename std::vector<T*>::const_iterator begin() const {
+		return mDense.begin();
+	}
+
+	typename std::vector<T*>::const_iterator end() const {
+		return mDense.end();
+	}
+
+private:
+	struct Slot {
+		std::unique_ptr<T> value;
+		uint32_t generation = 0;
+		uint32_t next = Handle::kInvalidIndex; ///< Dense position while occupied, next free slot otherwise.
+	};
+
+	std::vector<Slot> mSlots;
+	std::vector<T*> mDense;
+	std::vector<uint32_t> mDenseSlots;
+	uint32_t mFreeHead = Handle::kInvalidIndex;
+};
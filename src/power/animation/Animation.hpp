@@ -1,6 +1,9 @@
 #pragma once
 
+#include "LocalPose.hpp"
+
 #include "filesystem/CompressedSerialization.hpp"
+#include "profiling/MemoryTracker.hpp"
 
 #include <vector>
 #include <glm/vec3.hpp>
@@ -108,12 +111,17 @@ public:
 	// Add keyframes for a specific bone
 	void add_bone_keyframes(int boneIndex, const std::vector<KeyFrame>& keyframes) {
 		m_bone_animations.push_back({boneIndex, keyframes});
+		update_memory_usage();
 	}
 	
 	bool empty() const {
 		return m_bone_animations.empty();
 	}
 	
+	const std::vector<BoneAnimation>& get_bone_animations() const {
+		return m_bone_animations;
+	}
+	
 	void sort() {
 		std::sort(m_bone_animations.begin(), m_bone_animations.end(), [](const BoneAnimation& a, const BoneAnimation& b) {
 			return a.bone_index < b.bone_index;
@@ -173,6 +181,62 @@ public:
 		return bone_keyframes;
 	}
 
+	/**
+	 * Samples the animation into a preallocated local pose, addressed by bone index.
+	 *
+	 * Bones whose mask weight is zero are skipped and keep whatever the pose held,
+	 * so callers blending several layers only pay for the bones a layer affects.
+	 *
+	 * @param time      The animation time to sample.
+	 * @param pose      The destination pose; bones outside its range are ignored.
+	 * @param bone_mask Optional per-bone weights indexed like the pose, or nullptr.
+	 */
+	void sample_local_pose(float time, LocalPose& pose, const float* bone_mask = nullptr) const {
+		const size_t numBones = pose.size();
+		
+		for (const auto& bone_anim : m_bone_animations) {
+			const auto& keyframes = bone_anim.keyframes;
+			const int boneIndex = bone_anim.bone_index;
+			
+			if (keyframes.empty() || boneIndex < 0 || static_cast<size_t>(boneIndex) >= numBones) {
+				continue;
+			}
+			
+			if (bone_mask && bone_mask[boneIndex] <= 0.0f) {
+				continue;
+			}
+			
+			if (time <= keyframes.front().time) {
+				const KeyFrame& first_keyframe = keyframes.front();
+				pose.translations[boneIndex] = first_keyframe.translation;
+				pose.rotations[boneIndex] = first_keyframe.rotation;
+				pose.scales[boneIndex] = first_keyframe.scale;
+				continue;
+			}
+			
+			if (time >= keyframes.back().time) {
+				const KeyFrame& last_keyframe = keyframes.back();
+				pose.translations[boneIndex] = last_keyframe.translation;
+				pose.rotations[boneIndex] = last_keyframe.rotation;
+				pose.scales[boneIndex] = last_keyframe.scale;
+				continue;
+			}
+			
+			// Keyframes are stored in time order, so the surrounding pair is a binary search away
+			auto it1 = std::lower_bound(keyframes.begin(), keyframes.end(), time, [](const KeyFrame& kf, float t) {
+				return kf.time < t;
+			});
+			
+			auto it0 = (it1 != keyframes.begin()) ? std::prev(it1) : it1;
+			
+			float t = (time - it0->time) / (it1->time - it0->time);
+			
+			pose.translations[boneIndex] = glm::mix(it0->translation, it1->translation, t);
+			pose.rotations[boneIndex] = glm::slerp(it0->rotation, it1->rotation, t);
+			pose.scales[boneIndex] = glm::mix(it0->scale, it1->scale, t);
+		}
+	}
+
 	// Set the total duration of the animation
 	void set_duration(int duration) {
 		m_duration = duration;
@@ -288,10 +352,21 @@ public:
 			if (!bone_anim.deserialize(deserializer)) return false;
 		}
 		
+		update_memory_usage();
+		
 		return true;
 	}
 
 private:
+	void update_memory_usage() {
+		uint64_t bytes = tracked_capacity(m_bone_animations);
+		for (const auto& bone_anim : m_bone_animations) {
+			bytes += tracked_capacity(bone_anim.keyframes);
+		}
+		m_memory.set(bytes);
+	}
+	
 	std::vector<BoneAnimation> m_bone_animations;
 	int m_duration = 0;  // Duration of the animation
+	TrackedMemory m_memory{MemoryTracker::Tag::Animation};
 };
@@ -28,6 +28,10 @@ public:
 		mTime = time;
 	}
 	
+	float GetDuration() const {
+		return mDuration;
+	}
+	
 private:
 	float mTime;
 	float mDuration;
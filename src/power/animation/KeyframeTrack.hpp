@@ -0,0 +1,326 @@
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <utility>
+#include <vector>
+
+/**
+ * Time-ordered keyframe storage.
+ *
+ * Keyframes are stored by value and ordered by time, giving O(log n) insert,
+ * find and erase. Playback queries go through a cursor that remembers the last
+ * active keyframe, so scrubbing or playing forward is O(1) amortized. Handles
+ * stay valid until their keyframe is erased and are safe to hold from the UI.
+ */
+template<typename T>
+class KeyframeTrack {
+public:
+	struct Handle {
+		uint32_t index = UINT32_MAX;
+		uint32_t generation = 0;
+
+		bool valid() const {
+			return index != UINT32_MAX;
+		}
+
+		bool operator==(const Handle& rhs) const {
+			return index == rhs.index && generation == rhs.generation;
+		}
+	};
+
+private:
+	struct Entry {
+		T value;
+		Handle handle;
+	};
+
+	using Map = std::map<float, Entry>;
+	using MapIterator = typename Map::iterator;
+
+	struct Slot {
+		MapIterator it;
+		uint32_t generation = 0;
+		bool alive = false;
+	};
+
+	// Cursor moves further than this fall back to a binary search
+	static constexpr int kMaxCursorSteps = 4;
+
+public:
+	template<typename MapIt, typename Value>
+	class basic_iterator {
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = Value*;
+		using reference = Value&;
+
+		basic_iterator() = default;
+		explicit basic_iterator(MapIt it) : mIt(it) {}
+
+		reference operator*() const { return mIt->second.value; }
+		pointer operator->() const { return &mIt->second.value; }
+		float time() const { return mIt->first; }
+		Handle handle() const { return mIt->second.handle; }
+
+		basic_iterator& operator++() { ++mIt; return *this; }
+		basic_iterator& operator--() { --mIt; return *this; }
+		basic_iterator operator++(int) { auto copy = *this; ++mIt; return copy; }
+		basic_iterator operator--(int) { auto copy = *this; --mIt; return copy; }
+
+		bool operator==(const basic_iterator& rhs) const { return mIt == rhs.mIt; }
+		bool operator!=(const basic_iterator& rhs) const { return mIt != rhs.mIt; }
+
+	private:
+		MapIt mIt;
+	};
+
+	using iterator = basic_iterator<MapIterator, T>;
+	using const_iterator = basic_iterator<typename Map::const_iterator, const T>;
+	using reverse_iterator = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+	KeyframeTrack() : m_cursor(m_entries.end()) {}
+
+	KeyframeTrack(const KeyframeTrack&) = delete;
+	KeyframeTrack& operator=(const KeyframeTrack&) = delete;
+
+	// Map nodes move with the container, so slot iterators stay valid; only the cursor resets
+	KeyframeTrack(KeyframeTrack&& other) noexcept
+	: m_entries(std::move(other.m_entries)), m_cursor(m_entries.end()),
+	m_slots(std::move(other.m_slots)), m_free_slots(std::move(other.m_free_slots)) {
+		other.clear();
+	}
+
+	KeyframeTrack& operator=(KeyframeTrack&& other) noexcept {
+		if (this != &other) {
+			m_entries = std::move(other.m_entries);
+			m_cursor = m_entries.end();
+			m_slots = std::move(other.m_slots);
+			m_free_slots = std::move(other.m_free_slots);
+			other.clear();
+		}
+		return *this;
+	}
+
+	// Inserts a keyframe, replacing the value of an existing one at the same time
+	Handle insert(float time, T value) {
+		auto [it, inserted] = m_entries.try_emplace(time, Entry{std::move(value), Handle{}});
+
+		if (!inserted) {
+			it->second.value = std::move(value);
+			return it->second.handle;
+		}
+
+		it->second.handle = allocate_slot(it);
+		return it->second.handle;
+	}
+
+	bool erase(float time) {
+		auto it = m_entries.find(time);
+
+		if (it == m_entries.end()) {
+			return false;
+		}
+
+		erase(it);
+		return true;
+	}
+
+	bool erase(Handle handle) {
+		Slot* slot = resolve(handle);
+
+		if (!slot) {
+			return false;
+		}
+
+		erase(slot->it);
+		return true;
+	}
+
+	void clear() {
+		m_entries.clear();
+		m_slots.clear();
+		m_free_slots.clear();
+		m_cursor = m_entries.end();
+	}
+
+	T* find(float time) {
+		auto it = m_entries.find(time);
+		return it != m_entries.end() ? &it->second.value : nullptr;
+	}
+
+	const T* find(float time) const {
+		auto it = m_entries.find(time);
+		return it != m_entries.end() ? &it->second.value : nullptr;
+	}
+
+	bool contains(float time) const {
+		return m_entries.find(time) != m_entries.end();
+	}
+
+	Handle find_handle(float time) const {
+		auto it = m_entries.find(time);
+		return it != m_entries.end() ? it->second.handle : Handle{};
+	}
+
+	// Resolves a handle, returning nullptr once its keyframe has been erased
+	T* get(Handle handle) {
+		Slot* slot = resolve(handle);
+		return slot ? &slot->it->second.value : nullptr;
+	}
+
+	float get_time(Handle handle) const {
+		const Slot* slot = resolve(handle);
+		return slot ? slot->it->first : -1.0f;
+	}
+
+	// The keyframe in effect at the given time (last keyframe at or before it)
+	T* active_at(float time) {
+		auto it = seek(time);
+		return it != m_entries.end() ? &it->second.value : nullptr;
+	}
+
+	// The first keyframe strictly after the given time
+	T* next_after(float time) {
+		auto it = seek(time);
+		it = it == m_entries.end() ? m_entries.begin() : std::next(it);
+		return it != m_entries.end() ? &it->second.value : nullptr;
+	}
+
+	// The last keyframe strictly before the given time
+	T* previous_before(float time) {
+		auto it = seek(time);
+
+		if (it != m_entries.end() && it->first == time) {
+			it = it == m_entries.begin() ? m_entries.end() : std::prev(it);
+		}
+
+		return it != m_entries.end() ? &it->second.value : nullptr;
+	}
+
+	// Iterator to the keyframe in effect at the given time, or end()
+	iterator active_iterator_at(float time) {
+		return iterator(seek(time));
+	}
+
+	T& front() { return m_entries.begin()->second.value; }
+	T& back() { return std::prev(m_entries.end())->second.value; }
+	const T& front() const { return m_entries.begin()->second.value; }
+	const T& back() const { return std::prev(m_entries.end())->second.value; }
+
+	bool empty() const { return m_entries.empty(); }
+	size_t size() const { return m_entries.size(); }
+
+	iterator begin() { return iterator(m_entries.begin()); }
+	iterator end() { return iterator(m_entries.end()); }
+	const_iterator begin() const { return const_iterator(m_entries.begin()); }
+	const_iterator end() const { return const_iterator(m_entries.end()); }
+	reverse_iterator rbegin() { return reverse_iterator(end()); }
+	reverse_iterator rend() { return reverse_iterator(begin()); }
+	const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+	const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+private:
+	// Moves the cursor to the last entry at or before time; end() if time precedes every keyframe
+	MapIterator seek(float time) {
+		if (m_entries.empty()) {
+			return m_entries.end();
+		}
+
+		if (m_cursor == m_entries.end()) {
+			m_cursor = m_entries.begin();
+		}
+
+		int steps = 0;
+
+		// Walking forward while the next keyframe has already started
+		while (m_cursor->first <= time && steps < kMaxCursorSteps) {
+			auto next = std::next(m_cursor);
+
+			if (next == m_entries.end() || next->first > time) {
+				return m_cursor;
+			}
+
+			m_cursor = next;
+			++steps;
+		}
+
+		// Walking backward while the cursor is still ahead of time
+		while (m_cursor->first > time && steps < kMaxCursorSteps) {
+			if (m_cursor == m_entries.begin()) {
+				return m_entries.end();
+			}
+
+			--m_cursor;
+			++steps;
+
+			if (m_cursor->first <= time) {
+				return m_cursor;
+			}
+		}
+
+		// Large jumps (seeking the timeline) fall back to a binary search
+		auto it = m_entries.upper_bound(time);
+
+		if (it == m_entries.begin()) {
+			m_cursor = it;
+			return m_entries.end();
+		}
+
+		m_cursor = std::prev(it);
+		return m_cursor;
+	}
+
+	void erase(MapIterator it) {
+		Slot& slot = m_slots[it->second.handle.index];
+		slot.alive = false;
+		++slot.generation;
+		m_free_slots.push_back(it->second.handle.index);
+
+		if (m_cursor == it) {
+			m_cursor = m_entries.end();
+		}
+
+		m_entries.erase(it);
+	}
+
+	Handle allocate_slot(MapIterator it) {
+		uint32_t index;
+
+		if (!m_free_slots.empty()) {
+			index = m_free_slots.back();
+			m_free_slots.pop_back();
+		} else {
+			index = static_cast<uint32_t>(m_slots.size());
+			m_slots.emplace_back();
+		}
+
+		Slot& slot = m_slots[index];
+		slot.it = it;
+		slot.alive = true;
+
+		return Handle{index, slot.generation};
+	}
+
+	Slot* resolve(Handle handle) {
+		if (handle.index >= m_slots.size()) {
+			return nullptr;
+		}
+
+		Slot& slot = m_slots[handle.index];
+		return slot.alive && slot.generation == handle.generation ? &slot : nullptr;
+	}
+
+	const Slot* resolve(Handle handle) const {
+		return const_cast<KeyframeTrack*>(this)->resolve(handle);
+	}
+
+	Map m_entries;
+	MapIterator m_cursor;
+	std::vector<Slot> m_slots;
+	std::vector<uint32_t> m_free_slots;
+};
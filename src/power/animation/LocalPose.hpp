@@ -0,0 +1,58 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <vector>
+#include <cstddef>
+
+/**
+ * Local-space pose stored as separate translation, rotation and scale arrays,
+ * indexed by skeleton bone index. Buffers are sized once per skeleton and
+ * reused, so sampling and blending into them never touches the heap.
+ */
+struct LocalPose {
+	std::vector<glm::vec3> translations;
+	std::vector<glm::quat> rotations;
+	std::vector<glm::vec3> scales;
+
+	// Resizes the buffers; only allocates when the bone count grows
+	void resize(size_t numBones) {
+		translations.resize(numBones);
+		rotations.resize(numBones);
+		scales.resize(numBones);
+	}
+
+	size_t size() const {
+		return translations.size();
+	}
+
+	void set_identity(size_t boneIndex) {
+		translations[boneIndex] = glm::vec3(0.0f);
+		rotations[boneIndex] = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+		scales[boneIndex] = glm::vec3(1.0f);
+	}
+
+	void set_identity() {
+		for (size_t i = 0; i < size(); ++i) {
+			set_identity(i);
+		}
+	}
+
+	// Composes T * R * S for a single bone, matching Animation::evaluate
+	glm::mat4 to_matrix(size_t boneIndex) const {
+		glm::mat4 translation_matrix = glm::translate(glm::mat4(1.0f), translations[boneIndex]);
+		glm::mat4 rotation_matrix = glm::mat4_cast(rotations[boneIndex]);
+		glm::mat4 scale_matrix = glm::scale(glm::mat4(1.0f), scales[boneIndex]);
+		return translation_matrix * rotation_matrix * scale_matrix;
+	}
+
+	// Writes the model pose matrices into a caller-owned buffer of the same size
+	void to_matrices(std::vector<glm::mat4>& out) const {
+		out.resize(size());
+		for (size_t i = 0; i < size(); ++i) {
+			out[i] = to_matrix(i);
+		}
+	}
+};
@@ -0,0 +1,220 @@
+#pragma once
+
+#include "Animation.hpp"
+#include "LocalPose.hpp"
+#include "PoseSampler.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+/**
+ * Blends any number of weighted animation layers into a local pose.
+ *
+ * Override layers are combined as a normalized weighted average per bone, so a
+ * two-layer crossfade with weights (1 - t, t) matches Animation::blendKeyframes.
+ * Additive layers are applied afterwards as a delta against their reference time.
+ *
+ * All buffers are sized by resize() and reused; evaluate() never allocates as
+ * long as the bone count does not grow.
+ */
+class PoseBlender {
+public:
+	static constexpr size_t kMaxLayers = 16;
+
+	enum class BlendMode {
+		Override,
+		Additive
+	};
+
+	struct Layer {
+		const Animation* animation = nullptr;
+		float time = 0.0f;
+		float weight = 0.0f;
+		BlendMode mode = BlendMode::Override;
+		// Optional per-bone weights indexed by bone, must outlive evaluate()
+		const std::vector<float>* mask = nullptr;
+		// Time of the additive reference pose the layer is measured against
+		float reference_time = 0.0f;
+	};
+
+	PoseBlender() = default;
+
+	explicit PoseBlender(size_t numBones) {
+		resize(numBones);
+	}
+
+	void resize(size_t numBones) {
+		m_result.resize(numBones);
+		m_sample.resize(numBones);
+		m_reference.resize(numBones);
+		m_accumulated_weights.resize(numBones);
+		m_layer_weights.resize(numBones);
+	}
+
+	size_t num_bones() const {
+		return m_result.size();
+	}
+
+	void clear_layers() {
+		m_layer_count = 0;
+	}
+
+	bool add_layer(const Layer& layer) {
+		if (m_layer_count >= kMaxLayers) {
+			assert(false && "PoseBlender layer limit exceeded");
+			return false;
+		}
+
+		m_layers[m_layer_count++] = layer;
+		return true;
+	}
+
+	bool add_layer(const Animation& animation, float time, float weight, BlendMode mode = BlendMode::Override, const std::vector<float>* mask = nullptr) {
+		Layer layer;
+		layer.animation = &animation;
+		layer.time = time;
+		layer.weight = weight;
+		layer.mode = mode;
+		layer.mask = mask;
+		return add_layer(layer);
+	}
+
+	size_t layer_count() const {
+		return m_layer_count;
+	}
+
+	// Blends all layers into the local pose; bones no layer touches stay at identity
+	const LocalPose& evaluate() {
+		const size_t numBones = num_bones();
+
+		m_result.set_identity();
+		std::fill(m_accumulated_weights.begin(), m_accumulated_weights.end(), 0.0f);
+
+		for (size_t i = 0; i < m_layer_count; ++i) {
+			const Layer& layer = m_layers[i];
+
+			if (layer.mode == BlendMode::Override) {
+				blend_override(layer, numBones);
+			}
+		}
+
+		for (size_t i = 0; i < m_layer_count; ++i) {
+			const Layer& layer = m_layers[i];
+
+			if (layer.mode == BlendMode::Additive) {
+				blend_additive(layer, numBones);
+			}
+		}
+
+		return m_result;
+	}
+
+	// Evaluates and composes the result into model pose matrices
+	void evaluate(std::vector<glm::mat4>& modelPose) {
+		evaluate().to_matrices(modelPose);
+	}
+
+	const LocalPose& get_result() const {
+		return m_result;
+	}
+
+private:
+	// Computes the effective per-bone weight of a layer, returns false if it affects no bone
+	bool compute_layer_weights(const Layer& layer, size_t numBones) {
+		if (!layer.animation || layer.weight <= 0.0f) {
+			return false;
+		}
+
+		bool any = false;
+
+		for (size_t bone = 0; bone < numBones; ++bone) {
+			float weight = layer.weight;
+
+			if (layer.mask) {
+				weight *= bone < layer.mask->size() ? (*layer.mask)[bone] : 0.0f;
+			}
+
+			m_layer_weights[bone] = weight;
+			any = any || weight > 0.0f;
+		}
+
+		return any;
+	}
+
+	void blend_override(const Layer& layer, size_t numBones) {
+		if (!compute_layer_weights(layer, numBones)) {
+			return;
+		}
+
+		m_sample.set_identity();
+		PoseSampler::sample(*layer.animation, layer.time, m_sample, m_layer_weights.data());
+
+		for (size_t bone = 0; bone < numBones; ++bone) {
+			float weight = m_layer_weights[bone];
+
+			if (weight <= 0.0f) {
+				continue;
+			}
+
+			float accumulated = m_accumulated_weights[bone];
+
+			if (accumulated <= 0.0f) {
+				m_result.translations[bone] = m_sample.translations[bone];
+				m_result.rotations[bone] = m_sample.rotations[bone];
+				m_result.scales[bone] = m_sample.scales[bone];
+			} else {
+				// Incremental weighted average: blend towards the new layer by its share of the total weight
+				float alpha = weight / (accumulated + weight);
+
+				m_result.translations[bone] = glm::mix(m_result.translations[bone], m_sample.translations[bone], alpha);
+				m_result.scales[bone] = glm::mix(m_result.scales[bone], m_sample.scales[bone], alpha);
+				m_result.rotations[bone] = glm::normalize(glm::slerp(m_result.rotations[bone], m_sample.rotations[bone], alpha));
+			}
+
+			m_accumulated_weights[bone] = accumulated + weight;
+		}
+	}
+
+	void blend_additive(const Layer& layer, size_t numBones) {
+		if (!compute_layer_weights(layer, numBones)) {
+			return;
+		}
+
+		m_sample.set_identity();
+		m_reference.set_identity();
+		PoseSampler::sample(*layer.animation, layer.time, m_sample, m_layer_weights.data());
+		PoseSampler::sample(*layer.animation, layer.reference_time, m_reference, m_layer_weights.data());
+
+		const glm::quat identity(1.0f, 0.0f, 0.0f, 0.0f);
+
+		for (size_t bone = 0; bone < numBones; ++bone) {
+			float weight = glm::min(m_layer_weights[bone], 1.0f);
+
+			if (weight <= 0.0f) {
+				continue;
+			}
+
+			glm::vec3 deltaTranslation = m_sample.translations[bone] - m_reference.translations[bone];
+			glm::quat deltaRotation = m_sample.rotations[bone] * glm::inverse(m_reference.rotations[bone]);
+			glm::vec3 deltaScale = m_sample.scales[bone] / glm::max(m_reference.scales[bone], glm::vec3(1e-6f));
+
+			m_result.translations[bone] += deltaTranslation * weight;
+			m_result.rotations[bone] = glm::normalize(glm::slerp(identity, deltaRotation, weight) * m_result.rotations[bone]);
+			m_result.scales[bone] *= glm::mix(glm::vec3(1.0f), deltaScale, weight);
+		}
+	}
+
+	std::array<Layer, kMaxLayers> m_layers;
+	size_t m_layer_count = 0;
+
+	LocalPose m_result;
+	LocalPose m_sample;
+	LocalPose m_reference;
+	std::vector<float> m_accumulated_weights;
+	std::vector<float> m_layer_weights;
+};
@@ -0,0 +1,296 @@
+#pragma once
+
+#include "Animation.hpp"
+#include "LocalPose.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#if defined(POWER_POSE_FORCE_SCALAR)
+// Scalar lanes even where a vector ISA is available, so tests can check the fallback on any host
+#elif defined(__AVX__)
+#include <immintrin.h>
+#define POWER_POSE_SIMD_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define POWER_POSE_SIMD_SSE
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define POWER_POSE_SIMD_NEON
+#endif
+
+namespace PoseSimd {
+
+#if defined(POWER_POSE_SIMD_AVX)
+
+constexpr size_t kLaneCount = 8;
+constexpr const char* kBackendName = "avx";
+
+using Register = __m256;
+
+inline Register load(const float* p) { return _mm256_load_ps(p); }
+inline void store(float* p, Register v) { _mm256_store_ps(p, v); }
+inline Register set1(float v) { return _mm256_set1_ps(v); }
+inline Register add(Register a, Register b) { return _mm256_add_ps(a, b); }
+inline Register sub(Register a, Register b) { return _mm256_sub_ps(a, b); }
+inline Register mul(Register a, Register b) { return _mm256_mul_ps(a, b); }
+inline Register div(Register a, Register b) { return _mm256_div_ps(a, b); }
+inline Register sqrt(Register a) { return _mm256_sqrt_ps(a); }
+
+#elif defined(POWER_POSE_SIMD_SSE)
+
+constexpr size_t kLaneCount = 4;
+constexpr const char* kBackendName = "sse2";
+
+using Register = __m128;
+
+inline Register load(const float* p) { return _mm_load_ps(p); }
+inline void store(float* p, Register v) { _mm_store_ps(p, v); }
+inline Register set1(float v) { return _mm_set1_ps(v); }
+inline Register add(Register a, Register b) { return _mm_add_ps(a, b); }
+inline Register sub(Register a, Register b) { return _mm_sub_ps(a, b); }
+inline Register mul(Register a, Register b) { return _mm_mul_ps(a, b); }
+inline Register div(Register a, Register b) { return _mm_div_ps(a, b); }
+inline Register sqrt(Register a) { return _mm_sqrt_ps(a); }
+
+#elif defined(POWER_POSE_SIMD_NEON)
+
+constexpr size_t kLaneCount = 4;
+constexpr const char* kBackendName = "neon";
+
+using Register = float32x4_t;
+
+inline Register load(const float* p) { return vld1q_f32(p); }
+inline void store(float* p, Register v) { vst1q_f32(p, v); }
+inline Register set1(float v) { return vdupq_n_f32(v); }
+inline Register add(Register a, Register b) { return vaddq_f32(a, b); }
+inline Register sub(Register a, Register b) { return vsubq_f32(a, b); }
+inline Register mul(Register a, Register b) { return vmulq_f32(a, b); }
+inline Register div(Register a, Register b) { return vdivq_f32(a, b); }
+inline Register sqrt(Register a) { return vsqrtq_f32(a); }
+
+#else
+
+// Scalar fallback with the same lane interface, used when no vector ISA is available
+constexpr size_t kLaneCount = 4;
+constexpr const char* kBackendName = "scalar";
+
+struct Register {
+	float v[kLaneCount];
+};
+
+template<typename Op>
+inline Register apply(Register a, Register b, Op op) {
+	Register r{};
+	for (size_t i = 0; i < kLaneCount; ++i) {
+		r.v[i] = op(a.v[i], b.v[i]);
+	}
+	return r;
+}
+
+inline Register load(const float* p) { Register r{}; std::copy(p, p + kLaneCount, r.v); return r; }
+inline void store(float* p, Register v) { std::copy(v.v, v.v + kLaneCount, p); }
+inline Register set1(float v) { Register r{}; std::fill(r.v, r.v + kLaneCount, v); return r; }
+inline Register add(Register a, Register b) { return apply(a, b, [](float x, float y) { return x + y; }); }
+inline Register sub(Register a, Register b) { return apply(a, b, [](float x, float y) { return x - y; }); }
+inline Register mul(Register a, Register b) { return apply(a, b, [](float x, float y) { return x * y; }); }
+inline Register div(Register a, Register b) { return apply(a, b, [](float x, float y) { return x / y; }); }
+inline Register sqrt(Register a) { Register r{}; for (size_t i = 0; i < kLaneCount; ++i) r.v[i] = std::sqrt(a.v[i]); return r; }
+
+#endif
+
+// Same operation order as glm::mix so lerped lanes match the scalar path bit for bit
+inline Register lerp(Register a, Register b, Register t, Register oneMinusT) {
+	return add(mul(a, oneMinusT), mul(b, t));
+}
+
+} // namespace PoseSimd
+
+/**
+ * Vectorized local pose sampler.
+ *
+ * Keyframe pairs for kLaneCount bones are gathered into structure-of-arrays
+ * lanes and interpolated together. Translation and scale use the same lerp as
+ * glm::mix. Rotations use a normalized lerp when the two keys are close enough
+ * that it is indistinguishable from slerp, and fall back to glm::slerp per lane
+ * otherwise. Animation::sample_local_pose remains the scalar reference path.
+ */
+class PoseSampler {
+public:
+	// Above this |dot| the nlerp/slerp angular difference is below ~1e-6 radians
+	static constexpr float kNlerpDotThreshold = 0.9995f;
+
+	static constexpr size_t lane_count() {
+		return PoseSimd::kLaneCount;
+	}
+
+	static const char* backend_name() {
+		return PoseSimd::kBackendName;
+	}
+
+	/**
+	 * Samples the animation into the pose, skipping bones with a zero mask weight.
+	 * Matches Animation::sample_local_pose within kNlerpDotThreshold tolerance on rotations.
+	 */
+	static void sample(const Animation& animation, float time, LocalPose& pose, const float* bone_mask = nullptr) {
+		Batch batch;
+		const size_t numBones = pose.size();
+
+		for (const auto& bone_anim : animation.get_bone_animations()) {
+			const auto& keyframes = bone_anim.keyframes;
+			const int boneIndex = bone_anim.bone_index;
+
+			if (keyframes.empty() || boneIndex < 0 || static_cast<size_t>(boneIndex) >= numBones) {
+				continue;
+			}
+
+			if (bone_mask && bone_mask[boneIndex] <= 0.0f) {
+				continue;
+			}
+
+			// Bones clamped to either end of their track are plain copies, no interpolation needed
+			if (time <= keyframes.front().time) {
+				copy_keyframe(keyframes.front(), boneIndex, pose);
+				continue;
+			}
+
+			if (time >= keyframes.back().time) {
+				copy_keyframe(keyframes.back(), boneIndex, pose);
+				continue;
+			}
+
+			auto it1 = std::lower_bound(keyframes.begin(), keyframes.end(), time, [](const Animation::KeyFrame& kf, float t) {
+				return kf.time < t;
+			});
+
+			auto it0 = std::prev(it1);
+
+			float t = (time - it0->time) / (it1->time - it0->time);
+
+			batch.push(*it0, *it1, t, boneIndex);
+
+			if (batch.count == PoseSimd::kLaneCount) {
+				batch.flush(pose);
+			}
+		}
+
+		batch.flush(pose);
+	}
+
+private:
+	static void copy_keyframe(const Animation::KeyFrame& keyframe, int boneIndex, LocalPose& pose) {
+		pose.translations[boneIndex] = keyframe.translation;
+		pose.rotations[boneIndex] = keyframe.rotation;
+		pose.scales[boneIndex] = keyframe.scale;
+	}
+
+	struct alignas(32) Lanes {
+		float v[PoseSimd::kLaneCount];
+	};
+
+	struct Batch {
+		Lanes t;
+		Lanes translationA[3], translationB[3];
+		Lanes scaleA[3], scaleB[3];
+		Lanes rotationA[4], rotationB[4];
+		int bones[PoseSimd::kLaneCount];
+		bool slerp[PoseSimd::kLaneCount];
+		glm::quat slerped[PoseSimd::kLaneCount];
+		size_t count = 0;
+
+		void push(const Animation::KeyFrame& a, const Animation::KeyFrame& b, float factor, int boneIndex) {
+			const size_t lane = count++;
+
+			t.v[lane] = factor;
+			bones[lane] = boneIndex;
+
+			for (int c = 0; c < 3; ++c) {
+				translationA[c].v[lane] = a.translation[c];
+				translationB[c].v[lane] = b.translation[c];
+				scaleA[c].v[lane] = a.scale[c];
+				scaleB[c].v[lane] = b.scale[c];
+			}
+
+			// Resolving the shortest arc up front, as glm::slerp does
+			float cosTheta = glm::dot(a.rotation, b.rotation);
+			glm::quat target = cosTheta < 0.0f ? -b.rotation : b.rotation;
+
+			slerp[lane] = std::abs(cosTheta) < kNlerpDotThreshold;
+
+			if (slerp[lane]) {
+				slerped[lane] = glm::slerp(a.rotation, b.rotation, factor);
+			}
+
+			for (int c = 0; c < 4; ++c) {
+				rotationA[c].v[lane] = a.rotation[c];
+				rotationB[c].v[lane] = target[c];
+			}
+		}
+
+		void flush(LocalPose& pose) {
+			using namespace PoseSimd;
+
+			if (count == 0) {
+				return;
+			}
+
+			// Padding unused lanes with benign values keeps the normalization finite
+			for (size_t lane = count; lane < kLaneCount; ++lane) {
+				t.v[lane] = 0.0f;
+				for (int c = 0; c < 3; ++c) {
+					translationA[c].v[lane] = translationB[c].v[lane] = 0.0f;
+					scaleA[c].v[lane] = scaleB[c].v[lane] = 1.0f;
+				}
+				for (int c = 0; c < 4; ++c) {
+					rotationA[c].v[lane] = rotationB[c].v[lane] = c == 3 ? 1.0f : 0.0f;
+				}
+			}
+
+			Register factor = load(t.v);
+			Register oneMinusFactor = sub(set1(1.0f), factor);
+
+			Lanes translation[3], scale[3], rotation[4];
+
+			for (int c = 0; c < 3; ++c) {
+				store(translation[c].v, lerp(load(translationA[c].v), load(translationB[c].v), factor, oneMinusFactor));
+				store(scale[c].v, lerp(load(scaleA[c].v), load(scaleB[c].v), factor, oneMinusFactor));
+			}
+
+			Register q[4];
+			Register lengthSquared = set1(0.0f);
+
+			for (int c = 0; c < 4; ++c) {
+				q[c] = lerp(load(rotationA[c].v), load(rotationB[c].v), factor, oneMinusFactor);
+				lengthSquared = add(lengthSquared, mul(q[c], q[c]));
+			}
+
+			Register length = PoseSimd::sqrt(lengthSquared);
+
+			for (int c = 0; c < 4; ++c) {
+				store(rotation[c].v, div(q[c], length));
+			}
+
+			for (size_t lane = 0; lane < count; ++lane) {
+				const int bone = bones[lane];
+
+				pose.translations[bone] = glm::vec3(translation[0].v[lane], translation[1].v[lane], translation[2].v[lane]);
+				pose.scales[bone] = glm::vec3(scale[0].v[lane], scale[1].v[lane], scale[2].v[lane]);
+
+				if (slerp[lane]) {
+					pose.rotations[bone] = slerped[lane];
+				} else {
+					glm::quat& out = pose.rotations[bone];
+					for (int c = 0; c < 4; ++c) {
+						out[c] = rotation[c].v[lane];
+					}
+				}
+			}
+
+			count = 0;
+		}
+	};
+};
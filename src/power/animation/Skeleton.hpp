@@ -5,6 +5,8 @@
 
 #include <components/TransformComponent.hpp>
 
+#include "profiling/MemoryTracker.hpp"
+
 
 #include <string>
 #include <vector>
@@ -123,6 +125,8 @@ public:
 			// Add the new bone's index to its parent's list of children.
 			parent_bone->children.push_back(new_bone_index);
 		}
+		
+		update_memory_usage();
 	}
 
 	
@@ -158,6 +162,8 @@ public:
 					  }),
 					  m_bones.end()
 					  );
+		
+		update_memory_usage();
 	}
 	
 	// Find bone by name
@@ -192,6 +198,15 @@ public:
 	
 private:
 	std::vector<std::unique_ptr<Bone>> m_bones;
+	TrackedMemory m_memory{MemoryTracker::Tag::Skeleton};
+	
+	void update_memory_usage() {
+		uint64_t bytes = tracked_capacity(m_bones);
+		for (const auto& bone : m_bones) {
+			bytes += sizeof(Bone) + bone->name.capacity() + tracked_capacity(bone->children);
+		}
+		m_memory.set(bytes);
+	}
 	
 	void compute_global_and_transform(Bone& bone, const glm::mat4& parentGlobal, const std::vector<glm::mat4>& withAnimation) {
 		
@@ -0,0 +1,137 @@
+#include "bench/AllocationCounter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<uint64_t> gAllocations{0};
+std::atomic<uint64_t> gDeallocations{0};
+std::atomic<uint64_t> gBytes{0};
+
+void* counted_allocate(size_t size, size_t alignment) {
+	AllocationCounter::record_allocation(size);
+
+	if (size == 0) {
+		size = 1;
+	}
+
+	void* pointer = nullptr;
+
+	if (alignment > alignof(std::max_align_t)) {
+#if defined(_WIN32)
+		pointer = _aligned_malloc(size, alignment);
+#else
+		if (posix_memalign(&pointer, alignment, size) != 0) {
+			pointer = nullptr;
+		}
+#endif
+	} else {
+		pointer = std::malloc(size);
+	}
+
+	return pointer;
+}
+
+void counted_free(void* pointer, size_t alignment) {
+	if (!pointer) {
+		return;
+	}
+
+	AllocationCounter::record_deallocation();
+
+#if defined(_WIN32)
+	if (alignment > alignof(std::max_align_t)) {
+		_aligned_free(pointer);
+		return;
+	}
+#else
+	(void)alignment;
+#endif
+
+	std::free(pointer);
+}
+} // unnamed namespace
+
+namespace AllocationCounter {
+
+Snapshot snapshot() {
+	Snapshot result;
+	result.allocations = gAllocations.load(std::memory_order_relaxed);
+	result.deallocations = gDeallocations.load(std::memory_order_relaxed);
+	result.bytes = gBytes.load(std::memory_order_relaxed);
+	return result;
+}
+
+void record_allocation(size_t size) {
+	gAllocations.fetch_add(1, std::memory_order_relaxed);
+	gBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void record_deallocation() {
+	gDeallocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace AllocationCounter
+
+void* operator new(size_t size) {
+	if (void* pointer = counted_allocate(size, alignof(std::max_align_t))) {
+		return pointer;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+	return counted_allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+	return counted_allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+	if (void* pointer = counted_allocate(size, static_cast<size_t>(alignment))) {
+		return pointer;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+	return operator new(size, alignment);
+}
+
+void operator delete(void* pointer) noexcept {
+	counted_free(pointer, alignof(std::max_align_t));
+}
+
+void operator delete[](void* pointer) noexcept {
+	counted_free(pointer, alignof(std::max_align_t));
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+	counted_free(pointer, alignof(std::max_align_t));
+}
+
+void operator delete[](void* pointer, size_t) noexcept {
+	counted_free(pointer, alignof(std::max_align_t));
+}
+
+void operator delete(void* pointer, std::align_val_t alignment) noexcept {
+	counted_free(pointer, static_cast<size_t>(alignment));
+}
+
+void operator delete[](void* pointer, std::align_val_t alignment) noexcept {
+	counted_free(pointer, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* pointer, size_t, std::align_val_t alignment) noexcept {
+	counted_free(pointer, static_cast<size_t>(alignment));
+}
+
+void operator delete[](void* pointer, size_t, std::align_val_t alignment) noexcept {
+	counted_free(pointer, static_cast<size_t>(alignment));
+}
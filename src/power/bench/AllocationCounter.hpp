@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Process-wide heap allocation counters for the benchmark harness.
+ *
+ * The bench executable replaces the global operator new/delete and records every
+ * allocation here, so scenarios can report how many allocations an iteration made
+ * without instrumenting engine code.
+ */
+namespace AllocationCounter {
+
+struct Snapshot {
+	uint64_t allocations = 0;
+	uint64_t deallocations = 0;
+	uint64_t bytes = 0;
+};
+
+Snapshot snapshot();
+
+void record_allocation(size_t size);
+void record_deallocation();
+
+} // namespace AllocationCounter
@@ -0,0 +1,247 @@
+#include "bench/BenchContext.hpp"
+
+#include "Canvas.hpp"
+#include "CameraManager.hpp"
+#include "ShaderManager.hpp"
+#include "actors/ActorManager.hpp"
+#include "graphics/drawing/Batch.hpp"
+#include "graphics/drawing/BatchUnit.hpp"
+#include "graphics/drawing/MeshActorBuilder.hpp"
+#include "graphics/drawing/MeshBatch.hpp"
+#include "graphics/drawing/SkinnedMeshBatch.hpp"
+#include "graphics/shading/ShaderWrapper.hpp"
+#include "serialization/SceneSerializer.hpp"
+#include "serialization/SerializationModule.hpp"
+
+#include <nanogui/nanogui.h>
+#include <nanogui/renderpass.h>
+
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+#include <nanogui/opengl.h>
+#endif
+
+#include <GLFW/glfw3.h>
+
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+constexpr int kCanvasWidth = 1280;
+constexpr int kCanvasHeight = 720;
+
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+struct HeadlessContextApi {
+	int api;
+	const char* name;
+};
+
+// Tried in order before a hidden window; neither needs a display server
+constexpr HeadlessContextApi kHeadlessContextApis[] = {
+	{GLFW_EGL_CONTEXT_API, "surfaceless EGL"},
+	{GLFW_OSMESA_CONTEXT_API, "OSMesa"}
+};
+#endif
+} // unnamed namespace
+
+BenchContext::BenchContext(const BenchmarkOptions& options)
+: mOptions(options)
+, mTimeProvider(60 * 30) {
+}
+
+BenchContext::~BenchContext() {
+	if (mActorManager) {
+		// Meshes unregister from the batches on destruction, so actors go first
+		clear_scene();
+	}
+
+	mSerializationModule.reset();
+	mMeshActorBuilder.reset();
+	mSkinnedShader.reset();
+	mMeshShader.reset();
+	mBatchUnit.reset();
+	mSkinnedMeshBatch.reset();
+	mMeshBatch.reset();
+	mShaderManager.reset();
+	mCanvas.reset();
+	mActorManager.reset();
+	mCameraManager.reset();
+	mRegistry.reset();
+	mScreen.reset();
+
+	if (mNanoguiInitialized) {
+		nanogui::shutdown();
+	}
+}
+
+std::string BenchContext::sandbox_path(const std::string& relative) const {
+	return (std::filesystem::path(mOptions.sandbox) / relative).string();
+}
+
+bool BenchContext::require_engine(std::string& reason) {
+	if (!mEngineAvailable.has_value()) {
+		mEngineAvailable = create_engine(mEngineFailure);
+	}
+
+	if (!*mEngineAvailable) {
+		reason = mEngineFailure;
+	}
+
+	return *mEngineAvailable;
+}
+
+bool BenchContext::create_engine(std::string& reason) {
+	if (!create_screen(reason)) {
+		return false;
+	}
+
+	Batch::init_dummy_texture();
+
+	mRegistry = std::make_unique<entt::registry>();
+	mCameraManager = std::make_unique<CameraManager>();
+	mActorManager = std::make_unique<ActorManager>(*mRegistry, *mCameraManager);
+
+	mCanvas = std::make_unique<Canvas>(*mScreen, *mScreen, nanogui::Color{70, 130, 180, 255});
+	mCanvas->set_fixed_size(nanogui::Vector2i(kCanvasWidth, kCanvasHeight));
+	mCanvas->set_size(nanogui::Vector2i(kCanvasWidth, kCanvasHeight));
+
+	mShaderManager = std::make_unique<ShaderManager>(*mCanvas);
+	mShaderManager->load_default_shaders();
+
+	mMeshBatch = std::make_unique<MeshBatch>(mCanvas->render_pass());
+	mSkinnedMeshBatch = std::make_unique<SkinnedMeshBatch>(mCanvas->render_pass());
+	mMeshBatch->set_light_clusters(&mActorManager->light_clusters());
+	mSkinnedMeshBatch->set_light_clusters(&mActorManager->light_clusters());
+	mMeshBatch->set_render_list(&mActorManager->render_list());
+	mSkinnedMeshBatch->set_render_list(&mActorManager->render_list());
+	mBatchUnit = std::make_unique<BatchUnit>(*mMeshBatch, *mSkinnedMeshBatch);
+
+	mMeshShader = std::make_unique<ShaderWrapper>(mShaderManager->get_shader("mesh"));
+	mSkinnedShader = std::make_unique<ShaderWrapper>(mShaderManager->get_shader("skinned_mesh"));
+
+	mMeshActorBuilder = std::make_unique<MeshActorBuilder>(*mBatchUnit);
+
+	mSerializationModule = std::make_unique<SerializationModule>(*mActorManager, *mMeshActorBuilder, mTimeProvider, *mMeshShader, *mSkinnedShader);
+
+	return true;
+}
+
+bool BenchContext::create_screen(std::string& reason) {
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+	for (const auto& contextApi : kHeadlessContextApis) {
+		if (create_headless_screen(contextApi.api)) {
+			std::cerr << "Bench context: " << contextApi.name << std::endl;
+			return true;
+		}
+	}
+
+	// Back to the platform's display server for the hidden window
+	glfwInitHint(GLFW_PLATFORM, GLFW_ANY_PLATFORM);
+#endif
+
+	try {
+		nanogui::init();
+		mNanoguiInitialized = true;
+	} catch (const std::exception& e) {
+		reason = std::string("graphics unavailable: ") + e.what();
+		return false;
+	}
+
+	// The screen sizes its window after the primary monitor; run under a virtual display on CI
+	if (!glfwGetPrimaryMonitor()) {
+		reason = "graphics unavailable: no display";
+		return false;
+	}
+
+	// Never shown; the canvas renders into its own framebuffer
+	glfwDefaultWindowHints();
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+	try {
+		mScreen = std::make_unique<nanogui::Screen>("Power Engine Bench");
+	} catch (const std::exception& e) {
+		reason = std::string("graphics unavailable: ") + e.what();
+		return false;
+	}
+
+	std::cerr << "Bench context: hidden window" << std::endl;
+
+	return true;
+}
+
+bool BenchContext::create_headless_screen(int contextApi) {
+	// The null platform has a virtual monitor for the screen to size itself after, and no windows to show
+	glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+
+	try {
+		nanogui::init();
+		mNanoguiInitialized = true;
+	} catch (const std::exception&) {
+		return false;
+	}
+
+	glfwDefaultWindowHints();
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	glfwWindowHint(GLFW_CONTEXT_CREATION_API, contextApi);
+
+	try {
+		mScreen = std::make_unique<nanogui::Screen>("Power Engine Bench");
+		return true;
+	} catch (const std::exception&) {
+	}
+
+	nanogui::shutdown();
+	mNanoguiInitialized = false;
+
+	return false;
+}
+
+ActorManager& BenchContext::actor_manager() {
+	return *mActorManager;
+}
+
+MeshActorBuilder& BenchContext::mesh_actor_builder() {
+	return *mMeshActorBuilder;
+}
+
+SerializationModule& BenchContext::serialization_module() {
+	return *mSerializationModule;
+}
+
+AnimationTimeProvider& BenchContext::time_provider() {
+	return mTimeProvider;
+}
+
+ShaderWrapper& BenchContext::mesh_shader() {
+	return *mMeshShader;
+}
+
+ShaderWrapper& BenchContext::skinned_shader() {
+	return *mSkinnedShader;
+}
+
+void BenchContext::render_frame() {
+	auto& renderPass = mCanvas->render_pass();
+
+	renderPass.resize(nanogui::Vector2i(nanogui::Vector2f(mCanvas->size()) * mScreen->pixel_ratio()));
+	renderPass.begin();
+	renderPass.clear_color(0, mCanvas->background_color());
+	renderPass.clear_color(1, nanogui::Color(0.0f, 0.0f, 0.0f, 0.0f));
+	renderPass.clear_depth(1.0f);
+	renderPass.set_depth_test(nanogui::RenderPass::DepthTest::Less, true);
+
+	mActorManager->draw();
+	mActorManager->visit(*mMeshBatch);
+	mActorManager->visit(*mSkinnedMeshBatch);
+
+	renderPass.end();
+
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+	// Otherwise the timings would only cover command submission
+	glFinish();
+#endif
+}
+
+void BenchContext::clear_scene() {
+	mActorManager->clear_actors();
+}
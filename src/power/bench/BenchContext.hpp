@@ -0,0 +1,100 @@
+#pragma once
+
+#include "bench/Benchmark.hpp"
+
+#include "animation/AnimationTimeProvider.hpp"
+
+#include <entt/entt.hpp>
+
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace nanogui {
+class Screen;
+}
+
+class ActorManager;
+class CameraManager;
+class Canvas;
+class MeshActorBuilder;
+class MeshBatch;
+class SerializationModule;
+class ShaderManager;
+class ShaderWrapper;
+class SkinnedMeshBatch;
+
+struct BatchUnit;
+
+/**
+ * @brief Shared state handed to every benchmark scenario.
+ *
+ * CPU-only scenarios use nothing but the options. Scenarios that import models or
+ * render call require_engine(), which brings up the engine the same way Application
+ * does, but against a context that is never presented. OpenGL builds first try a
+ * context without any display, surfaceless EGL or OSMesa on GLFW's null platform,
+ * and only fall back to a hidden window when neither is available.
+ */
+class BenchContext {
+public:
+	explicit BenchContext(const BenchmarkOptions& options);
+	~BenchContext();
+
+	BenchContext(const BenchContext&) = delete;
+	BenchContext& operator=(const BenchContext&) = delete;
+
+	const BenchmarkOptions& options() const {
+		return mOptions;
+	}
+
+	// Resolves a path relative to the sandbox directory
+	std::string sandbox_path(const std::string& relative) const;
+
+	// Creates the headless engine on first use; false with a reason if no context is available
+	bool require_engine(std::string& reason);
+
+	ActorManager& actor_manager();
+	MeshActorBuilder& mesh_actor_builder();
+	SerializationModule& serialization_module();
+	AnimationTimeProvider& time_provider();
+	ShaderWrapper& mesh_shader();
+	ShaderWrapper& skinned_shader();
+
+	// Draws the current scene into the offscreen canvas and waits for the GPU
+	void render_frame();
+
+	// Removes every actor and the batch data they registered
+	void clear_scene();
+
+private:
+	bool create_engine(std::string& reason);
+
+	// Creates the screen and its context, headless where the backend allows it
+	bool create_screen(std::string& reason);
+
+	// Screen on GLFW's null platform with the given context creation API; leaves GLFW terminated on failure
+	bool create_headless_screen(int contextApi);
+
+	BenchmarkOptions mOptions;
+
+	std::optional<bool> mEngineAvailable;
+	std::string mEngineFailure;
+	bool mNanoguiInitialized = false;
+
+	AnimationTimeProvider mTimeProvider;
+
+	// Declared in construction order; destroyed in reverse
+	std::unique_ptr<nanogui::Screen> mScreen;
+	std::unique_ptr<entt::registry> mRegistry;
+	std::unique_ptr<CameraManager> mCameraManager;
+	std::unique_ptr<ActorManager> mActorManager;
+	std::unique_ptr<Canvas> mCanvas;
+	std::unique_ptr<ShaderManager> mShaderManager;
+	std::unique_ptr<MeshBatch> mMeshBatch;
+	std::unique_ptr<SkinnedMeshBatch> mSkinnedMeshBatch;
+	std::unique_ptr<BatchUnit> mBatchUnit;
+	std::unique_ptr<ShaderWrapper> mMeshShader;
+	std::unique_ptr<ShaderWrapper> mSkinnedShader;
+	std::unique_ptr<MeshActorBuilder> mMeshActorBuilder;
+	std::unique_ptr<SerializationModule> mSerializationModule;
+};
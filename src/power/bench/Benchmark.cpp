@@ -0,0 +1,251 @@
+#include "bench/Benchmark.hpp"
+
+#include "bench/AllocationCounter.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+
+namespace {
+std::string escape_json(const std::string& value) {
+	std::ostringstream escaped;
+
+	for (char c : value) {
+		switch (c) {
+			case '"': escaped << "\\\""; break;
+			case '\\': escaped << "\\\\"; break;
+			case '\n': escaped << "\\n"; break;
+			case '\r': escaped << "\\r"; break;
+			case '\t': escaped << "\\t"; break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20) {
+					escaped << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+				} else {
+					escaped << c;
+				}
+		}
+	}
+
+	return escaped.str();
+}
+
+double percentile(const std::vector<double>& sorted, double fraction) {
+	if (sorted.empty()) {
+		return 0.0;
+	}
+
+	double position = fraction * static_cast<double>(sorted.size() - 1);
+	size_t lower = static_cast<size_t>(std::floor(position));
+	size_t upper = std::min(lower + 1, sorted.size() - 1);
+	double weight = position - static_cast<double>(lower);
+
+	return sorted[lower] * (1.0 - weight) + sorted[upper] * weight;
+}
+
+void write_distribution(std::ostream& stream, const Distribution& distribution) {
+	stream << "{\"min\": " << distribution.min
+		   << ", \"max\": " << distribution.max
+		   << ", \"mean\": " << distribution.mean
+		   << ", \"median\": " << distribution.median
+		   << ", \"p90\": " << distribution.p90
+		   << ", \"p99\": " << distribution.p99
+		   << ", \"stddev\": " << distribution.stddev << "}";
+}
+
+const char* platform_name() {
+#if defined(__APPLE__)
+	return "macos";
+#elif defined(_WIN32)
+	return "windows";
+#elif defined(__linux__)
+	return "linux";
+#else
+	return "unknown";
+#endif
+}
+} // unnamed namespace
+
+Distribution Distribution::from(std::vector<double> samples) {
+	Distribution distribution;
+
+	if (samples.empty()) {
+		return distribution;
+	}
+
+	std::sort(samples.begin(), samples.end());
+
+	double count = static_cast<double>(samples.size());
+	double sum = std::accumulate(samples.begin(), samples.end(), 0.0);
+
+	distribution.min = samples.front();
+	distribution.max = samples.back();
+	distribution.mean = sum / count;
+	distribution.median = percentile(samples, 0.5);
+	distribution.p90 = percentile(samples, 0.9);
+	distribution.p99 = percentile(samples, 0.99);
+
+	double variance = 0.0;
+	for (double sample : samples) {
+		variance += (sample - distribution.mean) * (sample - distribution.mean);
+	}
+	distribution.stddev = std::sqrt(variance / count);
+
+	return distribution;
+}
+
+BenchmarkRunner::BenchmarkRunner(const BenchmarkOptions& options)
+: mOptions(options) {
+}
+
+void BenchmarkRunner::add(std::unique_ptr<Scenario> scenario) {
+	mScenarios.push_back(std::move(scenario));
+}
+
+std::vector<ScenarioResult> BenchmarkRunner::run(BenchContext& context) {
+	std::vector<ScenarioResult> results;
+
+	for (auto& scenario : mScenarios) {
+		if (!is_selected(*scenario)) {
+			continue;
+		}
+
+		std::cerr << "Running " << scenario->name() << "..." << std::endl;
+
+		results.push_back(run_scenario(context, *scenario));
+
+		const ScenarioResult& result = results.back();
+
+		if (result.skipped) {
+			std::cerr << "  skipped: " << result.skip_reason << std::endl;
+		} else {
+			std::cerr << "  median " << result.milliseconds.median << " ms, "
+					  << result.allocations.median << " allocations" << std::endl;
+		}
+	}
+
+	return results;
+}
+
+bool BenchmarkRunner::is_selected(const Scenario& scenario) const {
+	if (mOptions.filters.empty()) {
+		return true;
+	}
+
+	return std::find(mOptions.filters.begin(), mOptions.filters.end(), scenario.name()) != mOptions.filters.end();
+}
+
+ScenarioResult BenchmarkRunner::run_scenario(BenchContext& context, Scenario& scenario) {
+	ScenarioResult result;
+	result.name = scenario.name();
+	result.description = scenario.description();
+
+	try {
+		std::string skipReason;
+
+		if (!scenario.prepare(context, skipReason)) {
+			result.skipped = true;
+			result.skip_reason = skipReason;
+			return result;
+		}
+
+		for (int i = 0; i < mOptions.warmup; ++i) {
+			scenario.before_iteration(context);
+			scenario.run(context);
+			scenario.after_iteration(context);
+		}
+
+		std::vector<double> milliseconds;
+		std::vector<double> allocations;
+		std::vector<double> bytes;
+
+		for (int i = 0; i < mOptions.iterations; ++i) {
+			scenario.before_iteration(context);
+
+			auto allocationsBefore = AllocationCounter::snapshot();
+			auto start = std::chrono::steady_clock::now();
+
+			scenario.run(context);
+
+			auto end = std::chrono::steady_clock::now();
+			auto allocationsAfter = AllocationCounter::snapshot();
+
+			scenario.after_iteration(context);
+
+			milliseconds.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+			allocations.push_back(static_cast<double>(allocationsAfter.allocations - allocationsBefore.allocations));
+			bytes.push_back(static_cast<double>(allocationsAfter.bytes - allocationsBefore.bytes));
+		}
+
+		result.counters = scenario.counters();
+
+		scenario.finish(context);
+
+		result.iterations = mOptions.iterations;
+		result.milliseconds = Distribution::from(std::move(milliseconds));
+		result.allocations = Distribution::from(std::move(allocations));
+		result.allocated_bytes = Distribution::from(std::move(bytes));
+	} catch (const std::exception& e) {
+		result.skipped = true;
+		result.skip_reason = std::string("failed: ") + e.what();
+	}
+
+	return result;
+}
+
+void BenchmarkRunner::write_json(std::ostream& stream, const std::vector<ScenarioResult>& results) const {
+	auto timestamp = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+	stream << std::setprecision(6) << std::fixed;
+
+	stream << "{\n";
+	stream << "  \"schema\": 1,\n";
+	stream << "  \"timestamp\": " << timestamp << ",\n";
+	stream << "  \"platform\": \"" << platform_name() << "\",\n";
+	stream << "  \"options\": {\"iterations\": " << mOptions.iterations
+		   << ", \"warmup\": " << mOptions.warmup
+		   << ", \"actors\": " << mOptions.actors
+		   << ", \"sandbox\": \"" << escape_json(mOptions.sandbox) << "\"},\n";
+	stream << "  \"scenarios\": [";
+
+	for (size_t i = 0; i < results.size(); ++i) {
+		const ScenarioResult& result = results[i];
+
+		stream << (i == 0 ? "\n" : ",\n");
+		stream << "    {\n";
+		stream << "      \"name\": \"" << escape_json(result.name) << "\",\n";
+		stream << "      \"description\": \"" << escape_json(result.description) << "\",\n";
+
+		if (result.skipped) {
+			stream << "      \"skipped\": true,\n";
+			stream << "      \"reason\": \"" << escape_json(result.skip_reason) << "\"\n";
+			stream << "    }";
+			continue;
+		}
+
+		stream << "      \"skipped\": false,\n";
+		stream << "      \"iterations\": " << result.iterations << ",\n";
+		stream << "      \"milliseconds\": ";
+		write_distribution(stream, result.milliseconds);
+		stream << ",\n      \"allocations\": ";
+		write_distribution(stream, result.allocations);
+		stream << ",\n      \"allocated_bytes\": ";
+		write_distribution(stream, result.allocated_bytes);
+		stream << ",\n      \"counters\": {";
+
+		bool first = true;
+		for (const auto& [key, value] : result.counters) {
+			stream << (first ? "" : ", ") << "\"" << escape_json(key) << "\": " << value;
+			first = false;
+		}
+
+		stream << "}\n";
+		stream << "    }";
+	}
+
+	stream << "\n  ]\n";
+	stream << "}\n";
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class BenchContext;
+
+/**
+ * @brief One measurable workload of the benchmark harness.
+ *
+ * prepare() runs once and may decline the scenario (for example when an asset is
+ * missing) by returning false with a reason. Only run() is timed; the hooks around
+ * it restore state between iterations without polluting the measurements.
+ */
+class Scenario {
+public:
+	virtual ~Scenario() = default;
+
+	virtual std::string name() const = 0;
+	virtual std::string description() const = 0;
+
+	virtual bool prepare(BenchContext& context, std::string& skipReason) {
+		return true;
+	}
+
+	virtual void before_iteration(BenchContext& context) {}
+	virtual void run(BenchContext& context) = 0;
+	virtual void after_iteration(BenchContext& context) {}
+
+	virtual void finish(BenchContext& context) {}
+
+	// Scenario specific figures reported next to the timings, e.g. actor counts
+	virtual std::map<std::string, double> counters() const {
+		return {};
+	}
+};
+
+struct BenchmarkOptions {
+	int iterations = 10;
+	int warmup = 1;
+	int actors = 32;
+	std::string sandbox = "sandbox";
+	std::string cartridge;
+	int bridgePort = 0;
+	std::vector<std::string> filters;
+};
+
+struct Distribution {
+	double min = 0.0;
+	double max = 0.0;
+	double mean = 0.0;
+	double median = 0.0;
+	double p90 = 0.0;
+	double p99 = 0.0;
+	double stddev = 0.0;
+
+	static Distribution from(std::vector<double> samples);
+};
+
+struct ScenarioResult {
+	std::string name;
+	std::string description;
+	bool skipped = false;
+	std::string skip_reason;
+	int iterations = 0;
+	Distribution milliseconds;
+	Distribution allocations;
+	Distribution allocated_bytes;
+	std::map<std::string, double> counters;
+};
+
+/**
+ * @brief Runs registered scenarios and reports their results as JSON.
+ */
+class BenchmarkRunner {
+public:
+	explicit BenchmarkRunner(const BenchmarkOptions& options);
+
+	void add(std::unique_ptr<Scenario> scenario);
+
+	const std::vector<std::unique_ptr<Scenario>>& scenarios() const {
+		return mScenarios;
+	}
+
+	std::vector<ScenarioResult> run(BenchContext& context);
+
+	void write_json(std::ostream& stream, const std::vector<ScenarioResult>& results) const;
+
+private:
+	bool is_selected(const Scenario& scenario) const;
+	ScenarioResult run_scenario(BenchContext& context, Scenario& scenario);
+
+	BenchmarkOptions mOptions;
+	std::vector<std::unique_ptr<Scenario>> mScenarios;
+};
+
+// Defined alongside the scenarios; later subsystems register theirs here too
+void register_engine_scenarios(BenchmarkRunner& runner);
+void register_physics_scenarios(BenchmarkRunner& runner);
+void register_lighting_scenarios(BenchmarkRunner& runner);
+void register_simulation_scenarios(BenchmarkRunner& runner);
@@ -0,0 +1,652 @@
+#include "bench/Benchmark.hpp"
+#include "bench/BenchContext.hpp"
+
+#include "CameraManager.hpp"
+#include "actors/ActorManager.hpp"
+#include "components/TransformComponent.hpp"
+#include "components/SkinnedAnimationComponent.hpp"
+#include "graphics/drawing/MeshActorBuilder.hpp"
+#include "import/ModelImporter.hpp"
+#include "serialization/SerializationModule.hpp"
+#include "serialization/UUID.hpp"
+#include "simulation/MachinePool.hpp"
+#include "simulation/VirtualMachine.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+constexpr const char* kModelPath = "animations/BotAnimation.fbx";
+constexpr const char* kScenePath = "animations/Untitled.pwr";
+constexpr float kFrameTime = 1.0f / 60.0f;
+constexpr int kCartridgeFramesPerIteration = 60;
+constexpr size_t kCartridgeInstances = 1000;
+constexpr size_t kLoadedCartridgeInstances = 100;
+constexpr uint64_t kInstanceWarmupInstructions = 10000;
+constexpr size_t kDeletedActors = 50000;
+
+bool require_file(const std::string& path, std::string& skipReason) {
+	if (!std::filesystem::exists(path)) {
+		skipReason = "missing asset: " + path;
+		return false;
+	}
+
+	return true;
+}
+
+bool read_file(const std::string& path, std::string& contents) {
+	std::ifstream stream(path, std::ios::binary);
+
+	if (!stream.is_open()) {
+		return false;
+	}
+
+	std::ostringstream buffer;
+	buffer << stream.rdbuf();
+	contents = buffer.str();
+	return true;
+}
+
+// Reads the --cartridge executable for the scenarios that run it
+bool read_cartridge(BenchContext& context, std::string& contents, std::string& skipReason) {
+	const std::string& path = context.options().cartridge;
+
+	if (path.empty()) {
+		skipReason = "no cartridge given, pass --cartridge <riscv executable>";
+		return false;
+	}
+
+	if (!require_file(path, skipReason)) {
+		return false;
+	}
+
+	if (!read_file(path, contents)) {
+		skipReason = "unreadable cartridge: " + path;
+		return false;
+	}
+
+	return true;
+}
+
+// Builds count actors from an in-memory copy of the model, as drag and drop import does
+void spawn_models(BenchContext& context, const std::string& path, const std::string& contents, int count) {
+	for (int i = 0; i < count; ++i) {
+		std::stringstream stream(contents);
+		auto& actor = context.actor_manager().create_actor();
+		context.mesh_actor_builder().build(actor, context.time_provider(), stream, path, context.mesh_shader(), context.skinned_shader());
+	}
+}
+
+size_t actor_count(BenchContext& context) {
+	return context.actor_manager().query<IDComponent>().count();
+}
+
+// Scenarios that need a populated scene for every iteration
+class SceneScenario : public Scenario {
+public:
+	bool prepare(BenchContext& context, std::string& skipReason) override {
+		if (!context.require_engine(skipReason)) {
+			return false;
+		}
+
+		mModelPath = context.sandbox_path(kModelPath);
+
+		if (!require_file(mModelPath, skipReason)) {
+			return false;
+		}
+
+		if (!read_file(mModelPath, mModelContents)) {
+			skipReason = "unreadable asset: " + mModelPath;
+			return false;
+		}
+
+		context.clear_scene();
+		spawn_models(context, mModelPath, mModelContents, context.options().actors);
+
+		return true;
+	}
+
+	void finish(BenchContext& context) override {
+		context.clear_scene();
+	}
+
+	std::map<std::string, double> counters() const override {
+		return {{"actors", static_cast<double>(mActorCount)}};
+	}
+
+protected:
+	std::string mModelPath;
+	std::string mModelContents;
+	size_t mActorCount = 0;
+};
+
+class ImportModelScenario : public Scenario {
+public:
+	std::string name() const override {
+		return "import_fbx";
+	}
+
+	std::string description() const override {
+		return "ModelImporter::LoadModel on sandbox/animations/BotAnimation.fbx";
+	}
+
+	bool prepare(BenchContext& context, std::string& skipReason) override {
+		// Material textures are uploaded during import, so this needs a context
+		if (!context.require_engine(skipReason)) {
+			return false;
+		}
+
+		mPath = context.sandbox_path(kModelPath);
+		return require_file(mPath, skipReason);
+	}
+
+	void run(BenchContext& context) override {
+		ModelImporter importer;
+
+		if (!importer.LoadModel(mPath)) {
+			throw std::runtime_error("import failed: " + mPath);
+		}
+
+		mMeshes = importer.GetMeshData().size();
+		mAnimations = importer.GetAnimations().size();
+		mBones = importer.GetSkeleton() ? importer.GetSkeleton()->num_bones() : 0;
+	}
+
+	std::map<std::string, double> counters() const override {
+		return {
+			{"meshes", static_cast<double>(mMeshes)},
+			{"bones", static_cast<double>(mBones)},
+			{"animations", static_cast<double>(mAnimations)}
+		};
+	}
+
+private:
+	std::string mPath;
+	size_t mMeshes = 0;
+	size_t mBones = 0;
+	size_t mAnimations = 0;
+};
+
+class LoadSceneScenario : public Scenario {
+public:
+	std::string name() const override {
+		return "load_scene";
+	}
+
+	std::string description() const override {
+		return "SerializationModule::load_scene on sandbox/animations/Untitled.pwr";
+	}
+
+	bool prepare(BenchContext& context, std::string& skipReason) override {
+		if (!context.require_engine(skipReason)) {
+			return false;
+		}
+
+		mPath = context.sandbox_path(kScenePath);
+		return require_file(mPath, skipReason);
+	}
+
+	void run(BenchContext& context) override {
+		context.serialization_module().load_scene(mPath);
+	}
+
+	void after_iteration(BenchContext& context) override {
+		mActorCount = actor_count(context);
+		context.clear_scene();
+	}
+
+	std::map<std::string, double> counters() const override {
+		return {{"actors", static_cast<double>(mActorCount)}};
+	}
+
+private:
+	std::string mPath;
+	size_t mActorCount = 0;
+};
+
+class SpawnActorsScenario : public Scenario {
+public:
+	std::string name() const override {
+		return "spawn_actors";
+	}
+
+	std::string description() const override {
+		return "Builds N skinned actors from an in-memory BotAnimation.fbx";
+	}
+
+	bool prepare(BenchContext& context, std::string& skipReason) override {
+		if (!context.require_engine(skipReason)) {
+			return false;
+		}
+
+		mPath = context.sandbox_path(kModelPath);
+
+		if (!require_file(mPath, skipReason)) {
+			return false;
+		}
+
+		if (!read_file(mPath, mContents)) {
+			skipReason = "unreadable asset: " + mPath;
+			return false;
+		}
+
+		context.clear_scene();
+		return true;
+	}
+
+	void run(BenchContext& context) override {
+		spawn_models(context, mPath, mContents, context.options().actors);
+	}
+
+	void after_iteration(BenchContext& context) override {
+		mActorCount = actor_count(context);
+		context.clear_scene();
+	}
+
+	std::map<std::string, double> counters() const override {
+		return {{"actors", static_cast<double>(mActorCount)}};
+	}
+
+private:
+	std::string mPath;
+	std::string mContents;
+	size_t mActorCount = 0;
+};
+
+class PlayAnimationsScenario : public SceneScenario {
+public:
+	std::string name() const override {
+		return "play_animations";
+	}
+
+	std::string description() const override {
+		return "Advances one frame and evaluates every SkinnedAnimationComponent";
+	}
+
+	bool prepare(BenchContext& context, std::string& skipReason) override {
+		if (!SceneScenario::prepare(context, skipReason)) {
+			return false;
+		}
+
+		mActorCount = context.actor_manager().animated_actors().count();
+		mTime = 0.0f;
+
+		return true;
+	}
+
+	void run(BenchContext& context) override {
+		mTime += kFrameTime;
+		context.time_provider().Update(mTime);
+
+		context.actor_manager().animated_actors().each<SkinnedAnimationComponent>([](Actor&, SkinnedAnimationComponent& animation) {
+			animation.Evaluate();
+		});
+	}
+
+private:
+	float mTime = 0.0f;
+};
+
+class RenderFrameScenario : public SceneScenario {
+public:
+	std::string name() const override {
+		return "render_frame";
+	}
+
+	std::string description() const override {
+		return "Draws N actors through the mesh and skinned mesh batches offscreen";
+	}
+
+	bool prepare(BenchContext& context, std::string& skipReason) override {
+		if (!SceneScenario::prepare(context, skipReason)) {
+			return false;
+		}
+
+		mActorCount = actor_count(context);
+		return true;
+	}
+
+	void run(BenchContext& context) override {
+		context.render_frame();
+	}
+};
+
+class SerializeSceneScenario : public SceneScenario {
+public:
+	std::string name() const override {
+		return "serialize_scene";
+	}
+
+	std::string description() const override {
+		return "SerializationModule::save_scene with N actors";
+	}
+
+	bool prepare(BenchContext& context, std::string& skipReason) override {
+		if (!SceneScenario::prepare(context, skipReason)) {
+			return false;
+		}
+
+		mActorCount = actor_count(context);
+		mScenePath = (std::filesystem::temp_directory_path() / "power_engine_bench_serialize.pwr").string();
+		return true;
+	}
+
+	void run(BenchContext& context) override {
+		context.serialization_module().save_scene(mScenePath);
+	}
+
+	void finish(BenchContext& context) override {
+		std::error_code error;
+		std::filesystem::remove(mScenePath, error);
+		SceneScenario::finish(context);
+	}
+
+private:
+	std::string mScenePath;
+};
+
+class DeserializeSceneScenario : public SceneScenario {
+public:
+	std::string name() const override {
+		return "deserialize_scene";
+	}
+
+	std::string description() const override {
+		return "SerializationModule::load_scene of a saved scene with N actors";
+	}
+
+	bool prepare(BenchContext& context, std::string& skipReason) override {
+		if (!SceneScenario::prepare(context, skipReason)) {
+			return false;
+		}
+
+		mScenePath = (std::filesystem::temp_directory_path() / "power_engine_bench_deserialize.pwr").string();
+		context.serialization_module().save_scene(mScenePath);
+
+		return true;
+	}
+
+	void run(BenchContext& context) override {
+		// load_scene replaces the current scene, so every iteration starts from the same state
+		context.serialization_module().load_scene(mScenePath);
+	}
+
+	void after_iteration(BenchContext& context) override {
+		mActorCount = actor_count(context);
+	}
+
+	void finish(BenchContext& context) override {
+		std::error_code error;
+		std::filesystem::remove(mScenePath, error);
+		SceneScenario::finish(context);
+	}
+
+private:
+	std::string mScenePath;
+};
+
+class StepCartridgeScenario : public Scenario {
+public:
+	std::string name() const override {
+		return "step_cartridge";
+	}
+
+	std::string description() const override {
+		return "VirtualMachine::update for 60 frames of the --cartridge executable";
+	}
+
+	bool prepare(BenchContext& context, std::string& skipReason) override {
+		std::string contents;
+
+		if (!read_cartridge(context, contents, skipReason)) {
+			return false;
+		}
+
+		mVirtualMachine = std::make_unique<VirtualMachine>();
+		mVirtualMachine->start(std::vector<uint8_t>(contents.begin(), contents.end()));
+
+		return true;
+	}
+
+	void run(BenchContext& context) override {
+		for (int i = 0; i < kCartridgeFramesPerIteration; ++i) {
+			mVirtualMachine->update();
+		}
+	}
+
+	void finish(BenchContext& context) override {
+		mVirtualMachine.reset();
+	}
+
+	std::map<std::string, double> counters() const override {
+		return {{"frames", static_cast<double>(kCartridgeFramesPerIteration)}};
+	}
+
+private:
+	std::unique_ptr<VirtualMachine> mVirtualMachine;
+};
+
+// Touches the pages an instance writes on its first frames, so resident memory is not just the fork itself
+void warm_up(MachinePool::Machine& machine) {
+	try {
+		machine.simulate<false>(kInstanceWarmupInstructions);
+	} catch (const std::exception&) {
+		// A cartridge that faults this early still counts with what it touched
+	}
+}
+
+class ForkCartridgeScenario : public Scenario {
+public:
+	std::string name() const override {
+		return "fork_cartridge_instances";
+	}
+
+	std::string description() const override {
+		return "Forks " + std::to_string(kCartridgeInstances) + " copy-on-write instances of the --cartridge executable from a MachinePool";
+	}
+
+	bool prepare(BenchContext& context, std::string& skipReason) override {
+		std::string contents;
+
+		if (!read_cartridge(context, contents, skipReason)) {
+			return false;
+		}
+
+		if (!mPool.load(std::vector<uint8_t>(contents.begin(), contents.end()))) {
+			skipReason = "cartridge failed to load";
+			return false;
+		}
+
+		mInstances.reserve(kCartridgeInstances);
+		return true;
+	}
+
+	void run(BenchContext& context) override {
+		for (size_t i = 0; i < kCartridgeInstances; ++i) {
+			mInstances.push_back(&mPool.acquire());
+		}
+	}
+
+	void after_iteration(BenchContext& context) override {
+		for (auto* instance : mInstances) {
+			warm_up(*instance);
+		}
+
+		mPool.measure();
+		mResidentBytes = mPool.resident_bytes();
+
+		// Reuse through the idle list, untimed by the runner and reported on its own
+		for (auto* instance : mInstances) {
+			mPool.release(*instance);
+		}
+
+		auto start = std::chrono::steady_clock::now();
+
+		for (auto*& instance : mInstances) {
+			instance = &mPool.acquire();
+		}
+
+		mPooledMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		// Destroyed rather than released, so that every timed run() performs the copy-on-write forks
+		for (auto* instance : mInstances) {
+			mPool.destroy(*instance);
+		}
+
+		mInstances.clear();
+	}
+
+	void finish(BenchContext& context) override {
+		mPool.unload();
+	}
+
+	std::map<std::string, double> counters() const override {
+		return {
+			{"instances", static_cast<double>(kCartridgeInstances)},
+			{"template_bytes", static_cast<double>(mPool.template_bytes())},
+			{"resident_bytes", static_cast<double>(mResidentBytes)},
+			{"bytes_per_instance", static_cast<double>(mResidentBytes - mPool.template_bytes()) / kCartridgeInstances},
+			{"pooled_ms", mPooledMilliseconds}
+		};
+	}
+
+private:
+	MachinePool mPool;
+	std::vector<MachinePool::Machine*> mInstances;
+	uint64_t mResidentBytes = 0;
+	// Last iteration's acquire of every instance from the idle list
+	double mPooledMilliseconds = 0.0;
+};
+
+// Baseline for fork_cartridge_instances: every instance loads the ELF on its own, as VirtualMachine does
+class LoadCartridgeScenario : public Scenario {
+public:
+	std::string name() const override {
+		return "load_cartridge_instances";
+	}
+
+	std::string description() const override {
+		return "Loads " + std::to_string(kLoadedCartridgeInstances) + " independent machines from the --cartridge executable";
+	}
+
+	bool prepare(BenchContext& context, std::string& skipReason) override {
+		std::string contents;
+
+		if (!read_cartridge(context, contents, skipReason)) {
+			return false;
+		}
+
+		mExecutable.assign(contents.begin(), contents.end());
+		mInstances.reserve(kLoadedCartridgeInstances);
+		return true;
+	}
+
+	void run(BenchContext& context) override {
+		for (size_t i = 0; i < kLoadedCartridgeInstances; ++i) {
+			auto machine = std::make_unique<MachinePool::Machine>(mExecutable);
+			machine->setup_linux({});
+			machine->setup_linux_syscalls();
+
+			mInstances.push_back(std::move(machine));
+		}
+	}
+
+	void after_iteration(BenchContext& context) override {
+		mResidentBytes = 0;
+
+		for (auto& instance : mInstances) {
+			warm_up(*instance);
+			mResidentBytes += instance->memory.memory_usage_total();
+		}
+
+		mInstances.clear();
+	}
+
+	std::map<std::string, double> counters() const override {
+		return {
+			{"instances", static_cast<double>(kLoadedCartridgeInstances)},
+			{"resident_bytes", static_cast<double>(mResidentBytes)},
+			{"bytes_per_instance", static_cast<double>(mResidentBytes) / kLoadedCartridgeInstances}
+		};
+	}
+
+private:
+	std::vector<uint8_t> mExecutable;
+	std::vector<std::unique_ptr<MachinePool::Machine>> mInstances;
+	uint64_t mResidentBytes = 0;
+};
+
+// Needs no graphics, the actors only carry a transform
+class DeleteActorsScenario : public Scenario {
+public:
+	std::string name() const override {
+		return "delete_actors";
+	}
+
+	std::string description() const override {
+		return "Removes every other actor of a " + std::to_string(kDeletedActors * 2) + " actor scene, " + std::to_string(kDeletedActors) + " in one call";
+	}
+
+	bool prepare(BenchContext& context, std::string& skipReason) override {
+		mActorManager = std::make_unique<ActorManager>(mRegistry, mCameraManager);
+		mDeleted.reserve(kDeletedActors);
+		return true;
+	}
+
+	void before_iteration(BenchContext& context) override {
+		for (size_t i = 0; i < kDeletedActors * 2; ++i) {
+			auto& actor = mActorManager->create_actor();
+			actor.add_component<TransformComponent>();
+
+			if (i % 2 == 1) {
+				mDeleted.push_back(std::ref(actor));
+			}
+		}
+	}
+
+	void run(BenchContext& context) override {
+		mActorManager->remove_actors(mDeleted);
+	}
+
+	void after_iteration(BenchContext& context) override {
+		mRemaining = mActorManager->actor_count();
+		mDeleted.clear();
+		mActorManager->clear_actors();
+	}
+
+	void finish(BenchContext& context) override {
+		mActorManager.reset();
+	}
+
+	std::map<std::string, double> counters() const override {
+		return {
+			{"deleted", static_cast<double>(kDeletedActors)},
+			{"remaining", static_cast<double>(mRemaining)}
+		};
+	}
+
+private:
+	entt::registry mRegistry;
+	CameraManager mCameraManager;
+	std::unique_ptr<ActorManager> mActorManager;
+	std::vector<std::reference_wrapper<Actor>> mDeleted;
+	size_t mRemaining = 0;
+};
+} // unnamed namespace
+
+void register_engine_scenarios(BenchmarkRunner& runner) {
+	runner.add(std::make_unique<ImportModelScenario>());
+	runner.add(std::make_unique<LoadSceneScenario>());
+	runner.add(std::make_unique<SpawnActorsScenario>());
+	runner.add(std::make_unique<PlayAnimationsScenario>());
+	runner.add(std::make_unique<RenderFrameScenario>());
+	runner.add(std::make_unique<SerializeSceneScenario>());
+	runner.add(std::make_unique<DeserializeSceneScenario>());
+	runner.add(std::make_unique<StepCartridgeScenario>());
+	runner.add(std::make_unique<ForkCartridgeScenario>());
+	runner.add(std::make_unique<LoadCartridgeScenario>());
+	runner.add(std::make_unique<DeleteActorsScenario>());
+}
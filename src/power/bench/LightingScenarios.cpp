@@ -0,0 +1,84 @@
+#include "bench/Benchmark.hpp"
+#include "bench/BenchContext.hpp"
+
+#include "graphics/shading/LightClusters.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+#include <random>
+#include <string>
+
+namespace {
+constexpr float kLightFieldSize = 200.0f;
+
+// Point and spot lights scattered over a field in front of an editor-like camera
+class LightClusterScenario : public Scenario {
+public:
+	explicit LightClusterScenario(uint32_t lightCount)
+	: mLightCount(lightCount) {
+	}
+
+	std::string name() const override {
+		return "light_clusters_" + std::to_string(mLightCount);
+	}
+
+	std::string description() const override {
+		return "Assigns " + std::to_string(mLightCount) + " point and spot lights to the froxel grid for one camera";
+	}
+
+	bool prepare(BenchContext& context, std::string& skipReason) override {
+		std::mt19937 random(11);
+		std::uniform_real_distribution<float> position(-kLightFieldSize * 0.5f, kLightFieldSize * 0.5f);
+		std::uniform_real_distribution<float> height(0.0f, 10.0f);
+		std::uniform_real_distribution<float> range(2.0f, 12.0f);
+
+		mLights.clear();
+
+		for (uint32_t i = 0; i < mLightCount; ++i) {
+			LightClusters::Light light;
+			light.position = glm::vec3(position(random), height(random), position(random));
+			light.range = range(random);
+			light.color = glm::vec3(1.0f);
+			light.intensity = 1.0f;
+			light.direction = glm::vec3(0.0f, -1.0f, 0.0f);
+			light.cosInnerAngle = std::cos(glm::radians(20.0f));
+			light.cosOuterAngle = std::cos(glm::radians(35.0f));
+			light.spot = i % 4 == 0;
+
+			mLights.push_back(light);
+		}
+
+		mView = glm::lookAt(glm::vec3(0.0f, 20.0f, 120.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+		// Near and far planes of the default CameraComponent
+		mProjection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.01f, 1e5f);
+
+		return true;
+	}
+
+	void run(BenchContext& context) override {
+		mClusters.build(mView, mProjection, mLights);
+	}
+
+	std::map<std::string, double> counters() const override {
+		return {
+			{"visible_lights", static_cast<double>(mClusters.light_count())},
+			{"light_indices", static_cast<double>(mClusters.index_count())},
+			{"lights_per_cluster", static_cast<double>(mClusters.index_count()) / LightClusters::kClusterCount}
+		};
+	}
+
+private:
+	uint32_t mLightCount;
+	std::vector<LightClusters::Light> mLights;
+	glm::mat4 mView;
+	glm::mat4 mProjection;
+	LightClusters mClusters;
+};
+} // unnamed namespace
+
+void register_lighting_scenarios(BenchmarkRunner& runner) {
+	runner.add(std::make_unique<LightClusterScenario>(256));
+	runner.add(std::make_unique<LightClusterScenario>(1024));
+}
@@ -0,0 +1,147 @@
+#include "bench/Benchmark.hpp"
+#include "bench/BenchContext.hpp"
+
+#include "physics/Broadphase.h"
+#include "physics/ContactBuffer.h"
+#include "physics/GeometryExtensions.h"
+#include "physics/SliceCollision.h"
+
+#include <cmath>
+#include <random>
+
+namespace {
+constexpr uint32_t kPhysicsDynamicBodies = 4096;
+constexpr uint32_t kPhysicsStaticBodies = 4096;
+constexpr int kPhysicsWorldSize = 8192;
+constexpr float kPhysicsStepTime = 1.0f / 60.0f;
+constexpr float kPhysicsGravity = 8.0f;
+
+// Falling boxes over a field of platforms, stepped like PhysicsWorld::update
+class PhysicsBenchWorld {
+public:
+	void reset() {
+		std::mt19937 random(7);
+		std::uniform_int_distribution<int> position(0, kPhysicsWorldSize);
+		std::uniform_int_distribution<int> width(32, 160);
+
+		mBoxes.clear();
+		mSpeeds.assign(kPhysicsDynamicBodies, 0.0f);
+
+		for (uint32_t i = 0; i < kPhysicsDynamicBodies; ++i) {
+			mBoxes.emplace_back(position(random), position(random), 12, 24);
+		}
+
+		for (uint32_t i = 0; i < kPhysicsStaticBodies; ++i) {
+			mBoxes.emplace_back(position(random), position(random), width(random), 16);
+		}
+	}
+
+	void step(bool useBroadphase) {
+		mContacts.reset(mBoxes.size());
+
+		if (useBroadphase) {
+			mBroadphase.clear();
+
+			for (uint32_t i = 0; i < mBoxes.size(); ++i) {
+				mBroadphase.addProxy(mBoxes[i], i, 0, i >= kPhysicsDynamicBodies);
+			}
+
+			for (const auto& pair : mBroadphase.findPairs()) {
+				uint32_t body = mBroadphase.getProxy(pair.a).body;
+				uint32_t other = mBroadphase.getProxy(pair.b).body;
+
+				if (other >= kPhysicsDynamicBodies) {
+					physics::resolveSliceCollisions(mBoxes[body], mBoxes[other], mContacts, body, other);
+				}
+			}
+
+			mCandidateTests = mBroadphase.getCandidateTests();
+		} else {
+			mCandidateTests = 0;
+
+			for (uint32_t body = 0; body < kPhysicsDynamicBodies; ++body) {
+				for (uint32_t other = kPhysicsDynamicBodies; other < mBoxes.size(); ++other) {
+					++mCandidateTests;
+
+					if (windy::GeometryExtensions::rectIntersectsRect(mBoxes[body], mBoxes[other])) {
+						physics::resolveSliceCollisions(mBoxes[body], mBoxes[other], mContacts, body, other);
+					}
+				}
+			}
+		}
+
+		for (uint32_t body = 0; body < kPhysicsDynamicBodies; ++body) {
+			if (mContacts.hasContact(body, windy::Contact::Up) || mContacts.hasContact(body, windy::Contact::Down)) {
+				mSpeeds[body] = 0.0f;
+			} else {
+				mSpeeds[body] -= kPhysicsGravity * kPhysicsStepTime;
+			}
+
+			// Boxes leaving the bottom re-enter at the top so the density stays constant
+			auto& box = mBoxes[body];
+			box.origin.y += static_cast<int>(std::floor(mSpeeds[body]));
+
+			if (box.origin.y < 0) {
+				box.origin.y += kPhysicsWorldSize;
+			}
+		}
+	}
+
+	size_t contacts() const {
+		return mContacts.size();
+	}
+
+	size_t candidate_tests() const {
+		return mCandidateTests;
+	}
+
+private:
+	std::vector<windy::Rect> mBoxes;
+	std::vector<float> mSpeeds;
+	physics::Broadphase mBroadphase;
+	physics::ContactBuffer mContacts;
+	size_t mCandidateTests = 0;
+};
+
+class PhysicsStepScenario : public Scenario {
+public:
+	explicit PhysicsStepScenario(bool useBroadphase)
+	: mUseBroadphase(useBroadphase) {
+	}
+
+	std::string name() const override {
+		return mUseBroadphase ? "physics_broadphase" : "physics_bruteforce";
+	}
+
+	std::string description() const override {
+		return std::string("One collision step of 4096 falling boxes over 4096 platforms, ") +
+			(mUseBroadphase ? "pairs from the uniform grid broadphase" : "every dynamic box against every platform");
+	}
+
+	bool prepare(BenchContext& context, std::string& skipReason) override {
+		mWorld.reset();
+		return true;
+	}
+
+	void run(BenchContext& context) override {
+		mWorld.step(mUseBroadphase);
+	}
+
+	std::map<std::string, double> counters() const override {
+		return {
+			{"bodies", static_cast<double>(kPhysicsDynamicBodies + kPhysicsStaticBodies)},
+			{"candidate_tests", static_cast<double>(mWorld.candidate_tests())},
+			{"contacts", static_cast<double>(mWorld.contacts())}
+		};
+	}
+
+private:
+	bool mUseBroadphase;
+	PhysicsBenchWorld mWorld;
+};
+} // unnamed namespace
+
+void register_physics_scenarios(BenchmarkRunner& runner) {
+	runner.add(std::make_unique<PhysicsStepScenario>(true));
+	runner.add(std::make_unique<PhysicsStepScenario>(false));
+}
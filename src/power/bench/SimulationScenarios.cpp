@@ -0,0 +1,140 @@
+#include "bench/Benchmark.hpp"
+#include "bench/BenchContext.hpp"
+
+#include "simulation/CommandChannel.hpp"
+#include "simulation/LoopbackClient.hpp"
+#include "simulation/SimulationServer.hpp"
+
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace {
+constexpr size_t kBridgeBatches = 2000;
+constexpr size_t kBridgeCommandsPerBatch = 64;
+constexpr size_t kBridgePayloadSize = 32;
+
+// A producer thread stands in for the network thread; run() drains like the frame loop
+class CommandChannelScenario : public Scenario {
+public:
+	std::string name() const override {
+		return "debug_bridge_channel";
+	}
+
+	std::string description() const override {
+		return "Hands " + std::to_string(kBridgeBatches) + " batches of " + std::to_string(kBridgeCommandsPerBatch) +
+			   " commands from a producer thread to a drain of " + std::to_string(SimulationServer::kMaxCommandsPerFrame) + " commands per frame";
+	}
+
+	bool prepare(BenchContext& context, std::string& skipReason) override {
+		std::string payload(kBridgePayloadSize, 'x');
+
+		mRequest.reset();
+
+		for (size_t i = 0; i < kBridgeCommandsPerBatch; ++i) {
+			mRequest.add(DebugCommand::CommandType::EXECUTE, payload);
+		}
+
+		return true;
+	}
+
+	void run(BenchContext& context) override {
+		const size_t total = kBridgeBatches * kBridgeCommandsPerBatch;
+
+		std::thread producer([this]() {
+			std::string bytes;
+
+			for (size_t i = 0; i < kBridgeBatches; ++i) {
+				bytes.assign(mRequest.bytes());
+
+				while (mChannel.submit({}, bytes) == CommandChannel::SubmitResult::Busy) {
+					std::this_thread::yield();
+				}
+			}
+		});
+
+		size_t processed = 0;
+		size_t checksum = 0;
+		mFrames = 0;
+
+		while (processed < total) {
+			processed += mChannel.drain(SimulationServer::kMaxCommandsPerFrame, [&checksum](const CommandChannel::Batch&, const DebugCommandView& command) {
+				checksum += command.size;
+			}, [](const CommandChannel::Batch&) {
+			});
+
+			++mFrames;
+		}
+
+		producer.join();
+
+		mChecksum = checksum;
+	}
+
+	std::map<std::string, double> counters() const override {
+		return {
+			{"commands", static_cast<double>(kBridgeBatches * kBridgeCommandsPerBatch)},
+			{"frames", static_cast<double>(mFrames)},
+			{"busy_submits", static_cast<double>(mChannel.batches_rejected())},
+			{"payload_bytes", static_cast<double>(mChecksum)}
+		};
+	}
+
+private:
+	CommandChannel mChannel;
+	DebugCommandBatch mRequest;
+	size_t mFrames = 0;
+	size_t mChecksum = 0;
+};
+
+// Round trips through a SimulationServer that is already listening, such as a running editor
+class BridgeLoopbackScenario : public Scenario {
+public:
+	std::string name() const override {
+		return "debug_bridge_loopback";
+	}
+
+	std::string description() const override {
+		return "Streams " + std::to_string(kBridgeBatches) + " command batches to the SimulationServer on --bridge-port over 127.0.0.1";
+	}
+
+	bool prepare(BenchContext& context, std::string& skipReason) override {
+		if (context.options().bridgePort <= 0) {
+			skipReason = "no server given, pass --bridge-port <port>";
+			return false;
+		}
+
+		mOptions.port = static_cast<uint16_t>(context.options().bridgePort);
+		mOptions.batches = kBridgeBatches;
+		mOptions.commandsPerBatch = kBridgeCommandsPerBatch;
+		mOptions.payloadSize = kBridgePayloadSize;
+
+		return true;
+	}
+
+	void run(BenchContext& context) override {
+		mResult = LoopbackClient().run(mOptions);
+
+		if (!mResult.error.empty()) {
+			std::cerr << "debug_bridge_loopback: " << mResult.error << std::endl;
+		}
+	}
+
+	std::map<std::string, double> counters() const override {
+		return {
+			{"commands_per_second", mResult.commands_per_second()},
+			{"responses", static_cast<double>(mResult.responses)},
+			{"rejected_batches", static_cast<double>(mResult.batchesRejected)}
+		};
+	}
+
+private:
+	LoopbackClient::Options mOptions;
+	LoopbackClient::Result mResult;
+};
+} // unnamed namespace
+
+void register_simulation_scenarios(BenchmarkRunner& runner) {
+	runner.add(std::make_unique<CommandChannelScenario>());
+	runner.add(std::make_unique<BridgeLoopbackScenario>());
+}
@@ -0,0 +1,114 @@
+#include "bench/Benchmark.hpp"
+#include "bench/BenchContext.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace {
+void print_usage(const char* executable) {
+	std::cerr << "Usage: " << executable << " [options]\n"
+			  << "  --scenario <name>    Run only the named scenario; repeatable\n"
+			  << "  --iterations <n>     Timed iterations per scenario (default 10)\n"
+			  << "  --warmup <n>         Untimed iterations before measuring (default 1)\n"
+			  << "  --actors <n>         Actors spawned by scene scenarios (default 32)\n"
+			  << "  --sandbox <path>     Directory containing the benchmark assets (default sandbox)\n"
+			  << "  --cartridge <path>   RISC-V executable for the cartridge scenarios\n"
+			  << "  --bridge-port <n>    Port of a running SimulationServer for debug_bridge_loopback\n"
+			  << "  --output <path>      Write the JSON report to a file instead of stdout\n"
+			  << "  --list               List scenarios and exit\n";
+}
+
+bool parse_int(const char* value, int& result) {
+	char* end = nullptr;
+	long parsed = std::strtol(value, &end, 10);
+
+	if (!end || *end != '\0' || parsed < 0) {
+		return false;
+	}
+
+	result = static_cast<int>(parsed);
+	return true;
+}
+} // unnamed namespace
+
+int main(int argc, char** argv) {
+	BenchmarkOptions options;
+
+	std::string outputPath;
+	bool listOnly = false;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string argument = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (argument == "--list") {
+			listOnly = true;
+		} else if (argument == "--help" || argument == "-h") {
+			print_usage(argv[0]);
+			return 0;
+		} else if (argument == "--scenario" && hasValue) {
+			options.filters.push_back(argv[++i]);
+		} else if (argument == "--iterations" && hasValue && parse_int(argv[i + 1], options.iterations)) {
+			++i;
+		} else if (argument == "--warmup" && hasValue && parse_int(argv[i + 1], options.warmup)) {
+			++i;
+		} else if (argument == "--actors" && hasValue && parse_int(argv[i + 1], options.actors)) {
+			++i;
+		} else if (argument == "--sandbox" && hasValue) {
+			options.sandbox = argv[++i];
+		} else if (argument == "--cartridge" && hasValue) {
+			options.cartridge = argv[++i];
+		} else if (argument == "--bridge-port" && hasValue && parse_int(argv[i + 1], options.bridgePort)) {
+			++i;
+		} else if (argument == "--output" && hasValue) {
+			outputPath = argv[++i];
+		} else {
+			std::cerr << "Unknown or incomplete argument: " << argument << std::endl;
+			print_usage(argv[0]);
+			return 1;
+		}
+	}
+
+	std::error_code error;
+	options.sandbox = std::filesystem::absolute(options.sandbox, error).string();
+
+	BenchmarkRunner runner(options);
+	register_engine_scenarios(runner);
+	register_physics_scenarios(runner);
+	register_lighting_scenarios(runner);
+	register_simulation_scenarios(runner);
+
+	if (listOnly) {
+		for (const auto& scenario : runner.scenarios()) {
+			std::cout << scenario->name() << "\t" << scenario->description() << std::endl;
+		}
+		return 0;
+	}
+
+	std::vector<ScenarioResult> results;
+
+	{
+		BenchContext context(options);
+		results = runner.run(context);
+	}
+
+	if (outputPath.empty()) {
+		runner.write_json(std::cout, results);
+		return 0;
+	}
+
+	std::ofstream output(outputPath, std::ios::trunc);
+
+	if (!output.is_open()) {
+		std::cerr << "Failed to open output file: " << outputPath << std::endl;
+		return 1;
+	}
+
+	runner.write_json(output, results);
+
+	return 0;
+}
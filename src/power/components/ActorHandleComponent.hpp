@@ -0,0 +1,29 @@
+#pragma once
+
+#include "actors/SlotMap.hpp"
+
+class Actor;
+
+using ActorHandle = SlotHandle;
+
+// Points from an entity back to the Actor the ActorManager owns for it, so registry queries can yield actors
+class ActorHandleComponent {
+public:
+	ActorHandleComponent(Actor& actor, ActorHandle handle)
+	: mActor(&actor)
+	, mHandle(handle) {
+	}
+
+	Actor& actor() const {
+		return *mActor;
+	}
+
+	// The actor's slot in the manager, replaced when a detached actor is attached again
+	ActorHandle handle() const {
+		return mHandle;
+	}
+
+private:
+	Actor* mActor;
+	ActorHandle mHandle;
+};
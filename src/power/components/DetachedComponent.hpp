@@ -0,0 +1,16 @@
+#pragma once
+
+// Marks an actor taken out of the scene whose entity the undo history keeps alive for a later restore
+class DetachedComponent {
+public:
+	DetachedComponent(bool wasVisible = true)
+	: mWasVisible(wasVisible) {
+	}
+
+	bool was_visible() const {
+		return mWasVisible;
+	}
+
+private:
+	bool mWasVisible;
+};
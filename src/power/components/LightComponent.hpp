@@ -0,0 +1,87 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+// Dynamic point or spot light; position and direction (-Z) come from the actor's TransformComponent
+class LightComponent {
+public:
+	enum class ELightType {
+		Point,
+		Spot
+	};
+
+	LightComponent(ELightType type = ELightType::Point, const glm::vec3& color = glm::vec3(1.0f), float intensity = 1.0f, float range = 10.0f)
+	: mType(type)
+	, mColor(color)
+	, mIntensity(intensity)
+	, mRange(range) {
+		set_cone_angles(glm::radians(30.0f), glm::radians(45.0f));
+	}
+
+	ELightType get_type() const {
+		return mType;
+	}
+
+	void set_type(ELightType type) {
+		mType = type;
+	}
+
+	const glm::vec3& get_color() const {
+		return mColor;
+	}
+
+	void set_color(const glm::vec3& color) {
+		mColor = color;
+	}
+
+	float get_intensity() const {
+		return mIntensity;
+	}
+
+	void set_intensity(float intensity) {
+		mIntensity = intensity;
+	}
+
+	// Distance at which the light's contribution reaches zero
+	float get_range() const {
+		return mRange;
+	}
+
+	void set_range(float range) {
+		mRange = std::max(range, 0.0f);
+	}
+
+	float get_inner_angle() const {
+		return mInnerAngle;
+	}
+
+	float get_outer_angle() const {
+		return mOuterAngle;
+	}
+
+	// Half angles in radians; the spot falls off smoothly between inner and outer
+	void set_cone_angles(float inner, float outer) {
+		mOuterAngle = std::clamp(outer, 0.0f, glm::radians(89.0f));
+		mInnerAngle = std::clamp(inner, 0.0f, mOuterAngle);
+	}
+
+	bool get_enabled() const {
+		return mEnabled;
+	}
+
+	void set_enabled(bool enabled) {
+		mEnabled = enabled;
+	}
+
+private:
+	ELightType mType;
+	glm::vec3 mColor;
+	float mIntensity;
+	float mRange;
+	float mInnerAngle;
+	float mOuterAngle;
+	bool mEnabled = true;
+};
@@ -6,9 +6,13 @@
 
 #include "animation/Animation.hpp"
 #include "animation/AnimationTimeProvider.hpp"
+#include "animation/KeyframeTrack.hpp"
+#include "animation/PoseBlender.hpp"
 #include "animation/Transform.hpp"
 #include "animation/Skeleton.hpp"
 
+#include "profiling/Profiler.hpp"
+
 #include <glm/gtx/matrix_decompose.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -30,6 +34,7 @@ public:
 		size_t numBones = mSkeletonComponent.get_skeleton().num_bones();
 		mModelPose.resize(numBones);
 		mDefaultPose.resize(numBones);
+		mPoseBlender.resize(numBones);
 		
 		for (size_t i = 0; i < numBones; ++i) {
 			auto defaultTransform = glm::identity<glm::mat4>();
@@ -72,6 +77,8 @@ public:
 	}
 	
 	void Evaluate() {
+		POWER_PROFILE_ZONE("SkinnedAnimationComponent::Evaluate");
+		
 		if (!mFrozen) {
 			auto keyframe = evaluate_keyframe(mAnimationTimeProvider.GetTime());
 			
@@ -99,7 +106,7 @@ public:
 		auto m2 = evaluate_keyframe(mAnimationTimeProvider.GetTime());
 		
 		if (m2) {
-			return m1 == m2;
+			return m1.get() == m2;
 		} else {
 			return true;
 		}
@@ -144,47 +151,42 @@ public:
 		apply_pose_to_skeleton(mDefaultPose);
 	}
 	
-	std::shared_ptr<PlaybackComponent::Keyframe> evaluate_keyframe(float time) {
+	PlaybackComponent::Keyframe* evaluate_keyframe(float time) {
 		if (keyframes_.empty()) {
 			return nullptr;
 		}
 		
-		// Finding the next keyframe after the current time
-		auto nextKeyframeIt = std::upper_bound(keyframes_.begin(), keyframes_.end(), time,
-											   [](float t, const std::shared_ptr<PlaybackComponent::Keyframe>& kf) {
-			return t < kf->time;
-		});
+		// Finding the active keyframe and the one after it through the track cursor
+		PlaybackComponent::Keyframe* currentKeyframe = keyframes_.active_at(time);
+		PlaybackComponent::Keyframe* nextKeyframe = keyframes_.next_after(time);
 		
-		if (nextKeyframeIt == keyframes_.end()) {
+		if (!nextKeyframe) {
 			// If there is no next keyframe, use the last keyframe
-			return evaluate_keyframe(keyframes_.back(), time);
+			return evaluate_keyframe(&keyframes_.back(), time);
 		}
 		
-		if (nextKeyframeIt == keyframes_.begin()) {
+		if (!currentKeyframe) {
 			// If the current time is before the first keyframe
-			return evaluate_keyframe(*nextKeyframeIt, time);
+			return evaluate_keyframe(nextKeyframe, time);
 		}
 		
-		// Getting the previous keyframe (current keyframe)
-		auto currentKeyframeIt = nextKeyframeIt - 1;
-		
 		// Calculating interpolation factor
-		float segmentDuration = (*nextKeyframeIt)->time - (*currentKeyframeIt)->time;
-		float t = (time - (*currentKeyframeIt)->time) / segmentDuration;
+		float segmentDuration = nextKeyframe->time - currentKeyframe->time;
+		float t = (time - currentKeyframe->time) / segmentDuration;
 		
 		t = glm::clamp(t, 0.0f, 1.0f);
 		
 		// Handling playback modifiers (e.g., reverse)
-		PlaybackModifier currentModifier = (*currentKeyframeIt)->getPlaybackModifier();
+		PlaybackModifier currentModifier = currentKeyframe->getPlaybackModifier();
 		bool reverse = (currentModifier == PlaybackModifier::Reverse);
 		if (reverse) {
 			t = 1.0f - t;
 		}
 		
 		// Blending poses from current and next keyframes on a per-bone basis
-		blend_keyframes(*currentKeyframeIt, *nextKeyframeIt, time, t);
+		blend_keyframes(*currentKeyframe, *nextKeyframe, time, t);
 		
-		return *currentKeyframeIt;
+		return currentKeyframe;
 	}
 	
 	void evaluate_provider(float time, PlaybackModifier modifier) {
@@ -210,6 +212,22 @@ public:
 		}
 	}
 	
+	// Stable handles into the track can be held by the timeline UI
+	KeyframeTrack<PlaybackComponent::Keyframe>& get_keyframe_track() {
+		return keyframes_;
+	}
+	
+	// Layered blending entry point; callers add layers and then call apply_blended_pose()
+	PoseBlender& get_pose_blender() {
+		prepare_pose_buffers();
+		return mPoseBlender;
+	}
+	
+	void apply_blended_pose() {
+		mPoseBlender.evaluate(mModelPose);
+		apply_pose_to_skeleton();
+	}
+	
 private:
 	SkeletonComponent& mSkeletonComponent;
 	AnimationTimeProvider& mAnimationTimeProvider;
@@ -225,25 +243,19 @@ private:
 			updateKeyframe(time, state, modifier, trigger, playbackData);
 			return;
 		}
-		auto keyframe = std::make_shared<PlaybackComponent::Keyframe>(time, state, modifier, trigger, playbackData);
-		keyframes_.push_back(keyframe);
-		// Keeping keyframes sorted
-		std::sort(keyframes_.begin(), keyframes_.end(),
-				  [](const std::shared_ptr<PlaybackComponent::Keyframe>& a, const std::shared_ptr<PlaybackComponent::Keyframe>& b) {
-			return a->time < b->time;
-		});
+		// The track keeps keyframes ordered by time
+		keyframes_.insert(time, PlaybackComponent::Keyframe(time, state, modifier, trigger, playbackData));
 		
 		updateAnimationOffset(time);
 	}
 	
 	// Updating an existing keyframe at a specified time
 	void updateKeyframe(float time, PlaybackState state, PlaybackModifier modifier, PlaybackTrigger trigger, std::shared_ptr<PlaybackData> playbackData) {
-		auto it = findKeyframe(time);
-		if (it != keyframes_.end()) {
-			(*it)->setPlaybackState(state);
-			(*it)->setPlaybackModifier(modifier);
-			(*it)->setPlaybackTrigger(trigger);
-			(*it)->setPlaybackData(playbackData);
+		if (auto keyframe = keyframes_.find(time)) {
+			keyframe->setPlaybackState(state);
+			keyframe->setPlaybackModifier(modifier);
+			keyframe->setPlaybackTrigger(trigger);
+			keyframe->setPlaybackData(playbackData);
 		} else {
 			// If the keyframe does not exist, add it
 			addKeyframe(time, state, modifier, trigger, playbackData);
@@ -254,54 +266,36 @@ private:
 	
 	// Removing a keyframe at the specified time
 	void removeKeyframe(float time) {
-		auto it = findKeyframe(time);
-		if (it != keyframes_.end()) {
-			keyframes_.erase(it);
-		}
+		keyframes_.erase(time);
 		// Optionally handling the case where the keyframe does not exist
 		
 		updateAnimationOffset(time);
 	}
 	
 	// Evaluating the playback state at a given time
-	std::shared_ptr<PlaybackComponent::Keyframe> evaluate(float time) {
+	PlaybackComponent::Keyframe* evaluate(float time) {
 		if (keyframes_.empty()) {
 			return nullptr; // Default state if no keyframes
 		}
 		
 		// If time is before the first keyframe
-		if (time < keyframes_.front()->time) {
+		if (time < keyframes_.front().time) {
 			// Setting the model pose to the first keyframe's pose
-			evaluate_animation(keyframes_.front()->getPlaybackData()->get_animation(), keyframes_.front()->time);
+			evaluate_animation(keyframes_.front().getPlaybackData()->get_animation(), keyframes_.front().time);
 			
 			return nullptr;
 		}
 		
 		// If time is after the last keyframe
-		if (time > keyframes_.back()->time) {
+		if (time > keyframes_.back().time) {
 			// Setting the model pose to the last keyframe's pose
-			evaluate_animation(keyframes_.back()->getPlaybackData()->get_animation(), keyframes_.back()->time);
+			evaluate_animation(keyframes_.back().getPlaybackData()->get_animation(), keyframes_.back().time);
 			
-			return keyframes_.back();
-		}
-		
-		// Finding the first keyframe with time >= given time
-		auto it = std::lower_bound(keyframes_.begin(), keyframes_.end(), time,
-								   [](const std::shared_ptr<PlaybackComponent::Keyframe>& kf, float t) {
-			return kf->time < t;
-		});
-		
-		if (it != keyframes_.end()) {
-			if ((*it)->time == time) {
-				return *it;
-			} else if (it != keyframes_.begin()) {
-				// No exact match; use the closest keyframe to the left
-				return *(it - 1);
-			}
+			return &keyframes_.back();
 		}
 		
-		// Fallback (should not reach here if bounds are respected)
-		return nullptr;
+		// Exact match or the closest keyframe to the left
+		return keyframes_.active_at(time);
 	}
 	
 	// Checking if the current time corresponds to an exact keyframe
@@ -310,29 +304,13 @@ private:
 	}
 	
 	// Getting the previous keyframe before the given time
-	std::shared_ptr<PlaybackComponent::Keyframe> get_previous_keyframe(float time) {
-		if (keyframes_.empty()) return nullptr;
-		
-		auto it = std::lower_bound(keyframes_.begin(), keyframes_.end(), time,
-								   [](const std::shared_ptr<PlaybackComponent::Keyframe>& kf, float t) {
-			return kf->time < t;
-		});
-		
-		if (it == keyframes_.begin()) return nullptr; // No previous keyframe
-		--it;
-		return *it;
+	PlaybackComponent::Keyframe* get_previous_keyframe(float time) {
+		return keyframes_.previous_before(time);
 	}
 	
 	// Getting the next keyframe after the given time
-	std::shared_ptr<PlaybackComponent::Keyframe> get_next_keyframe(float time) {
-		if (keyframes_.empty()) return nullptr;
-		
-		auto it = std::upper_bound(keyframes_.begin(), keyframes_.end(), time,
-								   [](float t, const std::shared_ptr<PlaybackComponent::Keyframe>& kf) {
-			return t < kf->time;
-		});
-		if (it == keyframes_.end()) return nullptr; // No next keyframe
-		return *it;
+	PlaybackComponent::Keyframe* get_next_keyframe(float time) {
+		return keyframes_.next_after(time);
 	}
 	
 	float getAdjustedAnimationTime(float currentTime, float duration) {
@@ -347,32 +325,29 @@ private:
 		
 		// Initializing lastState and lastStateChangeTime based on the first keyframe
 		float lastStateChangeTime = mAnimationOffset;
-		PlaybackState lastState = keyframes_[0]->getPlaybackState();
-		
-		size_t keyframeIndex = 0;
+		PlaybackState lastState = keyframes_.front().getPlaybackState();
 		
 		// If the first keyframe is after currentTime, the animation hasn't started yet
-		if (keyframes_[0]->time > currentTime) {
+		if (keyframes_.front().time > currentTime) {
 			return 0.0f;
 		}
 		
 		// Processing keyframes
-		for (; keyframeIndex < keyframes_.size(); ++keyframeIndex) {
-			const auto& keyframe = keyframes_[keyframeIndex];
-			if (keyframe->time > currentTime) {
+		for (const auto& keyframe : keyframes_) {
+			if (keyframe.time > currentTime) {
 				break;
 			}
 			
 			// Handling state changes
-			PlaybackState currentState = keyframe->getPlaybackState();
+			PlaybackState currentState = keyframe.getPlaybackState();
 			
 			if (currentState != lastState) {
 				if (lastState == PlaybackState::Play) {
 					// Accumulating the duration from the last play state to the current keyframe time
-					accumulatedPlayTime += keyframe->time - lastStateChangeTime;
+					accumulatedPlayTime += keyframe.time - lastStateChangeTime;
 				}
 				lastState = currentState;
-				lastStateChangeTime = keyframe->time;
+				lastStateChangeTime = keyframe.time;
 			}
 		}
 		
@@ -388,7 +363,7 @@ private:
 		return adjustedTime;
 	}
 	
-	std::shared_ptr<PlaybackComponent::Keyframe> evaluate_keyframe(std::shared_ptr<PlaybackComponent::Keyframe> keyframe, float time) {
+	PlaybackComponent::Keyframe* evaluate_keyframe(PlaybackComponent::Keyframe* keyframe, float time) {
 		std::optional<std::reference_wrapper<Animation>> animation;
 		
 		if (keyframe) {
@@ -425,32 +400,14 @@ private:
 		return keyframe;
 	}
 	
-	std::shared_ptr<PlaybackComponent::Keyframe> get_keyframe(float time) {
-		auto it = findKeyframe(time);
-		
-		if (it != keyframes_.end()) {
-			return *it;
-		} else {
-			return nullptr;
-		}
+	PlaybackComponent::Keyframe* get_keyframe(float time) {
+		return keyframes_.find(time);
 	}
 	
 private:
 	// Checking if a keyframe exists at the given time
 	bool keyframeExists(float time) const {
-		return std::any_of(keyframes_.begin(), keyframes_.end(),
-						   [time](const std::shared_ptr<PlaybackComponent::Keyframe>& kf) { return kf->time == time; });
-	}
-	
-	// Finding a keyframe at the given time
-	typename std::vector<std::shared_ptr<PlaybackComponent::Keyframe>>::iterator findKeyframe(float time) {
-		return std::find_if(keyframes_.begin(), keyframes_.end(),
-							[time](const std::shared_ptr<PlaybackComponent::Keyframe>& kf) { return kf->time == time; });
-	}
-	
-	typename std::vector<std::shared_ptr<PlaybackComponent::Keyframe>>::const_iterator findKeyframe(float time) const {
-		return std::find_if(keyframes_.cbegin(), keyframes_.cend(),
-							[time](const std::shared_ptr<PlaybackComponent::Keyframe>& kf) { return kf->time == time; });
+		return keyframes_.contains(time);
 	}
 	
 	// Getting the current playback modifier at a given time
@@ -472,7 +429,20 @@ private:
 	}
 	
 	void evaluate_animation(const Animation& animation, float time) {
-		mModelPose = animation.evaluate(time);
+		prepare_pose_buffers();
+		
+		mPoseBlender.clear_layers();
+		mPoseBlender.add_layer(animation, time, 1.0f);
+		mPoseBlender.evaluate(mModelPose);
+	}
+	
+	// Keeping the pose buffers in step with the skeleton; only allocates if bones were added
+	void prepare_pose_buffers() {
+		size_t numBones = mSkeletonComponent.get_skeleton().num_bones();
+		
+		if (mPoseBlender.num_bones() != numBones) {
+			mPoseBlender.resize(numBones);
+		}
 	}
 	
 	void apply_pose_to_skeleton() {
@@ -490,29 +460,28 @@ private:
 		mAnimationOffset = 0.0f;
 		
 		// Finding the keyframe with the largest time less than or equal to the given time
-		auto keyframe_it = std::find_if(keyframes_.rbegin(), keyframes_.rend(),
-										[time](const std::shared_ptr<PlaybackComponent::Keyframe>& kf) { return kf->time <= time; });
+		auto keyframe_it = keyframes_.active_iterator_at(time);
 		
 		// Checking if the iterator is valid
-		if (keyframe_it != keyframes_.rend()) {
-			auto& currentAnimation = keyframes_.front()->getPlaybackData()->get_animation();
+		if (keyframe_it != keyframes_.end()) {
+			auto& currentAnimation = keyframes_.front().getPlaybackData()->get_animation();
 			
 			// Looping backwards through the keyframes starting from the found keyframe
-			for (auto it = keyframe_it; it != keyframes_.rend(); ++it) {
-				if (&(*it)->getPlaybackData()->get_animation() != &currentAnimation) {
+			for (auto it = std::make_reverse_iterator(std::next(keyframe_it)); it != keyframes_.rend(); ++it) {
+				if (&it->getPlaybackData()->get_animation() != &currentAnimation) {
 					// If the animation has changed, reset the offset and break
 					mAnimationOffset = 0.0f;
 					break;
 				} else {
-					mAnimationOffset = (*it)->time;  // Set offset to the found keyframe's time
+					mAnimationOffset = it->time;  // Set offset to the found keyframe's time
 				}
 			}
 		}
 	}
 	
-	std::shared_ptr<PlaybackComponent::Keyframe> getPreviousPlayStateKeyframe(float fromTime) {
+	PlaybackComponent::Keyframe* getPreviousPlayStateKeyframe(float fromTime) {
 		for (auto it = keyframes_.rbegin(); it != keyframes_.rend(); ++it) {
-			auto kf = *it;
+			auto kf = &*it;
 			if (kf->time < fromTime && kf->getPlaybackState() == PlaybackState::Play) {
 				return kf;
 			}
@@ -521,10 +490,10 @@ private:
 		return nullptr;
 	}
 	
-	std::shared_ptr<PlaybackComponent::Keyframe> getPreviousPauseStateKeyframe(float fromTime) {
+	PlaybackComponent::Keyframe* getPreviousPauseStateKeyframe(float fromTime) {
 		for (auto it = keyframes_.rbegin(); it != keyframes_.rend(); ++it) {
 
-			auto kf = *it;
+			auto kf = &*it;
 			if (kf->time < fromTime && kf->getPlaybackState() == PlaybackState::Pause) {
 				return kf;
 			}
@@ -533,10 +502,10 @@ private:
 		return nullptr;
 	}
 	
-	std::shared_ptr<PlaybackComponent::Keyframe> getFirstButPreviousPauseStateKeyframe(float fromTime) {
-		std::shared_ptr<PlaybackComponent::Keyframe> keyframe;
+	PlaybackComponent::Keyframe* getFirstButPreviousPauseStateKeyframe(float fromTime) {
+		PlaybackComponent::Keyframe* keyframe = nullptr;
 		for (auto it = keyframes_.rbegin(); it != keyframes_.rend(); ++it) {
-			auto kf = *it;
+			auto kf = &*it;
 			if (kf->time < fromTime && kf->getPlaybackState() == PlaybackState::Play) {
 				return keyframe;
 			} else if (kf->time < fromTime) {
@@ -547,10 +516,10 @@ private:
 		return nullptr;
 	}
 	
-	std::shared_ptr<PlaybackComponent::Keyframe> getFirstButPreviousPlayStateKeyframe(float fromTime) {
-		std::shared_ptr<PlaybackComponent::Keyframe> keyframe;
+	PlaybackComponent::Keyframe* getFirstButPreviousPlayStateKeyframe(float fromTime) {
+		PlaybackComponent::Keyframe* keyframe = nullptr;
 		for (auto it = keyframes_.rbegin(); it != keyframes_.rend(); ++it) {
-			auto kf = *it;
+			auto kf = &*it;
 			if (kf->time < fromTime && kf->getPlaybackState() == PlaybackState::Pause) {
 				return keyframe;
 			} else if (kf->time < fromTime) {
@@ -562,43 +531,26 @@ private:
 	}
 	
 	// Blending two keyframes by interpolating each bone's transformation
-	void blend_keyframes(const std::shared_ptr<PlaybackComponent::Keyframe>& current,
-						 const std::shared_ptr<PlaybackComponent::Keyframe>& next,
+	void blend_keyframes(const PlaybackComponent::Keyframe& current,
+						 const PlaybackComponent::Keyframe& next,
 						 float time,
 						 float t) {
-		if (!current->getPlaybackData() || !next->getPlaybackData()) {
+		if (!current.getPlaybackData() || !next.getPlaybackData()) {
 			std::cerr << "Invalid playback data or animation in keyframes." << std::endl;
 			return;
 		}
 		
 		// Retrieving the associated animations
-		Animation& animationA = current->getPlaybackData()->get_animation();
-		Animation& animationB = next->getPlaybackData()->get_animation();
-		
-		// Getting the total number of bones from the skeleton
-		size_t numBones = mSkeletonComponent.get_skeleton().num_bones();
-		
-		// Initializing blended pose
-		std::vector<glm::mat4> blendedPose(numBones, glm::mat4(1.0f));
+		Animation& animationA = current.getPlaybackData()->get_animation();
+		Animation& animationB = next.getPlaybackData()->get_animation();
 		
-		const std::vector<Animation::KeyFrame> boneKeyframesA = animationA.evaluate_keyframes(time);
-		const std::vector<Animation::KeyFrame> boneKeyframesB = animationB.evaluate_keyframes(time);
-		
-		// Blending the two transformations based on factor t
-		for (size_t boneIndex = 0; boneIndex < numBones; ++boneIndex) {
-			auto blendedKeyframe = Animation::blendKeyframes(boneKeyframesA[boneIndex], boneKeyframesB[boneIndex], t);
-			
-			glm::mat4 translation_matrix = glm::translate(glm::mat4(1.0f), blendedKeyframe.translation);
-			glm::mat4 rotation_matrix = glm::mat4_cast(blendedKeyframe.rotation);
-			glm::mat4 scale_matrix = glm::scale(glm::mat4(1.0f), blendedKeyframe.scale);
-			
-			glm::mat4 bone_transform = translation_matrix * rotation_matrix * scale_matrix;
-			
-			blendedPose[boneIndex] = bone_transform;
-		}
+		// Crossfading as two weighted layers over the preallocated pose buffers
+		prepare_pose_buffers();
 		
-		// Updating the internal pose buffer
-		mModelPose = blendedPose;
+		mPoseBlender.clear_layers();
+		mPoseBlender.add_layer(animationA, time, 1.0f - t);
+		mPoseBlender.add_layer(animationB, time, t);
+		mPoseBlender.evaluate(mModelPose);
 		
 		// Applying the blended pose to the skeleton
 		apply_pose_to_skeleton();
@@ -690,6 +642,7 @@ private:
 	float mAnimationOffset; // Animation offset time
 	std::vector<glm::mat4> mModelPose; // Buffers to store poses
 	std::vector<glm::mat4> mDefaultPose;
-	std::vector<std::shared_ptr<PlaybackComponent::Keyframe>> keyframes_; // Keyframes for playback control
+	PoseBlender mPoseBlender; // Reused local-space buffers for sampling and blending
+	KeyframeTrack<PlaybackComponent::Keyframe> keyframes_; // Keyframes for playback control, ordered by time
 	PlaybackState mLastPlaybackState = PlaybackState::Pause; // Current state tracking
 };
@@ -80,7 +80,15 @@ public:
 		transform.scale = scale;
 		trigger_on_transform_changed();
 	}
-	
+
+	// Sets all three at once and notifies the callbacks a single time
+	void set_transform(const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale) {
+		transform.translation = translation;
+		transform.rotation = rotation;
+		transform.scale = scale;
+		trigger_on_transform_changed();
+	}
+
 	glm::vec3 get_translation() const {
 		return glm::vec3(transform.translation.x, transform.translation.y, transform.translation.z);
 	}
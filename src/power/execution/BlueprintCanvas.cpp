@@ -391,6 +391,8 @@ void BlueprintCanvas::clear() {
 	mActiveOutputPin = std::nullopt;
 	mVisualNodes.clear();
 	mLinks.clear();
+	mNodeSlots.clear();
+	mLinkSlots.clear();
 }
 
 void BlueprintCanvas::attach_popup() {
@@ -398,7 +400,7 @@ void BlueprintCanvas::attach_popup() {
 }
 
 void BlueprintCanvas::add_link(VisualPin& start, VisualPin& end) {
-	mLinks.push_back(std::move(std::make_unique<VisualLink>(start, end)));
+	store_link(std::make_unique<VisualLink>(start, end));
 	mOnCanvasModifiedCallback();
 }
 
@@ -412,21 +414,88 @@ void BlueprintCanvas::link(CorePin& start, CorePin& end) {
 	auto* start_pin = start_node->find_pin(start.id);
 	auto* end_pin = end_node->find_pin(end.id);
 	
-	mLinks.push_back(std::move(std::make_unique<VisualLink>(*start_pin, *end_pin)));
+	store_link(std::make_unique<VisualLink>(*start_pin, *end_pin));
 	mOnCanvasModifiedCallback();
 }
 
-VisualBlueprintNode* BlueprintCanvas::find_node(UUID id) {
+void BlueprintCanvas::unlink(CorePin& end) {
+	auto it = mLinkSlots.find(&end);
 	
-	auto node_it = std::find_if(mVisualNodes.begin(), mVisualNodes.end(), [id](auto& node) {
-		return node->core_node().id == id;
-	});
+	if (it == mLinkSlots.end()) {
+		return;
+	}
+	
+	// Swapped with the last link so removal does not shift the others
+	size_t slot = it->second;
+	mLinkSlots.erase(it);
+	
+	if (slot != mLinks.size() - 1) {
+		mLinks[slot] = std::move(mLinks.back());
+		mLinkSlots[&mLinks[slot]->get_end().core_pin()] = slot;
+	}
+	
+	mLinks.pop_back();
+	mOnCanvasModifiedCallback();
+}
+
+void BlueprintCanvas::remove_node(UUID id) {
+	auto it = mNodeSlots.find(id);
+	
+	if (it == mNodeSlots.end()) {
+		return;
+	}
+	
+	size_t slot = it->second;
+	mNodeSlots.erase(it);
+	
+	VisualBlueprintNode& node = *mVisualNodes[slot];
+	node.core_node().set_position(node.position());
+	
+	if (mSelectedNode == &node) {
+		mSelectedNode = nullptr;
+	}
+	
+	if ((mActiveOutputPin && &mActiveOutputPin->get().node() == &node.core_node()) ||
+		(mActiveInputPin && &mActiveInputPin->get().node() == &node.core_node())) {
+		mActiveOutputPin = std::nullopt;
+		mActiveInputPin = std::nullopt;
+	}
 	
-	if (node_it != mVisualNodes.end()) {
-		return node_it->get();
+	remove_child(node);
+	
+	if (slot != mVisualNodes.size() - 1) {
+		mVisualNodes[slot] = std::move(mVisualNodes.back());
+		mNodeSlots[mVisualNodes[slot]->core_node().id] = slot;
 	}
 	
-	return nullptr;
+	mVisualNodes.pop_back();
+	mOnCanvasModifiedCallback();
+}
+
+void BlueprintCanvas::layout_node(VisualBlueprintNode& node) {
+	NVGcontext* ctx = screen().nvg_context();
+	
+	// As Widget::perform_layout sizes children without a layout
+	nanogui::Vector2i preferred = node.preferred_size(ctx);
+	nanogui::Vector2i fixed = node.fixed_size();
+	node.set_size(nanogui::Vector2i(fixed[0] ? fixed[0] : preferred[0], fixed[1] ? fixed[1] : preferred[1]));
+	static_cast<nanogui::Widget&>(node).perform_layout(ctx);
+}
+
+void BlueprintCanvas::store_link(std::unique_ptr<VisualLink> link) {
+	mLinkSlots[&link->get_end().core_pin()] = mLinks.size();
+	mLinks.push_back(std::move(link));
+}
+
+void BlueprintCanvas::store_node_positions() {
+	for (auto& node : mVisualNodes) {
+		node->core_node().set_position(node->position());
+	}
+}
+
+VisualBlueprintNode* BlueprintCanvas::find_node(UUID id) {
+	auto it = mNodeSlots.find(id);
+	return it != mNodeSlots.end() ? mVisualNodes[it->second].get() : nullptr;
 }
 
 bool BlueprintCanvas::keyboard_event(int key, int scancode, int action, int modifiers) {
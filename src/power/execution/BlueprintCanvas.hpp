@@ -8,6 +8,7 @@
 
 #include <optional>
 #include <functional>
+#include <unordered_map>
 
 class ScenePanel;
 class ShaderManager;
@@ -37,6 +38,18 @@ public:
 	void add_link(VisualPin& start, VisualPin& end);
 
 	void link(CorePin& start, CorePin& end);
+	
+	// Removes the visual link ending at the input pin, if any
+	void unlink(CorePin& end);
+	
+	// Removes the node's widget, first storing its position into the core node; links to it must be unlinked first
+	void remove_node(UUID id);
+	
+	// Sizes and lays out one node, so a node spawned into a laid out canvas does not relayout the rest
+	void layout_node(VisualBlueprintNode& node);
+	
+	// Writes where each visual node currently sits back into its core node
+	void store_node_positions();
 
 	VisualBlueprintNode* selected_node() {
 		return mSelectedNode;
@@ -48,10 +61,13 @@ public:
 	
 	
 	template<typename T, typename U>
-	void spawn_node(nanogui::Vector2i position, U& coreNode) {
+	T& spawn_node(nanogui::Vector2i position, U& coreNode) {
 		auto node = std::make_unique<T>(*this, position, nanogui::Vector2i(196, 244), coreNode);
+		T& node_ref = *node;
+		mNodeSlots[coreNode.id] = mVisualNodes.size();
 		mVisualNodes.push_back(std::move(node));
 		mOnCanvasModifiedCallback();
+		return node_ref;
 	}
 	
 	void on_modified() {
@@ -75,6 +91,8 @@ private:
 	void setup_options();
 	
 	VisualBlueprintNode* find_node(UUID id);
+	
+	void store_link(std::unique_ptr<VisualLink> link);
 
 private:
 	std::unique_ptr<ShaderManager> mShaderManager;
@@ -97,6 +115,10 @@ private:
 	std::vector<std::unique_ptr<VisualBlueprintNode>> mVisualNodes;
 	
 	std::vector<std::unique_ptr<VisualLink>> mLinks;
+	
+	// Positions in mVisualNodes by core node id, and in mLinks by the core input pin, which takes one link at most
+	std::unordered_map<UUID, size_t> mNodeSlots;
+	std::unordered_map<const CorePin*, size_t> mLinkSlots;
 
 	nanogui::Vector2i mMousePosition;
 	
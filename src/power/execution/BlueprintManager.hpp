@@ -41,6 +41,8 @@ public:
 		
 		mCanvas->set_fixed_size(nanogui::Vector2i(fixed_width(), parent.fixed_height() * 0.71));
 		
+		mNodeProcessor->attach_journal(mActorManager.journal(), *mCanvas);
+		
 		mBlueprintButton = std::make_shared<nanogui::Button>(parent, "", FA_FLASK);
 		
 		mBlueprintButton->set_fixed_size(nanogui::Vector2i(48, 48));
@@ -240,7 +242,11 @@ public:
 	}
 	
 	void start() {
-		mBlueprintActors = mActorManager.get_actors_with_component<BlueprintComponent>();
+		mBlueprintActors.clear();
+		
+		for (auto& actor : mActorManager.query<BlueprintComponent>()) {
+			mBlueprintActors.push_back(mActorManager.handle_of(actor));
+		}
 	}
 	
 	void stop() {
@@ -269,7 +275,8 @@ private:
 
 	std::optional<std::reference_wrapper<Actor>> mActiveActor;
 	
-	std::vector<std::reference_wrapper<Actor>> mBlueprintActors;
+	// Handles, so actors deleted while blueprints run are skipped rather than left dangling
+	std::vector<ActorHandle> mBlueprintActors;
 
 	bool mCommitted;
 	bool mDisplaying;
@@ -63,6 +63,8 @@ public:
 		
 		mBlueprintManager.process_events();
 		
+		mSimulationServer.process_commands();
+		
 		if (mExecutionMode == EExecutionMode::Game || mExecutionMode == EExecutionMode::Laboratory) {
 			mSimulationTime++; // will overflow in a few million of years. Maybe adding a two/x+-variable timer? Just in case.
 			
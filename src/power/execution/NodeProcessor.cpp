@@ -2,14 +2,119 @@
 #include "execution/BlueprintCanvas.hpp"
 #include "actors/Actor.hpp"
 #include "components/BlueprintComponent.hpp"
+#include "history/UndoJournal.hpp"
 #include "serialization/UUID.hpp"
 
+#include <nanogui/screen.h>
+
 // --- Include all concrete node types we can spawn ---
 #include "KeyPressNode.hpp"
 #include "KeyReleaseNode.hpp"
 #include "ReflectedNode.hpp"
 
 
+/**
+ * @brief Undo entry for nodes and links entering or leaving the graph.
+ *
+ * Whichever side is currently out of the graph is held here, so toggling only
+ * moves the affected nodes and links, and their widgets on the canvas, and
+ * never touches the rest of the graph.
+ */
+class NodeProcessor::GraphEdit : public UndoJournal::Entry {
+public:
+	GraphEdit(NodeProcessor& processor, std::vector<UUID> nodeIds, std::vector<std::unique_ptr<Link>> removedLinks)
+	: m_processor(processor)
+	, m_generation(processor.m_generation)
+	, m_node_ids(std::move(nodeIds))
+	, m_present(removedLinks.empty()) {
+		for (auto& link : removedLinks) {
+			m_link_ids.push_back(link->get_id());
+		}
+		m_parked_links = std::move(removedLinks);
+	}
+	
+	GraphEdit(NodeProcessor& processor, std::vector<UUID> nodeIds, std::vector<UUID> linkIds)
+	: m_processor(processor)
+	, m_generation(processor.m_generation)
+	, m_node_ids(std::move(nodeIds))
+	, m_link_ids(std::move(linkIds))
+	, m_present(true) {
+	}
+	
+	bool apply() override {
+		return toggle();
+	}
+	
+	bool revert() override {
+		return toggle();
+	}
+	
+	size_t memory_size() const override {
+		return sizeof(*this) + (m_node_ids.capacity() + m_link_ids.capacity()) * sizeof(UUID) +
+			m_parked_nodes.size() * sizeof(CoreNode) + m_parked_links.size() * sizeof(Link);
+	}
+	
+private:
+	bool toggle() {
+		if (m_processor.m_generation != m_generation) {
+			return false;
+		}
+		
+		BlueprintCanvas* canvas = m_processor.m_canvas;
+		
+		if (m_present) {
+			// Links hold pins of the nodes, they leave first and come back last
+			for (UUID id : m_link_ids) {
+				if (auto link = m_processor.take_link(id)) {
+					if (canvas) {
+						canvas->unlink(link->get_end());
+					}
+					m_parked_links.push_back(std::move(link));
+				}
+			}
+			for (UUID id : m_node_ids) {
+				if (auto node = m_processor.take_node(id)) {
+					if (canvas) {
+						canvas->remove_node(id);
+					}
+					m_parked_nodes.push_back(std::move(node));
+				}
+			}
+		} else {
+			for (auto& node : m_parked_nodes) {
+				CoreNode& restored = m_processor.store_node(std::move(node));
+				
+				if (canvas) {
+					if (auto* visual = m_processor.spawn_visual_node(*canvas, restored)) {
+						canvas->layout_node(*visual);
+					}
+				}
+			}
+			for (auto& link : m_parked_links) {
+				Link& restored = *link;
+				m_processor.restore_link(std::move(link));
+				
+				if (canvas) {
+					canvas->link(restored.get_start(), restored.get_end());
+				}
+			}
+			m_parked_nodes.clear();
+			m_parked_links.clear();
+		}
+		
+		m_present = !m_present;
+		return true;
+	}
+	
+	NodeProcessor& m_processor;
+	uint64_t m_generation;
+	std::vector<UUID> m_node_ids;
+	std::vector<UUID> m_link_ids;
+	std::vector<std::unique_ptr<CoreNode>> m_parked_nodes;
+	std::vector<std::unique_ptr<Link>> m_parked_links;
+	bool m_present;
+};
+
 NodeProcessor::NodeProcessor() {
 	// 1. Register hardcoded, non-reflected nodes (like events).
 	m_creators["KeyPress"] = [](UUID id) {
@@ -46,9 +151,7 @@ void NodeProcessor::build_node(CoreNode& node){
 
 void NodeProcessor::break_links(CoreNode& node) {
 	
-	
-	std::vector<Link*> links_to_remove;
-	
+	std::vector<UUID> link_ids;
 	
 	for (auto& link : links) {
 		
@@ -59,28 +162,37 @@ void NodeProcessor::break_links(CoreNode& node) {
 		
 		if (&start_pin.node == &node || &end_pin.node == &node) {
 			
-			links_to_remove.push_back(link.get());
+			link_ids.push_back(link->get_id());
 			
 		}
 		
 	}
 	
 	
-	links.erase(
-				
-				std::remove_if(links.begin(), links.end(),
-							   
-							   [&links_to_remove](const std::unique_ptr<Link>& link) {
-								   
-								   return std::find(links_to_remove.begin(), links_to_remove.end(), link.get()) != links_to_remove.end();
-								   
-							   }
-							   
-							   ),
+	std::vector<std::unique_ptr<Link>> removed_links;
+	
+	for (UUID id : link_ids) {
+		
+		if (auto link = take_link(id)) {
+			
+			if (m_canvas) {
 				
-				links.end()
+				m_canvas->unlink(link->get_end());
 				
-				);
+			}
+			
+			removed_links.push_back(std::move(link));
+			
+		}
+		
+	}
+	
+	
+	if (m_journal && !removed_links.empty()) {
+		
+		m_journal->record(std::make_unique<GraphEdit>(*this, std::vector<UUID>{}, std::move(removed_links)));
+		
+	}
 	
 }
 
@@ -94,14 +206,85 @@ std::unique_ptr<CoreNode> NodeProcessor::create_node(const std::string& type_nam
 }
 
 CoreNode& NodeProcessor::add_node(std::unique_ptr<CoreNode> node) {
+	CoreNode& ref = store_node(std::move(node));
+	
+	if (m_journal) {
+		m_journal->record(std::make_unique<GraphEdit>(*this, std::vector<UUID>{ref.id}, std::vector<UUID>{}));
+	}
+	return ref;
+}
+
+CoreNode& NodeProcessor::store_node(std::unique_ptr<CoreNode> node) {
 	if (!node) {
 		throw std::runtime_error("Attempted to add a null node to NodeProcessor.");
 	}
 	CoreNode& ref = *node;
+	m_node_slots[ref.id] = nodes.size();
 	nodes.push_back(std::move(node));
 	return ref;
 }
 
+std::unique_ptr<CoreNode> NodeProcessor::take_node(UUID id) {
+	auto it = m_node_slots.find(id);
+	
+	if (it == m_node_slots.end()) {
+		return nullptr;
+	}
+	
+	size_t slot = it->second;
+	m_node_slots.erase(it);
+	
+	std::unique_ptr<CoreNode> node = std::move(nodes[slot]);
+	
+	if (slot != nodes.size() - 1) {
+		nodes[slot] = std::move(nodes.back());
+		m_node_slots[nodes[slot]->id] = slot;
+	}
+	
+	nodes.pop_back();
+	return node;
+}
+
+Link& NodeProcessor::store_link(std::unique_ptr<Link> link) {
+	Link& ref = *link;
+	m_link_slots[ref.get_id()] = links.size();
+	links.push_back(std::move(link));
+	return ref;
+}
+
+std::unique_ptr<Link> NodeProcessor::take_link(UUID id) {
+	auto it = m_link_slots.find(id);
+	
+	if (it == m_link_slots.end()) {
+		return nullptr;
+	}
+	
+	size_t slot = it->second;
+	m_link_slots.erase(it);
+	
+	std::unique_ptr<Link> link = std::move(links[slot]);
+	
+	if (slot != links.size() - 1) {
+		links[slot] = std::move(links.back());
+		m_link_slots[links[slot]->get_id()] = slot;
+	}
+	
+	links.pop_back();
+	
+	// Pins must not keep pointing at a link that left the graph
+	for (CorePin* pin : {&link->get_start(), &link->get_end()}) {
+		std::erase(pin->links, link.get());
+	}
+	
+	return link;
+}
+
+void NodeProcessor::restore_link(std::unique_ptr<Link> link) {
+	link->get_start().links.push_back(link.get());
+	link->get_end().links.push_back(link.get());
+	store_link(std::move(link));
+}
+
 void NodeProcessor::serialize(BlueprintCanvas& canvas, Actor& actor) {
 	auto runtime_processor = std::make_unique<NodeProcessor>();
 	
@@ -172,13 +355,9 @@ void NodeProcessor::deserialize(BlueprintCanvas& canvas, Actor& actor) {
 			}
 			
 			// Spawn the corresponding VISUAL node on the canvas.
-			if (auto* reflected_core = dynamic_cast<ReflectedCoreNode*>(new_node.get())) {
-				canvas.spawn_node<ReflectedVisualNode>(new_node->position, *reflected_core);
-			} else if (auto* keypress_core = dynamic_cast<KeyPressCoreNode*>(new_node.get())) {
-				canvas.spawn_node<KeyPressVisualNode>(new_node->position, *keypress_core);
-			} // ... add else-if for other non-reflected visual node types.
+			spawn_visual_node(canvas, *new_node);
 			
-			this->add_node(std::move(new_node));
+			this->store_node(std::move(new_node));
 		}
 	}
 	
@@ -208,26 +387,44 @@ void NodeProcessor::create_link(UUID id, CorePin& output, CorePin& input){
 	auto link = std::make_unique<Link>(id, output, input);
 	output.links.push_back(link.get());
 	input.links.push_back(link.get());
-	links.push_back(std::move(link));
+	store_link(std::move(link));
 }
 
 void NodeProcessor::create_link(BlueprintCanvas& canvas, UUID id, VisualPin& output, VisualPin& input){
 	auto link = std::make_unique<Link>(id, output.core_pin(), input.core_pin());
 	output.core_pin().links.push_back(link.get());
 	input.core_pin().links.push_back(link.get());
-	links.push_back(std::move(link));
+	store_link(std::move(link));
 	canvas.add_link(output, input);
+	
+	if (m_journal) {
+		m_journal->record(std::make_unique<GraphEdit>(*this, std::vector<UUID>{}, std::vector<UUID>{id}));
+	}
 }
 
 CoreNode* NodeProcessor::find_node(UUID id) {
-	auto it = std::find_if(nodes.begin(), nodes.end(),
-						   [id](const std::unique_ptr<CoreNode>& node) {
-		return node->id == id;
-	});
-	return (it != nodes.end()) ? it->get() : nullptr;
+	auto it = m_node_slots.find(id);
+	return (it != m_node_slots.end()) ? nodes[it->second].get() : nullptr;
 }
 
 void NodeProcessor::clear() {
 	nodes.clear();
 	links.clear();
+	m_node_slots.clear();
+	m_link_slots.clear();
+	++m_generation;
+}
+
+void NodeProcessor::attach_journal(UndoJournal& journal, BlueprintCanvas& canvas) {
+	m_journal = &journal;
+	m_canvas = &canvas;
+}
+
+VisualBlueprintNode* NodeProcessor::spawn_visual_node(BlueprintCanvas& canvas, CoreNode& node) {
+	if (auto* reflected_core = dynamic_cast<ReflectedCoreNode*>(&node)) {
+		return &canvas.spawn_node<ReflectedVisualNode>(node.position, *reflected_core);
+	} else if (auto* keypress_core = dynamic_cast<KeyPressCoreNode*>(&node)) {
+		return &canvas.spawn_node<KeyPressVisualNode>(node.position, *keypress_core);
+	} // ... add else-if for other non-reflected visual node types.
+	return nullptr;
 }
@@ -8,12 +8,15 @@
 #include <string>
 #include <functional>
 #include <map>
+#include <unordered_map>
 #include <algorithm>
 #include <any>
 
 // Forward declarations
 class Actor;
 class BlueprintCanvas;
+class UndoJournal;
+class VisualBlueprintNode;
 
 /**
  * @class NodeProcessor
@@ -66,9 +69,18 @@ public:
 	
 	/**
 	 * @brief Clears all nodes and links from the processor.
+	 * Undo entries recorded for the previous graph stop applying.
 	 */
 	void clear();
 	
+	/**
+	 * @brief Records node additions, new links and broken links made through the editor.
+	 * Undo and redo add or remove only the affected visual nodes and links on the canvas.
+	 * @param journal The history the edits are recorded in.
+	 * @param canvas The canvas showing this processor's graph.
+	 */
+	void attach_journal(UndoJournal& journal, BlueprintCanvas& canvas);
+	
 	// --- Restored Helper Methods ---
 	
 	long long get_next_id();
@@ -80,7 +92,7 @@ public:
 		auto node = std::make_unique<T>(id);
 		build_node(*node);
 		T& node_ref = *node;
-		nodes.push_back(std::move(node));
+		store_node(std::move(node));
 		return node_ref;
 	}
 	
@@ -97,6 +109,16 @@ private:
 	// A function that can create a CoreNode.
 	using CreatorFunc = std::function<std::unique_ptr<CoreNode>(UUID)>;
 	
+	class GraphEdit;
+	
+	CoreNode& store_node(std::unique_ptr<CoreNode> node);
+	std::unique_ptr<CoreNode> take_node(UUID id);
+	std::unique_ptr<Link> take_link(UUID id);
+	Link& store_link(std::unique_ptr<Link> link);
+	void restore_link(std::unique_ptr<Link> link);
+	
+	VisualBlueprintNode* spawn_visual_node(BlueprintCanvas& canvas, CoreNode& node);
+	
 private:
 	// Maps a string name to a function that can create the corresponding node.
 	std::map<std::string, CreatorFunc> m_creators;
@@ -105,5 +127,15 @@ private:
 	std::vector<std::unique_ptr<CoreNode>> nodes;
 	std::vector<std::unique_ptr<Link>> links;
 	
+	// Positions in nodes and links by id; removal swaps the last entry into the hole
+	std::unordered_map<UUID, size_t> m_node_slots;
+	std::unordered_map<UUID, size_t> m_link_slots;
+	
+	UndoJournal* m_journal = nullptr;
+	BlueprintCanvas* m_canvas = nullptr;
+	
+	// Bumped by clear() so entries recorded against an unloaded graph turn stale
+	uint64_t m_generation = 0;
+	
 	friend class BlueprintSerializer;
 };
@@ -18,25 +18,22 @@
 #include <future>
 #include <mutex>
 
-#include <openssl/md5.h>
+#include "filesystem/ContentHash.hpp"
+#include "profiling/MemoryTracker.hpp"
 
 class Hash32 {
 public:
-	// Generates a 32-bit CRC32 hash from the provided compressed data
+	// Generates a 32-bit CRC32 hash from the provided compressed data, streamed from its buffer without copying it
 	static uint32_t generate_crc32_from_compressed_data(const std::stringstream& compressedData) {
-		// Convert the stringstream to a string
-		std::string data = compressedData.str();
+		ContentHasher hasher(ContentHash::Crc32);
+		hasher.update(*compressedData.rdbuf());
 		
-		// Compute CRC32 using zlib
-		uint32_t crc = crc32(0L, Z_NULL, 0); // Initialize CRC
-		crc = crc32(crc, reinterpret_cast<const Bytef*>(data.c_str()), data.size());
-		
-		return crc;
+		return hasher.finish().crc;
 	}
 	
 	// Optional: Generates a CRC32 hash from a string directly
 	static uint32_t generate_crc32_from_string(const std::string& data) {
-		return crc32(0L, reinterpret_cast<const Bytef*>(data.c_str()), data.size());
+		return ContentHasher::hash(data.data(), data.size(), ContentHash::Crc32).crc;
 	}
 };
 
@@ -44,26 +41,12 @@ class Md5 {
 public:
 	static
 	void generate_md5_from_compressed_data(std::stringstream& compressedData, uint64_t hash_id[2]) {
-		// Convert the stringstream to a string
-		std::string data = compressedData.str();
-		
-		// Create an MD5 digest array (16 bytes for 128 bits)
-		unsigned char digest[MD5_DIGEST_LENGTH];
-		
-		// Perform the MD5 hashing
-		MD5(reinterpret_cast<const unsigned char*>(data.c_str()), data.size(), digest);
+		// Streamed from the buffer in blocks rather than copied out with str()
+		ContentHasher hasher(ContentHash::Md5);
+		hasher.update(*compressedData.rdbuf());
 		
-		// First 8 bytes of the digest go into hash_id[0]
-		hash_id[0] = 0;
-		for (int i = 0; i < 8; ++i) {
-			hash_id[0] = (hash_id[0] << 8) | digest[i];
-		}
-		
-		// Next 8 bytes of the digest go into hash_id[1]
-		hash_id[1] = 0;
-		for (int i = 8; i < 16; ++i) {
-			hash_id[1] = (hash_id[1] << 8) | digest[i];
-		}
+		// First 8 bytes of the digest go into hash_id[0], the next 8 into hash_id[1]
+		hasher.finish().md5_words(hash_id);
 	}
 };
 
@@ -579,6 +562,9 @@ public:
 				}
 			}
 			
+			TrackedMemory compressedMemory(MemoryTracker::Tag::Serialization,
+										   std::accumulate(compressedSizes.begin(), compressedSizes.end(), static_cast<uint64_t>(0)));
+			
 			// Write compression metadata and compressed data to the stream
 			// Structure:
 			// [numThreads][compressedSizes][uncompressedSizes][compressedData]
@@ -649,11 +635,13 @@ public:
 	private:
 		std::vector<char> buffer; // Main buffer
 		std::vector<char> header; // Header buffer
+		TrackedMemory memory{MemoryTracker::Tag::Serialization};
 		
 		// Helper method to write raw data to a specified buffer
-		void write_data(const void* data, size_t size, std::vector<char>& targetBuffer) const {
+		void write_data(const void* data, size_t size, std::vector<char>& targetBuffer) {
 			const char* bytes = static_cast<const char*>(data);
 			targetBuffer.insert(targetBuffer.end(), bytes, bytes + size);
+			memory.set(tracked_capacity(buffer) + tracked_capacity(header));
 		}
 	};
 	
@@ -916,6 +904,18 @@ public:
 		
 		std::vector<char> header; // Header buffer
 		size_t readHeaderOffset = 0;
+		TrackedMemory memory{MemoryTracker::Tag::Serialization};
+		
+		void update_memory_usage() {
+			uint64_t bytes = tracked_capacity(decompressedData) + tracked_capacity(header);
+			for (const auto& chunk : compressedChunks) {
+				bytes += tracked_capacity(chunk);
+			}
+			for (const auto& chunk : decompressedChunks) {
+				bytes += tracked_capacity(chunk);
+			}
+			memory.set(bytes);
+		}
 		
 		// Helper method to read raw data from the main decompressed buffer
 		bool read_data(void* data, size_t size) {
@@ -1050,6 +1050,7 @@ public:
 			
 			// Initialize read offset after decompression
 			readOffsetTotal = 0;
+			update_memory_usage();
 			return true;
 		}
 	};
@@ -0,0 +1,251 @@
+#include "ContentHash.hpp"
+
+#include <openssl/evp.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+namespace {
+constexpr uint64_t kXxhPrime1 = 0x9E3779B185EBCA87ull;
+constexpr uint64_t kXxhPrime2 = 0xC2B2AE3D27D4EB4Full;
+constexpr uint64_t kXxhPrime3 = 0x165667B19E3779F9ull;
+constexpr uint64_t kXxhPrime4 = 0x85EBCA77C2B2AE63ull;
+constexpr uint64_t kXxhPrime5 = 0x27D4EB2F165667C5ull;
+
+uint64_t xxh_rotate(uint64_t value, int bits) {
+	return (value << bits) | (value >> (64 - bits));
+}
+
+// Little endian, which every platform the engine ships on is
+uint64_t xxh_read64(const uint8_t* data) {
+	uint64_t value;
+	std::memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+uint32_t xxh_read32(const uint8_t* data) {
+	uint32_t value;
+	std::memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+uint64_t xxh_round(uint64_t lane, uint64_t input) {
+	lane += input * kXxhPrime2;
+	lane = xxh_rotate(lane, 31);
+	return lane * kXxhPrime1;
+}
+
+uint64_t xxh_merge(uint64_t hash, uint64_t lane) {
+	hash ^= xxh_round(0, lane);
+	return hash * kXxhPrime1 + kXxhPrime4;
+}
+} // unnamed namespace
+
+std::string ContentHash::md5_hex() const {
+	std::ostringstream hex;
+	for (uint8_t byte : md5) {
+		hex << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(byte);
+	}
+	return hex.str();
+}
+
+void ContentHash::md5_words(uint64_t words[2]) const {
+	words[0] = 0;
+	words[1] = 0;
+	for (int i = 0; i < 8; ++i) {
+		words[0] = (words[0] << 8) | md5[i];
+		words[1] = (words[1] << 8) | md5[i + 8];
+	}
+}
+
+ContentHasher::ContentHasher(uint32_t algorithms)
+: mAlgorithms(algorithms)
+, mCrc(crc32(0L, Z_NULL, 0)) {
+	mLanes[0] = kXxhPrime1 + kXxhPrime2;
+	mLanes[1] = kXxhPrime2;
+	mLanes[2] = 0;
+	mLanes[3] = 0 - kXxhPrime1;
+
+	if (mAlgorithms & ContentHash::Md5) {
+		mMd5 = EVP_MD_CTX_new();
+
+		if (mMd5 && EVP_DigestInit_ex(mMd5, EVP_md5(), nullptr) != 1) {
+			EVP_MD_CTX_free(mMd5);
+			mMd5 = nullptr;
+		}
+	}
+}
+
+ContentHasher::~ContentHasher() {
+	EVP_MD_CTX_free(mMd5);
+}
+
+void ContentHasher::update(const void* data, size_t size) {
+	const auto* bytes = static_cast<const uint8_t*>(data);
+
+	if (mAlgorithms & ContentHash::Crc32) {
+		// crc32 takes a 32-bit length
+		for (size_t offset = 0; offset < size; offset += kBlockSize) {
+			size_t count = std::min(kBlockSize, size - offset);
+			mCrc = static_cast<uint32_t>(crc32(mCrc, bytes + offset, static_cast<uInt>(count)));
+		}
+	}
+
+	if (mMd5) {
+		EVP_DigestUpdate(mMd5, bytes, size);
+	}
+
+	if (!(mAlgorithms & ContentHash::Fast)) {
+		return;
+	}
+
+	mLength += size;
+
+	if (mPendingSize > 0) {
+		size_t count = std::min(sizeof(mPending) - mPendingSize, size);
+		std::memcpy(mPending + mPendingSize, bytes, count);
+		mPendingSize += count;
+		bytes += count;
+		size -= count;
+
+		if (mPendingSize < sizeof(mPending)) {
+			return;
+		}
+
+		consume_stripes(mPending, 1);
+		mPendingSize = 0;
+	}
+
+	size_t stripes = size / sizeof(mPending);
+	consume_stripes(bytes, stripes);
+	bytes += stripes * sizeof(mPending);
+	size -= stripes * sizeof(mPending);
+
+	std::memcpy(mPending, bytes, size);
+	mPendingSize = size;
+}
+
+void ContentHasher::update(std::streambuf& buffer) {
+	auto position = buffer.pubseekoff(0, std::ios::cur, std::ios::in);
+
+	if (buffer.pubseekpos(0, std::ios::in) != std::streampos(0)) {
+		return;
+	}
+
+	std::vector<char> block(kBlockSize);
+
+	for (std::streamsize count; (count = buffer.sgetn(block.data(), static_cast<std::streamsize>(block.size()))) > 0;) {
+		update(block.data(), static_cast<size_t>(count));
+	}
+
+	buffer.pubseekpos(position, std::ios::in);
+}
+
+ContentHash ContentHasher::finish() {
+	ContentHash result;
+
+	if (mAlgorithms & ContentHash::Fast) {
+		uint64_t hash;
+
+		if (mLength >= sizeof(mPending)) {
+			hash = xxh_rotate(mLanes[0], 1) + xxh_rotate(mLanes[1], 7) + xxh_rotate(mLanes[2], 12) + xxh_rotate(mLanes[3], 18);
+			for (uint64_t lane : mLanes) {
+				hash = xxh_merge(hash, lane);
+			}
+		} else {
+			hash = kXxhPrime5;
+		}
+
+		hash += mLength;
+
+		const uint8_t* tail = mPending;
+		size_t remaining = mPendingSize;
+
+		for (; remaining >= 8; tail += 8, remaining -= 8) {
+			hash ^= xxh_round(0, xxh_read64(tail));
+			hash = xxh_rotate(hash, 27) * kXxhPrime1 + kXxhPrime4;
+		}
+
+		if (remaining >= 4) {
+			hash ^= static_cast<uint64_t>(xxh_read32(tail)) * kXxhPrime1;
+			hash = xxh_rotate(hash, 23) * kXxhPrime2 + kXxhPrime3;
+			tail += 4;
+			remaining -= 4;
+		}
+
+		for (; remaining > 0; ++tail, --remaining) {
+			hash ^= *tail * kXxhPrime5;
+			hash = xxh_rotate(hash, 11) * kXxhPrime1;
+		}
+
+		hash ^= hash >> 33;
+		hash *= kXxhPrime2;
+		hash ^= hash >> 29;
+		hash *= kXxhPrime3;
+		hash ^= hash >> 32;
+
+		result.fast = hash;
+	}
+
+	if (mAlgorithms & ContentHash::Crc32) {
+		result.crc = mCrc;
+	}
+
+	if (mMd5) {
+		unsigned char digest[EVP_MAX_MD_SIZE];
+		unsigned int digestLength = 0;
+
+		if (EVP_DigestFinal_ex(mMd5, digest, &digestLength) == 1 && digestLength == result.md5.size()) {
+			std::memcpy(result.md5.data(), digest, result.md5.size());
+		}
+	}
+
+	return result;
+}
+
+ContentHash ContentHasher::hash(const void* data, size_t size, uint32_t algorithms) {
+	ContentHasher hasher(algorithms);
+	hasher.update(data, size);
+	return hasher.finish();
+}
+
+bool ContentHasher::hash_file(const std::string& path, ContentHash& hash, uint32_t algorithms) {
+	std::ifstream stream(path, std::ios::binary);
+
+	if (!stream.is_open()) {
+		return false;
+	}
+
+	ContentHasher hasher(algorithms);
+	std::vector<char> block(kBlockSize);
+
+	while (stream) {
+		stream.read(block.data(), block.size());
+		std::streamsize count = stream.gcount();
+
+		if (count > 0) {
+			hasher.update(block.data(), static_cast<size_t>(count));
+		}
+	}
+
+	if (stream.bad()) {
+		return false;
+	}
+
+	hash = hasher.finish();
+	return true;
+}
+
+void ContentHasher::consume_stripes(const uint8_t* data, size_t count) {
+	for (size_t stripe = 0; stripe < count; ++stripe, data += sizeof(mPending)) {
+		mLanes[0] = xxh_round(mLanes[0], xxh_read64(data));
+		mLanes[1] = xxh_round(mLanes[1], xxh_read64(data + 8));
+		mLanes[2] = xxh_round(mLanes[2], xxh_read64(data + 16));
+		mLanes[3] = xxh_round(mLanes[3], xxh_read64(data + 24));
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <streambuf>
+#include <string>
+
+struct evp_md_ctx_st;
+
+/**
+ * @brief Digests of a block of content, computed together in one pass.
+ *
+ * fast is XXH64, for identity checks where collisions only cost a redundant
+ * rebuild. crc and md5 match Hash32 and Md5 in CompressedSerialization.hpp and
+ * the hex MD5 keys of the thumbnail and texture caches.
+ */
+struct ContentHash {
+	enum Algorithm : uint32_t {
+		Fast = 1 << 0,
+		Crc32 = 1 << 1,
+		Md5 = 1 << 2,
+		All = Fast | Crc32 | Md5
+	};
+
+	uint64_t fast = 0;
+	uint32_t crc = 0;
+	std::array<uint8_t, 16> md5{};
+
+	std::string md5_hex() const;
+
+	// Big-endian halves of the MD5, as Md5::generate_md5_from_compressed_data packs them
+	void md5_words(uint64_t words[2]) const;
+};
+
+/**
+ * @brief Incremental hasher over any number of update() calls.
+ *
+ * Files and stream buffers are read in kBlockSize blocks, so nothing is ever
+ * held or copied whole. Only the selected algorithms are computed; the others
+ * are left zero in the result.
+ */
+class ContentHasher {
+public:
+	static constexpr size_t kBlockSize = 1 << 20;
+
+	explicit ContentHasher(uint32_t algorithms = ContentHash::All);
+	~ContentHasher();
+
+	ContentHasher(const ContentHasher&) = delete;
+	ContentHasher& operator=(const ContentHasher&) = delete;
+
+	void update(const void* data, size_t size);
+
+	// Everything the buffer holds from its start, as str() would return it, without copying it; restores the read position
+	void update(std::streambuf& buffer);
+
+	ContentHash finish();
+
+	static ContentHash hash(const void* data, size_t size, uint32_t algorithms = ContentHash::All);
+
+	// False when the file cannot be read; see HashCache to skip files hashed before
+	static bool hash_file(const std::string& path, ContentHash& hash, uint32_t algorithms = ContentHash::All);
+
+private:
+	void consume_stripes(const uint8_t* data, size_t count);
+
+	uint32_t mAlgorithms;
+
+	// XXH64 state: four lanes over 32 byte stripes, plus the partial stripe
+	uint64_t mLanes[4];
+	uint8_t mPending[32];
+	size_t mPendingSize = 0;
+	uint64_t mLength = 0;
+
+	uint32_t mCrc;
+	evp_md_ctx_st* mMd5 = nullptr;
+};
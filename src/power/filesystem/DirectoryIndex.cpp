@@ -0,0 +1,624 @@
+#include "DirectoryIndex.hpp"
+
+#include "profiling/Profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+constexpr uint32_t kCacheMagic = 0x58494450; // "PDIX"
+constexpr uint32_t kCacheVersion = 1;
+
+// Minimum spacing between snapshots while a burst of changes is arriving
+constexpr auto kPublishInterval = std::chrono::milliseconds(100);
+constexpr auto kCacheSaveInterval = std::chrono::seconds(5);
+// Without change notifications the tree is rescanned on this period
+constexpr auto kRescanInterval = std::chrono::seconds(5);
+constexpr int kPollTimeoutMs = 100;
+
+bool make_entry(const fs::directory_entry& directoryEntry, DirectoryIndex::Entry& entry) {
+	std::error_code error;
+
+	entry.path = directoryEntry.path().string();
+	entry.is_directory = directoryEntry.is_directory(error);
+
+	if (error) {
+		return false;
+	}
+
+	entry.size = 0;
+	if (!entry.is_directory && directoryEntry.is_regular_file(error)) {
+		entry.size = directoryEntry.file_size(error);
+	}
+
+	auto time = directoryEntry.last_write_time(error);
+	entry.mtime = error ? 0 : std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+
+	return true;
+}
+
+template<typename T>
+void write_value(std::ostream& stream, const T& value) {
+	stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+bool read_value(std::istream& stream, T& value) {
+	return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+void write_string(std::ostream& stream, const std::string& value) {
+	write_value(stream, static_cast<uint32_t>(value.size()));
+	stream.write(value.data(), value.size());
+}
+
+bool read_string(std::istream& stream, std::string& value) {
+	uint32_t length = 0;
+
+	if (!read_value(stream, length)) {
+		return false;
+	}
+
+	value.resize(length);
+	return static_cast<bool>(stream.read(value.data(), length));
+}
+} // unnamed namespace
+
+std::string DirectoryIndex::Entry::filename() const {
+	return fs::path(path).filename().string();
+}
+
+std::string DirectoryIndex::Entry::extension() const {
+	return fs::path(path).extension().string();
+}
+
+const std::vector<DirectoryIndex::Entry>* DirectoryIndex::Snapshot::children(const std::string& directory) const {
+	auto it = mChildren.find(directory);
+	return it != mChildren.end() ? &it->second : nullptr;
+}
+
+const DirectoryIndex::Entry* DirectoryIndex::Snapshot::find(const std::string& path) const {
+	auto siblings = children(fs::path(path).parent_path().string());
+
+	if (!siblings) {
+		return nullptr;
+	}
+
+	auto it = std::lower_bound(siblings->begin(), siblings->end(), path, [](const Entry& entry, const std::string& value) {
+		return entry.path < value;
+	});
+
+	return it != siblings->end() && it->path == path ? &*it : nullptr;
+}
+
+DirectoryIndex::DirectoryIndex(const std::string& root)
+: mRoot(root)
+, mSnapshot(std::make_shared<Snapshot>()) {
+	mWorker = std::thread([this]() {
+		run();
+	});
+}
+
+DirectoryIndex::~DirectoryIndex() {
+	{
+		std::unique_lock<std::mutex> lock(mRequestMutex);
+		mStopping = true;
+	}
+
+	mRequestAvailable.notify_all();
+
+	if (mWorker.joinable()) {
+		mWorker.join();
+	}
+}
+
+std::shared_ptr<const DirectoryIndex::Snapshot> DirectoryIndex::snapshot() const {
+	std::unique_lock<std::mutex> lock(mSnapshotMutex);
+	return mSnapshot;
+}
+
+void DirectoryIndex::invalidate(const std::string& path) {
+	{
+		std::unique_lock<std::mutex> lock(mRequestMutex);
+		mInvalidated.push_back(path);
+	}
+
+	mRequestAvailable.notify_all();
+}
+
+void DirectoryIndex::run() {
+	POWER_PROFILE_THREAD("Directory index");
+	
+	// The previous session's tree is shown immediately while the real scan runs
+	if (load_cache()) {
+		publish();
+	}
+
+#if defined(__linux__)
+	mNotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+	if (mNotifyDescriptor < 0) {
+		std::cerr << "Directory change notifications unavailable, falling back to periodic rescans" << std::endl;
+	}
+#endif
+
+	scan_all();
+	mReady.store(true, std::memory_order_release);
+	publish();
+
+	if (mCacheDirty) {
+		save_cache();
+	}
+
+	auto lastPublish = std::chrono::steady_clock::now();
+	auto lastSave = lastPublish;
+	auto lastRescan = lastPublish;
+
+	while (true) {
+		std::vector<std::string> invalidated;
+
+		if (mNotifyDescriptor >= 0) {
+#if defined(__linux__)
+			pollfd descriptor{mNotifyDescriptor, POLLIN, 0};
+
+			if (poll(&descriptor, 1, kPollTimeoutMs) > 0) {
+				process_watch_events();
+			}
+#endif
+			std::unique_lock<std::mutex> lock(mRequestMutex);
+
+			if (mStopping) {
+				break;
+			}
+
+			invalidated.swap(mInvalidated);
+		} else {
+			std::unique_lock<std::mutex> lock(mRequestMutex);
+
+			mRequestAvailable.wait_for(lock, mDirty ? kPublishInterval : kRescanInterval, [this]() {
+				return mStopping || !mInvalidated.empty();
+			});
+
+			if (mStopping) {
+				break;
+			}
+
+			invalidated.swap(mInvalidated);
+			lock.unlock();
+
+			if (std::chrono::steady_clock::now() - lastRescan >= kRescanInterval) {
+				scan_all();
+				lastRescan = std::chrono::steady_clock::now();
+			}
+		}
+
+		for (const auto& path : invalidated) {
+			update_path(path);
+		}
+
+		auto now = std::chrono::steady_clock::now();
+
+		if (mDirty && now - lastPublish >= kPublishInterval) {
+			publish();
+			lastPublish = now;
+		}
+
+		if (mCacheDirty && now - lastSave >= kCacheSaveInterval) {
+			save_cache();
+			lastSave = now;
+		}
+	}
+
+	if (mCacheDirty) {
+		save_cache();
+	}
+
+#if defined(__linux__)
+	if (mNotifyDescriptor >= 0) {
+		close(mNotifyDescriptor);
+		mNotifyDescriptor = -1;
+	}
+#endif
+}
+
+std::string DirectoryIndex::cache_path() const {
+	std::error_code error;
+	fs::path directory = fs::temp_directory_path(error);
+
+	if (error) {
+		return "";
+	}
+
+	std::ostringstream filename;
+	filename << "directory_index_" << std::hex << std::hash<std::string>{}(mRoot) << ".bin";
+
+	return (directory / "PowerEngine" / filename.str()).string();
+}
+
+bool DirectoryIndex::load_cache() {
+	std::string path = cache_path();
+
+	if (path.empty()) {
+		return false;
+	}
+
+	std::ifstream stream(path, std::ios::binary);
+
+	if (!stream.is_open()) {
+		return false;
+	}
+
+	uint32_t magic = 0;
+	uint32_t version = 0;
+	std::string root;
+
+	if (!read_value(stream, magic) || magic != kCacheMagic || !read_value(stream, version) || version != kCacheVersion || !read_string(stream, root) || root != mRoot) {
+		return false;
+	}
+
+	uint32_t directoryCount = 0;
+
+	if (!read_value(stream, directoryCount)) {
+		return false;
+	}
+
+	std::unordered_map<std::string, DirectoryMap> directories;
+
+	for (uint32_t i = 0; i < directoryCount; ++i) {
+		std::string directory;
+		uint32_t entryCount = 0;
+
+		if (!read_string(stream, directory) || !read_value(stream, entryCount)) {
+			return false;
+		}
+
+		DirectoryMap& entries = directories[directory];
+
+		for (uint32_t j = 0; j < entryCount; ++j) {
+			Entry entry;
+			uint8_t isDirectory = 0;
+
+			if (!read_string(stream, entry.path) || !read_value(stream, entry.size) || !read_value(stream, entry.mtime) || !read_value(stream, isDirectory)) {
+				return false;
+			}
+
+			entry.is_directory = isDirectory != 0;
+			entries.emplace(entry.path, std::move(entry));
+		}
+	}
+
+	mDirectories = std::move(directories);
+	mDirty = true;
+
+	return true;
+}
+
+void DirectoryIndex::save_cache() {
+	std::string path = cache_path();
+
+	if (path.empty()) {
+		return;
+	}
+
+	std::error_code error;
+	fs::create_directories(fs::path(path).parent_path(), error);
+
+	// Written aside and renamed so a crash never leaves a truncated cache behind
+	std::string temporaryPath = path + ".tmp";
+
+	{
+		std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+
+		if (!stream.is_open()) {
+			return;
+		}
+
+		write_value(stream, kCacheMagic);
+		write_value(stream, kCacheVersion);
+		write_string(stream, mRoot);
+		write_value(stream, static_cast<uint32_t>(mDirectories.size()));
+
+		for (const auto& [directory, entries] : mDirectories) {
+			write_string(stream, directory);
+			write_value(stream, static_cast<uint32_t>(entries.size()));
+
+			for (const auto& [entryPath, entry] : entries) {
+				write_string(stream, entry.path);
+				write_value(stream, entry.size);
+				write_value(stream, entry.mtime);
+				write_value(stream, static_cast<uint8_t>(entry.is_directory ? 1 : 0));
+			}
+		}
+
+		if (!stream.good()) {
+			return;
+		}
+	}
+
+	fs::rename(temporaryPath, path, error);
+
+	if (!error) {
+		mCacheDirty = false;
+	}
+}
+
+void DirectoryIndex::scan_all() {
+	POWER_PROFILE_ZONE("DirectoryIndex::scan_all");
+	
+	bool wasDirty = mDirty;
+	bool wasCacheDirty = mCacheDirty;
+
+	std::unordered_map<std::string, DirectoryMap> previous = std::move(mDirectories);
+	mDirectories.clear();
+
+	for (const auto& [directory, descriptor] : std::unordered_map<std::string, int>(mWatches)) {
+		unwatch(directory);
+	}
+
+	std::error_code error;
+	if (fs::is_directory(mRoot, error)) {
+		scan_directory(mRoot);
+	}
+
+	// Periodic rescans of an unchanged tree should neither publish nor rewrite the cache
+	bool changed = mDirectories != previous;
+	mDirty = wasDirty || changed;
+	mCacheDirty = wasCacheDirty || changed;
+}
+
+void DirectoryIndex::scan_directory(const std::string& directory) {
+	std::vector<std::string> pending{directory};
+
+	while (!pending.empty()) {
+		std::string current = std::move(pending.back());
+		pending.pop_back();
+
+		// Watching before listing so nothing created in between is missed
+		watch(current);
+
+		DirectoryMap& entries = mDirectories[current];
+		entries.clear();
+
+		std::error_code error;
+		fs::directory_iterator iterator(current, fs::directory_options::skip_permission_denied, error);
+
+		if (error) {
+			std::cerr << "Filesystem error accessing " << current << ": " << error.message() << std::endl;
+			continue;
+		}
+
+		for (; iterator != fs::directory_iterator(); iterator.increment(error)) {
+			Entry entry;
+
+			if (!make_entry(*iterator, entry)) {
+				continue;
+			}
+
+			// Symlinked directories are listed but not followed, so cycles cannot occur
+			if (entry.is_directory && !iterator->is_symlink(error)) {
+				pending.push_back(entry.path);
+			}
+
+			entries.emplace(entry.path, std::move(entry));
+		}
+	}
+
+	mDirty = true;
+	mCacheDirty = true;
+}
+
+void DirectoryIndex::update_path(const std::string& path) {
+	fs::path fsPath(path);
+	std::string parent = fsPath.parent_path().string();
+
+	if (path == mRoot || path.compare(0, mRoot.size(), mRoot) != 0) {
+		return;
+	}
+
+	std::error_code error;
+	fs::directory_entry directoryEntry(fsPath, error);
+
+	if (error || !directoryEntry.exists(error)) {
+		remove_path(path);
+		return;
+	}
+
+	// Creating the missing ancestors first, e.g. for a nested folder made in one go
+	if (mDirectories.find(parent) == mDirectories.end()) {
+		update_path(parent);
+
+		if (mDirectories.find(parent) == mDirectories.end()) {
+			return;
+		}
+	}
+
+	Entry entry;
+
+	if (!make_entry(directoryEntry, entry)) {
+		return;
+	}
+
+	DirectoryMap& siblings = mDirectories[parent];
+	auto it = siblings.find(path);
+
+	if (it == siblings.end() || !(it->second == entry)) {
+		siblings[path] = entry;
+		mDirty = true;
+		mCacheDirty = true;
+	}
+
+	if (entry.is_directory && !directoryEntry.is_symlink(error) && mDirectories.find(path) == mDirectories.end()) {
+		scan_directory(path);
+	}
+}
+
+void DirectoryIndex::remove_path(const std::string& path) {
+	auto parent = mDirectories.find(fs::path(path).parent_path().string());
+
+	if (parent != mDirectories.end() && parent->second.erase(path) > 0) {
+		mDirty = true;
+		mCacheDirty = true;
+	}
+
+	auto directory = mDirectories.find(path);
+
+	if (directory == mDirectories.end()) {
+		return;
+	}
+
+	std::vector<std::string> children;
+	for (const auto& [childPath, child] : directory->second) {
+		if (child.is_directory) {
+			children.push_back(childPath);
+		}
+	}
+
+	unwatch(path);
+	mDirectories.erase(directory);
+
+	for (const auto& child : children) {
+		remove_path(child);
+	}
+
+	mDirty = true;
+	mCacheDirty = true;
+}
+
+void DirectoryIndex::publish() {
+	auto snapshot = std::make_shared<Snapshot>();
+
+	snapshot->mChildren.reserve(mDirectories.size());
+
+	for (const auto& [directory, entries] : mDirectories) {
+		auto& children = snapshot->mChildren[directory];
+		children.reserve(entries.size());
+
+		for (const auto& [path, entry] : entries) {
+			children.push_back(entry);
+		}
+
+		snapshot->mEntryCount += entries.size();
+	}
+
+	snapshot->mGeneration = mGeneration.load(std::memory_order_relaxed) + 1;
+
+	{
+		std::unique_lock<std::mutex> lock(mSnapshotMutex);
+		mSnapshot = std::move(snapshot);
+	}
+
+	mGeneration.fetch_add(1, std::memory_order_release);
+	mDirty = false;
+}
+
+void DirectoryIndex::watch(const std::string& directory) {
+#if defined(__linux__)
+	if (mNotifyDescriptor < 0 || mWatches.count(directory) > 0) {
+		return;
+	}
+
+	constexpr uint32_t mask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+
+	int descriptor = inotify_add_watch(mNotifyDescriptor, directory.c_str(), mask);
+
+	if (descriptor < 0) {
+		// Usually fs.inotify.max_user_watches; the rest of the tree is still indexed, only not live
+		static bool reported = false;
+		if (!reported) {
+			std::cerr << "Failed to watch " << directory << ", changes below it will not be tracked" << std::endl;
+			reported = true;
+		}
+		return;
+	}
+
+	mWatches[directory] = descriptor;
+	mWatchedPaths[descriptor] = directory;
+#else
+	(void)directory;
+#endif
+}
+
+void DirectoryIndex::unwatch(const std::string& directory) {
+#if defined(__linux__)
+	auto it = mWatches.find(directory);
+
+	if (it == mWatches.end()) {
+		return;
+	}
+
+	inotify_rm_watch(mNotifyDescriptor, it->second);
+	mWatchedPaths.erase(it->second);
+	mWatches.erase(it);
+#else
+	(void)directory;
+#endif
+}
+
+void DirectoryIndex::process_watch_events() {
+#if defined(__linux__)
+	alignas(inotify_event) char buffer[16 * 1024];
+	bool overflow = false;
+
+	while (true) {
+		ssize_t length = read(mNotifyDescriptor, buffer, sizeof(buffer));
+
+		if (length <= 0) {
+			break;
+		}
+
+		for (char* cursor = buffer; cursor < buffer + length;) {
+			auto* event = reinterpret_cast<inotify_event*>(cursor);
+			cursor += sizeof(inotify_event) + event->len;
+
+			if (event->mask & IN_Q_OVERFLOW) {
+				overflow = true;
+				continue;
+			}
+
+			auto watched = mWatchedPaths.find(event->wd);
+
+			if (watched == mWatchedPaths.end()) {
+				continue;
+			}
+
+			if (event->mask & IN_IGNORED) {
+				mWatches.erase(watched->second);
+				mWatchedPaths.erase(watched);
+				continue;
+			}
+
+			if (event->len == 0) {
+				// The watched directory itself was deleted or moved
+				update_path(watched->second);
+				continue;
+			}
+
+			std::string path = (fs::path(watched->second) / event->name).string();
+
+			if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+				remove_path(path);
+			} else {
+				update_path(path);
+			}
+		}
+	}
+
+	// Events were dropped, so the only safe state is a fresh scan
+	if (overflow) {
+		scan_all();
+	}
+#endif
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Incrementally maintained index of a directory tree.
+ *
+ * A background thread owns the filesystem. It first publishes the snapshot
+ * cached on disk by the previous session, then rescans the tree and keeps it
+ * current, with inotify on Linux and periodic rescans elsewhere. Queries only
+ * read the latest immutable snapshot, so the UI never waits on the disk.
+ */
+class DirectoryIndex {
+public:
+	struct Entry {
+		std::string path;
+		uint64_t size = 0;
+		int64_t mtime = 0;
+		bool is_directory = false;
+
+		bool operator==(const Entry& rhs) const = default;
+
+		std::string filename() const;
+		std::string extension() const;
+	};
+
+	class Snapshot {
+	public:
+		// Direct children of a directory, sorted by path; nullptr if the directory is unknown
+		const std::vector<Entry>* children(const std::string& directory) const;
+
+		const Entry* find(const std::string& path) const;
+
+		size_t size() const {
+			return mEntryCount;
+		}
+
+		uint64_t generation() const {
+			return mGeneration;
+		}
+
+	private:
+		friend class DirectoryIndex;
+
+		std::unordered_map<std::string, std::vector<Entry>> mChildren;
+		size_t mEntryCount = 0;
+		uint64_t mGeneration = 0;
+	};
+
+	explicit DirectoryIndex(const std::string& root);
+	~DirectoryIndex();
+
+	DirectoryIndex(const DirectoryIndex&) = delete;
+	DirectoryIndex& operator=(const DirectoryIndex&) = delete;
+
+	const std::string& root() const {
+		return mRoot;
+	}
+
+	// Latest published snapshot; never touches the filesystem
+	std::shared_ptr<const Snapshot> snapshot() const;
+
+	// Bumped every time a new snapshot is published, cheap enough to poll every frame
+	uint64_t generation() const {
+		return mGeneration.load(std::memory_order_acquire);
+	}
+
+	// Whether the tree has been fully scanned at least once this session
+	bool is_ready() const {
+		return mReady.load(std::memory_order_acquire);
+	}
+
+	// Asks the worker to re-examine a path the application just wrote
+	void invalidate(const std::string& path);
+
+private:
+	using DirectoryMap = std::map<std::string, Entry>;
+
+	void run();
+
+	bool load_cache();
+	void save_cache();
+	std::string cache_path() const;
+
+	void scan_all();
+	void scan_directory(const std::string& directory);
+	void update_path(const std::string& path);
+	void remove_path(const std::string& path);
+
+	void publish();
+
+	void watch(const std::string& directory);
+	void unwatch(const std::string& directory);
+	void process_watch_events();
+
+	std::string mRoot;
+
+	// Worker-owned tree, keyed by directory then by entry path
+	std::unordered_map<std::string, DirectoryMap> mDirectories;
+	bool mDirty = false;
+	bool mCacheDirty = false;
+
+	mutable std::mutex mSnapshotMutex;
+	std::shared_ptr<const Snapshot> mSnapshot;
+	std::atomic<uint64_t> mGeneration{0};
+	std::atomic<bool> mReady{false};
+
+	std::mutex mRequestMutex;
+	std::condition_variable mRequestAvailable;
+	std::vector<std::string> mInvalidated;
+	bool mStopping = false;
+
+	// inotify instance on Linux, -1 where change notifications are unavailable
+	int mNotifyDescriptor = -1;
+	std::unordered_map<int, std::string> mWatchedPaths;
+	std::unordered_map<std::string, int> mWatches;
+
+	std::thread mWorker;
+};
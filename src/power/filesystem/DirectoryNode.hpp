@@ -1,5 +1,7 @@
 #pragma once
 
+#include "DirectoryIndex.hpp"
+
 #include <filesystem>
 #include <memory>
 #include <set>
@@ -24,43 +26,39 @@ public:
 		if (!instance || instance->FullPath != path) {
 			// Same fix here: use `new` directly.
 			instance = std::shared_ptr<DirectoryNode>(new DirectoryNode(path));
+			instance->mIndex = std::make_shared<DirectoryIndex>(path);
 		}
 		
 		instance->refresh();
 		return instance;
 	}
 	
+	// Rebuilds the children from the directory index; never touches the filesystem
 	bool refresh(const std::set<std::string>& allowedExtensions = {".psk", ".pma", ".pan", ".psq", ".psn", ".png"}) {
-		if (!IsDirectory || !std::filesystem::exists(FullPath)) {
+		if (!IsDirectory || !mIndex) {
 			return false;
 		}
 		
-		Children.clear();
-		bool hasValidChildren = false;
+		auto snapshot = mIndex->snapshot();
 		
-		try {
-			for (const auto& entry : std::filesystem::directory_iterator(FullPath)) {
-				// A regular member function can also access private constructors.
-				auto newNode = std::shared_ptr<DirectoryNode>(new DirectoryNode(entry.path().string(), shared_from_this()));
-				
-				if (newNode->IsDirectory) {
-					if (newNode->refresh(allowedExtensions)) {
-						Children.push_back(newNode);
-						hasValidChildren = true;
-					}
-				} else if (entry.is_regular_file()) {
-					const std::string extension = entry.path().extension().string();
-					if (allowedExtensions.empty() || allowedExtensions.count(extension) > 0) {
-						Children.push_back(newNode);
-						hasValidChildren = true;
-					}
-				}
-			}
-		} catch (const std::filesystem::filesystem_error& e) {
-			std::cerr << "Filesystem error accessing " << FullPath << ": " << e.what() << std::endl;
+		// Nothing changed since the last refresh with the same filter
+		if (snapshot->generation() == mBuiltGeneration && allowedExtensions == mBuiltExtensions) {
+			return !Children.empty();
 		}
 		
-		return hasValidChildren;
+		return rebuild(*snapshot, allowedExtensions);
+	}
+	
+	// Generation of the underlying index; panels poll it to know when to refresh
+	uint64_t index_generation() const {
+		return mIndex ? mIndex->generation() : 0;
+	}
+	
+	// Lets the index pick up a file the editor just wrote without waiting for change events
+	void invalidate(const std::string& path) {
+		if (mIndex) {
+			mIndex->invalidate(path);
+		}
 	}
 	
 	static std::shared_ptr<DirectoryNode> createProjectFolder(const std::string& folderPath) {
@@ -82,6 +80,42 @@ public:
 	std::weak_ptr<DirectoryNode> Parent;
 	
 private:
+	bool rebuild(const DirectoryIndex::Snapshot& snapshot, const std::set<std::string>& allowedExtensions) {
+		Children.clear();
+		mBuiltGeneration = snapshot.generation();
+		mBuiltExtensions = allowedExtensions;
+		
+		const auto* entries = snapshot.children(FullPath);
+		
+		if (!entries) {
+			return false;
+		}
+		
+		bool hasValidChildren = false;
+		
+		for (const auto& entry : *entries) {
+			// A regular member function can also access private constructors.
+			auto newNode = std::shared_ptr<DirectoryNode>(new DirectoryNode(entry, shared_from_this()));
+			newNode->mIndex = mIndex;
+			
+			if (newNode->IsDirectory) {
+				if (newNode->rebuild(snapshot, allowedExtensions)) {
+					Children.push_back(newNode);
+					hasValidChildren = true;
+				}
+			} else {
+				const std::string extension = entry.extension();
+				if (allowedExtensions.empty() || allowedExtensions.count(extension) > 0) {
+					Children.push_back(newNode);
+					hasValidChildren = true;
+				}
+			}
+		}
+		
+		return hasValidChildren;
+	}
+	
+
 	// Constructors are private again, which was the original intent.
 	explicit DirectoryNode(const std::string& path, std::shared_ptr<DirectoryNode> parent = nullptr)
 	: FullPath(path), Parent(parent) {
@@ -100,9 +134,18 @@ private:
 		}
 	}
 	
+	DirectoryNode(const DirectoryIndex::Entry& entry, std::shared_ptr<DirectoryNode> parent)
+	: FullPath(entry.path), FileName(entry.filename()), IsDirectory(entry.is_directory), Parent(parent) {
+	}
+	
 	// Disallow copy/move.
 	DirectoryNode(const DirectoryNode&) = delete;
 	DirectoryNode& operator=(const DirectoryNode&) = delete;
 	DirectoryNode(DirectoryNode&&) = delete;
 	DirectoryNode& operator=(DirectoryNode&&) = delete;
+	
+	// Shared by every node of the tree
+	std::shared_ptr<DirectoryIndex> mIndex;
+	uint64_t mBuiltGeneration = 0;
+	std::set<std::string> mBuiltExtensions;
 };
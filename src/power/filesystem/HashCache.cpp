@@ -0,0 +1,197 @@
+#include "HashCache.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+namespace {
+constexpr uint32_t kHashCacheMagic = 0x43485348; // "HSHC"
+constexpr uint32_t kHashCacheVersion = 1;
+constexpr size_t kHashCacheMaxPath = 4096;
+
+// Past this many records, the ones for files that no longer exist are dropped on save
+constexpr size_t kHashCachePruneThreshold = 1 << 16;
+
+bool stat_hashed_file(const fs::path& path, uint64_t& size, int64_t& mtime) {
+	std::error_code error;
+	size = fs::file_size(path, error);
+
+	if (error) {
+		return false;
+	}
+
+	auto time = fs::last_write_time(path, error);
+	mtime = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+
+	return !error;
+}
+
+template<typename T>
+void write_hash_field(std::ostream& stream, const T& value) {
+	stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+bool read_hash_field(std::istream& stream, T& value) {
+	return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+} // unnamed namespace
+
+HashCache& HashCache::instance() {
+	static HashCache cache;
+	return cache;
+}
+
+HashCache::HashCache(const std::string& path)
+: mPath(path) {
+	std::error_code error;
+
+	if (mPath.empty()) {
+		fs::path directory = fs::temp_directory_path(error) / "PowerEngine";
+		fs::create_directories(directory, error);
+		mPath = (directory / "hashes.bin").string();
+	}
+
+	load();
+}
+
+HashCache::~HashCache() {
+	save();
+}
+
+bool HashCache::hash_file(const std::string& path, ContentHash& hash) {
+	std::error_code error;
+	fs::path absolute = fs::absolute(path, error).lexically_normal();
+	std::string key = error ? path : absolute.string();
+
+	uint64_t size = 0;
+	int64_t mtime = 0;
+
+	if (!stat_hashed_file(key, size, mtime)) {
+		return false;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		auto it = mRecords.find(key);
+
+		if (it != mRecords.end() && it->second.size == size && it->second.mtime == mtime) {
+			hash = it->second.hash;
+			++mHits;
+			return true;
+		}
+	}
+
+	// Hashed outside the lock, so that other files are answered meanwhile
+	if (!ContentHasher::hash_file(key, hash)) {
+		return false;
+	}
+
+	uint64_t sizeAfter = 0;
+	int64_t mtimeAfter = 0;
+
+	// Written to while it was read; the hash is still returned, just not remembered
+	if (!stat_hashed_file(key, sizeAfter, mtimeAfter) || sizeAfter != size || mtimeAfter != mtime) {
+		return true;
+	}
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	mRecords[key] = Record{size, mtime, hash};
+	mDirty = true;
+
+	return true;
+}
+
+void HashCache::save() {
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	if (!mDirty) {
+		return;
+	}
+
+	if (mRecords.size() > kHashCachePruneThreshold) {
+		for (auto it = mRecords.begin(); it != mRecords.end();) {
+			std::error_code error;
+
+			if (!fs::exists(it->first, error)) {
+				it = mRecords.erase(it);
+			} else {
+				++it;
+			}
+		}
+	}
+
+	std::string temporaryPath = mPath + ".tmp";
+
+	{
+		std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+
+		if (!stream.is_open()) {
+			std::cerr << "Failed to write hash cache: " << temporaryPath << std::endl;
+			return;
+		}
+
+		write_hash_field(stream, kHashCacheMagic);
+		write_hash_field(stream, kHashCacheVersion);
+		write_hash_field(stream, static_cast<uint64_t>(mRecords.size()));
+
+		for (const auto& [path, record] : mRecords) {
+			write_hash_field(stream, static_cast<uint32_t>(path.size()));
+			stream.write(path.data(), path.size());
+			write_hash_field(stream, record.size);
+			write_hash_field(stream, record.mtime);
+			write_hash_field(stream, record.hash.fast);
+			write_hash_field(stream, record.hash.crc);
+			write_hash_field(stream, record.hash.md5);
+		}
+
+		if (!stream.good()) {
+			return;
+		}
+	}
+
+	std::error_code error;
+	fs::rename(temporaryPath, mPath, error);
+
+	if (!error) {
+		mDirty = false;
+	}
+}
+
+void HashCache::load() {
+	std::ifstream stream(mPath, std::ios::binary);
+
+	if (!stream.is_open()) {
+		return;
+	}
+
+	uint32_t magic = 0;
+	uint32_t version = 0;
+	uint64_t count = 0;
+
+	if (!read_hash_field(stream, magic) || magic != kHashCacheMagic || !read_hash_field(stream, version) || version != kHashCacheVersion || !read_hash_field(stream, count)) {
+		return;
+	}
+
+	// A truncated file keeps the records read before the damage
+	for (uint64_t i = 0; i < count; ++i) {
+		uint32_t length = 0;
+
+		if (!read_hash_field(stream, length) || length > kHashCacheMaxPath) {
+			break;
+		}
+
+		std::string path(length, '\0');
+		Record record{};
+
+		if (!stream.read(path.data(), length) || !read_hash_field(stream, record.size) || !read_hash_field(stream, record.mtime) || !read_hash_field(stream, record.hash.fast) || !read_hash_field(stream, record.hash.crc) || !read_hash_field(stream, record.hash.md5)) {
+			break;
+		}
+
+		mRecords[std::move(path)] = record;
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "filesystem/ContentHash.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief Content hashes of files, remembered across sessions by path, size and modification time.
+ *
+ * A file whose size and modification time still match its record is never
+ * read again; anything else is rehashed with every algorithm and its record
+ * replaced. Records are written back by save() to a single file replaced
+ * atomically; the application saves after imports and thumbnail batches and
+ * on shutdown, and destruction saves whatever is left. Thread-safe.
+ */
+class HashCache {
+public:
+	static HashCache& instance();
+
+	/**
+	 * @param path  Cache file; empty selects PowerEngine/hashes.bin in the temp directory.
+	 */
+	explicit HashCache(const std::string& path = "");
+	~HashCache();
+
+	HashCache(const HashCache&) = delete;
+	HashCache& operator=(const HashCache&) = delete;
+
+	// False when the file cannot be read
+	bool hash_file(const std::string& path, ContentHash& hash);
+
+	void save();
+
+	// Lookups answered without reading the file
+	uint64_t hits() const {
+		return mHits;
+	}
+
+private:
+	struct Record {
+		uint64_t size;
+		int64_t mtime; ///< Nanoseconds since the file clock epoch.
+		ContentHash hash;
+	};
+
+	void load();
+
+	std::string mPath;
+
+	std::mutex mMutex;
+	std::unordered_map<std::string, Record> mRecords;
+	bool mDirty = false;
+	std::atomic<uint64_t> mHits{0};
+};
@@ -1,5 +1,7 @@
 #include "ImageUtils.hpp"
 
+#include "profiling/MemoryTracker.hpp"
+
 #include "stb_image.h"
 
 #define STB_IMAGE_WRITE_IMPLEMENTATION
@@ -110,6 +112,7 @@ bool write_to_png(const std::vector<uint8_t>& pixels,
 	
 	// Create a copy of the pixel data to manipulate (flip vertically)
 	std::vector<unsigned char> flipped_pixels = pixels;
+	TrackedMemory flippedMemory(MemoryTracker::Tag::Images, tracked_capacity(flipped_pixels));
 	
 	// Flip the image vertically
 	flip_image_vertically(flipped_pixels.data(), width, height, channels);
@@ -143,6 +146,8 @@ bool write_compressed_png_to_file(const std::vector<uint8_t>& imageData, const s
 		return false;
 	}
 	
+	TrackedMemory decodedMemory(MemoryTracker::Tag::Images, static_cast<uint64_t>(width) * height * 4);
+	
 	// Flip the image vertically
 	flip_image_vertically(img, width, height, 4);
 	
@@ -187,6 +192,7 @@ bool read_png_file_to_vector(const std::string& filename,
 	
 	// Calculate the total number of pixels
 	size_t total_pixels = static_cast<size_t>(width) * static_cast<size_t>(height) * 4; // RGBA
+	TrackedMemory decodedMemory(MemoryTracker::Tag::Images, total_pixels);
 	
 	// Copy pixel data into the vector
 	pixels.assign(img, img + total_pixels);
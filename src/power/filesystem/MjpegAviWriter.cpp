@@ -0,0 +1,208 @@
+#include "MjpegAviWriter.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+namespace {
+constexpr uint32_t kAvifHasIndex = 0x10;
+constexpr uint32_t kAviifKeyframe = 0x10;
+constexpr uint32_t kMainHeaderSize = 56;
+constexpr uint32_t kStreamHeaderSize = 56;
+constexpr uint32_t kBitmapInfoSize = 40;
+// 'strl' fourcc + strh chunk + strf chunk
+constexpr uint32_t kStrlListSize = 4 + (8 + kStreamHeaderSize) + (8 + kBitmapInfoSize);
+// 'hdrl' fourcc + avih chunk + strl list
+constexpr uint32_t kHdrlListSize = 4 + (8 + kMainHeaderSize) + (8 + kStrlListSize);
+} // unnamed namespace
+
+MjpegAviWriter::~MjpegAviWriter() {
+	if (is_open()) {
+		close();
+	}
+}
+
+bool MjpegAviWriter::open(const std::string& filename, int width, int height, int fps) {
+	if (is_open()) {
+		close();
+	}
+
+	mFile.open(filename, std::ios::binary | std::ios::trunc);
+
+	if (!mFile.is_open()) {
+		std::cerr << "Failed to create movie file: " << filename << std::endl;
+		return false;
+	}
+
+	mIndex.clear();
+	mMaxFrameSize = 0;
+	mWidth = width;
+	mHeight = height;
+	mFps = fps > 0 ? fps : 60;
+
+	write_fourcc("RIFF");
+	mRiffSizePos = mFile.tellp();
+	write_u32(0);
+	write_fourcc("AVI ");
+
+	write_fourcc("LIST");
+	write_u32(kHdrlListSize);
+	write_fourcc("hdrl");
+
+	// MainAVIHeader
+	write_fourcc("avih");
+	write_u32(kMainHeaderSize);
+	write_u32(1000000u / static_cast<uint32_t>(mFps)); // dwMicroSecPerFrame
+	write_u32(0); // dwMaxBytesPerSec
+	write_u32(0); // dwPaddingGranularity
+	write_u32(kAvifHasIndex); // dwFlags
+	mAvihTotalFramesPos = mFile.tellp();
+	write_u32(0); // dwTotalFrames
+	write_u32(0); // dwInitialFrames
+	write_u32(1); // dwStreams
+	mAvihSuggestedBufferPos = mFile.tellp();
+	write_u32(0); // dwSuggestedBufferSize
+	write_u32(static_cast<uint32_t>(mWidth));
+	write_u32(static_cast<uint32_t>(mHeight));
+	for (int i = 0; i < 4; ++i) {
+		write_u32(0); // dwReserved
+	}
+
+	write_fourcc("LIST");
+	write_u32(kStrlListSize);
+	write_fourcc("strl");
+
+	// AVIStreamHeader
+	write_fourcc("strh");
+	write_u32(kStreamHeaderSize);
+	write_fourcc("vids");
+	write_fourcc("MJPG");
+	write_u32(0); // dwFlags
+	write_u16(0); // wPriority
+	write_u16(0); // wLanguage
+	write_u32(0); // dwInitialFrames
+	write_u32(1); // dwScale
+	write_u32(static_cast<uint32_t>(mFps)); // dwRate
+	write_u32(0); // dwStart
+	mStrhLengthPos = mFile.tellp();
+	write_u32(0); // dwLength
+	mStrhSuggestedBufferPos = mFile.tellp();
+	write_u32(0); // dwSuggestedBufferSize
+	write_u32(std::numeric_limits<uint32_t>::max()); // dwQuality
+	write_u32(0); // dwSampleSize
+	write_u16(0); // rcFrame.left
+	write_u16(0); // rcFrame.top
+	write_u16(static_cast<uint16_t>(mWidth));
+	write_u16(static_cast<uint16_t>(mHeight));
+
+	// BITMAPINFOHEADER
+	write_fourcc("strf");
+	write_u32(kBitmapInfoSize);
+	write_u32(kBitmapInfoSize);
+	write_u32(static_cast<uint32_t>(mWidth));
+	write_u32(static_cast<uint32_t>(mHeight));
+	write_u16(1); // biPlanes
+	write_u16(24); // biBitCount
+	write_fourcc("MJPG");
+	write_u32(static_cast<uint32_t>(mWidth * mHeight * 3)); // biSizeImage
+	write_u32(0); // biXPelsPerMeter
+	write_u32(0); // biYPelsPerMeter
+	write_u32(0); // biClrUsed
+	write_u32(0); // biClrImportant
+
+	write_fourcc("LIST");
+	mMoviSizePos = mFile.tellp();
+	write_u32(0);
+	mMoviFourccPos = mFile.tellp();
+	write_fourcc("movi");
+
+	return mFile.good();
+}
+
+bool MjpegAviWriter::write_frame(const uint8_t* jpeg, size_t size) {
+	if (!is_open()) {
+		return false;
+	}
+
+	std::streamoff position = mFile.tellp();
+
+	// Leaving room for the index and padding within the 32-bit RIFF size
+	uint64_t projected = static_cast<uint64_t>(position) + 8 + size + 1 + (mIndex.size() + 1) * 16 + 8;
+	if (projected >= std::numeric_limits<uint32_t>::max()) {
+		std::cerr << "Movie file reached the AVI size limit, dropping frame" << std::endl;
+		return false;
+	}
+
+	write_fourcc("00dc");
+	write_u32(static_cast<uint32_t>(size));
+	mFile.write(reinterpret_cast<const char*>(jpeg), static_cast<std::streamsize>(size));
+
+	// RIFF chunks are word aligned
+	if (size & 1) {
+		mFile.put(0);
+	}
+
+	mIndex.push_back({static_cast<uint32_t>(position - mMoviFourccPos), static_cast<uint32_t>(size)});
+	mMaxFrameSize = std::max(mMaxFrameSize, static_cast<uint32_t>(size));
+
+	return mFile.good();
+}
+
+bool MjpegAviWriter::close() {
+	if (!is_open()) {
+		return false;
+	}
+
+	std::streamoff moviEnd = mFile.tellp();
+
+	write_fourcc("idx1");
+	write_u32(static_cast<uint32_t>(mIndex.size() * 16));
+	for (const auto& entry : mIndex) {
+		write_fourcc("00dc");
+		write_u32(kAviifKeyframe);
+		write_u32(entry.offset);
+		write_u32(entry.size);
+	}
+
+	std::streamoff fileEnd = mFile.tellp();
+
+	patch_u32(mRiffSizePos, static_cast<uint32_t>(fileEnd - 8));
+	patch_u32(mMoviSizePos, static_cast<uint32_t>(moviEnd - mMoviFourccPos));
+	patch_u32(mAvihTotalFramesPos, frame_count());
+	patch_u32(mAvihSuggestedBufferPos, mMaxFrameSize);
+	patch_u32(mStrhLengthPos, frame_count());
+	patch_u32(mStrhSuggestedBufferPos, mMaxFrameSize);
+
+	bool ok = mFile.good();
+	mFile.close();
+
+	return ok;
+}
+
+void MjpegAviWriter::write_u16(uint16_t value) {
+	char bytes[2] = {
+		static_cast<char>(value & 0xFF),
+		static_cast<char>((value >> 8) & 0xFF)
+	};
+	mFile.write(bytes, 2);
+}
+
+void MjpegAviWriter::write_u32(uint32_t value) {
+	char bytes[4] = {
+		static_cast<char>(value & 0xFF),
+		static_cast<char>((value >> 8) & 0xFF),
+		static_cast<char>((value >> 16) & 0xFF),
+		static_cast<char>((value >> 24) & 0xFF)
+	};
+	mFile.write(bytes, 4);
+}
+
+void MjpegAviWriter::write_fourcc(const char* fourcc) {
+	mFile.write(fourcc, 4);
+}
+
+void MjpegAviWriter::patch_u32(std::streamoff position, uint32_t value) {
+	mFile.seekp(position);
+	write_u32(value);
+	mFile.seekp(0, std::ios::end);
+}
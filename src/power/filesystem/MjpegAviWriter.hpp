@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Writes a single-stream Motion JPEG AVI (RIFF AVI 1.0) file.
+ *
+ * Frames are appended as already-encoded JPEG images. Header fields that depend
+ * on the final frame count are patched and the idx1 index is written on close().
+ * AVI 1.0 keeps 32-bit offsets, so a single file is limited to roughly 4 GB.
+ */
+class MjpegAviWriter {
+public:
+	MjpegAviWriter() = default;
+	~MjpegAviWriter();
+
+	MjpegAviWriter(const MjpegAviWriter&) = delete;
+	MjpegAviWriter& operator=(const MjpegAviWriter&) = delete;
+
+	/**
+	 * @brief Creates the file and writes the provisional headers.
+	 *
+	 * @param filename   Destination path of the .avi file.
+	 * @param width      Frame width in pixels.
+	 * @param height     Frame height in pixels.
+	 * @param fps        Playback rate in frames per second.
+	 * @return true if the file could be created; false otherwise.
+	 */
+	bool open(const std::string& filename, int width, int height, int fps);
+
+	/**
+	 * @brief Appends one JPEG-encoded frame to the movi list.
+	 *
+	 * @return true if the frame was written; false if the writer is closed or the file is full.
+	 */
+	bool write_frame(const uint8_t* jpeg, size_t size);
+
+	bool write_frame(const std::vector<uint8_t>& jpeg) {
+		return write_frame(jpeg.data(), jpeg.size());
+	}
+
+	// Writes the index, patches sizes and frame counts, and closes the file
+	bool close();
+
+	bool is_open() const {
+		return mFile.is_open();
+	}
+
+	uint32_t frame_count() const {
+		return static_cast<uint32_t>(mIndex.size());
+	}
+
+private:
+	struct IndexEntry {
+		uint32_t offset; // Relative to the 'movi' fourcc
+		uint32_t size;
+	};
+
+	void write_u16(uint16_t value);
+	void write_u32(uint32_t value);
+	void write_fourcc(const char* fourcc);
+	void patch_u32(std::streamoff position, uint32_t value);
+
+	std::ofstream mFile;
+	std::vector<IndexEntry> mIndex;
+	uint32_t mMaxFrameSize = 0;
+	int mWidth = 0;
+	int mHeight = 0;
+	int mFps = 0;
+
+	// Positions of fields patched on close
+	std::streamoff mRiffSizePos = 0;
+	std::streamoff mAvihTotalFramesPos = 0;
+	std::streamoff mAvihSuggestedBufferPos = 0;
+	std::streamoff mStrhLengthPos = 0;
+	std::streamoff mStrhSuggestedBufferPos = 0;
+	std::streamoff mMoviSizePos = 0;
+	std::streamoff mMoviFourccPos = 0;
+};
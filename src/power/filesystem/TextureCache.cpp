@@ -0,0 +1,469 @@
+#include "TextureCache.hpp"
+
+#include "stb_image.h"
+
+#include <zlib.h>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <tuple>
+
+namespace fs = std::filesystem;
+
+namespace {
+constexpr uint32_t kCookedMagic = 0x58455443; // "CTEX"
+constexpr uint32_t kCookedVersion = 1;
+constexpr const char* kCookedExtension = ".ctex";
+constexpr size_t kCookedChunkSize = 1 << 20;
+constexpr int kCookedMaxSize = 16384;
+// Below this many destination pixels a level is filtered on the calling thread
+constexpr size_t kParallelFilterPixels = 1 << 16;
+
+struct CookedHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t levelCount;
+	uint32_t chunkCount;
+	uint64_t pixelBytes;
+};
+
+struct CookedLevel {
+	uint32_t width;
+	uint32_t height;
+};
+
+struct CookedChunk {
+	uint64_t fileOffset;
+	uint32_t compressedSize;
+	uint32_t rawSize;
+};
+
+// Read-only view of a whole file, mapped where the platform allows it
+class MappedTextureFile {
+public:
+	explicit MappedTextureFile(const std::string& path) {
+#if defined(_WIN32)
+		std::ifstream stream(path, std::ios::binary);
+		if (stream.is_open()) {
+			mFallback.assign(std::istreambuf_iterator<char>(stream), {});
+			mData = mFallback.data();
+			mSize = mFallback.size();
+		}
+#else
+		int descriptor = ::open(path.c_str(), O_RDONLY);
+		if (descriptor < 0) {
+			return;
+		}
+
+		struct stat status {};
+		if (::fstat(descriptor, &status) == 0 && status.st_size > 0) {
+			void* mapping = ::mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+			if (mapping != MAP_FAILED) {
+				mData = static_cast<const uint8_t*>(mapping);
+				mSize = static_cast<size_t>(status.st_size);
+			}
+		}
+
+		::close(descriptor);
+#endif
+	}
+
+	~MappedTextureFile() {
+#if !defined(_WIN32)
+		if (mData) {
+			::munmap(const_cast<uint8_t*>(mData), mSize);
+		}
+#endif
+	}
+
+	MappedTextureFile(const MappedTextureFile&) = delete;
+	MappedTextureFile& operator=(const MappedTextureFile&) = delete;
+
+	const uint8_t* data() const {
+		return mData;
+	}
+
+	size_t size() const {
+		return mSize;
+	}
+
+private:
+	const uint8_t* mData = nullptr;
+	size_t mSize = 0;
+#if defined(_WIN32)
+	std::vector<uint8_t> mFallback;
+#endif
+};
+
+// Runs job(i) for every i below count on up to one thread per core; false if any job returned false
+template <typename Job>
+bool for_each_chunk(size_t count, Job job) {
+	size_t threadCount = std::min<size_t>(count, std::max(1u, std::thread::hardware_concurrency()));
+	std::vector<std::future<bool>> futures;
+
+	for (size_t thread = 0; thread < threadCount; ++thread) {
+		futures.emplace_back(std::async(std::launch::async, [&job, count, threadCount, thread]() {
+			bool succeeded = true;
+			for (size_t i = thread; i < count; i += threadCount) {
+				succeeded = job(i) && succeeded;
+			}
+			return succeeded;
+		}));
+	}
+
+	bool succeeded = true;
+	for (auto& future : futures) {
+		succeeded = future.get() && succeeded;
+	}
+
+	return succeeded;
+}
+
+size_t level_bytes(int width, int height) {
+	return static_cast<size_t>(width) * height * 4;
+}
+
+// 2x2 box filter of the rows [begin, end) of the destination level; odd edges reuse their last texel
+void filter_rows(const uint8_t* source, int sourceWidth, int sourceHeight, uint8_t* target, int targetWidth, int begin, int end) {
+	for (int y = begin; y < end; ++y) {
+		int y0 = std::min(y * 2, sourceHeight - 1);
+		int y1 = std::min(y * 2 + 1, sourceHeight - 1);
+
+		for (int x = 0; x < targetWidth; ++x) {
+			int x0 = std::min(x * 2, sourceWidth - 1);
+			int x1 = std::min(x * 2 + 1, sourceWidth - 1);
+
+			const uint8_t* a = source + (static_cast<size_t>(y0) * sourceWidth + x0) * 4;
+			const uint8_t* b = source + (static_cast<size_t>(y0) * sourceWidth + x1) * 4;
+			const uint8_t* c = source + (static_cast<size_t>(y1) * sourceWidth + x0) * 4;
+			const uint8_t* d = source + (static_cast<size_t>(y1) * sourceWidth + x1) * 4;
+			uint8_t* out = target + (static_cast<size_t>(y) * targetWidth + x) * 4;
+
+			for (int channel = 0; channel < 4; ++channel) {
+				out[channel] = static_cast<uint8_t>((a[channel] + b[channel] + c[channel] + d[channel] + 2) / 4);
+			}
+		}
+	}
+}
+} // unnamed namespace
+
+TextureCache::TextureCache(const std::string& directory, uint64_t budget)
+: mDirectory(directory)
+, mBudget(budget) {
+	std::error_code error;
+
+	if (mDirectory.empty()) {
+		mDirectory = (fs::temp_directory_path(error) / "PowerEngine" / "textures").string();
+	}
+
+	fs::create_directories(mDirectory, error);
+
+	// Rebuilding recency from the previous sessions, oldest first
+	std::vector<std::tuple<fs::file_time_type, std::string, uint64_t>> existing;
+
+	for (fs::directory_iterator it(mDirectory, error), end; !error && it != end; it.increment(error)) {
+		if (it->path().extension() != kCookedExtension) {
+			continue;
+		}
+
+		std::error_code entryError;
+		auto time = it->last_write_time(entryError);
+		auto size = it->file_size(entryError);
+
+		if (!entryError) {
+			existing.emplace_back(time, it->path().stem().string(), size);
+		}
+	}
+
+	std::sort(existing.begin(), existing.end());
+
+	for (const auto& [time, key, size] : existing) {
+		mRecency.push_front(key);
+		mRecords[key] = Record{size, mRecency.begin()};
+		mTotalSize += size;
+	}
+
+	evict();
+}
+
+bool TextureCache::cook(const uint8_t* data, size_t size, Cooked& cooked) {
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+
+	std::unique_ptr<stbi_uc, void (*)(void*)> image(stbi_load_from_memory(data, static_cast<int>(size), &width, &height, &channels, 4), stbi_image_free);
+
+	if (!image) {
+		std::cerr << "Failed to decode texture: " << stbi_failure_reason() << std::endl;
+		return false;
+	}
+
+	if (width > kCookedMaxSize || height > kCookedMaxSize) {
+		std::cerr << "Texture exceeds " << kCookedMaxSize << " pixels: " << width << "x" << height << std::endl;
+		return false;
+	}
+
+	cooked.levels.clear();
+
+	size_t total = 0;
+	for (int w = width, h = height;; w = std::max(1, w / 2), h = std::max(1, h / 2)) {
+		cooked.levels.push_back({w, h, total});
+		total += level_bytes(w, h);
+
+		if (w == 1 && h == 1) {
+			break;
+		}
+	}
+
+	cooked.pixels.resize(total);
+	std::copy_n(image.get(), level_bytes(width, height), cooked.pixels.data());
+
+	size_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+	// Each level is filtered from the previous one, the rows of a level are split between threads
+	for (size_t level = 1; level < cooked.levels.size(); ++level) {
+		const auto& source = cooked.levels[level - 1];
+		const auto& target = cooked.levels[level];
+		const uint8_t* sourceData = cooked.level_data(level - 1);
+		uint8_t* targetData = cooked.pixels.data() + target.offset;
+
+		size_t pixels = static_cast<size_t>(target.width) * target.height;
+		size_t jobs = pixels < kParallelFilterPixels ? 1 : std::min<size_t>(threadCount, target.height);
+
+		if (jobs == 1) {
+			filter_rows(sourceData, source.width, source.height, targetData, target.width, 0, target.height);
+			continue;
+		}
+
+		std::vector<std::future<void>> futures;
+		int rowsPerJob = static_cast<int>((target.height + jobs - 1) / jobs);
+
+		for (int begin = 0; begin < target.height; begin += rowsPerJob) {
+			int end = std::min(target.height, begin + rowsPerJob);
+			futures.emplace_back(std::async(std::launch::async, filter_rows, sourceData, source.width, source.height, targetData, target.width, begin, end));
+		}
+
+		for (auto& future : futures) {
+			future.get();
+		}
+	}
+
+	return true;
+}
+
+bool TextureCache::load(const std::string& key, Cooked& cooked) {
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+
+		if (mRecords.find(key) == mRecords.end()) {
+			return false;
+		}
+	}
+
+	MappedTextureFile file(path_for(key));
+
+	if (!file.data() || file.size() < sizeof(CookedHeader)) {
+		return false;
+	}
+
+	CookedHeader header;
+	std::memcpy(&header, file.data(), sizeof(header));
+
+	if (header.magic != kCookedMagic || header.version != kCookedVersion || header.levelCount == 0 || header.levelCount > 32) {
+		return false;
+	}
+
+	size_t tableBytes = header.levelCount * sizeof(CookedLevel) + static_cast<size_t>(header.chunkCount) * sizeof(CookedChunk);
+	size_t expectedChunks = (header.pixelBytes + kCookedChunkSize - 1) / kCookedChunkSize;
+
+	if (header.chunkCount != expectedChunks || file.size() < sizeof(CookedHeader) + tableBytes) {
+		return false;
+	}
+
+	std::vector<CookedLevel> levels(header.levelCount);
+	std::vector<CookedChunk> chunks(header.chunkCount);
+	std::memcpy(levels.data(), file.data() + sizeof(CookedHeader), levels.size() * sizeof(CookedLevel));
+	std::memcpy(chunks.data(), file.data() + sizeof(CookedHeader) + levels.size() * sizeof(CookedLevel), chunks.size() * sizeof(CookedChunk));
+
+	cooked.levels.clear();
+
+	size_t total = 0;
+	for (const auto& level : levels) {
+		if (level.width == 0 || level.height == 0 || level.width > kCookedMaxSize || level.height > kCookedMaxSize) {
+			return false;
+		}
+
+		cooked.levels.push_back({static_cast<int>(level.width), static_cast<int>(level.height), total});
+		total += level_bytes(level.width, level.height);
+	}
+
+	if (total != header.pixelBytes) {
+		return false;
+	}
+
+	for (size_t i = 0; i < chunks.size(); ++i) {
+		const auto& chunk = chunks[i];
+		size_t expectedRaw = std::min(kCookedChunkSize, total - i * kCookedChunkSize);
+
+		if (chunk.rawSize != expectedRaw || chunk.fileOffset > file.size() || chunk.compressedSize > file.size() - chunk.fileOffset) {
+			return false;
+		}
+	}
+
+	cooked.pixels.resize(total);
+
+	auto inflateChunk = [&](size_t i) {
+		const auto& chunk = chunks[i];
+		uLongf rawSize = chunk.rawSize;
+
+		return uncompress(cooked.pixels.data() + i * kCookedChunkSize, &rawSize, file.data() + chunk.fileOffset, chunk.compressedSize) == Z_OK && rawSize == chunk.rawSize;
+	};
+
+	if (!for_each_chunk(chunks.size(), inflateChunk)) {
+		std::cerr << "Damaged cooked texture: " << path_for(key) << std::endl;
+		return false;
+	}
+
+	touch(key);
+	return true;
+}
+
+void TextureCache::store(const std::string& key, const Cooked& cooked) {
+	size_t chunkCount = (cooked.pixels.size() + kCookedChunkSize - 1) / kCookedChunkSize;
+
+	std::vector<std::vector<uint8_t>> compressedChunks(chunkCount);
+
+	bool compressed = for_each_chunk(chunkCount, [&](size_t i) {
+		size_t rawSize = std::min(kCookedChunkSize, cooked.pixels.size() - i * kCookedChunkSize);
+		uLongf compressedSize = compressBound(rawSize);
+		auto& chunk = compressedChunks[i];
+		chunk.resize(compressedSize);
+
+		if (compress2(chunk.data(), &compressedSize, cooked.pixels.data() + i * kCookedChunkSize, rawSize, Z_DEFAULT_COMPRESSION) != Z_OK) {
+			return false;
+		}
+
+		chunk.resize(compressedSize);
+		return true;
+	});
+
+	if (!compressed) {
+		return;
+	}
+
+	CookedHeader header{kCookedMagic, kCookedVersion, static_cast<uint32_t>(cooked.levels.size()), static_cast<uint32_t>(chunkCount), cooked.pixels.size()};
+
+	std::vector<CookedLevel> levels;
+	for (const auto& level : cooked.levels) {
+		levels.push_back({static_cast<uint32_t>(level.width), static_cast<uint32_t>(level.height)});
+	}
+
+	std::vector<CookedChunk> chunks;
+	uint64_t offset = sizeof(CookedHeader) + levels.size() * sizeof(CookedLevel) + chunkCount * sizeof(CookedChunk);
+
+	for (size_t i = 0; i < chunkCount; ++i) {
+		uint32_t rawSize = static_cast<uint32_t>(std::min(kCookedChunkSize, cooked.pixels.size() - i * kCookedChunkSize));
+		chunks.push_back({offset, static_cast<uint32_t>(compressedChunks[i].size()), rawSize});
+		offset += compressedChunks[i].size();
+	}
+
+	std::string path = path_for(key);
+	std::string temporaryPath = path + ".tmp";
+
+	{
+		std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+
+		if (!stream.is_open()) {
+			std::cerr << "Failed to write cooked texture: " << temporaryPath << std::endl;
+			return;
+		}
+
+		stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		stream.write(reinterpret_cast<const char*>(levels.data()), levels.size() * sizeof(CookedLevel));
+		stream.write(reinterpret_cast<const char*>(chunks.data()), chunks.size() * sizeof(CookedChunk));
+
+		for (const auto& compressed : compressedChunks) {
+			stream.write(reinterpret_cast<const char*>(compressed.data()), compressed.size());
+		}
+
+		if (!stream.good()) {
+			return;
+		}
+	}
+
+	std::error_code error;
+	fs::rename(temporaryPath, path, error);
+
+	if (error) {
+		return;
+	}
+
+	uint64_t size = offset;
+
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	auto it = mRecords.find(key);
+	if (it != mRecords.end()) {
+		mTotalSize -= it->second.size;
+		mRecency.erase(it->second.recency);
+		mRecords.erase(it);
+	}
+
+	mRecency.push_front(key);
+	mRecords[key] = Record{size, mRecency.begin()};
+	mTotalSize += size;
+
+	evict();
+}
+
+uint64_t TextureCache::size_in_bytes() const {
+	std::unique_lock<std::mutex> lock(mMutex);
+	return mTotalSize;
+}
+
+std::string TextureCache::path_for(const std::string& key) const {
+	return (fs::path(mDirectory) / (key + kCookedExtension)).string();
+}
+
+void TextureCache::touch(const std::string& key) {
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	auto it = mRecords.find(key);
+	if (it == mRecords.end()) {
+		return;
+	}
+
+	mRecency.splice(mRecency.begin(), mRecency, it->second.recency);
+
+	// The modification time carries recency over to the next session
+	std::error_code error;
+	fs::last_write_time(path_for(key), fs::file_time_type::clock::now(), error);
+}
+
+void TextureCache::evict() {
+	while (mTotalSize > mBudget && !mRecency.empty()) {
+		const std::string& key = mRecency.back();
+		auto it = mRecords.find(key);
+
+		std::error_code error;
+		fs::remove(path_for(key), error);
+
+		mTotalSize -= it->second.size;
+		mRecords.erase(it);
+		mRecency.pop_back();
+	}
+}
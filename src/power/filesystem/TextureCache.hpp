@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief On-disk store of decoded textures and their mip chains, keyed by source content hash.
+ *
+ * cook() decodes an encoded image once and box filters its mip chain on worker
+ * threads. Stored files hold every level as RGBA8, back to back, split into
+ * zlib chunks that are inflated in parallel straight out of a memory mapping,
+ * so a later load costs no image decoding and each level uploads as is.
+ * Evicted least recently used first beyond the byte budget, with recency kept
+ * in the files' modification times like ThumbnailCache. All methods are thread-safe.
+ */
+class TextureCache {
+public:
+	struct Cooked {
+		struct Level {
+			int width = 0;
+			int height = 0;
+			size_t offset = 0; ///< Into pixels.
+		};
+
+		std::vector<Level> levels;
+		std::vector<uint8_t> pixels;
+
+		const uint8_t* level_data(size_t level) const {
+			return pixels.data() + levels[level].offset;
+		}
+	};
+
+	/**
+	 * @param directory  Cache location; empty selects PowerEngine/textures in the temp directory.
+	 * @param budget     Maximum total size of the cache on disk in bytes.
+	 */
+	explicit TextureCache(const std::string& directory = "", uint64_t budget = 512ull * 1024 * 1024);
+
+	TextureCache(const TextureCache&) = delete;
+	TextureCache& operator=(const TextureCache&) = delete;
+
+	// Decodes an encoded image (PNG, JPG, ...) to RGBA8 with its full mip chain down to 1x1; false if it cannot be decoded
+	static bool cook(const uint8_t* data, size_t size, Cooked& cooked);
+
+	bool load(const std::string& key, Cooked& cooked);
+	void store(const std::string& key, const Cooked& cooked);
+
+	uint64_t size_in_bytes() const;
+
+private:
+	struct Record {
+		uint64_t size;
+		std::list<std::string>::iterator recency;
+	};
+
+	std::string path_for(const std::string& key) const;
+	void touch(const std::string& key);
+	void evict();
+
+	std::string mDirectory;
+	uint64_t mBudget;
+
+	mutable std::mutex mMutex;
+	// Front is most recently used
+	std::list<std::string> mRecency;
+	std::unordered_map<std::string, Record> mRecords;
+	uint64_t mTotalSize = 0;
+};
@@ -0,0 +1,184 @@
+#include "ThumbnailCache.hpp"
+
+#include "filesystem/HashCache.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <tuple>
+
+namespace fs = std::filesystem;
+
+namespace {
+constexpr uint32_t kThumbnailMagic = 0x424D4854; // "THMB"
+constexpr const char* kThumbnailExtension = ".thumb";
+} // unnamed namespace
+
+ThumbnailCache::ThumbnailCache(const std::string& directory, uint64_t budget)
+: mDirectory(directory)
+, mBudget(budget) {
+	std::error_code error;
+
+	if (mDirectory.empty()) {
+		mDirectory = (fs::temp_directory_path(error) / "PowerEngine" / "thumbnails").string();
+	}
+
+	fs::create_directories(mDirectory, error);
+
+	// Rebuilding recency from the previous sessions, oldest first
+	std::vector<std::tuple<fs::file_time_type, std::string, uint64_t>> existing;
+
+	for (fs::directory_iterator it(mDirectory, error), end; !error && it != end; it.increment(error)) {
+		if (it->path().extension() != kThumbnailExtension) {
+			continue;
+		}
+
+		std::error_code entryError;
+		auto time = it->last_write_time(entryError);
+		auto size = it->file_size(entryError);
+
+		if (!entryError) {
+			existing.emplace_back(time, it->path().stem().string(), size);
+		}
+	}
+
+	std::sort(existing.begin(), existing.end());
+
+	for (const auto& [time, key, size] : existing) {
+		mRecency.push_front(key);
+		mRecords[key] = Record{size, mRecency.begin()};
+		mTotalSize += size;
+	}
+
+	evict();
+}
+
+std::string ThumbnailCache::hash_file(const std::string& path) {
+	ContentHash hash;
+
+	if (!HashCache::instance().hash_file(path, hash)) {
+		return "";
+	}
+
+	return hash.md5_hex();
+}
+
+bool ThumbnailCache::load(const std::string& key, Image& image) {
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+
+		if (mRecords.find(key) == mRecords.end()) {
+			return false;
+		}
+	}
+
+	std::ifstream stream(path_for(key), std::ios::binary);
+
+	if (!stream.is_open()) {
+		return false;
+	}
+
+	uint32_t header[3] = {};
+	stream.read(reinterpret_cast<char*>(header), sizeof(header));
+
+	if (!stream || header[0] != kThumbnailMagic || header[1] == 0 || header[2] == 0 || header[1] > 4096 || header[2] > 4096) {
+		return false;
+	}
+
+	image.width = static_cast<int>(header[1]);
+	image.height = static_cast<int>(header[2]);
+	image.pixels.resize(static_cast<size_t>(image.width) * image.height * 4);
+	stream.read(reinterpret_cast<char*>(image.pixels.data()), image.pixels.size());
+
+	if (!stream) {
+		return false;
+	}
+
+	touch(key);
+	return true;
+}
+
+void ThumbnailCache::store(const std::string& key, const Image& image) {
+	std::string path = path_for(key);
+	std::string temporaryPath = path + ".tmp";
+
+	{
+		std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+
+		if (!stream.is_open()) {
+			std::cerr << "Failed to write thumbnail: " << temporaryPath << std::endl;
+			return;
+		}
+
+		uint32_t header[3] = {kThumbnailMagic, static_cast<uint32_t>(image.width), static_cast<uint32_t>(image.height)};
+		stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+		stream.write(reinterpret_cast<const char*>(image.pixels.data()), image.pixels.size());
+
+		if (!stream.good()) {
+			return;
+		}
+	}
+
+	std::error_code error;
+	fs::rename(temporaryPath, path, error);
+
+	if (error) {
+		return;
+	}
+
+	uint64_t size = sizeof(uint32_t) * 3 + image.pixels.size();
+
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	auto it = mRecords.find(key);
+	if (it != mRecords.end()) {
+		mTotalSize -= it->second.size;
+		mRecency.erase(it->second.recency);
+		mRecords.erase(it);
+	}
+
+	mRecency.push_front(key);
+	mRecords[key] = Record{size, mRecency.begin()};
+	mTotalSize += size;
+
+	evict();
+}
+
+uint64_t ThumbnailCache::size_in_bytes() const {
+	std::unique_lock<std::mutex> lock(mMutex);
+	return mTotalSize;
+}
+
+std::string ThumbnailCache::path_for(const std::string& key) const {
+	return (fs::path(mDirectory) / (key + kThumbnailExtension)).string();
+}
+
+void ThumbnailCache::touch(const std::string& key) {
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	auto it = mRecords.find(key);
+	if (it == mRecords.end()) {
+		return;
+	}
+
+	mRecency.splice(mRecency.begin(), mRecency, it->second.recency);
+
+	// The modification time carries recency over to the next session
+	std::error_code error;
+	fs::last_write_time(path_for(key), fs::file_time_type::clock::now(), error);
+}
+
+void ThumbnailCache::evict() {
+	while (mTotalSize > mBudget && !mRecency.empty()) {
+		const std::string& key = mRecency.back();
+		auto it = mRecords.find(key);
+
+		std::error_code error;
+		fs::remove(path_for(key), error);
+
+		mTotalSize -= it->second.size;
+		mRecords.erase(it);
+		mRecency.pop_back();
+	}
+}
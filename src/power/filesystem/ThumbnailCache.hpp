@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief On-disk store of RGBA thumbnails keyed by source content hash.
+ *
+ * Entries survive between sessions and are evicted least recently used first
+ * once the cache grows beyond its byte budget. Recency is persisted through
+ * the files' modification times. All methods are thread-safe.
+ */
+class ThumbnailCache {
+public:
+	struct Image {
+		int width = 0;
+		int height = 0;
+		std::vector<uint8_t> pixels;
+	};
+
+	/**
+	 * @param directory  Cache location; empty selects PowerEngine/thumbnails in the temp directory.
+	 * @param budget     Maximum total size of the cache on disk in bytes.
+	 */
+	explicit ThumbnailCache(const std::string& directory = "", uint64_t budget = 64ull * 1024 * 1024);
+
+	ThumbnailCache(const ThumbnailCache&) = delete;
+	ThumbnailCache& operator=(const ThumbnailCache&) = delete;
+
+	// Hex MD5 of a file's contents, through HashCache; empty on failure
+	static std::string hash_file(const std::string& path);
+
+	bool load(const std::string& key, Image& image);
+	void store(const std::string& key, const Image& image);
+
+	uint64_t size_in_bytes() const;
+
+private:
+	struct Record {
+		uint64_t size;
+		std::list<std::string>::iterator recency;
+	};
+
+	std::string path_for(const std::string& key) const;
+	void touch(const std::string& key);
+	void evict();
+
+	std::string mDirectory;
+	uint64_t mBudget;
+
+	mutable std::mutex mMutex;
+	// Front is most recently used
+	std::list<std::string> mRecency;
+	std::unordered_map<std::string, Record> mRecords;
+	uint64_t mTotalSize = 0;
+};
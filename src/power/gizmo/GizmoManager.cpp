@@ -20,7 +20,10 @@
 
 
 
+#include <glm/gtc/type_ptr.hpp>
+
 #include <cmath>
+#include <cstring>
 
 
 
@@ -36,8 +39,12 @@
 
 #include "components/DrawableComponent.hpp"
 
+#include "components/MetadataComponent.hpp"
+
 #include "components/TransformComponent.hpp"
 
+#include "graphics/shading/ShaderWrapper.hpp"
+
 
 
 extern std::string get_resources_path();
@@ -114,12 +121,66 @@ mScaleGizmo(std::move(mMeshActorLoader.create_unique_actor(mRegistry, "ScaleGizm
 	
 	set_mode(GizmoMode::None);
 	
+	
+	upload_axis_instances();
+	
+}
+
+
+
+void GizmoManager::upload_axis_instances() {
+	
+	struct AxisInstance {
+		float axis[16];
+		float color[4];
+		float identifier[4];
+	};
+	
+	// The handle is authored along +X. Green picks as GizmoAxis::Z and blue as GizmoAxis::Y, as translate() expects
+	const glm::mat4 axes[3] = {
+		glm::mat4(1.0f),
+		glm::rotate(glm::mat4(1.0f), glm::half_pi<float>(), glm::vec3(0, 0, 1)),
+		glm::rotate(glm::mat4(1.0f), -glm::half_pi<float>(), glm::vec3(0, 1, 0))
+	};
+	
+	const glm::vec4 colors[3] = {{1, 0, 0, 1}, {0, 1, 0, 1}, {0, 0, 1, 1}};
+	const GizmoAxis identifiers[3] = {GizmoAxis::X, GizmoAxis::Z, GizmoAxis::Y};
+	
+	AxisInstance instances[3];
+	
+	for (int i = 0; i < 3; ++i) {
+		std::memcpy(instances[i].axis, glm::value_ptr(axes[i]), sizeof(instances[i].axis));
+		std::memcpy(instances[i].color, glm::value_ptr(colors[i]), sizeof(instances[i].color));
+		instances[i].identifier[0] = static_cast<float>(identifiers[i]);
+		instances[i].identifier[1] = instances[i].identifier[2] = instances[i].identifier[3] = 0.0f;
+	}
+	
+	// Shared by all three gizmos, which use the same shader
+	mMeshShader->persist_buffer("aInstances", nanogui::VariableType::Float32, {3, sizeof(AxisInstance) / sizeof(float)}, instances);
+	
 }
 
 
 
 void GizmoManager::select(GizmoAxis gizmoId) {
 	
+	bool dragging = gizmoId == GizmoAxis::X || gizmoId == GizmoAxis::Y || gizmoId == GizmoAxis::Z;
+	
+	
+	// A drag runs from grabbing an axis until it is released, its steps undo as one
+	if (dragging && !mDragging) {
+		
+		mActorManager.journal().begin_group();
+		
+	} else if (!dragging && mDragging) {
+		
+		mActorManager.journal().end_group();
+		
+	}
+	
+	
+	mDragging = dragging;
+	
 	mGizmoAxis = gizmoId;
 	
 }
@@ -142,6 +203,8 @@ void GizmoManager::select(std::optional<std::reference_wrapper<Actor>> actor) {
 	
 	mActiveActor = actor;
 	
+	mRenderListDirty = true;
+	
 	
 	if (mActiveActor.has_value()) {
 		
@@ -368,6 +431,16 @@ void GizmoManager::transform(float px, float py) {
 		auto& actor = mActiveActor.value().get();
 		
 		
+		if (!actor.find_component<TransformComponent>()) {
+			
+			return;
+			
+		}
+		
+		
+		Transform before = actor.get_component<TransformComponent>().transform;
+		
+		
 		switch (mCurrentMode) {
 				
 			case GizmoMode::Translation:{
@@ -401,6 +474,9 @@ void GizmoManager::transform(float px, float py) {
 				
 		}
 		
+		
+		mActorManager.record_transform_change(actor, before);
+		
 	}
 	
 }
@@ -411,6 +487,8 @@ void GizmoManager::set_mode(GizmoMode mode) {
 	
 	mCurrentMode = mode;
 	
+	mRenderListDirty = true;
+	
 	
 	mTranslationGizmo->get_component<ColorComponent>().set_visible(false);
 	
@@ -471,15 +549,32 @@ void GizmoManager::draw() {
 void GizmoManager::draw_content(const nanogui::Matrix4f& model, const nanogui::Matrix4f& view,
 								const nanogui::Matrix4f& projection) {
 	
+	// An idle editor keeps last frame's gizmo, its mesh already lives in the gizmo batches
+	glm::vec3 translation(0.0f);
+	glm::quat rotation(1, 0, 0, 0);
+	
+	if (mActiveActor.has_value()) {
+		auto& transformComponent = mActiveActor->get().get_component<TransformComponent>();
+		translation = transformComponent.get_translation();
+		rotation = transformComponent.get_rotation();
+	}
+	
+	if (!mRenderListDirty
+		&& translation == mRenderedTranslation
+		&& rotation == mRenderedRotation
+		&& std::memcmp(view.m, mRenderedView.m, sizeof(view.m)) == 0) {
+		return;
+	}
+	
+	mRenderListDirty = false;
+	mRenderedTranslation = translation;
+	mRenderedRotation = rotation;
+	mRenderedView = view;
+	
+	mRenderList.clear();
+	
 	if (mActiveActor.has_value() && mActiveGizmo.has_value()) {
 		
-		auto& actor = mActiveActor->get();
-		auto& transformComponent = actor.get_component<TransformComponent>();
-		
-		// Get the actor's transformation properties
-		auto translation = transformComponent.get_translation();
-		auto rotation = transformComponent.get_rotation(); // Actor's rotation (glm::quat)
-		
 		glm::vec3 actorPosition(translation.x, translation.y, translation.z);
 		
 		// --- FIX 1: Correct Camera Position and Scaling ---
@@ -515,9 +610,16 @@ void GizmoManager::draw_content(const nanogui::Matrix4f& model, const nanogui::M
 		// Combine transformations in the correct order: Scale -> Rotate -> Translate
 		auto gizmoModel = actorTranslationMatrix * finalRotationMatrix * scaleMatrix;
 		
-		// Convert the final GLM matrix back to a nanogui matrix and draw
-		auto gizmoMatrix = glm_to_nanogui(gizmoModel);
-		auto& drawable = mActiveGizmo->get().get_component<DrawableComponent>();
-		drawable.draw_content(gizmoMatrix, view, projection);
+		// Convert the final GLM matrix back to a nanogui matrix and hand it to the gizmo batches
+		auto& gizmo = mActiveGizmo->get();
+		auto& color = gizmo.get_component<ColorComponent>();
+		
+		auto& item = mRenderList.add();
+		item.model = glm_to_nanogui(gizmoModel);
+		item.color = color.get_color();
+		item.pickId = color.identifier();
+		item.instance = gizmo.get_component<MetadataComponent>().identifier();
+		item.flags = color.get_visible() ? RenderList::Visible : 0u;
+		item.instances = 3;
 	}
 }
@@ -2,9 +2,13 @@
 
 #include "animation/AnimationTimeProvider.hpp"
 #include "graphics/drawing/Drawable.hpp"
+#include "graphics/drawing/RenderList.hpp"
 
 #include <entt/entt.hpp>
 
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
 #include <nanogui/nanogui.h>
 
 #include <functional>
@@ -53,9 +57,17 @@ public:
     
     void draw_content(const nanogui::Matrix4f& model, const nanogui::Matrix4f& view, const nanogui::Matrix4f& projection) override;
 	
+	// Holds the active gizmo after draw(), for the gizmo batches
+	const RenderList& render_list() const {
+		return mRenderList;
+	}
+	
 private:
 	void set_mode(GizmoMode mode);
 	
+	// Uploads the transform, color and picking id of the three axis handles, drawn as instances of one handle
+	void upload_axis_instances();
+	
 	entt::registry mRegistry;
 
 	AnimationTimeProvider mDummyAnimationTimeProvider;
@@ -75,10 +87,21 @@ private:
 
 	GizmoAxis mGizmoAxis = GizmoAxis::None;
 	
+	// True while an axis is held, transform steps recorded meanwhile coalesce into one undo entry
+	bool mDragging = false;
+	
 	std::shared_ptr<nanogui::Button> mTranslationButton;
 	std::shared_ptr<nanogui::Button> mRotationButton;
 	std::shared_ptr<nanogui::Button> mScaleButton;
 	
 	std::optional<std::reference_wrapper<Actor>> mActiveGizmo;
+	
+	RenderList mRenderList;
+	
+	// What the render list was built from, it is only rebuilt when one of them changes
+	bool mRenderListDirty = true;
+	glm::vec3 mRenderedTranslation{0.0f};
+	glm::quat mRenderedRotation{1, 0, 0, 0};
+	nanogui::Matrix4f mRenderedView;
 };
 
@@ -0,0 +1,403 @@
+#include "graphics/capture/FrameCapture.hpp"
+
+#include "filesystem/ImageUtils.hpp"
+#include "profiling/Profiler.hpp"
+
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+#include <nanogui/opengl.h>
+#elif defined(NANOGUI_USE_METAL)
+#include "MetalHelper.hpp"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace {
+constexpr int kChannels = 4;
+
+void flip_rows(std::vector<uint8_t>& pixels, int width, int height, std::vector<uint8_t>& row) {
+	const size_t stride = static_cast<size_t>(width) * kChannels;
+	row.resize(stride);
+
+	for (int y = 0; y < height / 2; ++y) {
+		uint8_t* top = pixels.data() + y * stride;
+		uint8_t* bottom = pixels.data() + (height - 1 - y) * stride;
+		std::memcpy(row.data(), top, stride);
+		std::memcpy(top, bottom, stride);
+		std::memcpy(bottom, row.data(), stride);
+	}
+}
+} // unnamed namespace
+
+FrameCapture::FrameCapture(const Settings& settings) : mSettings(settings) {
+	size_t workerCount = mSettings.worker_count;
+
+	if (workerCount == 0) {
+		unsigned int hardwareThreads = std::thread::hardware_concurrency();
+		workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+
+	mSettings.max_frames_in_flight = std::max<size_t>(mSettings.max_frames_in_flight, 1);
+	mSettings.readback_buffer_count = std::max<size_t>(mSettings.readback_buffer_count, 1);
+	workerCount = std::min(workerCount, mSettings.max_frames_in_flight);
+
+	if (mSettings.format == OutputFormat::JpegSequence) {
+		std::error_code error;
+		std::filesystem::create_directories(mSettings.path, error);
+	}
+
+	for (size_t i = 0; i < workerCount; ++i) {
+		mWorkers.emplace_back([this]() {
+			worker_loop();
+		});
+	}
+}
+
+FrameCapture::~FrameCapture() {
+	finish();
+}
+
+void FrameCapture::capture(uint32_t framebuffer, void* nswin, void* texture, int x, int y, int width, int height) {
+	if (mFinished || width <= 0 || height <= 0) {
+		return;
+	}
+
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+	(void)nswin;
+	(void)texture;
+
+	ensure_readback_buffers(width, height);
+
+	ReadbackBuffer& buffer = mReadbackBuffers[mReadbackCursor];
+
+	// The oldest buffer in the ring was issued several frames ago and is normally ready
+	if (buffer.pending) {
+		resolve_readback(buffer);
+	}
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.handle);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	buffer.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+	buffer.pending = true;
+	mReadbackCursor = (mReadbackCursor + 1) % mReadbackBuffers.size();
+#elif defined(NANOGUI_USE_METAL)
+	(void)framebuffer;
+
+	// Metal readback is synchronous; encoding and writing still leave the render thread
+	std::vector<uint8_t> pixels = acquire_pixels(static_cast<size_t>(width) * height * kChannels);
+	MetalHelper::readPixelsFromMetal(nswin, texture, x, y, width, height, pixels);
+	submit(std::move(pixels), width, height, false);
+#else
+	(void)framebuffer;
+	(void)nswin;
+	(void)texture;
+	(void)x;
+	(void)y;
+#endif
+}
+
+void FrameCapture::submit(std::vector<uint8_t>&& pixels, int width, int height, bool flip) {
+	std::unique_lock<std::mutex> lock(mJobMutex);
+
+	// Backpressure: the render thread waits rather than queueing unbounded frames
+	mSlotAvailable.wait(lock, [this]() {
+		return mFramesInFlight < mSettings.max_frames_in_flight;
+	});
+
+	++mFramesInFlight;
+
+	mJobs.push_back(Job{mFramesCaptured++, std::move(pixels), width, height, flip});
+	mJobAvailable.notify_one();
+}
+
+void FrameCapture::finish() {
+	if (mFinished) {
+		return;
+	}
+
+	drain_readbacks();
+
+	{
+		std::unique_lock<std::mutex> lock(mJobMutex);
+		mSlotAvailable.wait(lock, [this]() {
+			return mFramesInFlight == 0;
+		});
+
+		mStopping = true;
+	}
+
+	mJobAvailable.notify_all();
+
+	for (auto& worker : mWorkers) {
+		if (worker.joinable()) {
+			worker.join();
+		}
+	}
+
+	mWorkers.clear();
+
+	{
+		std::unique_lock<std::mutex> lock(mWriteMutex);
+		if (mAviWriter.is_open()) {
+			mAviWriter.close();
+		}
+	}
+
+	destroy_readback_buffers();
+
+	mFinished = true;
+}
+
+uint64_t FrameCapture::frames_captured() const {
+	return mFramesCaptured;
+}
+
+uint64_t FrameCapture::frames_written() const {
+	std::unique_lock<std::mutex> lock(mWriteMutex);
+	return mFramesWritten;
+}
+
+std::vector<uint8_t> FrameCapture::acquire_pixels(size_t size) {
+	std::vector<uint8_t> pixels;
+
+	{
+		std::unique_lock<std::mutex> lock(mJobMutex);
+
+		if (!mPixelPool.empty()) {
+			pixels = std::move(mPixelPool.back());
+			mPixelPool.pop_back();
+		}
+	}
+
+	pixels.resize(size);
+	return pixels;
+}
+
+void FrameCapture::release_pixels(std::vector<uint8_t>&& pixels) {
+	std::unique_lock<std::mutex> lock(mJobMutex);
+	mPixelPool.push_back(std::move(pixels));
+}
+
+void FrameCapture::worker_loop() {
+	POWER_PROFILE_THREAD("Frame capture");
+	
+	std::vector<uint8_t> row;
+
+	while (true) {
+		Job job;
+
+		{
+			std::unique_lock<std::mutex> lock(mJobMutex);
+			mJobAvailable.wait(lock, [this]() {
+				return mStopping || !mJobs.empty();
+			});
+
+			if (mJobs.empty()) {
+				return;
+			}
+
+			job = std::move(mJobs.front());
+			mJobs.pop_front();
+		}
+
+		if (job.flip) {
+			flip_rows(job.pixels, job.width, job.height, row);
+		}
+
+		encode(job);
+	}
+}
+
+void FrameCapture::encode(Job& job) {
+	POWER_PROFILE_ZONE("FrameCapture::encode");
+	
+	std::vector<uint8_t> jpeg;
+	write_to_jpeg(job.pixels, job.width, job.height, kChannels, jpeg, mSettings.quality);
+
+	release_pixels(std::move(job.pixels));
+
+	// Failed encodes still commit an empty frame so later frames are not held back
+	commit(job.index, std::move(jpeg), job.width, job.height);
+}
+
+void FrameCapture::commit(uint64_t index, std::vector<uint8_t>&& jpeg, int width, int height) {
+	size_t completed = 0;
+
+	{
+		std::unique_lock<std::mutex> lock(mWriteMutex);
+
+		mEncodedFrames.emplace(index, EncodedFrame{std::move(jpeg), width, height});
+
+		// Writing every frame that is now contiguous with what is already on disk
+		while (!mEncodedFrames.empty() && mEncodedFrames.begin()->first == mNextFrameToWrite) {
+			write_frame(mEncodedFrames.begin()->second);
+			mEncodedFrames.erase(mEncodedFrames.begin());
+			++mNextFrameToWrite;
+			++completed;
+		}
+	}
+
+	if (completed > 0) {
+		std::unique_lock<std::mutex> lock(mJobMutex);
+		mFramesInFlight -= std::min(completed, mFramesInFlight);
+		mSlotAvailable.notify_all();
+	}
+}
+
+void FrameCapture::write_frame(const EncodedFrame& frame) {
+	const std::vector<uint8_t>& jpeg = frame.jpeg;
+
+	if (jpeg.empty()) {
+		std::cerr << "Skipping frame " << mNextFrameToWrite << ", encoding failed" << std::endl;
+		return;
+	}
+
+	if (mSettings.format == OutputFormat::MjpegAvi) {
+		if (!mAviWriter.is_open() && !mAviWriter.open(mSettings.path, frame.width, frame.height, mSettings.fps)) {
+			return;
+		}
+
+		if (mAviWriter.write_frame(jpeg)) {
+			++mFramesWritten;
+		}
+		return;
+	}
+
+	// Generate the frame filename with padded zeros
+	std::ostringstream filename_stream;
+	filename_stream << "frame" << std::setw(mFramePadding) << std::setfill('0') << mFramesWritten << ".jpg";
+
+	std::filesystem::path frame_path = std::filesystem::path(mSettings.path) / filename_stream.str();
+
+	std::ofstream file(frame_path, std::ios::binary);
+	if (file.is_open()) {
+		file.write(reinterpret_cast<const char*>(jpeg.data()), jpeg.size());
+		++mFramesWritten;
+	} else {
+		std::cerr << "Failed to save frame: " << frame_path << std::endl;
+		return;
+	}
+
+	// Check if padding needs to be increased
+	int max_frames = static_cast<int>(std::pow(10, mFramePadding) - 1);
+	if (static_cast<int64_t>(mFramesWritten) > max_frames) {
+		mFramePadding += 1;
+		std::cout << "Increased frame padding to: " << mFramePadding << " digits." << std::endl;
+	}
+}
+
+void FrameCapture::ensure_readback_buffers(int width, int height) {
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+	if (!mReadbackBuffers.empty() && mReadbackBuffers.front().width == width && mReadbackBuffers.front().height == height) {
+		return;
+	}
+
+	// The canvas was resized; flush what is in flight before reallocating
+	drain_readbacks();
+	destroy_readback_buffers();
+
+	mReadbackBuffers.resize(mSettings.readback_buffer_count);
+
+	for (auto& buffer : mReadbackBuffers) {
+		GLuint handle = 0;
+		glGenBuffers(1, &handle);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, handle);
+		glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(width) * height * kChannels, nullptr, GL_STREAM_READ);
+
+		buffer.handle = handle;
+		buffer.width = width;
+		buffer.height = height;
+	}
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	mReadbackCursor = 0;
+#else
+	(void)width;
+	(void)height;
+#endif
+}
+
+void FrameCapture::resolve_readback(ReadbackBuffer& buffer) {
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+	GLsync fence = static_cast<GLsync>(buffer.fence);
+	GLenum status = GL_ALREADY_SIGNALED;
+
+	if (fence) {
+		status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+		glDeleteSync(fence);
+		buffer.fence = nullptr;
+	}
+
+	buffer.pending = false;
+
+	// The copy never landed; the frame is dropped rather than written as garbage
+	if (status == GL_TIMEOUT_EXPIRED || status == GL_WAIT_FAILED) {
+		std::cerr << "Frame capture: readback did not complete, dropping frame" << std::endl;
+		return;
+	}
+
+	const size_t size = static_cast<size_t>(buffer.width) * buffer.height * kChannels;
+	std::vector<uint8_t> pixels = acquire_pixels(size);
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.handle);
+	void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(size), GL_MAP_READ_BIT);
+
+	if (mapped) {
+		std::memcpy(pixels.data(), mapped, size);
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	if (!mapped) {
+		std::cerr << "Frame capture: failed to map readback buffer, dropping frame" << std::endl;
+		release_pixels(std::move(pixels));
+		return;
+	}
+
+	// OpenGL rows are bottom-up
+	submit(std::move(pixels), buffer.width, buffer.height, true);
+#else
+	(void)buffer;
+#endif
+}
+
+void FrameCapture::drain_readbacks() {
+	if (mReadbackBuffers.empty()) {
+		return;
+	}
+
+	// Resolving in issue order keeps frame indices in capture order
+	for (size_t i = 0; i < mReadbackBuffers.size(); ++i) {
+		ReadbackBuffer& buffer = mReadbackBuffers[(mReadbackCursor + i) % mReadbackBuffers.size()];
+
+		if (buffer.pending) {
+			resolve_readback(buffer);
+		}
+	}
+}
+
+void FrameCapture::destroy_readback_buffers() {
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+	for (auto& buffer : mReadbackBuffers) {
+		if (buffer.fence) {
+			glDeleteSync(static_cast<GLsync>(buffer.fence));
+		}
+
+		GLuint handle = buffer.handle;
+		glDeleteBuffers(1, &handle);
+	}
+#endif
+
+	mReadbackBuffers.clear();
+}
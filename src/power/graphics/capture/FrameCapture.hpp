@@ -0,0 +1,135 @@
+#pragma once
+
+#include "filesystem/MjpegAviWriter.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Asynchronous frame capture for movie export.
+ *
+ * The render thread only issues the read back. On OpenGL, pixels go into a ring
+ * of pixel buffer objects and are mapped a few frames later, so the GPU never
+ * stalls waiting for the read. Flipping and JPEG encoding run on a bounded pool
+ * of worker threads. Encoded frames are written to disk strictly in capture
+ * order, either as a numbered JPEG sequence or into a single MJPEG AVI file.
+ */
+class FrameCapture {
+public:
+	enum class OutputFormat {
+		JpegSequence,
+		MjpegAvi
+	};
+
+	struct Settings {
+		OutputFormat format = OutputFormat::JpegSequence;
+		// Directory for a JPEG sequence, file path for an AVI
+		std::string path;
+		int fps = 60;
+		int quality = 95;
+		// 0 picks hardware_concurrency - 1
+		size_t worker_count = 0;
+		// Frames read back but not yet written; capture() blocks beyond this
+		size_t max_frames_in_flight = 8;
+		// Depth of the pixel buffer object ring on OpenGL
+		size_t readback_buffer_count = 3;
+	};
+
+	explicit FrameCapture(const Settings& settings);
+	~FrameCapture();
+
+	FrameCapture(const FrameCapture&) = delete;
+	FrameCapture& operator=(const FrameCapture&) = delete;
+
+	/**
+	 * @brief Reads back a region of a framebuffer and queues it for encoding.
+	 *
+	 * Must be called on the thread that owns the graphics context.
+	 *
+	 * @param framebuffer  OpenGL framebuffer handle (ignored on Metal).
+	 * @param nswin        Native window used for Metal readback (ignored on OpenGL).
+	 * @param texture      Metal texture to read from (ignored on OpenGL).
+	 */
+	void capture(uint32_t framebuffer, void* nswin, void* texture, int x, int y, int width, int height);
+
+	/**
+	 * @brief Queues already read back RGBA pixels for encoding.
+	 *
+	 * @param pixels      RGBA8 pixels, moved into the pipeline.
+	 * @param flip        Whether rows are stored bottom-up and must be flipped.
+	 */
+	void submit(std::vector<uint8_t>&& pixels, int width, int height, bool flip);
+
+	// Drains pending read backs, waits for every frame to be written and closes the output
+	void finish();
+
+	uint64_t frames_captured() const;
+	uint64_t frames_written() const;
+
+private:
+	struct Job {
+		uint64_t index;
+		std::vector<uint8_t> pixels;
+		int width;
+		int height;
+		bool flip;
+	};
+
+	struct EncodedFrame {
+		std::vector<uint8_t> jpeg;
+		int width;
+		int height;
+	};
+
+	struct ReadbackBuffer {
+		uint32_t handle = 0;
+		void* fence = nullptr;
+		int width = 0;
+		int height = 0;
+		bool pending = false;
+	};
+
+	std::vector<uint8_t> acquire_pixels(size_t size);
+	void release_pixels(std::vector<uint8_t>&& pixels);
+
+	void worker_loop();
+	void encode(Job& job);
+	void commit(uint64_t index, std::vector<uint8_t>&& jpeg, int width, int height);
+	void write_frame(const EncodedFrame& frame);
+
+	void ensure_readback_buffers(int width, int height);
+	void resolve_readback(ReadbackBuffer& buffer);
+	void drain_readbacks();
+	void destroy_readback_buffers();
+
+	Settings mSettings;
+
+	std::vector<std::thread> mWorkers;
+	std::deque<Job> mJobs;
+	std::mutex mJobMutex;
+	std::condition_variable mJobAvailable;
+	std::condition_variable mSlotAvailable;
+	size_t mFramesInFlight = 0;
+	bool mStopping = false;
+
+	// Recycled pixel storage so steady-state capture does not hit the allocator
+	std::vector<std::vector<uint8_t>> mPixelPool;
+
+	mutable std::mutex mWriteMutex;
+	std::map<uint64_t, EncodedFrame> mEncodedFrames;
+	uint64_t mNextFrameToWrite = 0;
+	uint64_t mFramesWritten = 0;
+	int mFramePadding = 4;
+	MjpegAviWriter mAviWriter;
+
+	uint64_t mFramesCaptured = 0;
+	std::vector<ReadbackBuffer> mReadbackBuffers;
+	size_t mReadbackCursor = 0;
+	bool mFinished = false;
+};
@@ -1,13 +1,109 @@
 #include "Batch.hpp"
 
+#include "graphics/shading/LightClusters.hpp"
+#include "graphics/shading/MaterialProperties.hpp"
+#include "graphics/shading/ShaderWrapper.hpp"
+#include "graphics/shading/TextureRegistry.hpp"
+
 #include <nanogui/texture.h>
 
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
 void Batch::init_dummy_texture() {
+	// A one layer array, as the mesh shaders sample array textures
 	mDummyTexture = std::make_shared<nanogui::Texture>(
 													   nanogui::Texture::PixelFormat::RGBA,       // Set pixel format to RGBA
 													   nanogui::Texture::ComponentFormat::UInt8,  // Use unsigned 8-bit components for each channel
-													   nanogui::Vector2i(1, 1));                              // Size of the texture (1x1)
+													   nanogui::Vector2i(1, 1),                   // Size of the texture (1x1)
+													   nanogui::Texture::InterpolationMode::Nearest,
+													   nanogui::Texture::InterpolationMode::Nearest,
+													   nanogui::Texture::WrapMode::Repeat,
+													   1,
+													   nanogui::Texture::TextureFlags::ShaderRead,
+													   false,
+													   1);
 	
 }
 
 std::shared_ptr<nanogui::Texture> Batch::mDummyTexture;
+
+void Batch::upload_materials(ShaderWrapper& shader, const std::vector<std::shared_ptr<MaterialProperties>>& materials) {
+	auto& bound = mBoundMaterials[shader.identifier()];
+	
+	// Consecutive draws of the same model keep their materials and textures bound
+	if (!bound.materials.empty() && bound.materials.size() == materials.size() &&
+		std::equal(materials.begin(), materials.end(), bound.materials.begin(),
+				   [](const auto& material, const auto& boundMaterial) { return boundMaterial.lock() == material; })) {
+		return;
+	}
+	
+	bound.materials.assign(materials.begin(), materials.end());
+	
+	size_t slotCount = shader.get_buffer_size("textures");
+	
+	// Distinct arrays in first use order; materials on layers of the same array share its slot
+	std::vector<std::shared_ptr<nanogui::Texture>> slots;
+	std::vector<MaterialCPU> materialsCPU(std::max<size_t>(materials.size(), 1));
+	
+	for (size_t i = 0; i < materials.size(); ++i) {
+		auto& material = *materials[i];
+		MaterialCPU& materialCPU = materialsCPU[i];
+		memcpy(&materialCPU.mAmbient[0], glm::value_ptr(material.mAmbient), sizeof(materialCPU.mAmbient));
+		memcpy(&materialCPU.mDiffuse[0], glm::value_ptr(material.mDiffuse), sizeof(materialCPU.mDiffuse));
+		memcpy(&materialCPU.mSpecular[0], glm::value_ptr(material.mSpecular), sizeof(materialCPU.mSpecular));
+		materialCPU.mShininess = material.mShininess;
+		materialCPU.mOpacity = material.mOpacity;
+		
+		if (!material.mHasDiffuseTexture || !material.mTextureDiffuse) {
+			continue;
+		}
+		
+		auto& texture = material.mTextureDiffuse->texture();
+		size_t slot = std::find(slots.begin(), slots.end(), texture) - slots.begin();
+		
+		if (slot == slots.size()) {
+			if (slots.size() == slotCount) {
+				std::cerr << "Material " << i << " left untextured: more than " << slotCount << " texture arrays in one draw" << std::endl;
+				continue;
+			}
+			
+			slots.push_back(texture);
+		}
+		
+		materialCPU.mHasDiffuseTexture = 1.0f;
+		materialCPU.mTextureLayer = static_cast<float>(material.mTextureDiffuse->layer());
+		materialCPU.mTextureSlot = static_cast<float>(slot);
+	}
+	
+	shader.set_buffer("materials", nanogui::VariableType::Float32,
+					  {materialsCPU.size(), sizeof(MaterialCPU) / sizeof(float)},
+					  materialsCPU.data(), -1, true);
+	
+	bound.textures.resize(slotCount);
+	
+	for (size_t slot = 0; slot < slotCount; ++slot) {
+		const auto& texture = slot < slots.size() ? slots[slot] : mDummyTexture;
+		
+		if (bound.textures[slot].lock() != texture) {
+			shader.set_texture("textures", texture, static_cast<int>(slot));
+			bound.textures[slot] = texture;
+		}
+	}
+}
+
+std::unordered_map<int, Batch::BoundMaterials> Batch::mBoundMaterials;
+
+void Batch::upload_light_clusters(ShaderWrapper& shader, const std::pair<nanogui::Vector2i, nanogui::Vector2i>& viewport) {
+	auto& generation = mLightClusterGenerations[shader.identifier()];
+	
+	if (generation == mLightClusters->generation()) {
+		return;
+	}
+	
+	mLightClusters->upload(shader, viewport);
+	generation = mLightClusters->generation();
+}
@@ -3,15 +3,22 @@
 
 #include <nanogui/vector.h>
 
+#include <cstdint>
 #include <memory>
 #include <functional>
+#include <unordered_map>
+#include <vector>
 
 
 namespace nanogui {
 class Texture;
 }
 
+class LightClusters;
 class Mesh;
+class RenderList;
+class ShaderWrapper;
+struct MaterialProperties;
 
 class Batch {
 	
@@ -27,6 +34,39 @@ public:
 		return mDummyTexture;
 	}
 	
+	// Dynamic lights for shaders that support clustered lighting; unlit when unset
+	void set_light_clusters(const LightClusters* lightClusters) {
+		mLightClusters = lightClusters;
+	}
+	
+	// What to draw this frame; batches only submit the instances listed in it
+	void set_render_list(const RenderList* renderList) {
+		mRenderList = renderList;
+	}
+	
+protected:
+	// Uploads a draw's materials as a persisted buffer and binds the array textures they sample. Skipped when
+	// the shader already holds the set from an earlier draw; a texture slot is only rebound when its array changes
+	static void upload_materials(ShaderWrapper& shader, const std::vector<std::shared_ptr<MaterialProperties>>& materials);
+	
+	// Uploads the light clusters to the shader unless it already holds the ones from their latest build
+	void upload_light_clusters(ShaderWrapper& shader, const std::pair<nanogui::Vector2i, nanogui::Vector2i>& viewport);
+	
+	const LightClusters* mLightClusters = nullptr;
+	const RenderList* mRenderList = nullptr;
+	
 private:
+	// Light cluster generation last uploaded to each shader, by shader identifier
+	std::unordered_map<int, uint64_t> mLightClusterGenerations;
+	
 	static std::shared_ptr<nanogui::Texture> mDummyTexture;
+	
+	// Weak, so that binding keeps neither materials nor textures alive; an expired entry never matches
+	struct BoundMaterials {
+		std::vector<std::weak_ptr<MaterialProperties>> materials;
+		std::vector<std::weak_ptr<nanogui::Texture>> textures; ///< By texture slot.
+	};
+	
+	// By shader identifier
+	static std::unordered_map<int, BoundMaterials> mBoundMaterials;
 };
@@ -5,6 +5,8 @@
 
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <cstring>
+
 
 #if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
 #include <nanogui/opengl.h>
@@ -15,50 +17,36 @@
 Grid::Grid(ShaderManager& shaderManager)
 : mShaderWrapper(shaderManager.get_shader("grid"))
 {
-	mGridVertices = {
-		// positions
-		-1.0f, -1.0f,
-		1.0f, -1.0f,
-		1.0f,  1.0f,
-		1.0f,  1.0f,
-		-1.0f,  1.0f,
-		-1.0f, -1.0f
-	};
-
+	// Near and far planes, fixed for the editor grid
+	mShaderWrapper.set_uniform("u_near", 0.01f);
+	mShaderWrapper.set_uniform("u_far", 1200.0f);
 }
 
 void Grid::draw_content(const nanogui::Matrix4f& model, const nanogui::Matrix4f& view, const nanogui::Matrix4f& projection) {
 	
-	// Common code: Set up vertex buffer
-	mShaderWrapper.set_buffer("aPosition", nanogui::VariableType::Float32, {mGridVertices.size() / 2, 2}, mGridVertices.data());
+	bool changed = !mUniformsSet
+		|| std::memcmp(mView.m, view.m, sizeof(view.m)) != 0
+		|| std::memcmp(mProjection.m, projection.m, sizeof(projection.m)) != 0;
 	
-	// Common code: Near and far planes
-	float nearPlane = 0.01f;   // Example value for near plane
-	float farPlane = 1200;      // Example value for far plane
+	if (changed) {
+		mView = view;
+		mProjection = projection;
+		mUniformsSet = true;
+		
+		mShaderWrapper.set_uniform("aView", view);
+		mShaderWrapper.set_uniform("aInvProjectionView", (projection * view).inverse());
+	}
 	
-	// Common code: Set uniforms
-	mShaderWrapper.set_uniform("u_near", nearPlane);
-	mShaderWrapper.set_uniform("u_far", farPlane);
-	mShaderWrapper.set_uniform("aView", view);
-//	mShaderWrapper.set_uniform("aProjection", projection);
-	
-	nanogui::Matrix4f projectionView = projection * view;
-	
-	nanogui::Matrix4f projectionViewInverse = projectionView.inverse();
-
-	mShaderWrapper.set_uniform("aInvProjectionView", projectionViewInverse); // Pass inverse matrix
-
-	
-	// Common code: Begin shader, draw, and end
+	// The vertex shader builds a full-screen triangle from the vertex index, nothing is uploaded
 	mShaderWrapper.begin();
-	mShaderWrapper.draw_array(nanogui::Shader::PrimitiveType::Triangle, 0, 6, false);
+	mShaderWrapper.draw_array(nanogui::Shader::PrimitiveType::Triangle, 0, 3, false);
 	mShaderWrapper.end();
 }
 
 Grid2d::Grid2d(ShaderManager& shaderManager)
 : mShaderWrapper(shaderManager.load_shader("grid2d", "internal/shaders/metal/grid2d_vs.metal", "internal/shaders/metal/grid2d_fs.metal", nanogui::Shader::BlendMode::AlphaBlend)), mScrollOffset(0.0f, 0.0f), mGridSize(125.0f), mLineWidth(1.0f)
 {
-	mGridVertices = {
+	std::vector<float> vertices = {
 		// positions for a full-screen quad
 		-1.0f, -1.0f,
 		1.0f, -1.0f,
@@ -67,6 +55,9 @@ Grid2d::Grid2d(ShaderManager& shaderManager)
 		-1.0f,  1.0f,
 		-1.0f, -1.0f
 	};
+	
+	// Uploaded once, the quad never changes
+	mShaderWrapper.persist_buffer("aPosition", nanogui::VariableType::Float32, {vertices.size() / 2, 2}, vertices.data());
 }
 
 // Method to update scroll offset
@@ -77,9 +68,6 @@ void Grid2d::set_scroll_offset(const nanogui::Vector2f& offset) {
 
 void Grid2d::draw_content(const nanogui::Matrix4f& model, const nanogui::Matrix4f& view, const nanogui::Matrix4f& projection) {
 	
-	// Set up vertex buffer
-	mShaderWrapper.set_buffer("aPosition", nanogui::VariableType::Float32, {mGridVertices.size() / 2, 2}, mGridVertices.data());
-	
 	// Set uniforms
 	mShaderWrapper.set_uniform("aView", view);
 	mShaderWrapper.set_uniform("aProjection", projection);
@@ -89,7 +77,7 @@ void Grid2d::draw_content(const nanogui::Matrix4f& model, const nanogui::Matrix4
 	
 	// Draw
 	mShaderWrapper.begin();
-	mShaderWrapper.draw_array(nanogui::Shader::PrimitiveType::Triangle, 0, mGridVertices.size() / 2);
+	mShaderWrapper.draw_array(nanogui::Shader::PrimitiveType::Triangle, 0, kQuadVertexCount);
 	mShaderWrapper.end();
 }
 
@@ -18,8 +18,11 @@ public:
 	
 private:
 	ShaderWrapper mShaderWrapper;
-	std::vector<float> mGridVertices;
-	std::vector<unsigned int> mGridIndices;
+	
+	// Uniforms persist on the shader, so they are only sent again when the camera moves
+	nanogui::Matrix4f mView;
+	nanogui::Matrix4f mProjection;
+	bool mUniformsSet = false;
 };
 
 
@@ -33,8 +36,9 @@ public:
 	void set_scroll_offset(const nanogui::Vector2f& offset);
 	
 private:
+	static constexpr size_t kQuadVertexCount = 6;
+	
 	ShaderWrapper mShaderWrapper;
-	std::vector<float> mGridVertices;
 	nanogui::Vector2f mScrollOffset;
 	float mGridSize;
 	float mLineWidth;
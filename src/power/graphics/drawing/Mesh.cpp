@@ -24,7 +24,7 @@
 #include <algorithm>
 
 Mesh::Mesh(MeshData& meshData, ShaderWrapper& shader, IMeshBatch& meshBatch, MetadataComponent& metadataComponent, ColorComponent& colorComponent)
-: mMeshData(meshData), mShader(shader), mMeshBatch(meshBatch), mMetadataComponent(metadataComponent), mColorComponent(colorComponent), mModelMatrix(nanogui::Matrix4f::identity()) {
+: mMeshData(meshData), mShader(shader), mMeshBatch(meshBatch), mMetadataComponent(metadataComponent), mColorComponent(colorComponent) {
 	
 	size_t numVertices = mMeshData.get_vertices().size();
 	
@@ -75,7 +75,10 @@ Mesh::Mesh(MeshData& meshData, ShaderWrapper& shader, IMeshBatch& meshBatch, Met
 		mFlattenedColors[i * 4 + 3] = color.a;
 	}
 	
-	mModelMatrix = nanogui::Matrix4f::identity(); // Or any other transformation
+	mMeshData.update_memory_usage();
+	mFlattenedMemory.set(tracked_capacity(mFlattenedPositions) + tracked_capacity(mFlattenedNormals) +
+						 tracked_capacity(mFlattenedTexCoords1) + tracked_capacity(mFlattenedTexCoords2) +
+						 tracked_capacity(mFlattenedMaterialIds) + tracked_capacity(mFlattenedColors));
 	
 	// Properly pass a reference_wrapper<Mesh> to add_mesh
 	mMeshBatch.add_mesh(std::ref(*this));
@@ -87,6 +90,5 @@ Mesh::~Mesh() {
 
 void Mesh::draw_content(const nanogui::Matrix4f& model, const nanogui::Matrix4f& view,
 							   const nanogui::Matrix4f& projection) {
-	
-	mModelMatrix = model;
+	// Submitted by MeshBatch from the render list
 }
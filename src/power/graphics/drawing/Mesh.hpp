@@ -5,6 +5,7 @@
 #include "graphics/shading/MeshData.hpp"
 #include "graphics/shading/MeshVertex.hpp"
 #include "graphics/shading/ShaderWrapper.hpp"
+#include "profiling/MemoryTracker.hpp"
 
 #include <nanogui/vector.h>
 
@@ -45,9 +46,6 @@ public:
 		return mColorComponent;
 	}
 	
-	const nanogui::Matrix4f& get_model_matrix() {
-		return mModelMatrix;
-	}
 	
 private:
 	MeshData& mMeshData;
@@ -62,10 +60,9 @@ private:
 	std::vector<float> mFlattenedTexCoords2;
 	std::vector<int> mFlattenedMaterialIds;
 	std::vector<float> mFlattenedColors; // Added to store flattened color data
+	TrackedMemory mFlattenedMemory{MemoryTracker::Tag::FlattenedAttributes};
 
 	IMeshBatch& mMeshBatch;
 	MetadataComponent& mMetadataComponent;
 	ColorComponent& mColorComponent;
-	
-	nanogui::Matrix4f mModelMatrix;
 };
@@ -2,7 +2,11 @@
 #include "MeshBatch.hpp"
 #include "components/ColorComponent.hpp"
 #include "graphics/drawing/Mesh.hpp"
+#include "graphics/drawing/RenderList.hpp"
+#include "graphics/shading/LightClusters.hpp"
 #include "graphics/shading/ShaderWrapper.hpp"
+#include "profiling/Profiler.hpp"
+#include <nanogui/renderpass.h>
 #include <algorithm>
 #include <vector>
 
@@ -24,6 +28,8 @@ void MeshBatch::clear() {
 	mMeshBatchIndex.clear();
 	mMeshOffsetInBatch.clear();
 	mMeshIndexCount.clear();
+	
+	update_memory_usage();
 }
 
 size_t MeshBatch::find_or_create_batch(int identifier, size_t requiredVertices) {
@@ -86,6 +92,8 @@ void MeshBatch::append(std::reference_wrapper<Mesh> meshRef) {
 	
 	// Upload the current batch
 	upload_vertex_data(shader, identifier, batchIndex);
+	
+	update_memory_usage();
 }
 
 void MeshBatch::remove(std::reference_wrapper<Mesh> meshRef) {
@@ -124,7 +132,24 @@ void MeshBatch::remove(std::reference_wrapper<Mesh> meshRef) {
 		mMeshBatchIndex[instanceId].erase(identifier);
 		mMeshOffsetInBatch[instanceId].erase(identifier);
 		mMeshIndexCount[instanceId].erase(identifier);
+		
+		update_memory_usage();
+	}
+}
+
+void MeshBatch::update_memory_usage() {
+	uint64_t bytes = 0;
+	
+	for (const auto& [identifier, batches] : mBatches) {
+		for (const auto& batch : batches) {
+			bytes += tracked_capacity(batch.positions) + tracked_capacity(batch.normals) +
+					 tracked_capacity(batch.texCoords1) + tracked_capacity(batch.texCoords2) +
+					 tracked_capacity(batch.materialIds) + tracked_capacity(batch.colors) +
+					 tracked_capacity(batch.indices);
+		}
 	}
+	
+	mMemory.set(bytes);
 }
 
 void MeshBatch::upload_vertex_data(ShaderWrapper& shader, int identifier, size_t batchIndex) {
@@ -145,73 +170,55 @@ void MeshBatch::upload_vertex_data(ShaderWrapper& shader, int identifier, size_t
 						  {batch.indices.size()}, batch.indices.data());
 }
 
-void MeshBatch::upload_material_data(ShaderWrapper& shader,
-									 const std::vector<std::shared_ptr<MaterialProperties>>& materialData) {
-	size_t numMaterials = materialData.size();
-	std::vector<MaterialCPU> materialsCPU(numMaterials);
-	int textureSetCount = 0;
-	
-	for (size_t i = 0; i < numMaterials; ++i) {
-		auto& material = *materialData[i];
-		MaterialCPU& materialCPU = materialsCPU[i];
-		memcpy(&materialCPU.mAmbient[0], glm::value_ptr(material.mAmbient), sizeof(materialCPU.mAmbient));
-		memcpy(&materialCPU.mDiffuse[0], glm::value_ptr(material.mDiffuse), sizeof(materialCPU.mDiffuse));
-		memcpy(&materialCPU.mSpecular[0], glm::value_ptr(material.mSpecular), sizeof(materialCPU.mSpecular));
-		materialCPU.mShininess = material.mShininess;
-		materialCPU.mOpacity = material.mOpacity;
-		materialCPU.mHasDiffuseTexture = material.mHasDiffuseTexture ? 1.0f : 0.0f;
-		if (material.mHasDiffuseTexture) {
-			shader.set_texture("textures", material.mTextureDiffuse, i);
-			textureSetCount++;
-		}
-	}
+void MeshBatch::draw_content(const nanogui::Matrix4f& view, const nanogui::Matrix4f& projection) {
+	POWER_PROFILE_ZONE("MeshBatch::draw_content");
+	POWER_PROFILE_GPU_ZONE("MeshBatch");
 	
-	if (numMaterials == 0) {
-		numMaterials = 1;
-		materialsCPU.push_back({});
+	if (!mRenderList) {
+		return;
 	}
 	
-	shader.set_buffer("materials", nanogui::VariableType::Float32,
-					  {numMaterials, sizeof(MaterialCPU) / sizeof(float)},
-					  materialsCPU.data());
-	
-	size_t dummy_texture_count = shader.get_buffer_size("textures");
-	for (size_t i = textureSetCount; i < dummy_texture_count; ++i) {
-		shader.set_texture("textures", Batch::get_dummy_texture(), i);
+	// Once per frame and shader, ahead of the draws, which all read the same persisted cluster buffers
+	if (mLightClusters) {
+		for (const auto& [instance, meshes] : mMeshes) {
+			for (const auto& meshRef : meshes) {
+				upload_light_clusters(meshRef.get().get_shader(), mRenderPass.viewport());
+			}
+		}
 	}
-}
-
-void MeshBatch::draw_content(const nanogui::Matrix4f& view, const nanogui::Matrix4f& projection) {
-	for (const auto& [identifier, batches] : mBatches) {
-		for (size_t batchIndex = 0; batchIndex < batches.size(); ++batchIndex) {
-			for (const auto& [instanceId, meshVector] : mMeshes) {
-				for (const auto& meshRef : meshVector) {
-					auto& mesh = meshRef.get();
-					if (!mesh.get_color_component().get_visible() ||
-						mesh.get_shader().identifier() != identifier ||
-						mMeshBatchIndex[instanceId][identifier] != batchIndex) {
-						continue;
-					}
-					
-					auto& shader = mesh.get_shader();
-					shader.set_uniform("aProjection", projection);
-					shader.set_uniform("aView", view);
-					shader.set_uniform("aModel", mesh.get_model_matrix());
-					shader.set_uniform("identifier", mesh.get_color_component().identifier());
-					shader.set_uniform("color", glm_to_nanogui(mesh.get_color_component().get_color()));
-					
-					upload_material_data(shader, mesh.get_mesh_data().get_material_properties());
-					
-					size_t startIdx = mMeshOffsetInBatch[instanceId][identifier];
-					size_t count = mMeshIndexCount[instanceId][identifier];
-					
-					// Only issue a draw call if there is something to draw.
-					if (count > 0) {
-						shader.begin();
-						shader.draw_array(nanogui::Shader::PrimitiveType::Triangle, (uint32_t)startIdx, (uint32_t)count, true);
-						shader.end();
-					}
-				}
+	
+	for (const auto& item : mRenderList->items()) {
+		if (!(item.flags & RenderList::Visible) || (item.flags & RenderList::Skinned)) {
+			continue;
+		}
+		
+		auto instanceIt = mMeshes.find(item.instance);
+		
+		if (instanceIt == mMeshes.end()) {
+			continue;
+		}
+		
+		for (const auto& meshRef : instanceIt->second) {
+			auto& mesh = meshRef.get();
+			auto& shader = mesh.get_shader();
+			int identifier = shader.identifier();
+			
+			shader.set_uniform("aProjection", projection);
+			shader.set_uniform("aView", view);
+			shader.set_uniform("aModel", item.model);
+			shader.set_uniform("identifier", item.pickId);
+			shader.set_uniform("color", glm_to_nanogui(mRenderList->color_of(item)));
+			
+			upload_materials(shader, mesh.get_mesh_data().get_material_properties());
+			
+			size_t startIdx = mMeshOffsetInBatch[item.instance][identifier];
+			size_t count = mMeshIndexCount[item.instance][identifier];
+			
+			// Only issue a draw call if there is something to draw.
+			if (count > 0) {
+				shader.begin();
+				shader.draw_array(nanogui::Shader::PrimitiveType::Triangle, (uint32_t)startIdx, (uint32_t)count, true, item.instances);
+				shader.end();
 			}
 		}
 	}
@@ -3,6 +3,7 @@
 
 #include "graphics/drawing/IMeshBatch.hpp"
 #include "graphics/shading/MaterialProperties.hpp"
+#include "profiling/MemoryTracker.hpp"
 #include <nanogui/vector.h>
 #include <functional>
 
@@ -41,9 +42,9 @@ public:
 	
 private:
 	void append(std::reference_wrapper<Mesh> meshRef) override;
-	void upload_material_data(ShaderWrapper& shader, const std::vector<std::shared_ptr<MaterialProperties>>& materialData);
 	void upload_vertex_data(ShaderWrapper& shader, int identifier, size_t batchIndex);
 	size_t find_or_create_batch(int identifier, size_t requiredVertices);
+	void update_memory_usage();
 	
 	// Main data structures
 	std::unordered_map<int, std::vector<std::reference_wrapper<Mesh>>> mMeshes;
@@ -55,4 +56,6 @@ private:
 	std::unordered_map<int, std::unordered_map<int, size_t>> mMeshIndexCount; // instance ID -> index count
 	
 	nanogui::RenderPass& mRenderPass;
+	
+	TrackedMemory mMemory{MemoryTracker::Tag::BatchBuffers};
 };
@@ -0,0 +1,217 @@
+#include "ModelThumbnailRenderer.hpp"
+
+#include "ShaderManager.hpp"
+#include "components/ColorComponent.hpp"
+#include "components/MetadataComponent.hpp"
+#include "graphics/drawing/Mesh.hpp"
+#include "graphics/drawing/MeshBatch.hpp"
+#include "graphics/drawing/RenderList.hpp"
+#include "graphics/shading/LightClusters.hpp"
+#include "graphics/shading/ShaderWrapper.hpp"
+#include "import/ModelImporter.hpp"
+#include "profiling/Profiler.hpp"
+
+#include <nanogui/renderpass.h>
+#include <nanogui/texture.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+namespace {
+// Rendered at this multiple of the thumbnail size and averaged down, for smooth edges
+constexpr int kThumbnailSupersampling = 2;
+
+constexpr float kThumbnailFov = 0.5f; // radians
+
+// Stands in for the actor identifier the meshes are batched under
+constexpr int kThumbnailInstance = 1;
+} // unnamed namespace
+
+ModelThumbnailRenderer::ModelThumbnailRenderer() = default;
+
+ModelThumbnailRenderer::~ModelThumbnailRenderer() = default;
+
+void ModelThumbnailRenderer::prepare(int resolution) {
+	if (!mRenderPass) {
+		nanogui::Vector2i size(resolution, resolution);
+
+		mColorTarget = std::make_shared<nanogui::Texture>(nanogui::Texture::PixelFormat::RGBA,
+														  nanogui::Texture::ComponentFormat::UInt8,
+														  size,
+														  nanogui::Texture::InterpolationMode::Bilinear,
+														  nanogui::Texture::InterpolationMode::Bilinear,
+														  nanogui::Texture::WrapMode::ClampToEdge,
+														  1,
+														  nanogui::Texture::TextureFlags::RenderTarget);
+
+		// The mesh shader also writes picking identifiers, which are discarded here
+		mIdentifierTarget = std::make_shared<nanogui::Texture>(nanogui::Texture::PixelFormat::R,
+															   nanogui::Texture::ComponentFormat::Int32,
+															   size,
+															   nanogui::Texture::InterpolationMode::Nearest,
+															   nanogui::Texture::InterpolationMode::Nearest,
+															   nanogui::Texture::WrapMode::ClampToEdge,
+															   1,
+															   nanogui::Texture::TextureFlags::RenderTarget);
+
+		mDepthTarget = std::make_shared<nanogui::Texture>(nanogui::Texture::PixelFormat::Depth,
+														  nanogui::Texture::ComponentFormat::Float32,
+														  size,
+														  nanogui::Texture::InterpolationMode::Nearest,
+														  nanogui::Texture::InterpolationMode::Nearest,
+														  nanogui::Texture::WrapMode::ClampToEdge,
+														  1,
+														  nanogui::Texture::TextureFlags::RenderTarget);
+
+		mRenderPass = std::make_unique<nanogui::RenderPass>(std::vector<std::reference_wrapper<nanogui::Object>>{*mColorTarget, *mIdentifierTarget},
+															std::make_optional<std::reference_wrapper<nanogui::Object>>(*mDepthTarget));
+		mRenderPass->set_clear_color(0, nanogui::Color(0.0f, 0.0f, 0.0f, 0.0f));
+		mRenderPass->set_clear_color(1, nanogui::Color(0.0f, 0.0f, 0.0f, 0.0f));
+		mRenderPass->set_clear_depth(1.0f);
+
+		// Pipelines are built for the targets of the pass they are loaded against
+		mShaderManager = std::make_unique<ShaderManager>(*mRenderPass);
+		mShaderManager->load_default_shaders();
+		mShader = std::make_unique<ShaderWrapper>(mShaderManager->get_shader("mesh"));
+
+		mRenderList = std::make_unique<RenderList>();
+		mLightClusters = std::make_unique<LightClusters>();
+
+		mMeshBatch = std::make_unique<MeshBatch>(*mRenderPass);
+		mMeshBatch->set_render_list(mRenderList.get());
+		mMeshBatch->set_light_clusters(mLightClusters.get());
+	}
+
+	if (resolution != mResolution) {
+		mRenderPass->resize(nanogui::Vector2i(resolution, resolution));
+		mResolution = resolution;
+	}
+}
+
+ModelThumbnailRenderer::Model::Model() = default;
+
+ModelThumbnailRenderer::Model::~Model() = default;
+
+std::unique_ptr<ModelThumbnailRenderer::Model> ModelThumbnailRenderer::load(const std::string& path) {
+	POWER_PROFILE_ZONE("ModelThumbnailRenderer::load");
+
+	auto model = std::make_unique<Model>();
+	model->importer = std::make_unique<ModelImporter>();
+
+	if (!model->importer->LoadModel(path)) {
+		std::cerr << "Failed to import model for thumbnail: " << path << std::endl;
+		return nullptr;
+	}
+
+	model->minimum = glm::vec3(std::numeric_limits<float>::max());
+	model->maximum = glm::vec3(std::numeric_limits<float>::lowest());
+
+	for (auto& meshData : model->importer->GetMeshData()) {
+		for (const auto& vertex : meshData->get_vertices()) {
+			glm::vec3 position = vertex->get_position();
+			model->minimum = glm::min(model->minimum, position);
+			model->maximum = glm::max(model->maximum, position);
+		}
+	}
+
+	if (model->minimum.x > model->maximum.x) {
+		return nullptr;
+	}
+
+	return model;
+}
+
+bool ModelThumbnailRenderer::render(Model& model, int size, ThumbnailCache::Image& thumbnail) {
+	POWER_PROFILE_ZONE("ModelThumbnailRenderer::render");
+
+	if (size <= 0) {
+		return false;
+	}
+
+	int resolution = size * kThumbnailSupersampling;
+
+	prepare(resolution);
+
+	MetadataComponent metadata(kThumbnailInstance, "Thumbnail");
+	ColorComponent color(kThumbnailInstance);
+
+	// Skinned models are drawn in their bind pose, with the static mesh shader
+	std::vector<std::unique_ptr<Mesh>> meshes;
+
+	for (auto& meshData : model.importer->GetMeshData()) {
+		meshes.push_back(std::make_unique<Mesh>(*meshData, *mShader, *mMeshBatch, metadata, color));
+	}
+
+	// Frames the bounding sphere, seen from the front right and slightly above
+	glm::vec3 center = (model.minimum + model.maximum) * 0.5f;
+	float radius = std::max(glm::length(model.maximum - model.minimum) * 0.5f, 1e-3f);
+	float distance = radius / std::sin(kThumbnailFov * 0.5f);
+	glm::vec3 eye = center + glm::normalize(glm::vec3(1.0f, 0.6f, 1.0f)) * distance;
+	float near = std::max(distance - radius * 1.5f, distance * 0.01f);
+	float far = distance + radius * 1.5f;
+
+	nanogui::Matrix4f view = nanogui::Matrix4f::look_at(nanogui::Vector3f(eye.x, eye.y, eye.z),
+														  nanogui::Vector3f(center.x, center.y, center.z),
+														  nanogui::Vector3f(0.0f, 1.0f, 0.0f));
+	nanogui::Matrix4f projection = nanogui::Matrix4f::perspective(kThumbnailFov, near, far, 1.0f);
+
+	// No dynamic lights; built anyway so the shader reads an empty light list
+	mLightClusters->build(glm::lookAt(eye, center, glm::vec3(0.0f, 1.0f, 0.0f)),
+						  glm::perspective(kThumbnailFov, 1.0f, near, far), {});
+
+	mRenderList->clear();
+	auto& item = mRenderList->add();
+	item.model = nanogui::Matrix4f::identity();
+	item.color = color.get_color();
+	item.instance = kThumbnailInstance;
+	item.pickId = 0;
+	item.flags = RenderList::Visible;
+
+	mRenderPass->begin();
+	mRenderPass->set_depth_test(nanogui::RenderPass::DepthTest::Less, true);
+	mMeshBatch->draw_content(view, projection);
+	mRenderPass->end();
+
+	mRenderList->clear();
+
+	// Batch data goes first, so the meshes do not rebuild it one by one as they are destroyed
+	mMeshBatch->clear();
+	meshes.clear();
+
+	// Waits for the pass to finish
+	std::vector<uint8_t> pixels(static_cast<size_t>(resolution) * resolution * 4);
+	mColorTarget->download(pixels.data());
+
+	thumbnail.width = size;
+	thumbnail.height = size;
+	thumbnail.pixels.assign(static_cast<size_t>(size) * size * 4, 0);
+
+	for (int y = 0; y < size; ++y) {
+		for (int x = 0; x < size; ++x) {
+			uint32_t sum[4] = {0, 0, 0, 0};
+
+			for (int sy = 0; sy < kThumbnailSupersampling; ++sy) {
+				const uint8_t* row = pixels.data() + ((static_cast<size_t>(y) * kThumbnailSupersampling + sy) * resolution + x * kThumbnailSupersampling) * 4;
+
+				for (int sx = 0; sx < kThumbnailSupersampling; ++sx, row += 4) {
+					for (int c = 0; c < 4; ++c) {
+						sum[c] += row[c];
+					}
+				}
+			}
+
+			uint8_t* pixel = thumbnail.pixels.data() + (static_cast<size_t>(y) * size + x) * 4;
+
+			for (int c = 0; c < 4; ++c) {
+				pixel[c] = static_cast<uint8_t>(sum[c] / (kThumbnailSupersampling * kThumbnailSupersampling));
+			}
+		}
+	}
+
+	return true;
+}
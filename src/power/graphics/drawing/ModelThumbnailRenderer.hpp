@@ -0,0 +1,72 @@
+#pragma once
+
+#include "filesystem/ThumbnailCache.hpp"
+
+#include <glm/glm.hpp>
+
+#include <memory>
+#include <string>
+
+namespace nanogui {
+class RenderPass;
+class Texture;
+}
+
+class LightClusters;
+class MeshBatch;
+class ModelImporter;
+class RenderList;
+class ShaderManager;
+class ShaderWrapper;
+
+/**
+ * @brief Renders model files into small RGBA images for the resources browser.
+ *
+ * load() imports the model and measures its bounds, and may run on a worker
+ * thread. render() batches the imported meshes through a MeshBatch of its own
+ * and draws them in their bind pose, framed by the bounds, into an offscreen
+ * render pass that is read back once the GPU is done. Render targets and the
+ * shader are created on first use and kept for later renders. render() is main
+ * thread only.
+ */
+class ModelThumbnailRenderer {
+public:
+	// Imported meshes of a model and their bounds
+	struct Model {
+		Model();
+		~Model();
+
+		std::unique_ptr<ModelImporter> importer;
+		glm::vec3 minimum;
+		glm::vec3 maximum;
+	};
+
+	ModelThumbnailRenderer();
+	~ModelThumbnailRenderer();
+
+	ModelThumbnailRenderer(const ModelThumbnailRenderer&) = delete;
+	ModelThumbnailRenderer& operator=(const ModelThumbnailRenderer&) = delete;
+
+	// Nullptr when the model cannot be imported or has nothing to draw. Material
+	// textures are created here, which the Metal backend allows from any thread
+	static std::unique_ptr<Model> load(const std::string& path);
+
+	bool render(Model& model, int size, ThumbnailCache::Image& thumbnail);
+
+private:
+	// Creates the targets at the given size, and the shader and batch on first use
+	void prepare(int resolution);
+
+	int mResolution = 0;
+
+	std::shared_ptr<nanogui::Texture> mColorTarget;
+	std::shared_ptr<nanogui::Texture> mIdentifierTarget;
+	std::shared_ptr<nanogui::Texture> mDepthTarget;
+	std::unique_ptr<nanogui::RenderPass> mRenderPass;
+
+	std::unique_ptr<ShaderManager> mShaderManager;
+	std::unique_ptr<ShaderWrapper> mShader;
+	std::unique_ptr<RenderList> mRenderList;
+	std::unique_ptr<LightClusters> mLightClusters;
+	std::unique_ptr<MeshBatch> mMeshBatch;
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "profiling/MemoryTracker.hpp"
+
+#include <nanogui/vector.h>
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Packed per-frame draw records, written once by the render extraction and read by the batches.
+ *
+ * One item per drawn actor, laid out contiguously so submission walks plain memory
+ * instead of reaching through components and virtual draw calls. Items refer to the
+ * actor's meshes by the instance identifier the batches registered them under; the
+ * batches resolve the shader and index range from it.
+ */
+class RenderList {
+public:
+	enum Flags : uint32_t {
+		Visible = 1u << 0,
+		Skinned = 1u << 1
+	};
+
+	struct Item {
+		nanogui::Matrix4f model;
+		glm::vec4 color;
+		int instance; ///< MetadataComponent identifier the meshes were batched under.
+		int pickId;   ///< ColorComponent identifier written to the picking target.
+		uint32_t flags;
+		uint32_t instances = 1; ///< Copies drawn by one call, told apart by the shader's instance id.
+	};
+
+	// Keeps the capacity, so a scene of stable size extracts without allocating
+	void clear() {
+		mItems.clear();
+		mHighlightId = 0;
+	}
+
+	Item& add() {
+		mItems.emplace_back();
+
+		if (mItems.capacity() != mCapacity) {
+			mCapacity = mItems.capacity();
+			mMemory.set(tracked_capacity(mItems));
+		}
+
+		return mItems.back();
+	}
+
+	const std::vector<Item>& items() const {
+		return mItems;
+	}
+
+	// Overrides the color of one item for this frame, used for the selection
+	void set_highlight(int pickId, const glm::vec4& color) {
+		mHighlightId = pickId;
+		mHighlightColor = color;
+	}
+
+	const glm::vec4& color_of(const Item& item) const {
+		return item.pickId == mHighlightId && mHighlightId != 0 ? mHighlightColor : item.color;
+	}
+
+private:
+	std::vector<Item> mItems;
+	size_t mCapacity = 0;
+
+	int mHighlightId = 0;
+	glm::vec4 mHighlightColor{1.0f};
+
+	TrackedMemory mMemory{MemoryTracker::Tag::BatchBuffers};
+};
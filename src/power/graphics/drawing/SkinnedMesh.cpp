@@ -35,8 +35,7 @@ mShader(shader),
 mMeshBatch(meshBatch),
 mMetadataComponent(metadataComponent),
 mColorComponent(colorComponent),
-mSkeletonComponent(skeletonComponent),
-mModelMatrix(nanogui::Matrix4f::identity()) {
+mSkeletonComponent(skeletonComponent) {
 	
 	size_t numVertices = mMeshData.get_vertices().size();
 	
@@ -95,7 +94,11 @@ mModelMatrix(nanogui::Matrix4f::identity()) {
 
 	}
 	
-	mModelMatrix = nanogui::Matrix4f::identity();
+	mMeshData.update_memory_usage();
+	mFlattenedMemory.set(tracked_capacity(mFlattenedPositions) + tracked_capacity(mFlattenedNormals) +
+						 tracked_capacity(mFlattenedTexCoords1) + tracked_capacity(mFlattenedTexCoords2) +
+						 tracked_capacity(mFlattenedBoneIds) + tracked_capacity(mFlattenedWeights) +
+						 tracked_capacity(mFlattenedMaterialIds) + tracked_capacity(mFlattenedColors));
 	
 	// Append the mesh to the batch
 	mMeshBatch.add_mesh(*this);
@@ -107,6 +110,5 @@ SkinnedMesh::~SkinnedMesh() {
 
 void SkinnedMesh::draw_content(const nanogui::Matrix4f& model, const nanogui::Matrix4f& view,
 							   const nanogui::Matrix4f& projection) {
-	
-	mModelMatrix = model;
+	// Submitted by SkinnedMeshBatch from the render list
 }
@@ -7,6 +7,7 @@
 #include "graphics/shading/MeshData.hpp"
 #include "graphics/shading/MaterialProperties.hpp"
 #include "graphics/shading/ShaderWrapper.hpp"
+#include "profiling/MemoryTracker.hpp"
 
 #include <nanogui/vector.h>
 
@@ -56,9 +57,6 @@ public:
 		return mSkeletonComponent;
 	}
 
-	const nanogui::Matrix4f& get_model_matrix() {
-		return mModelMatrix;
-	}
 	
 private:
 	MeshData& mMeshData;
@@ -74,10 +72,10 @@ private:
 	std::vector<float> mFlattenedWeights;
 	std::vector<int> mFlattenedMaterialIds;
 	std::vector<float> mFlattenedColors; // Added to store flattened color data
+	TrackedMemory mFlattenedMemory{MemoryTracker::Tag::FlattenedAttributes};
 	
 	ISkinnedMeshBatch& mMeshBatch;
 	MetadataComponent& mMetadataComponent;
 	ColorComponent& mColorComponent;
 	SkeletonComponent& mSkeletonComponent;
-	nanogui::Matrix4f mModelMatrix;
 };
@@ -4,8 +4,11 @@
 #include "components/MetadataComponent.hpp"
 #include "components/SkinnedAnimationComponent.hpp"
 
+#include "graphics/drawing/RenderList.hpp"
 #include "graphics/drawing/SkinnedMesh.hpp"
+#include "graphics/shading/LightClusters.hpp"
 #include "graphics/shading/ShaderWrapper.hpp"
+#include "profiling/Profiler.hpp"
 
 #include <nanogui/renderpass.h>
 
@@ -69,6 +72,8 @@ void SkinnedMeshBatch::clear() {
 	mMeshBatchIndex.clear();
 	mMeshOffsetInBatch.clear();
 	mMeshIndexCount.clear();
+	
+	update_memory_usage();
 }
 
 size_t SkinnedMeshBatch::find_or_create_batch(int identifier, size_t requiredVertices) {
@@ -132,6 +137,8 @@ void SkinnedMeshBatch::append(std::reference_wrapper<SkinnedMesh> meshRef) {
 	
 	// Upload the current batch
 	upload_vertex_data(shader, identifier, batchIndex);
+	
+	update_memory_usage();
 }
 
 
@@ -169,66 +176,26 @@ void SkinnedMeshBatch::remove(std::reference_wrapper<SkinnedMesh> meshRef) {
 		mMeshBatchIndex[instanceId].erase(identifier);
 		mMeshOffsetInBatch[instanceId].erase(identifier);
 		mMeshIndexCount[instanceId].erase(identifier);
+		
+		update_memory_usage();
 	}
 }
 
 
-void SkinnedMeshBatch::upload_material_data(ShaderWrapper& shader, const std::vector<std::shared_ptr<MaterialProperties>>& materialData) {
-	// Ensure we have a valid number of materials
-	size_t numMaterials = materialData.size();
+void SkinnedMeshBatch::update_memory_usage() {
+	uint64_t bytes = 0;
 	
-	// Create a CPU-side array of Material structs
-	std::vector<MaterialCPU> materialsCPU(numMaterials);
-	
-	int textureSetCount = 0;
-	
-	for (size_t i = 0; i < numMaterials; ++i) {
-		auto& material = *materialData[i];
-		MaterialCPU& materialCPU = materialsCPU[i];
-		
-		// Copy ambient, diffuse, and specular as arrays
-		memcpy(&materialCPU.mAmbient[0], glm::value_ptr(material.mAmbient), sizeof(materialCPU.mAmbient));
-		
-		memcpy(&materialCPU.mDiffuse[0], glm::value_ptr(material.mDiffuse), sizeof(materialCPU.mDiffuse));
-		
-		memcpy(&materialCPU.mSpecular[0], glm::value_ptr(material.mSpecular), sizeof(materialCPU.mSpecular));
-		
-		// Copy the rest of the individual fields
-		materialCPU.mShininess = material.mShininess;
-		materialCPU.mOpacity = material.mOpacity;
-		materialCPU.mHasDiffuseTexture = material.mHasDiffuseTexture ? 1.0f : 0.0f;
-		
-		// Set the diffuse texture (if it exists) or a dummy texture
-		std::string textureBaseName = "textures";
-		if (material.mHasDiffuseTexture) {
-			shader.set_texture(textureBaseName, material.mTextureDiffuse, i);
-			
-			textureSetCount++;
+	for (const auto& [identifier, batches] : mBatches) {
+		for (const auto& batch : batches) {
+			bytes += tracked_capacity(batch.positions) + tracked_capacity(batch.normals) +
+					 tracked_capacity(batch.texCoords1) + tracked_capacity(batch.texCoords2) +
+					 tracked_capacity(batch.materialIds) + tracked_capacity(batch.colors) +
+					 tracked_capacity(batch.indices) +
+					 tracked_capacity(batch.boneIds) + tracked_capacity(batch.boneWeights);
 		}
-		
-	}
-	
-	if (numMaterials == 0) { // upload dummy material
-		numMaterials = 1;
-		materialsCPU.push_back({});
-	}
-	
-	
-	shader.set_buffer(
-					  "materials",
-					  nanogui::VariableType::Float32,
-					  {numMaterials, sizeof(MaterialCPU) / sizeof(float)},
-					  materialsCPU.data()
-					  );
-	
-	size_t dummy_texture_count = shader.get_buffer_size("textures");
-	
-	for (size_t i = textureSetCount; i<dummy_texture_count; ++i) {
-		std::string textureBaseName = "textures";
-		
-		shader.set_texture(textureBaseName, Batch::get_dummy_texture(), i);
 	}
 	
+	mMemory.set(bytes);
 }
 
 void SkinnedMeshBatch::upload_vertex_data(ShaderWrapper& shader, int identifier, size_t batchIndex) {
@@ -256,47 +223,63 @@ void SkinnedMeshBatch::upload_vertex_data(ShaderWrapper& shader, int identifier,
 
 
 void SkinnedMeshBatch::draw_content(const nanogui::Matrix4f& view, const nanogui::Matrix4f& projection) {
-	for (const auto& [identifier, batches] : mBatches) {
-		for (size_t batchIndex = 0; batchIndex < batches.size(); ++batchIndex) {
-			for (const auto& [instanceId, meshVector] : mMeshes) {
-				for (const auto& meshRef : meshVector) {
-					auto& mesh = meshRef.get();
-					
-					if (!mesh.get_color_component().get_visible() ||
-						mesh.get_shader().identifier() != identifier ||
-						mMeshBatchIndex[instanceId][identifier] != batchIndex) {
-						continue;
-					}
-					
-					auto& shader = mesh.get_shader();
-					shader.set_uniform("aProjection", projection);
-					shader.set_uniform("aView", view);
-					
-					shader.set_uniform("aModel", mesh.get_model_matrix());
-
-					// Apply color component
-					shader.set_uniform("identifier", mesh.get_color_component().identifier());
-					shader.set_uniform("color", glm_to_nanogui(mesh.get_color_component().get_color()));
-					
-					// Upload materials for the current mesh
-					upload_material_data(shader, mesh.get_mesh_data().get_material_properties());
-					
-					// Upload bone data for animation
-					auto bones = SkinnedMeshBatchUtils::build_cpu_bones(mesh.get_skeleton_component());
-					shader.set_buffer("bones", nanogui::VariableType::Float32,
-									  {bones.size(), sizeof(SkinnedMeshBatchUtils::BoneCPU) / sizeof(float)},
-									  bones.data());
-					
-					size_t startIdx = mMeshOffsetInBatch[instanceId][identifier];
-					size_t count = mMeshIndexCount[instanceId][identifier];
-					
-					if (count > 0) {
-						shader.begin();
-						// The 'startIdx' is an offset in the index buffer.
-						shader.draw_array(nanogui::Shader::PrimitiveType::Triangle, (uint32_t)startIdx, (uint32_t)count, true);
-						shader.end();
-					}
-				}
+	POWER_PROFILE_ZONE("SkinnedMeshBatch::draw_content");
+	POWER_PROFILE_GPU_ZONE("SkinnedMeshBatch");
+	
+	if (!mRenderList) {
+		return;
+	}
+	
+	// Once per frame and shader, ahead of the draws, which all read the same persisted cluster buffers
+	if (mLightClusters) {
+		for (const auto& [instance, meshes] : mMeshes) {
+			for (const auto& meshRef : meshes) {
+				upload_light_clusters(meshRef.get().get_shader(), mRenderPass.viewport());
+			}
+		}
+	}
+	
+	for (const auto& item : mRenderList->items()) {
+		if (!(item.flags & RenderList::Visible) || !(item.flags & RenderList::Skinned)) {
+			continue;
+		}
+		
+		auto instanceIt = mMeshes.find(item.instance);
+		
+		if (instanceIt == mMeshes.end()) {
+			continue;
+		}
+		
+		for (const auto& meshRef : instanceIt->second) {
+			auto& mesh = meshRef.get();
+			auto& shader = mesh.get_shader();
+			int identifier = shader.identifier();
+			
+			shader.set_uniform("aProjection", projection);
+			shader.set_uniform("aView", view);
+			shader.set_uniform("aModel", item.model);
+			
+			// Apply color component
+			shader.set_uniform("identifier", item.pickId);
+			shader.set_uniform("color", glm_to_nanogui(mRenderList->color_of(item)));
+			
+			// Upload materials for the current mesh
+			upload_materials(shader, mesh.get_mesh_data().get_material_properties());
+			
+			// Upload bone data for animation
+			auto bones = SkinnedMeshBatchUtils::build_cpu_bones(mesh.get_skeleton_component());
+			shader.set_buffer("bones", nanogui::VariableType::Float32,
+							  {bones.size(), sizeof(SkinnedMeshBatchUtils::BoneCPU) / sizeof(float)},
+							  bones.data());
+			
+			size_t startIdx = mMeshOffsetInBatch[item.instance][identifier];
+			size_t count = mMeshIndexCount[item.instance][identifier];
+			
+			if (count > 0) {
+				shader.begin();
+				// The 'startIdx' is an offset in the index buffer.
+				shader.draw_array(nanogui::Shader::PrimitiveType::Triangle, (uint32_t)startIdx, (uint32_t)count, true, item.instances);
+				shader.end();
 			}
 		}
 	}
@@ -0,0 +1,309 @@
+#include "graphics/shading/LightClusters.hpp"
+
+#include "graphics/shading/ShaderWrapper.hpp"
+#include "profiling/Profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+// Smallest near plane used for slicing, guards against degenerate projections
+constexpr float kMinimumNearPlane = 1e-4f;
+
+// Bounding sphere of a spot light's cone, tighter than the range sphere for narrow cones
+void spot_bounding_sphere(const LightClusters::Light& light, glm::vec3& center, float& radius) {
+	float cosAngle = light.cosOuterAngle;
+
+	if (cosAngle >= 0.70710678f) {
+		radius = light.range / (2.0f * cosAngle);
+		center = light.position + light.direction * radius;
+	} else {
+		radius = light.range * std::sqrt(std::max(0.0f, 1.0f - cosAngle * cosAngle));
+		center = light.position + light.direction * (light.range * cosAngle);
+	}
+}
+
+uint32_t clamp_tile(float ndc, uint32_t tiles) {
+	float tile = std::floor((ndc * 0.5f + 0.5f) * static_cast<float>(tiles));
+	return static_cast<uint32_t>(std::clamp(tile, 0.0f, static_cast<float>(tiles - 1)));
+}
+} // unnamed namespace
+
+LightClusters::LightClusters()
+: mMinX(kClusterCount), mMinY(kClusterCount), mMinZ(kClusterCount)
+, mMaxX(kClusterCount), mMaxY(kClusterCount), mMaxZ(kClusterCount)
+, mRowHits(kTilesX)
+, mClusterCounts(kClusterCount)
+, mGpuLights(1)
+, mLightGrid(kClusterCount * 2, 0)
+, mLightIndices(1, 0) {
+}
+
+void LightClusters::build(const glm::mat4& view, const glm::mat4& projection, const std::vector<Light>& lights) {
+	POWER_PROFILE_ZONE("LightClusters::build");
+
+	++mGeneration;
+
+	if (projection != mProjection) {
+		rebuild_cluster_bounds(projection);
+	}
+
+	mVisibleLights.clear();
+
+	for (uint32_t i = 0; i < lights.size(); ++i) {
+		const Light& light = lights[i];
+
+		if (light.range <= 0.0f || light.intensity <= 0.0f) {
+			continue;
+		}
+
+		glm::vec3 center = light.position;
+		float radius = light.range;
+
+		if (light.spot) {
+			spot_bounding_sphere(light, center, radius);
+		}
+
+		glm::vec3 viewCenter = glm::vec3(view * glm::vec4(center, 1.0f));
+		float depth = -viewCenter.z;
+
+		if (depth + radius < mNear || depth - radius > mFar) {
+			continue;
+		}
+
+		mVisibleLights.push_back({ glm::length(viewCenter) - radius, i, viewCenter, radius });
+	}
+
+	if (mVisibleLights.size() > kMaxLights) {
+		std::nth_element(mVisibleLights.begin(), mVisibleLights.begin() + kMaxLights, mVisibleLights.end(),
+						 [](const VisibleLight& a, const VisibleLight& b) {
+			return a.distance < b.distance;
+		});
+
+		mVisibleLights.resize(kMaxLights);
+	}
+
+	std::fill(mClusterCounts.begin(), mClusterCounts.end(), 0);
+	mAssignments.clear();
+	mGpuLights.clear();
+
+	for (const auto& visible : mVisibleLights) {
+		const Light& light = lights[visible.light];
+		uint32_t index = static_cast<uint32_t>(mGpuLights.size());
+
+		GpuLight gpuLight = {
+			{ light.position.x, light.position.y, light.position.z, light.range },
+			{ light.color.r, light.color.g, light.color.b, light.intensity },
+			{ light.direction.x, light.direction.y, light.direction.z, light.spot ? 1.0f : 0.0f },
+			{ light.cosOuterAngle, light.cosInnerAngle, 0.0f, 0.0f }
+		};
+
+		mGpuLights.push_back(gpuLight);
+
+		assign_light(index, visible.center, visible.radius);
+	}
+
+	// Counting sort by cluster keeps every list in light order
+	uint32_t offset = 0;
+
+	for (uint32_t cluster = 0; cluster < kClusterCount; ++cluster) {
+		mLightGrid[cluster * 2] = offset;
+		mLightGrid[cluster * 2 + 1] = mClusterCounts[cluster];
+		offset += mClusterCounts[cluster];
+		mClusterCounts[cluster] = mLightGrid[cluster * 2];
+	}
+
+	mLightIndices.resize(mAssignments.size());
+
+	for (const auto& [cluster, light] : mAssignments) {
+		mLightIndices[mClusterCounts[cluster]++] = light;
+	}
+
+	mLightCount = mGpuLights.size();
+	mIndexCount = mLightIndices.size();
+
+	// Shader buffers cannot be empty
+	if (mGpuLights.empty()) {
+		mGpuLights.emplace_back();
+	}
+
+	if (mLightIndices.empty()) {
+		mLightIndices.push_back(0);
+	}
+
+	POWER_PROFILE_COUNT(LightClusterIndices, mIndexCount);
+}
+
+void LightClusters::upload(ShaderWrapper& shader, const std::pair<nanogui::Vector2i, nanogui::Vector2i>& viewport) const {
+	GpuParams params = {
+		{
+			static_cast<float>(viewport.first.x()), static_cast<float>(viewport.first.y()),
+			static_cast<float>(viewport.second.x()), static_cast<float>(viewport.second.y())
+		},
+		{ mSliceScale, mSliceBias, mPerspective ? 1.0f : 0.0f, static_cast<float>(mLightCount) },
+		{ static_cast<float>(kTilesX), static_cast<float>(kTilesY), static_cast<float>(kDepthSlices), 0.0f }
+	};
+
+	shader.set_buffer("lights", nanogui::VariableType::Float32,
+					  {mGpuLights.size(), sizeof(GpuLight) / sizeof(float)}, mGpuLights.data(), -1, true);
+	shader.set_buffer("lightGrid", nanogui::VariableType::UInt32,
+					  {kClusterCount, 2}, mLightGrid.data(), -1, true);
+	shader.set_buffer("lightIndices", nanogui::VariableType::UInt32,
+					  {mLightIndices.size()}, mLightIndices.data(), -1, true);
+	shader.set_buffer("clusterParams", nanogui::VariableType::Float32,
+					  {sizeof(GpuParams) / sizeof(float)}, &params, -1, true);
+}
+
+void LightClusters::rebuild_cluster_bounds(const glm::mat4& projection) {
+	mProjection = projection;
+
+	// GL-style clip space, as built by nanogui::Matrix4f::perspective and ortho
+	mPerspective = projection[2][3] != 0.0f;
+
+	if (mPerspective) {
+		mNear = projection[3][2] / (projection[2][2] - 1.0f);
+		mFar = projection[3][2] / (projection[2][2] + 1.0f);
+	} else {
+		mNear = (projection[3][2] + 1.0f) / projection[2][2];
+		mFar = (projection[3][2] - 1.0f) / projection[2][2];
+	}
+
+	if (mPerspective) {
+		mNear = std::max(mNear, kMinimumNearPlane);
+	}
+
+	mFar = std::max(mFar, mNear + kMinimumNearPlane);
+
+	std::vector<float> sliceDepths(kDepthSlices + 1);
+
+	for (uint32_t k = 0; k <= kDepthSlices; ++k) {
+		float t = static_cast<float>(k) / kDepthSlices;
+		sliceDepths[k] = mPerspective ? mNear * std::pow(mFar / mNear, t) : mNear + (mFar - mNear) * t;
+	}
+
+	if (mPerspective) {
+		mSliceScale = kDepthSlices / std::log(mFar / mNear);
+		mSliceBias = -std::log(mNear) * mSliceScale;
+	} else {
+		mSliceScale = kDepthSlices / (mFar - mNear);
+		mSliceBias = -mNear * mSliceScale;
+	}
+
+	// View-space line through every tile corner, from the near to the far plane
+	glm::dmat4 inverse = glm::inverse(glm::dmat4(projection));
+	std::vector<glm::dvec3> nearCorners((kTilesX + 1) * (kTilesY + 1));
+	std::vector<glm::dvec3> farCorners(nearCorners.size());
+
+	for (uint32_t y = 0; y <= kTilesY; ++y) {
+		for (uint32_t x = 0; x <= kTilesX; ++x) {
+			double ndcX = -1.0 + 2.0 * x / kTilesX;
+			double ndcY = -1.0 + 2.0 * y / kTilesY;
+
+			glm::dvec4 nearPoint = inverse * glm::dvec4(ndcX, ndcY, -1.0, 1.0);
+			glm::dvec4 farPoint = inverse * glm::dvec4(ndcX, ndcY, 1.0, 1.0);
+
+			nearCorners[y * (kTilesX + 1) + x] = glm::dvec3(nearPoint) / nearPoint.w;
+			farCorners[y * (kTilesX + 1) + x] = glm::dvec3(farPoint) / farPoint.w;
+		}
+	}
+
+	for (uint32_t slice = 0; slice < kDepthSlices; ++slice) {
+		for (uint32_t y = 0; y < kTilesY; ++y) {
+			for (uint32_t x = 0; x < kTilesX; ++x) {
+				glm::dvec3 minimum(std::numeric_limits<double>::max());
+				glm::dvec3 maximum(std::numeric_limits<double>::lowest());
+
+				for (uint32_t corner = 0; corner < 4; ++corner) {
+					size_t cornerIndex = (y + corner / 2) * (kTilesX + 1) + x + corner % 2;
+					const glm::dvec3& nearCorner = nearCorners[cornerIndex];
+					const glm::dvec3& farCorner = farCorners[cornerIndex];
+
+					for (uint32_t side = 0; side < 2; ++side) {
+						double depth = sliceDepths[slice + side];
+						double t = (depth + nearCorner.z) / (nearCorner.z - farCorner.z);
+						glm::dvec3 point = glm::mix(nearCorner, farCorner, t);
+
+						minimum = glm::min(minimum, point);
+						maximum = glm::max(maximum, point);
+					}
+				}
+
+				uint32_t cluster = cluster_index(x, y, slice);
+				mMinX[cluster] = static_cast<float>(minimum.x);
+				mMinY[cluster] = static_cast<float>(minimum.y);
+				mMinZ[cluster] = static_cast<float>(minimum.z);
+				mMaxX[cluster] = static_cast<float>(maximum.x);
+				mMaxY[cluster] = static_cast<float>(maximum.y);
+				mMaxZ[cluster] = static_cast<float>(maximum.z);
+			}
+		}
+	}
+}
+
+uint32_t LightClusters::depth_slice(float depth) const {
+	float value = mPerspective ? std::log(std::max(depth, mNear)) : depth;
+	float slice = std::floor(value * mSliceScale + mSliceBias);
+	return static_cast<uint32_t>(std::clamp(slice, 0.0f, static_cast<float>(kDepthSlices - 1)));
+}
+
+void LightClusters::assign_light(uint32_t lightIndex, const glm::vec3& center, float radius) {
+	float depth = -center.z;
+
+	// One slice of slack either way absorbs rounding at the boundaries; the AABB test is exact
+	uint32_t firstSlice = depth_slice(depth - radius);
+	uint32_t lastSlice = depth_slice(depth + radius);
+	firstSlice = firstSlice > 0 ? firstSlice - 1 : 0;
+	lastSlice = std::min(lastSlice + 1, kDepthSlices - 1);
+
+	uint32_t firstX = 0, lastX = kTilesX - 1;
+	uint32_t firstY = 0, lastY = kTilesY - 1;
+
+	// Spheres crossing the near plane cannot be projected, they keep the full tile range
+	if (!mPerspective || depth - radius > mNear) {
+		glm::vec2 minimum(std::numeric_limits<float>::max());
+		glm::vec2 maximum(std::numeric_limits<float>::lowest());
+
+		for (uint32_t corner = 0; corner < 8; ++corner) {
+			glm::vec3 offset((corner & 1) ? radius : -radius, (corner & 2) ? radius : -radius, (corner & 4) ? radius : -radius);
+			glm::vec4 clip = mProjection * glm::vec4(center + offset, 1.0f);
+			glm::vec2 ndc = glm::vec2(clip) / clip.w;
+
+			minimum = glm::min(minimum, ndc);
+			maximum = glm::max(maximum, ndc);
+		}
+
+		if (maximum.x < -1.0f || minimum.x > 1.0f || maximum.y < -1.0f || minimum.y > 1.0f) {
+			return;
+		}
+
+		firstX = clamp_tile(minimum.x, kTilesX);
+		lastX = clamp_tile(maximum.x, kTilesX);
+		firstY = clamp_tile(minimum.y, kTilesY);
+		lastY = clamp_tile(maximum.y, kTilesY);
+	}
+
+	float radiusSquared = radius * radius;
+
+	for (uint32_t slice = firstSlice; slice <= lastSlice; ++slice) {
+		for (uint32_t y = firstY; y <= lastY; ++y) {
+			uint32_t row = cluster_index(0, y, slice);
+
+			// Branch-free sphere/AABB distance over a contiguous row of froxels
+			for (uint32_t x = firstX; x <= lastX; ++x) {
+				uint32_t cluster = row + x;
+				float dx = std::max(0.0f, std::max(mMinX[cluster] - center.x, center.x - mMaxX[cluster]));
+				float dy = std::max(0.0f, std::max(mMinY[cluster] - center.y, center.y - mMaxY[cluster]));
+				float dz = std::max(0.0f, std::max(mMinZ[cluster] - center.z, center.z - mMaxZ[cluster]));
+				mRowHits[x] = dx * dx + dy * dy + dz * dz <= radiusSquared;
+			}
+
+			for (uint32_t x = firstX; x <= lastX; ++x) {
+				if (mRowHits[x]) {
+					mAssignments.push_back({ row + x, lightIndex });
+					++mClusterCounts[row + x];
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <nanogui/vector.h>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class ShaderWrapper;
+
+/**
+ * @brief Clustered culling for dynamic point and spot lights.
+ *
+ * The view frustum is split into kTilesX * kTilesY screen tiles and kDepthSlices
+ * depth slices (exponential for perspective cameras, linear for orthographic),
+ * and every light is assigned to the froxels its bounding sphere touches. Shaders
+ * look up their froxel and only walk the lights listed for it, so shading cost
+ * follows the lights per pixel rather than the number of lights in the scene.
+ *
+ * Froxel bounds are kept as view-space AABBs in SoA arrays and only rebuilt when
+ * the projection changes; the sphere tests run over contiguous rows of them.
+ */
+class LightClusters {
+public:
+	static constexpr uint32_t kTilesX = 16;
+	static constexpr uint32_t kTilesY = 9;
+	static constexpr uint32_t kDepthSlices = 24;
+	static constexpr uint32_t kClusterCount = kTilesX * kTilesY * kDepthSlices;
+
+	// Lights beyond this count are dropped, nearest to the camera are kept
+	static constexpr uint32_t kMaxLights = 4096;
+
+	struct Light {
+		glm::vec3 position; // world space
+		float range;
+		glm::vec3 color;
+		float intensity;
+		glm::vec3 direction; // world space, spot lights only
+		float cosInnerAngle;
+		float cosOuterAngle;
+		bool spot;
+	};
+
+	// Layout shared with the diffuse fragment shader
+	struct GpuLight {
+		float positionRange[4];
+		float colorIntensity[4];
+		float directionSpot[4]; // xyz direction, w is 1 for spot lights
+		float cone[4];          // cos outer, cos inner
+	};
+
+	struct GpuParams {
+		float viewport[4];   // offset and size in framebuffer pixels
+		float slicing[4];    // depth scale, depth bias, 1 for logarithmic slices, light count
+		float dimensions[4]; // tiles x, tiles y, depth slices
+	};
+
+	LightClusters();
+
+	void build(const glm::mat4& view, const glm::mat4& projection, const std::vector<Light>& lights);
+
+	// Persists "lights", "lightGrid", "lightIndices" and "clusterParams" on the shader for every draw until the next upload
+	void upload(ShaderWrapper& shader, const std::pair<nanogui::Vector2i, nanogui::Vector2i>& viewport) const;
+
+	// Increments with every build(), so users can upload once per build
+	uint64_t generation() const { return mGeneration; }
+
+	static uint32_t cluster_index(uint32_t x, uint32_t y, uint32_t slice) {
+		return (slice * kTilesY + y) * kTilesX + x;
+	}
+
+	// Indices into the built light list for one froxel
+	std::pair<const uint32_t*, const uint32_t*> cluster_lights(uint32_t cluster) const {
+		const uint32_t* begin = mLightIndices.data() + mLightGrid[cluster * 2];
+		return { begin, begin + mLightGrid[cluster * 2 + 1] };
+	}
+
+	size_t light_count() const { return mLightCount; }
+	size_t index_count() const { return mIndexCount; }
+
+private:
+	void rebuild_cluster_bounds(const glm::mat4& projection);
+	void assign_light(uint32_t lightIndex, const glm::vec3& center, float radius);
+	uint32_t depth_slice(float depth) const;
+
+	glm::mat4 mProjection{0.0f};
+	float mNear = 0.0f;
+	float mFar = 0.0f;
+	bool mPerspective = true;
+	float mSliceScale = 0.0f;
+	float mSliceBias = 0.0f;
+
+	// View-space froxel bounds, SoA so the sphere test vectorizes along a tile row
+	std::vector<float> mMinX, mMinY, mMinZ;
+	std::vector<float> mMaxX, mMaxY, mMaxZ;
+	std::vector<uint8_t> mRowHits;
+
+	struct VisibleLight {
+		float distance; // closest approach of the bounding sphere to the camera
+		uint32_t light;
+		glm::vec3 center; // view space
+		float radius;
+	};
+
+	std::vector<uint32_t> mClusterCounts;
+	std::vector<std::pair<uint32_t, uint32_t>> mAssignments; // cluster, light
+	std::vector<VisibleLight> mVisibleLights;
+
+	std::vector<GpuLight> mGpuLights;
+	std::vector<uint32_t> mLightGrid; // offset and count per cluster
+	std::vector<uint32_t> mLightIndices;
+	size_t mLightCount = 0;
+	size_t mIndexCount = 0;
+	uint64_t mGeneration = 0;
+};
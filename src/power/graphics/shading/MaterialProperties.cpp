@@ -1,5 +1,7 @@
 #include "MaterialProperties.hpp"
 
+#include "graphics/shading/TextureRegistry.hpp"
+
 
 // MaterialProperties move constructor
 MaterialProperties::MaterialProperties(MaterialProperties&& other) noexcept
@@ -39,10 +41,7 @@ MaterialProperties& MaterialProperties::operator=(MaterialProperties&& other) no
 std::vector<uint8_t> MaterialProperties::downloadTexture()
 {
 	if (mHasDiffuseTexture && mTextureDiffuse) {
-		size_t textureSize = mTextureDiffuse->size().x() * mTextureDiffuse->size().y() * mTextureDiffuse->bytes_per_pixel();
-		std::vector<uint8_t> textureData(textureSize);
-		mTextureDiffuse->download(textureData.data());
-		return textureData;
+		return mTextureDiffuse->download();
 	}
 	return {};
 }
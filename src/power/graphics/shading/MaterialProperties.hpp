@@ -9,6 +9,7 @@
 #include <iostream>
 
 struct MaterialProperties;
+class TextureLayer;
 
 struct SerializableMaterialProperties
 {
@@ -43,7 +44,7 @@ struct MaterialProperties
 	float mShininess{1.0f};
 	float mOpacity{1.0f};
 	bool mHasDiffuseTexture{false};
-	std::shared_ptr<nanogui::Texture> mTextureDiffuse;
+	std::shared_ptr<TextureLayer> mTextureDiffuse;
 	
 	MaterialProperties() = default;
 	MaterialProperties(MaterialProperties&& other) noexcept;
@@ -65,7 +66,9 @@ struct MaterialCPU
 	float mShininess{1.0f};
 	float mOpacity{1.0f};
 	float mHasDiffuseTexture{0.0f};
-	float _1 = 0.0f;
+	float mTextureLayer{0.0f}; ///< Layer of the array texture bound at mTextureSlot.
+	float mTextureSlot{0.0f};  ///< Index into the shader's textures, shared by materials using the same array.
+	float _1[3] = {0.0f, 0.0f, 0.0f};
 } __attribute__((packed));
 
 #endif
@@ -3,6 +3,8 @@
 #include "MeshVertex.hpp"
 #include "MaterialProperties.hpp"
 
+#include "profiling/MemoryTracker.hpp"
+
 #include <memory>
 #include <vector>
 
@@ -24,10 +26,22 @@ public:
 		return mMaterials;
 	}
 	
+	// Re-estimates the tracked footprint; call after filling or resizing the data
+	void update_memory_usage() {
+		mMemory.set(tracked_capacity(mVertices) + mVertices.size() * vertex_size() + tracked_capacity(mIndices));
+	}
+	
 protected:
+	virtual size_t vertex_size() const {
+		return sizeof(MeshVertex);
+	}
+	
 	std::vector<std::unique_ptr<MeshVertex>> mVertices;
 	std::vector<unsigned int> mIndices;
 	std::vector<std::shared_ptr<MaterialProperties>> mMaterials;
+	
+private:
+	TrackedMemory mMemory{MemoryTracker::Tag::Meshes};
 };
 
 class SkinnedMeshData : public MeshData {
@@ -46,7 +60,15 @@ public:
 		for (auto& meshVertex : vertexBackup) {
 			mVertices.push_back(std::make_unique<SkinnedMeshVertex>(*meshVertex));
 		}
+		
+		update_memory_usage();
+		meshData.update_memory_usage();
 	}
 	
 	~SkinnedMeshData() override = default;
+	
+protected:
+	size_t vertex_size() const override {
+		return sizeof(SkinnedMeshVertex);
+	}
 };
@@ -1,6 +1,12 @@
 #include "graphics/shading/ShaderWrapper.hpp"
 
+#include "profiling/MemoryTracker.hpp"
+#include "profiling/Profiler.hpp"
+
 #include <nanogui/shader.h>
+#include <nanogui/traits.h>
+
+#include <numeric>
 
 ShaderWrapper::ShaderWrapper(std::shared_ptr<nanogui::Shader> shader) : mShader(shader), mMetadata(std::hash<std::string>{}(shader->name()), shader->name())
  {}
@@ -11,23 +17,50 @@ ShaderWrapper::~ShaderWrapper() {
 
 void ShaderWrapper::persist_buffer(const std::string &name, nanogui::VariableType type,
 							   std::initializer_list<size_t> shape, const void *data, int index) {
+	size_t bytes = std::accumulate(shape.begin(), shape.end(), nanogui::type_size(type), std::multiplies<size_t>());
+	POWER_PROFILE_COUNT(BufferBytesUploaded, bytes);
+	
 	mShader->set_buffer(name, type, shape.end() - shape.begin(), shape.begin(), data, index, true);
+	
+	track_buffer(name, index, bytes);
 }
 
 
 void ShaderWrapper::set_buffer(const std::string &name, nanogui::VariableType type,
 							   std::initializer_list<size_t> shape, const void *data, int index, bool persist) {
+	size_t bytes = std::accumulate(shape.begin(), shape.end(), nanogui::type_size(type), std::multiplies<size_t>());
+	POWER_PROFILE_COUNT(BufferBytesUploaded, bytes);
+	
 	mShader->set_buffer(name, type, shape.end() - shape.begin(), shape.begin(), data, index, persist);
+	
+	track_buffer(name, index, bytes);
 }
 
 void ShaderWrapper::set_texture(const std::string& name, std::shared_ptr<nanogui::Texture> texture, int index) {
 	mShader->set_texture(name, texture, index);
+	
+	if (texture) {
+		// Keyed by the texture itself, so sharing it between shaders and slots counts it once
+		uint64_t bytes = static_cast<uint64_t>(texture->size().x()) * texture->size().y() * texture->bytes_per_pixel();
+		MemoryTracker::instance().track_shared(MemoryTracker::Tag::GpuTextures, texture, bytes);
+	}
 }
 
 size_t ShaderWrapper::get_buffer_size(const std::string& name) {
 	return mShader->get_buffer_size(name);
 }
 
+void ShaderWrapper::track_buffer(const std::string& name, int index, uint64_t bytes) {
+	auto& slots = mBufferMemory[name];
+	auto it = slots.find(index);
+	
+	if (it == slots.end()) {
+		it = slots.emplace(index, TrackedMemory(MemoryTracker::Tag::GpuBuffers)).first;
+	}
+	
+	it->second.set(bytes);
+}
+
 int ShaderWrapper::identifier() const {
 	return mMetadata.identifier();
 }
@@ -35,6 +68,12 @@ int ShaderWrapper::identifier() const {
 void ShaderWrapper::begin() { mShader->begin(); }
 void ShaderWrapper::end() { mShader->end(); }
 void ShaderWrapper::draw_array(nanogui::Shader::PrimitiveType primitive_type, size_t offset,
-							   size_t count, bool indexed) {
-	mShader->draw_array(primitive_type, offset, count, indexed);
+							   size_t count, bool indexed, size_t instanceCount) {
+	POWER_PROFILE_COUNT(DrawCalls, 1);
+	
+	if (primitive_type == nanogui::Shader::PrimitiveType::Triangle) {
+		POWER_PROFILE_COUNT(Triangles, count / 3 * instanceCount);
+	}
+	
+	mShader->draw_array(primitive_type, offset, count, indexed, instanceCount);
 }
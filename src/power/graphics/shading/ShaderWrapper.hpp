@@ -1,11 +1,13 @@
 #pragma once
 
 #include "components/MetadataComponent.hpp"
+#include "profiling/MemoryTracker.hpp"
 
 #include <nanogui/shader.h>
 #include <nanogui/texture.h>
 
 #include <string>
+#include <unordered_map>
 
 namespace nanogui{
 class Shader;
@@ -37,7 +39,8 @@ public:
 	virtual void end();
 	void draw_array(nanogui::Shader::PrimitiveType primitive_type,
 					size_t offset, size_t count,
-					bool indexed = false);
+					bool indexed = false,
+					size_t instanceCount = 1);
 	
 	nanogui::RenderPass& render_pass() const {
 		return mShader->render_pass();
@@ -47,5 +50,9 @@ protected:
 	std::shared_ptr<nanogui::Shader> mShader;
 	
 private:
+	// Estimated GPU footprint of the buffers last uploaded under each name and index
+	void track_buffer(const std::string& name, int index, uint64_t bytes);
+	
 	MetadataComponent mMetadata;
+	std::unordered_map<std::string, std::unordered_map<int, TrackedMemory>> mBufferMemory;
 };
@@ -0,0 +1,259 @@
+#include "graphics/shading/TextureRegistry.hpp"
+
+#include "filesystem/HashCache.hpp"
+
+#include <nanogui/texture.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+/**
+ * @brief A mipmapped RGBA8 2D array texture and which of its layers are free.
+ */
+class TextureArray {
+public:
+	TextureArray(std::shared_ptr<nanogui::Texture> texture, int layers)
+	: mTexture(std::move(texture)) {
+		for (int layer = layers - 1; layer >= 0; --layer) {
+			mFreeLayers.push_back(layer);
+		}
+	}
+
+	const std::shared_ptr<nanogui::Texture>& texture() const {
+		return mTexture;
+	}
+
+	// -1 when every layer is taken
+	int acquire() {
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		if (mFreeLayers.empty()) {
+			return -1;
+		}
+
+		int layer = mFreeLayers.back();
+		mFreeLayers.pop_back();
+		return layer;
+	}
+
+	void release(int layer) {
+		std::lock_guard<std::mutex> lock(mMutex);
+		mFreeLayers.push_back(layer);
+	}
+
+private:
+	std::shared_ptr<nanogui::Texture> mTexture;
+
+	std::mutex mMutex;
+	std::vector<int> mFreeLayers;
+};
+
+TextureLayer::TextureLayer(std::shared_ptr<TextureArray> array, int layer)
+: mArray(std::move(array))
+, mLayer(layer) {
+}
+
+TextureLayer::~TextureLayer() {
+	mArray->release(mLayer);
+}
+
+const std::shared_ptr<nanogui::Texture>& TextureLayer::texture() const {
+	return mArray->texture();
+}
+
+std::vector<uint8_t> TextureLayer::download() const {
+	auto& texture = *mArray->texture();
+	std::vector<uint8_t> pixels(static_cast<size_t>(texture.size().x()) * texture.size().y() * texture.bytes_per_pixel());
+	texture.download(pixels.data(), mLayer);
+	return pixels;
+}
+
+TextureRegistry& TextureRegistry::instance() {
+	static TextureRegistry registry;
+	return registry;
+}
+
+std::shared_ptr<TextureLayer> TextureRegistry::load(const uint8_t* data, size_t size) {
+	return load(ContentHasher::hash(data, size, ContentHash::Md5), data, size, "");
+}
+
+std::shared_ptr<TextureLayer> TextureRegistry::load_file(const std::string& path) {
+	ContentHash hash;
+
+	// Files hashed in an earlier session are not even read when their texture is live or cooked
+	if (!HashCache::instance().hash_file(path, hash)) {
+		std::cerr << "Failed to open texture: " << path << std::endl;
+		return nullptr;
+	}
+
+	return load(hash, nullptr, 0, path);
+}
+
+std::shared_ptr<TextureLayer> TextureRegistry::load(const ContentHash& hash, const uint8_t* data, size_t size, const std::string& path) {
+	uint64_t words[2];
+	hash.md5_words(words);
+
+	Key key{words[0], words[1]};
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		auto it = mTextures.find(key);
+
+		if (it != mTextures.end()) {
+			if (auto texture = it->second.lock()) {
+				++mHits;
+				return texture;
+			}
+		}
+	}
+
+	// Cooked outside the lock, two threads loading the same new image both cook it and the first one registered wins
+	TextureCache::Cooked cooked;
+	std::string hex = hash.md5_hex();
+
+	if (!mCache.load(hex, cooked)) {
+		std::vector<uint8_t> buffer;
+
+		if (!data) {
+			std::ifstream file(path, std::ios::binary);
+
+			if (!file) {
+				std::cerr << "Failed to open texture: " << path << std::endl;
+				return nullptr;
+			}
+
+			buffer.assign(std::istreambuf_iterator<char>(file), {});
+			data = buffer.data();
+			size = buffer.size();
+		}
+
+		if (!TextureCache::cook(data, size, cooked)) {
+			return nullptr;
+		}
+
+		mCache.store(hex, cooked);
+	}
+
+	auto texture = allocate(cooked);
+
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	auto& entry = mTextures[key];
+
+	if (auto existing = entry.lock()) {
+		return existing;
+	}
+
+	entry = texture;
+
+	if (mTextures.size() >= mPruneThreshold) {
+		prune();
+	}
+
+	return texture;
+}
+
+size_t TextureRegistry::size() {
+	std::lock_guard<std::mutex> lock(mMutex);
+	prune();
+	return mTextures.size();
+}
+
+size_t TextureRegistry::arrays() {
+	std::lock_guard<std::mutex> lock(mMutex);
+	prune();
+
+	size_t count = 0;
+
+	for (const auto& [sizeClass, arrays] : mArrays) {
+		count += arrays.size();
+	}
+
+	return count;
+}
+
+std::shared_ptr<TextureLayer> TextureRegistry::allocate(const TextureCache::Cooked& cooked) {
+	const int width = cooked.levels[0].width;
+	const int height = cooked.levels[0].height;
+	const uint64_t sizeClass = (static_cast<uint64_t>(width) << 40) | (static_cast<uint64_t>(height) << 16) | cooked.levels.size();
+
+	std::shared_ptr<TextureArray> array;
+	int layer = -1;
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		auto& arrays = mArrays[sizeClass];
+
+		for (auto& entry : arrays) {
+			auto candidate = entry.lock();
+
+			if (candidate && (layer = candidate->acquire()) >= 0) {
+				array = std::move(candidate);
+				break;
+			}
+		}
+
+		if (!array) {
+			// Every level is stored as is, so the cooked pixels are exactly one layer
+			int layers = static_cast<int>(std::clamp<size_t>(kArrayBudget / std::max<size_t>(cooked.pixels.size(), 1), 1, kMaxLayers));
+
+			auto texture = std::make_shared<nanogui::Texture>(nanogui::Texture::PixelFormat::RGBA,
+															  nanogui::Texture::ComponentFormat::UInt8,
+															  nanogui::Vector2i(width, height),
+															  nanogui::Texture::InterpolationMode::Trilinear,
+															  nanogui::Texture::InterpolationMode::Bilinear,
+															  nanogui::Texture::WrapMode::Repeat,
+															  1,
+															  nanogui::Texture::TextureFlags::ShaderRead,
+															  true,
+															  layers);
+
+			array = std::make_shared<TextureArray>(std::move(texture), layers);
+			layer = array->acquire();
+
+			auto expired = std::find_if(arrays.begin(), arrays.end(), [](const auto& entry) { return entry.expired(); });
+
+			if (expired != arrays.end()) {
+				*expired = array;
+			} else {
+				arrays.push_back(array);
+			}
+		}
+	}
+
+	// The layer is reserved, so it is filled outside the lock; every level is already filtered, so uploads are plain copies
+	for (size_t level = 0; level < cooked.levels.size(); ++level) {
+		array->texture()->upload_level(cooked.level_data(level), static_cast<int>(level), layer);
+	}
+
+	return std::make_shared<TextureLayer>(std::move(array), layer);
+}
+
+void TextureRegistry::prune() {
+	for (auto it = mTextures.begin(); it != mTextures.end();) {
+		if (it->second.expired()) {
+			it = mTextures.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	for (auto it = mArrays.begin(); it != mArrays.end();) {
+		auto& arrays = it->second;
+		arrays.erase(std::remove_if(arrays.begin(), arrays.end(), [](const auto& entry) { return entry.expired(); }), arrays.end());
+
+		if (arrays.empty()) {
+			it = mArrays.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	// Amortized over the insertions that grow the map past twice its live size
+	mPruneThreshold = std::max<size_t>(64, mTextures.size() * 2);
+}
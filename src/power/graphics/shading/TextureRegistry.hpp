@@ -0,0 +1,124 @@
+#pragma once
+
+#include "filesystem/ContentHash.hpp"
+#include "filesystem/TextureCache.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nanogui {
+class Texture;
+}
+
+class TextureArray;
+
+/**
+ * @brief One image, held in a layer of a 2D array texture shared with other images of its size.
+ *
+ * Shaders sample texture() at layer(). The layer is handed back to the array
+ * when the last material holding it releases it.
+ */
+class TextureLayer {
+public:
+	TextureLayer(std::shared_ptr<TextureArray> array, int layer);
+	~TextureLayer();
+
+	TextureLayer(const TextureLayer&) = delete;
+	TextureLayer& operator=(const TextureLayer&) = delete;
+
+	const std::shared_ptr<nanogui::Texture>& texture() const;
+
+	int layer() const {
+		return mLayer;
+	}
+
+	// Packed RGBA8 pixels of the top level
+	std::vector<uint8_t> download() const;
+
+private:
+	std::shared_ptr<TextureArray> mArray;
+	int mLayer;
+};
+
+/**
+ * @brief Textures keyed by the MD5 of their encoded image, packed into 2D array textures by size.
+ *
+ * Materials that reference the same image, whether the same file from several
+ * models or identical embedded blobs, share one decoded and uploaded layer.
+ * Images of the same size share array textures, so draws whose materials use
+ * different images of one size keep the same texture bound. Images not seen
+ * in this session come from the TextureCache, cooked with their mip chain on
+ * first use, so they are only ever decoded once. Entries only hold weak
+ * references, so a layer is released with the last material using it, and an
+ * array with its last layer. Thread-safe.
+ */
+class TextureRegistry {
+public:
+	// Bytes of one array texture, mip chains included, which sets how many layers it holds
+	static constexpr size_t kArrayBudget = 16ull * 1024 * 1024;
+	static constexpr int kMaxLayers = 64;
+
+	static TextureRegistry& instance();
+
+	TextureRegistry(const TextureRegistry&) = delete;
+	TextureRegistry& operator=(const TextureRegistry&) = delete;
+
+	// Mipmapped layer for an encoded image (PNG, JPG, ...), shared with any live layer of the same bytes; null if it cannot be decoded
+	std::shared_ptr<TextureLayer> load(const uint8_t* data, size_t size);
+
+	// Same as load() for the contents of a file, hashed through HashCache; null when it cannot be read
+	std::shared_ptr<TextureLayer> load_file(const std::string& path);
+
+	// Live images
+	size_t size();
+
+	// Live array textures
+	size_t arrays();
+
+	// Loads that found their image already uploaded
+	uint64_t hits() const {
+		return mHits;
+	}
+
+private:
+	struct Key {
+		uint64_t high;
+		uint64_t low;
+
+		bool operator==(const Key& other) const {
+			return high == other.high && low == other.low;
+		}
+	};
+
+	struct KeyHash {
+		size_t operator()(const Key& key) const {
+			return static_cast<size_t>(key.high ^ key.low);
+		}
+	};
+
+	TextureRegistry() = default;
+
+	// Without data, the file at path is only read if the image has to be cooked
+	std::shared_ptr<TextureLayer> load(const ContentHash& hash, const uint8_t* data, size_t size, const std::string& path);
+
+	// Uploads the image into a free layer of an array of its size, creating the array when all are full
+	std::shared_ptr<TextureLayer> allocate(const TextureCache::Cooked& cooked);
+
+	// Drops the entries whose layer or array was released
+	void prune();
+
+	TextureCache mCache;
+
+	std::mutex mMutex;
+	std::unordered_map<Key, std::weak_ptr<TextureLayer>, KeyHash> mTextures;
+	// Arrays by size class: width, height and mip level count packed into one key
+	std::unordered_map<uint64_t, std::vector<std::weak_ptr<TextureArray>>> mArrays;
+	size_t mPruneThreshold = 64;
+	std::atomic<uint64_t> mHits{0};
+};
@@ -0,0 +1,123 @@
+#include "history/UndoJournal.hpp"
+
+UndoJournal::UndoJournal(size_t memoryBudget)
+: mMemoryBudget(memoryBudget) {
+}
+
+void UndoJournal::record(std::unique_ptr<Entry> entry) {
+	if (!entry || mReplaying) {
+		return;
+	}
+
+	while (!mRedo.empty()) {
+		mMemoryUsage -= mRedo.back().bytes;
+		mRedo.pop_back();
+	}
+
+	if (mGroupDepth > 0 && mGroupHasEntry && !mUndo.empty()) {
+		auto& top = mUndo.back();
+
+		if (top.entry->merge(*entry)) {
+			mMemoryUsage -= top.bytes;
+			top.bytes = top.entry->memory_size();
+			mMemoryUsage += top.bytes;
+
+			mTrackedMemory.set(mMemoryUsage);
+			return;
+		}
+	}
+
+	push(mUndo, std::move(entry));
+
+	mGroupHasEntry = mGroupDepth > 0;
+
+	evict();
+}
+
+bool UndoJournal::undo() {
+	return step(mUndo, mRedo, false);
+}
+
+bool UndoJournal::redo() {
+	return step(mRedo, mUndo, true);
+}
+
+bool UndoJournal::step(std::deque<Record>& from, std::deque<Record>& to, bool forward) {
+	// Nothing recorded after an undo or redo may merge into what came before it
+	mGroupHasEntry = false;
+
+	while (!from.empty()) {
+		Record record = std::move(from.back());
+		from.pop_back();
+		mMemoryUsage -= record.bytes;
+
+		mReplaying = true;
+		bool applied = forward ? record.entry->apply() : record.entry->revert();
+		mReplaying = false;
+
+		if (applied) {
+			push(to, std::move(record.entry));
+			evict();
+			return true;
+		}
+
+		// Stale entries are dropped and the next one is tried
+	}
+
+	mTrackedMemory.set(mMemoryUsage);
+	return false;
+}
+
+void UndoJournal::push(std::deque<Record>& stack, std::unique_ptr<Entry> entry) {
+	size_t bytes = entry->memory_size();
+
+	stack.push_back({std::move(entry), bytes});
+	mMemoryUsage += bytes;
+}
+
+void UndoJournal::evict() {
+	// Oldest first: the bottom of the undo stack, then the far end of the redo stack
+	while (mMemoryUsage > mMemoryBudget && !mUndo.empty()) {
+		mMemoryUsage -= mUndo.front().bytes;
+		mUndo.pop_front();
+	}
+
+	while (mMemoryUsage > mMemoryBudget && !mRedo.empty()) {
+		mMemoryUsage -= mRedo.front().bytes;
+		mRedo.pop_front();
+	}
+
+	if (mUndo.empty()) {
+		mGroupHasEntry = false;
+	}
+
+	mTrackedMemory.set(mMemoryUsage);
+}
+
+void UndoJournal::begin_group() {
+	if (mGroupDepth++ == 0) {
+		mGroupHasEntry = false;
+	}
+}
+
+void UndoJournal::end_group() {
+	if (mGroupDepth > 0 && --mGroupDepth == 0) {
+		mGroupHasEntry = false;
+	}
+}
+
+void UndoJournal::clear() {
+	// Redo entries are newer than undo entries, release them first
+	mRedo.clear();
+	mUndo.clear();
+
+	mMemoryUsage = 0;
+	mGroupHasEntry = false;
+
+	mTrackedMemory.set(0);
+}
+
+void UndoJournal::set_memory_budget(size_t bytes) {
+	mMemoryBudget = bytes;
+	evict();
+}
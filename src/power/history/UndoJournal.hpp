@@ -0,0 +1,98 @@
+#pragma once
+
+#include "profiling/MemoryTracker.hpp"
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+
+/**
+ * @brief Bounded undo/redo history of editor operations.
+ *
+ * Entries record only what an operation changed (a transform before and after,
+ * the actors it removed, the links it broke), so applying or reverting one costs
+ * the size of that change and never walks the scene. Entries recorded while a
+ * group is open are merged when they allow it, which folds a gizmo drag into a
+ * single step. Once the history outgrows its memory budget the oldest entries
+ * are evicted, releasing whatever they kept alive.
+ */
+class UndoJournal {
+public:
+	class Entry {
+	public:
+		virtual ~Entry() = default;
+
+		// Both return false when the entry no longer applies (e.g. its graph was unloaded); the journal drops it
+		virtual bool apply() = 0;
+		virtual bool revert() = 0;
+
+		// Bytes held by the entry, including anything it keeps alive for a later apply
+		virtual size_t memory_size() const = 0;
+
+		// Folds a newer entry recorded in the same group into this one
+		virtual bool merge(Entry& next) {
+			return false;
+		}
+	};
+
+	static constexpr size_t kDefaultMemoryBudget = 64 * 1024 * 1024;
+
+	explicit UndoJournal(size_t memoryBudget = kDefaultMemoryBudget);
+
+	// Records an operation that has already been performed and drops the redo history
+	void record(std::unique_ptr<Entry> entry);
+
+	bool undo();
+	bool redo();
+
+	// Entries recorded between begin_group and end_group merge into one step where they allow it
+	void begin_group();
+	void end_group();
+
+	void clear();
+
+	void set_memory_budget(size_t bytes);
+
+	size_t memory_budget() const {
+		return mMemoryBudget;
+	}
+
+	size_t memory_usage() const {
+		return mMemoryUsage;
+	}
+
+	bool can_undo() const {
+		return !mUndo.empty();
+	}
+
+	bool can_redo() const {
+		return !mRedo.empty();
+	}
+
+	// True while an entry is being applied or reverted, when edits must not record themselves
+	bool replaying() const {
+		return mReplaying;
+	}
+
+private:
+	struct Record {
+		std::unique_ptr<Entry> entry;
+		size_t bytes;
+	};
+
+	bool step(std::deque<Record>& from, std::deque<Record>& to, bool forward);
+	void push(std::deque<Record>& stack, std::unique_ptr<Entry> entry);
+	void evict();
+
+	std::deque<Record> mUndo;
+	std::deque<Record> mRedo;
+
+	size_t mMemoryBudget;
+	size_t mMemoryUsage = 0;
+
+	int mGroupDepth = 0;
+	bool mGroupHasEntry = false;
+	bool mReplaying = false;
+
+	TrackedMemory mTrackedMemory{MemoryTracker::Tag::UndoHistory};
+};
@@ -15,6 +15,7 @@
 #include "graphics/shading/MeshVertex.hpp"
 #include "graphics/shading/MeshData.hpp"
 #include "graphics/shading/MeshVertex.hpp"
+#include "graphics/shading/TextureRegistry.hpp"
 #include "animation/Skeleton.hpp"
 #include "animation/Animation.hpp"
 
@@ -26,10 +27,14 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtx/matrix_decompose.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <future>
 #include <iostream>
 #include <filesystem>
 #include <fstream>
 #include <set>
+#include <thread>
 
 namespace {
 // Helper to convert Assimp's matrix to glm::mat4
@@ -53,6 +58,69 @@ std::tuple<glm::vec3, glm::quat, glm::vec3> DecomposeTransform(const glm::mat4&
 	glm::decompose(transform, scale, rotation, translation, skew, perspective);
 	return {translation, glm::conjugate(rotation), scale};
 }
+
+// Fills the attributes shared by static and skinned vertices, in place in the mesh's array
+template<typename Vertex>
+void FillImportedVertices(const aiMesh* mesh, const glm::mat4& transform, std::vector<Vertex>& vertices) {
+	vertices.resize(mesh->mNumVertices);
+	
+	glm::mat4 normalMatrix = glm::transpose(glm::inverse(transform));
+	
+	for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
+		Vertex& vertex = vertices[i];
+		
+		// Position
+		glm::vec4 pos = transform * glm::vec4(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z, 1.0f);
+		vertex.set_position(glm::vec3(pos));
+		
+		// Normals
+		if (mesh->HasNormals()) {
+			glm::vec4 normal = normalMatrix * glm::vec4(mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z, 0.0f);
+			vertex.set_normal(glm::normalize(glm::vec3(normal)));
+		}
+		
+		// Texture Coordinates
+		if (mesh->mTextureCoords[0]) {
+			vertex.set_texture_coords1({mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y});
+		}
+		
+		// Vertex Colors
+		if (mesh->mColors[0]) {
+			vertex.set_color({mesh->mColors[0][i].r, mesh->mColors[0][i].g, mesh->mColors[0][i].b, mesh->mColors[0][i].a});
+		}
+		
+		vertex.set_material_id(mesh->mMaterialIndex);
+	}
+}
+
+// Runs job(i) for every i below count on a pool of up to one worker per core, returning once all are done
+template <typename Job>
+void ParallelForEachIndex(size_t count, Job job) {
+	size_t workerCount = std::min<size_t>(count, std::max(1u, std::thread::hardware_concurrency()));
+	
+	if (workerCount <= 1) {
+		for (size_t i = 0; i < count; ++i) {
+			job(i);
+		}
+		return;
+	}
+	
+	// Workers pull the next index, so a few large meshes do not stall the others behind them
+	std::atomic<size_t> next{0};
+	std::vector<std::future<void>> workers;
+	
+	for (size_t worker = 0; worker < workerCount; ++worker) {
+		workers.emplace_back(std::async(std::launch::async, [&next, &job, count]() {
+			for (size_t i = next++; i < count; i = next++) {
+				job(i);
+			}
+		}));
+	}
+	
+	for (auto& worker : workers) {
+		worker.get();
+	}
+}
 }
 
 bool ModelImporter::LoadModel(const std::string& path) {
@@ -72,14 +140,7 @@ bool ModelImporter::LoadModel(const std::string& path) {
 		return false;
 	}
 	
-	// Process materials first, so they are available when processing meshes.
-	ProcessMaterials(scene);
-	ProcessNode(scene->mRootNode, scene, glm::mat4(1.0f));
-	
-	if(mBoneCount > 0) {
-		BuildSkeleton(scene);
-		ProcessAnimations(scene);
-	}
+	ProcessScene(scene);
 	
 	return true;
 }
@@ -102,140 +163,136 @@ bool ModelImporter::LoadModel(const std::vector<char>& data, const std::string&
 		return false;
 	}
 	
-	// Process materials first, so they are available when processing meshes.
+	ProcessScene(scene);
+	
+	return true;
+}
+
+void ModelImporter::ProcessScene(const aiScene* scene) {
+	// Materials first, meshes only keep pointers to them
 	ProcessMaterials(scene);
-	ProcessNode(scene->mRootNode, scene, glm::mat4(1.0f));
+	
+	std::vector<MeshInstance> instances;
+	CollectMeshes(scene->mRootNode, scene, glm::mat4(1.0f), instances);
+	
+	// Serial, so bone ids come out in the same order as a depth-first walk
+	AssignBoneIds(instances);
+	
+	std::vector<std::unique_ptr<MeshData>> meshes(instances.size());
+	
+	// Vertex allocation happens on the workers too; materials are only read from here on
+	ParallelForEachIndex(instances.size(), [&](size_t i) {
+		ImportedMesh imported;
+		ProcessMesh(instances[i], imported);
+		meshes[i] = BuildMeshData(imported);
+	});
+	
+	// Kept in hierarchy order, whatever order the workers finished in
+	for (auto& meshData : meshes) {
+		mMeshes.push_back(std::move(meshData));
+	}
 	
 	if(mBoneCount > 0) {
 		BuildSkeleton(scene);
 		ProcessAnimations(scene);
 	}
-	
-	return true;
 }
 
-void ModelImporter::ProcessNode(aiNode* node, const aiScene* scene, const glm::mat4& parentTransform) {
+void ModelImporter::CollectMeshes(aiNode* node, const aiScene* scene, const glm::mat4& parentTransform, std::vector<MeshInstance>& instances) {
 	glm::mat4 transform = parentTransform * AssimpToGlmMat4(node->mTransformation);
 	
 	for (unsigned int i = 0; i < node->mNumMeshes; i++) {
-		aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-		ProcessMesh(mesh, scene, transform);
+		instances.push_back({scene->mMeshes[node->mMeshes[i]], transform, {}});
 	}
 	
 	for (unsigned int i = 0; i < node->mNumChildren; i++) {
-		ProcessNode(node->mChildren[i], scene, transform);
+		CollectMeshes(node->mChildren[i], scene, transform, instances);
 	}
 }
 
-void ModelImporter::ProcessMesh(aiMesh* mesh, const aiScene* scene, const glm::mat4& transform) {
-	std::unique_ptr<MeshData> meshData;
-	std::vector<std::unique_ptr<MeshVertex>>* verticesPtr;
-	
-	// Create SkinnedMeshData if the mesh has bones
-	if (mesh->HasBones()) {
-		auto skinnedData = std::make_unique<SkinnedMeshData>();
-		// We need to get the vertex vector from the derived class.
-		// This is a bit tricky and relies on the memory layout.
-		// A safer approach might involve a virtual get_vertices() returning a variant or base pointer.
-		verticesPtr = reinterpret_cast<std::vector<std::unique_ptr<MeshVertex>>*>(&skinnedData->get_vertices());
-		meshData = std::move(skinnedData);
-	} else {
-		meshData = std::make_unique<MeshData>();
-		verticesPtr = &meshData->get_vertices();
+void ModelImporter::AssignBoneIds(std::vector<MeshInstance>& instances) {
+	for (auto& instance : instances) {
+		aiMesh* mesh = instance.mesh;
+		instance.boneIds.resize(mesh->mNumBones);
+		
+		for (unsigned int i = 0; i < mesh->mNumBones; i++) {
+			std::string boneName = mesh->mBones[i]->mName.C_Str();
+			auto it = mBoneMapping.find(boneName);
+			
+			if (it == mBoneMapping.end()) {
+				it = mBoneMapping.emplace(boneName, mBoneCount++).first;
+			}
+			
+			instance.boneIds[i] = it->second;
+		}
 	}
+}
+
+void ModelImporter::ProcessMesh(const MeshInstance& instance, ImportedMesh& imported) const {
+	const aiMesh* mesh = instance.mesh;
 	
-	auto& vertices = *verticesPtr;
-	auto& indices = meshData->get_indices();
-	vertices.resize(mesh->mNumVertices);
-	
-	glm::mat4 normalMatrix = glm::transpose(glm::inverse(transform));
+	imported.skinned = mesh->HasBones();
+	imported.materialIndex = mesh->mMaterialIndex;
 	
-	// Process vertices
-	for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
-		std::unique_ptr<MeshVertex> vertex;
-		if (mesh->HasBones()) {
-			vertex = std::make_unique<SkinnedMeshVertex>();
-		} else {
-			vertex = std::make_unique<MeshVertex>();
-		}
-		
-		// Position
-		glm::vec4 pos = transform * glm::vec4(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z, 1.0f);
-		vertex->set_position(glm::vec3(pos));
-		
-		// Normals
-		if (mesh->HasNormals()) {
-			glm::vec4 normal = normalMatrix * glm::vec4(mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z, 0.0f);
-			vertex->set_normal(glm::normalize(glm::vec3(normal)));
-		}
-		
-		// Texture Coordinates
-		if (mesh->mTextureCoords[0]) {
-			vertex->set_texture_coords1({mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y});
-		}
-		
-		// Vertex Colors
-		if (mesh->mColors[0]) {
-			vertex->set_color({mesh->mColors[0][i].r, mesh->mColors[0][i].g, mesh->mColors[0][i].b, mesh->mColors[0][i].a});
-		}
-		
-		vertex->set_material_id(mesh->mMaterialIndex);
-		vertices[i] = std::move(vertex);
+	if (imported.skinned) {
+		FillImportedVertices(mesh, instance.transform, imported.skinnedVertices);
+	} else {
+		FillImportedVertices(mesh, instance.transform, imported.vertices);
 	}
 	
 	// Process indices
+	imported.indices.reserve(static_cast<size_t>(mesh->mNumFaces) * 3);
 	for (unsigned int i = 0; i < mesh->mNumFaces; i++) {
-		aiFace face = mesh->mFaces[i];
-		for (unsigned int j = 0; j < face.mNumIndices; j++) {
-			indices.push_back(face.mIndices[j]);
-		}
+		const aiFace& face = mesh->mFaces[i];
+		imported.indices.insert(imported.indices.end(), face.mIndices, face.mIndices + face.mNumIndices);
 	}
 	
-	// Process bones
-	if (mesh->HasBones()) {
-		auto& skinnedVertices = static_cast<SkinnedMeshData*>(meshData.get())->get_vertices();
-		for (unsigned int i = 0; i < mesh->mNumBones; i++) {
-			aiBone* bone = mesh->mBones[i];
-			std::string boneName = bone->mName.C_Str();
-			int boneID;
-			
-			if (mBoneMapping.find(boneName) == mBoneMapping.end()) {
-				boneID = mBoneCount++;
-				mBoneMapping[boneName] = boneID;
-			} else {
-				boneID = mBoneMapping[boneName];
-			}
-			
-			for (unsigned int j = 0; j < bone->mNumWeights; j++) {
-				unsigned int vertexID = bone->mWeights[j].mVertexId;
-				float weight = bone->mWeights[j].mWeight;
-				if (vertexID < skinnedVertices.size()) {
-					auto* skinnedVertex = dynamic_cast<SkinnedMeshVertex*>(vertices[vertexID].get());
-					if(skinnedVertex) {
-						skinnedVertex->set_bone(boneID, weight);
-					}
-				}
+	// Process bones, their ids were assigned by AssignBoneIds()
+	for (unsigned int i = 0; i < mesh->mNumBones; i++) {
+		const aiBone* bone = mesh->mBones[i];
+		int boneID = instance.boneIds[i];
+		
+		for (unsigned int j = 0; j < bone->mNumWeights; j++) {
+			unsigned int vertexID = bone->mWeights[j].mVertexId;
+			if (vertexID < imported.skinnedVertices.size()) {
+				imported.skinnedVertices[vertexID].set_bone(boneID, bone->mWeights[j].mWeight);
 			}
 		}
-		// Normalize weights if needed (your SkinnedMeshVertex should handle this)
 	}
+}
+
+std::unique_ptr<MeshData> ModelImporter::BuildMeshData(ImportedMesh& imported) const {
+	std::unique_ptr<MeshData> meshData = imported.skinned ? std::make_unique<SkinnedMeshData>() : std::make_unique<MeshData>();
+	
+	auto& vertices = meshData->get_vertices();
+	vertices.reserve(imported.skinned ? imported.skinnedVertices.size() : imported.vertices.size());
+	
+	for (const auto& vertex : imported.skinnedVertices) {
+		vertices.push_back(std::make_unique<SkinnedMeshVertex>(vertex));
+	}
+	
+	for (const auto& vertex : imported.vertices) {
+		vertices.push_back(std::make_unique<MeshVertex>(vertex));
+	}
+	
+	meshData->get_indices() = std::move(imported.indices);
 	
 	// Assign the corresponding material to the mesh data.
-	// This is possible because ProcessMaterials() was called before ProcessNode().
-	if (mesh->mMaterialIndex >= 0) {
-		if (static_cast<unsigned int>(mesh->mMaterialIndex) < mMaterialProperties.size()) {
-			meshData->get_material_properties().push_back(mMaterialProperties[mesh->mMaterialIndex]);
-		} else {
-			std::cerr << "Warning: Mesh has an invalid material index: " << mesh->mMaterialIndex << std::endl;
-		}
+	// This is possible because ProcessMaterials() was called before the meshes.
+	if (imported.materialIndex < mMaterialProperties.size()) {
+		meshData->get_material_properties().push_back(mMaterialProperties[imported.materialIndex]);
+	} else {
+		std::cerr << "Warning: Mesh has an invalid material index: " << imported.materialIndex << std::endl;
 	}
 	
-	mMeshes.push_back(std::move(meshData));
+	meshData->update_memory_usage();
+	return meshData;
 }
 
 void ModelImporter::ProcessMaterials(const aiScene* scene) {
 	mMaterialProperties.resize(scene->mNumMaterials);
-	for (unsigned int i = 0; i < scene->mNumMaterials; i++) {
+	
+	auto processMaterial = [this, scene](size_t i) {
 		aiMaterial* material = scene->mMaterials[i];
 		auto matPtr = std::make_shared<MaterialProperties>();
 		
@@ -264,10 +321,20 @@ void ModelImporter::ProcessMaterials(const aiScene* scene) {
 		}
 		
 		mMaterialProperties[i] = matPtr;
+	};
+	
+#if defined(NANOGUI_USE_METAL)
+	// Texture decoding dominates here; Metal textures can be created from any thread
+	ParallelForEachIndex(scene->mNumMaterials, processMaterial);
+#else
+	// GL textures can only be created on the thread that owns the context
+	for (unsigned int i = 0; i < scene->mNumMaterials; i++) {
+		processMaterial(i);
 	}
+#endif
 }
 
-std::shared_ptr<nanogui::Texture> ModelImporter::LoadMaterialTexture(aiMaterial* mat, const aiScene* scene, const std::string& typeName) {
+std::shared_ptr<TextureLayer> ModelImporter::LoadMaterialTexture(aiMaterial* mat, const aiScene* scene, const std::string& typeName) {
 	// Determine the Assimp texture type from our internal type name.
 	aiTextureType assimpType;
 	if (typeName == "texture_diffuse") {
@@ -304,12 +371,9 @@ std::shared_ptr<nanogui::Texture> ModelImporter::LoadMaterialTexture(aiMaterial*
 	// If a valid path was found, try to load the file.
 	if (!finalPath.empty() && std::filesystem::exists(finalPath)) {
 		std::cout << "Found texture file, loading: " << finalPath << std::endl;
-		std::ifstream file(finalPath, std::ios::binary);
-		if (file) {
-			std::vector<uint8_t> buffer(std::istreambuf_iterator<char>(file), {});
-			// Create texture from the file data in memory.
-			// This assumes nanogui::Texture can be constructed from a memory buffer of a PNG/JPG.
-			return std::make_shared<nanogui::Texture>(buffer.data(), buffer.size());
+		// Shared with every other material whose image has the same contents
+		if (auto texture = TextureRegistry::instance().load_file(finalPath.string())) {
+			return texture;
 		}
 	}
 	
@@ -325,10 +389,8 @@ std::shared_ptr<nanogui::Texture> ModelImporter::LoadMaterialTexture(aiMaterial*
 		// If mHeight is 0, the texture is compressed (e.g., PNG, JPG).
 		// The size of the compressed data is stored in mWidth.
 		if (embeddedTexture->mHeight == 0) {
-			return std::make_shared<nanogui::Texture>(
-													  reinterpret_cast<uint8_t*>(embeddedTexture->pcData),
-													  embeddedTexture->mWidth
-													  );
+			return TextureRegistry::instance().load(reinterpret_cast<uint8_t*>(embeddedTexture->pcData),
+													embeddedTexture->mWidth);
 		} else {
 			// The texture is uncompressed raw ARGB data. This requires special handling
 			// that is not implemented here, as nanogui::Texture likely expects a
@@ -412,62 +474,72 @@ void ModelImporter::AddNodeToSkeleton(aiNode* node, int parentBoneId, const aiSc
 }
 
 void ModelImporter::ProcessAnimations(const aiScene* scene) {
-	for (unsigned int i = 0; i < scene->mNumAnimations; i++) {
-		aiAnimation* anim = scene->mAnimations[i];
-		auto animation = std::make_unique<Animation>();
+	std::vector<std::unique_ptr<Animation>> animations(scene->mNumAnimations);
+	
+	ParallelForEachIndex(scene->mNumAnimations, [&](size_t i) {
+		animations[i] = ProcessAnimation(scene->mAnimations[i]);
+	});
+	
+	for (auto& animation : animations) {
+		if (!animation->empty()) {
+			mAnimations.push_back(std::move(animation));
+		}
+	}
+}
+
+std::unique_ptr<Animation> ModelImporter::ProcessAnimation(const aiAnimation* anim) const {
+	auto animation = std::make_unique<Animation>();
+	
+	double ticksPerSecond = anim->mTicksPerSecond != 0 ? anim->mTicksPerSecond : 24.0;
+	animation->set_duration(anim->mDuration / ticksPerSecond);
+	
+	for (unsigned int j = 0; j < anim->mNumChannels; j++) {
+		aiNodeAnim* channel = anim->mChannels[j];
+		std::string boneName = channel->mNodeName.C_Str();
 		
-		double ticksPerSecond = anim->mTicksPerSecond != 0 ? anim->mTicksPerSecond : 24.0;
-		animation->set_duration(anim->mDuration / ticksPerSecond);
+		auto it = mBoneMapping.find(boneName);
+		if (it == mBoneMapping.end()) continue;
+		int boneID = it->second;
 		
-		for (unsigned int j = 0; j < anim->mNumChannels; j++) {
-			aiNodeAnim* channel = anim->mChannels[j];
-			std::string boneName = channel->mNodeName.C_Str();
-			
-			auto it = mBoneMapping.find(boneName);
-			if (it == mBoneMapping.end()) continue;
-			int boneID = it->second;
-			
-			std::vector<Animation::KeyFrame> keyframes;
+		std::vector<Animation::KeyFrame> keyframes;
+		
+		// This example assumes keyframes for pos/rot/scale are aligned.
+		// A more robust implementation would merge timestamps from all three tracks.
+		for (unsigned int k = 0; k < channel->mNumPositionKeys; k++) {
+			Animation::KeyFrame frame;
+			frame.time = channel->mPositionKeys[k].mTime / ticksPerSecond;
+			frame.translation = {channel->mPositionKeys[k].mValue.x, channel->mPositionKeys[k].mValue.y, channel->mPositionKeys[k].mValue.z};
 			
-			// This example assumes keyframes for pos/rot/scale are aligned.
-			// A more robust implementation would merge timestamps from all three tracks.
-			for (unsigned int k = 0; k < channel->mNumPositionKeys; k++) {
-				Animation::KeyFrame frame;
-				frame.time = channel->mPositionKeys[k].mTime / ticksPerSecond;
-				frame.translation = {channel->mPositionKeys[k].mValue.x, channel->mPositionKeys[k].mValue.y, channel->mPositionKeys[k].mValue.z};
-				
-				// Find corresponding rotation and scale (or interpolate)
-				// For simplicity, we'll use the closest key
-				unsigned int rotIndex = 0;
-				for (unsigned int r = 0; r < channel->mNumRotationKeys - 1; ++r) {
-					if (frame.time < channel->mRotationKeys[r + 1].mTime) {
-						rotIndex = r;
-						break;
-					}
-				}
-				aiQuaternion rot = channel->mRotationKeys[rotIndex].mValue;
-				frame.rotation = glm::quat(rot.w, rot.x, rot.y, rot.z);
-				
-				unsigned int scaleIndex = 0;
-				for (unsigned int s = 0; s < channel->mNumScalingKeys - 1; ++s) {
-					if (frame.time < channel->mScalingKeys[s + 1].mTime) {
-						scaleIndex = s;
-						break;
-					}
+			// Find corresponding rotation and scale (or interpolate)
+			// For simplicity, we'll use the closest key
+			unsigned int rotIndex = 0;
+			for (unsigned int r = 0; r < channel->mNumRotationKeys - 1; ++r) {
+				if (frame.time < channel->mRotationKeys[r + 1].mTime) {
+					rotIndex = r;
+					break;
 				}
-				aiVector3D scale = channel->mScalingKeys[scaleIndex].mValue;
-				frame.scale = {scale.x, scale.y, scale.z};
-				
-				keyframes.push_back(frame);
 			}
-			if(!keyframes.empty()) {
-				animation->add_bone_keyframes(boneID, keyframes);
+			aiQuaternion rot = channel->mRotationKeys[rotIndex].mValue;
+			frame.rotation = glm::quat(rot.w, rot.x, rot.y, rot.z);
+			
+			unsigned int scaleIndex = 0;
+			for (unsigned int s = 0; s < channel->mNumScalingKeys - 1; ++s) {
+				if (frame.time < channel->mScalingKeys[s + 1].mTime) {
+					scaleIndex = s;
+					break;
+				}
 			}
+			aiVector3D scale = channel->mScalingKeys[scaleIndex].mValue;
+			frame.scale = {scale.x, scale.y, scale.z};
+			
+			keyframes.push_back(frame);
 		}
-		if (!animation->empty()) {
-			mAnimations.push_back(std::move(animation));
+		if(!keyframes.empty()) {
+			animation->add_bone_keyframes(boneID, keyframes);
 		}
 	}
+	
+	return animation;
 }
 
 
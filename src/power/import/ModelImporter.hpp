@@ -17,6 +17,7 @@ struct aiScene;
 struct aiNode;
 struct aiMesh;
 struct aiMaterial;
+struct aiAnimation;
 
 class ModelImporter {
 public:
@@ -37,9 +38,28 @@ public:
     std::vector<std::unique_ptr<Animation>>& GetAnimations();
 
 private:
+    // A mesh reference from the node hierarchy, listed in depth-first order
+    struct MeshInstance {
+        aiMesh* mesh;
+        glm::mat4 transform;
+        std::vector<int> boneIds; // Per aiBone of the mesh
+    };
+
+    // A mesh's vertices in contiguous arrays, filled and turned into MeshData on a worker
+    struct ImportedMesh {
+        std::vector<MeshVertex> vertices;               // Meshes without bones
+        std::vector<SkinnedMeshVertex> skinnedVertices; // Meshes with bones
+        std::vector<unsigned int> indices;
+        unsigned int materialIndex = 0;
+        bool skinned = false;
+    };
+
     // Internal processing functions
-    void ProcessNode(aiNode* node, const aiScene* scene, const glm::mat4& parentTransform);
-    void ProcessMesh(aiMesh* mesh, const aiScene* scene, const glm::mat4& transform);
+    void ProcessScene(const aiScene* scene);
+    void CollectMeshes(aiNode* node, const aiScene* scene, const glm::mat4& parentTransform, std::vector<MeshInstance>& instances);
+    void AssignBoneIds(std::vector<MeshInstance>& instances);
+    void ProcessMesh(const MeshInstance& instance, ImportedMesh& imported) const;
+    std::unique_ptr<MeshData> BuildMeshData(ImportedMesh& imported) const;
     void ProcessMaterials(const aiScene* scene);
     void BuildSkeleton(const aiScene* scene);
 	void AddNodeToSkeleton(aiNode* node,
@@ -49,9 +69,10 @@ private:
 						   const std::set<std::string>& boneNames,
 						   const std::map<std::string, glm::mat4>& offsetMatrices);
     void ProcessAnimations(const aiScene* scene);
+    std::unique_ptr<Animation> ProcessAnimation(const aiAnimation* anim) const;
 
     // Helper to load textures
-    std::shared_ptr<nanogui::Texture> LoadMaterialTexture(aiMaterial* mat, const aiScene* scene, const std::string& typeName);
+    std::shared_ptr<TextureLayer> LoadMaterialTexture(aiMaterial* mat, const aiScene* scene, const std::string& typeName);
 
     // Data members
     std::vector<std::unique_ptr<MeshData>> mMeshes;
@@ -8,6 +8,7 @@
 
 #include "execution/BlueprintManager.hpp"
 #include "execution/ExecutionManager.hpp"
+#include "filesystem/HashCache.hpp"
 #include "gizmo/GizmoManager.hpp"
 #include "graphics/drawing/SkinnedMeshBatch.hpp"
 #include "simulation/Cartridge.hpp"
@@ -27,6 +28,9 @@ int main(int /* argc */, char ** /* argv */) {
 		nanogui::mainloop();
 	}
 	
+	// Written here rather than during static destruction, after every import and thumbnail worker has stopped
+	HashCache::instance().save();
+	
 	nanogui::shutdown();
 	
 	return 0;
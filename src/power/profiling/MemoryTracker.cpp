@@ -0,0 +1,403 @@
+#include "profiling/MemoryTracker.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace {
+constexpr const char* kBudgetEnvironmentVariable = "POWER_ENGINE_MEMORY_BUDGETS";
+
+// Usage has to drop this far below a budget before it warns again
+constexpr double kBudgetRearmRatio = 0.9;
+
+const char* kTagNames[MemoryTracker::kTagCount] = {
+	"meshes",
+	"flattened_attributes",
+	"batch_buffers",
+	"animation",
+	"skeleton",
+	"images",
+	"serialization",
+	"vm",
+	"gpu_buffers",
+	"gpu_textures",
+	"undo_history"
+};
+
+std::string trim_whitespace(const std::string& value) {
+	size_t begin = value.find_first_not_of(" \t");
+	size_t end = value.find_last_not_of(" \t");
+	return begin == std::string::npos ? "" : value.substr(begin, end - begin + 1);
+}
+
+bool parse_size(const std::string& text, uint64_t& bytes) {
+	size_t consumed = 0;
+	double value = 0.0;
+
+	try {
+		value = std::stod(text, &consumed);
+	} catch (...) {
+		return false;
+	}
+
+	std::string unit = trim_whitespace(text.substr(consumed));
+	std::transform(unit.begin(), unit.end(), unit.begin(), ::toupper);
+
+	double scale = 1.0;
+
+	if (unit == "KB" || unit == "K") {
+		scale = 1024.0;
+	} else if (unit == "MB" || unit == "M") {
+		scale = 1024.0 * 1024.0;
+	} else if (unit == "GB" || unit == "G") {
+		scale = 1024.0 * 1024.0 * 1024.0;
+	} else if (!unit.empty() && unit != "B") {
+		return false;
+	}
+
+	if (value < 0.0) {
+		return false;
+	}
+
+	bytes = static_cast<uint64_t>(value * scale);
+	return true;
+}
+} // unnamed namespace
+
+uint64_t MemoryTracker::Snapshot::total() const {
+	uint64_t sum = 0;
+
+	for (const auto& usage : tags) {
+		sum += usage.current;
+	}
+
+	return sum;
+}
+
+MemoryTracker& MemoryTracker::instance() {
+	static MemoryTracker tracker;
+	return tracker;
+}
+
+MemoryTracker::MemoryTracker() {
+	if (const char* budgets = std::getenv(kBudgetEnvironmentVariable)) {
+		if (!load_budgets(budgets)) {
+			std::cerr << "Ignoring invalid entries in " << kBudgetEnvironmentVariable << ": " << budgets << std::endl;
+		}
+	}
+}
+
+const char* MemoryTracker::tag_name(Tag tag) {
+	size_t index = static_cast<size_t>(tag);
+	return index < kTagCount ? kTagNames[index] : "unknown";
+}
+
+void MemoryTracker::add(Tag tag, uint64_t bytes) {
+	Counter& counter = mCounters[static_cast<size_t>(tag)];
+	uint64_t current = counter.current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+
+	uint64_t peak = counter.peak.load(std::memory_order_relaxed);
+	while (current > peak && !counter.peak.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+	}
+
+	check_budget(tag, current);
+}
+
+void MemoryTracker::remove(Tag tag, uint64_t bytes) {
+	Counter& counter = mCounters[static_cast<size_t>(tag)];
+	uint64_t current = counter.current.fetch_sub(bytes, std::memory_order_relaxed) - bytes;
+
+	check_budget(tag, current);
+}
+
+uint64_t MemoryTracker::current(Tag tag) const {
+	return mCounters[static_cast<size_t>(tag)].current.load(std::memory_order_relaxed);
+}
+
+void MemoryTracker::set_budget(Tag tag, uint64_t bytes) {
+	Counter& counter = mCounters[static_cast<size_t>(tag)];
+	counter.budget.store(bytes, std::memory_order_relaxed);
+	counter.warned.store(false, std::memory_order_relaxed);
+
+	check_budget(tag, counter.current.load(std::memory_order_relaxed));
+}
+
+uint64_t MemoryTracker::budget(Tag tag) const {
+	return mCounters[static_cast<size_t>(tag)].budget.load(std::memory_order_relaxed);
+}
+
+bool MemoryTracker::load_budgets(const std::string& specification) {
+	bool valid = true;
+	std::stringstream stream(specification);
+	std::string entry;
+
+	while (std::getline(stream, entry, ',')) {
+		entry = trim_whitespace(entry);
+
+		if (entry.empty()) {
+			continue;
+		}
+
+		size_t separator = entry.find('=');
+
+		if (separator == std::string::npos) {
+			valid = false;
+			continue;
+		}
+
+		std::string name = trim_whitespace(entry.substr(0, separator));
+		uint64_t bytes = 0;
+
+		auto begin = std::begin(kTagNames);
+		auto end = std::end(kTagNames);
+		auto it = std::find_if(begin, end, [&name](const char* tagName) {
+			return name == tagName;
+		});
+
+		if (it == end || !parse_size(entry.substr(separator + 1), bytes)) {
+			valid = false;
+			continue;
+		}
+
+		set_budget(static_cast<Tag>(it - begin), bytes);
+	}
+
+	return valid;
+}
+
+void MemoryTracker::track_shared(Tag tag, const std::shared_ptr<const void>& resource, uint64_t bytes) {
+	if (!resource) {
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(mSharedMutex);
+
+	auto it = mShared.find(resource.get());
+
+	if (it != mShared.end()) {
+		// Rebinding a known resource is the common case and must stay cheap
+		if (!it->second.resource.expired() && it->second.tag == tag && it->second.bytes == bytes) {
+			return;
+		}
+
+		// Resized, or a new resource reusing the address of a released one
+		remove(it->second.tag, it->second.bytes);
+		add_handles(it->second.tag, -1);
+		mShared.erase(it);
+	} else {
+		collect_shared();
+	}
+
+	mShared[resource.get()] = SharedEntry{tag, bytes, resource};
+	add_handles(tag, 1);
+	add(tag, bytes);
+}
+
+void MemoryTracker::collect_shared() {
+	for (auto it = mShared.begin(); it != mShared.end();) {
+		if (it->second.resource.expired()) {
+			remove(it->second.tag, it->second.bytes);
+			add_handles(it->second.tag, -1);
+			it = mShared.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+MemoryTracker::Snapshot MemoryTracker::snapshot() {
+	{
+		std::unique_lock<std::mutex> lock(mSharedMutex);
+		collect_shared();
+	}
+
+	Snapshot snapshot;
+	snapshot.time = std::chrono::system_clock::now();
+
+	for (size_t i = 0; i < kTagCount; ++i) {
+		const Counter& counter = mCounters[i];
+		TagUsage& usage = snapshot.tags[i];
+
+		usage.current = counter.current.load(std::memory_order_relaxed);
+		usage.peak = counter.peak.load(std::memory_order_relaxed);
+		usage.handles = counter.handles.load(std::memory_order_relaxed);
+		usage.budget = counter.budget.load(std::memory_order_relaxed);
+	}
+
+	return snapshot;
+}
+
+std::string MemoryTracker::report(const Snapshot& snapshot) {
+	std::ostringstream output;
+
+	output << std::left << std::setw(22) << "subsystem"
+		   << std::right << std::setw(12) << "current"
+		   << std::setw(12) << "peak"
+		   << std::setw(10) << "handles"
+		   << std::setw(12) << "budget" << "\n";
+
+	for (size_t i = 0; i < kTagCount; ++i) {
+		const TagUsage& usage = snapshot.tags[i];
+
+		output << std::left << std::setw(22) << kTagNames[i]
+			   << std::right << std::setw(12) << format_bytes(usage.current)
+			   << std::setw(12) << format_bytes(usage.peak)
+			   << std::setw(10) << usage.handles
+			   << std::setw(12) << (usage.budget ? format_bytes(usage.budget) : "-");
+
+		if (usage.budget && usage.current > usage.budget) {
+			output << "  OVER BUDGET";
+		}
+
+		output << "\n";
+	}
+
+	output << std::left << std::setw(22) << "total"
+		   << std::right << std::setw(12) << format_bytes(snapshot.total()) << "\n";
+
+	return output.str();
+}
+
+std::string MemoryTracker::diff(const Snapshot& before, const Snapshot& after) {
+	std::ostringstream output;
+
+	auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(after.time - before.time);
+	output << "Memory change over " << elapsed.count() / 1000.0 << "s\n";
+
+	auto signed_bytes = [](uint64_t from, uint64_t to) {
+		return (to >= from ? "+" : "-") + format_bytes(to >= from ? to - from : from - to);
+	};
+
+	bool changed = false;
+
+	for (size_t i = 0; i < kTagCount; ++i) {
+		const TagUsage& from = before.tags[i];
+		const TagUsage& to = after.tags[i];
+
+		if (from.current == to.current && from.handles == to.handles) {
+			continue;
+		}
+
+		changed = true;
+
+		int64_t handles = static_cast<int64_t>(to.handles) - static_cast<int64_t>(from.handles);
+
+		output << std::left << std::setw(22) << kTagNames[i]
+			   << std::right << std::setw(12) << signed_bytes(from.current, to.current)
+			   << "  (" << format_bytes(from.current) << " -> " << format_bytes(to.current) << ", "
+			   << (handles >= 0 ? "+" : "") << handles << " handles)\n";
+	}
+
+	if (!changed) {
+		output << "No change\n";
+	}
+
+	output << std::left << std::setw(22) << "total"
+		   << std::right << std::setw(12) << signed_bytes(before.total(), after.total()) << "\n";
+
+	return output.str();
+}
+
+std::string MemoryTracker::format_bytes(uint64_t bytes) {
+	static const char* units[] = {"B", "KB", "MB", "GB", "TB"};
+
+	double value = static_cast<double>(bytes);
+	size_t unit = 0;
+
+	while (value >= 1024.0 && unit + 1 < std::size(units)) {
+		value /= 1024.0;
+		++unit;
+	}
+
+	std::ostringstream output;
+	output << std::fixed << std::setprecision(unit == 0 ? 0 : 1) << value << " " << units[unit];
+	return output.str();
+}
+
+void MemoryTracker::add_handles(Tag tag, int64_t count) {
+	mCounters[static_cast<size_t>(tag)].handles.fetch_add(static_cast<uint64_t>(count), std::memory_order_relaxed);
+}
+
+void MemoryTracker::check_budget(Tag tag, uint64_t current) {
+	Counter& counter = mCounters[static_cast<size_t>(tag)];
+	uint64_t budget = counter.budget.load(std::memory_order_relaxed);
+
+	if (budget == 0) {
+		return;
+	}
+
+	if (current > budget) {
+		if (!counter.warned.exchange(true, std::memory_order_relaxed)) {
+			std::cerr << "Memory budget exceeded for " << tag_name(tag) << ": "
+					  << format_bytes(current) << " of " << format_bytes(budget) << std::endl;
+		}
+	} else if (static_cast<double>(current) < static_cast<double>(budget) * kBudgetRearmRatio) {
+		counter.warned.store(false, std::memory_order_relaxed);
+	}
+}
+
+TrackedMemory::TrackedMemory(MemoryTracker::Tag tag, uint64_t bytes)
+: mTag(tag) {
+	set(bytes);
+}
+
+TrackedMemory::~TrackedMemory() {
+	set(0);
+}
+
+TrackedMemory::TrackedMemory(const TrackedMemory& other)
+: mTag(other.mTag) {
+	set(other.mBytes);
+}
+
+TrackedMemory& TrackedMemory::operator=(const TrackedMemory& other) {
+	if (this != &other) {
+		set(0);
+		mTag = other.mTag;
+		set(other.mBytes);
+	}
+
+	return *this;
+}
+
+TrackedMemory::TrackedMemory(TrackedMemory&& other) noexcept
+: mTag(other.mTag)
+, mBytes(other.mBytes) {
+	other.mBytes = 0;
+}
+
+TrackedMemory& TrackedMemory::operator=(TrackedMemory&& other) noexcept {
+	if (this != &other) {
+		set(0);
+		mTag = other.mTag;
+		mBytes = other.mBytes;
+		other.mBytes = 0;
+	}
+
+	return *this;
+}
+
+void TrackedMemory::set(uint64_t bytes) {
+	if (bytes == mBytes) {
+		return;
+	}
+
+	MemoryTracker& tracker = MemoryTracker::instance();
+
+	if (mBytes == 0) {
+		tracker.add_handles(mTag, 1);
+	} else if (bytes == 0) {
+		tracker.add_handles(mTag, -1);
+	}
+
+	if (bytes > mBytes) {
+		tracker.add(mTag, bytes - mBytes);
+	} else {
+		tracker.remove(mTag, mBytes - bytes);
+	}
+
+	mBytes = bytes;
+}
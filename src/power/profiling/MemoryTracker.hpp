@@ -0,0 +1,143 @@
+#pragma once
+
+/**
+ * @brief Per-subsystem memory accounting with soft budgets.
+ *
+ * Subsystems report the size of the containers they own through TrackedMemory
+ * handles, so totals are estimates of live payload rather than exact heap usage.
+ * GPU sizes are derived from the data handed to ShaderWrapper. Budgets are soft:
+ * crossing one prints a warning once, and it re-arms after usage falls below 90%.
+ *
+ * Budgets can be set in code or through POWER_ENGINE_MEMORY_BUDGETS, e.g.
+ *   POWER_ENGINE_MEMORY_BUDGETS="meshes=512MB,gpu_textures=1GB,vm=256MB"
+ */
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class MemoryTracker {
+public:
+	enum class Tag {
+		Meshes,
+		FlattenedAttributes,
+		BatchBuffers,
+		Animation,
+		Skeleton,
+		Images,
+		Serialization,
+		VirtualMachine,
+		GpuBuffers,
+		GpuTextures,
+		UndoHistory,
+		Count
+	};
+
+	static constexpr size_t kTagCount = static_cast<size_t>(Tag::Count);
+
+	struct TagUsage {
+		uint64_t current = 0;
+		uint64_t peak = 0;
+		uint64_t handles = 0; // live tracked containers and resources
+		uint64_t budget = 0; // zero when unbudgeted
+	};
+
+	struct Snapshot {
+		std::chrono::system_clock::time_point time;
+		std::array<TagUsage, kTagCount> tags{};
+
+		uint64_t total() const;
+	};
+
+	static MemoryTracker& instance();
+
+	static const char* tag_name(Tag tag);
+
+	void add(Tag tag, uint64_t bytes);
+	void remove(Tag tag, uint64_t bytes);
+
+	uint64_t current(Tag tag) const;
+
+	// Zero removes the budget
+	void set_budget(Tag tag, uint64_t bytes);
+	uint64_t budget(Tag tag) const;
+
+	// Parses "tag=size[KB|MB|GB],..." and applies every valid entry; false if any entry was rejected
+	bool load_budgets(const std::string& specification);
+
+	// Accounts a shared resource once while any owner keeps it alive; releases are picked up lazily
+	void track_shared(Tag tag, const std::shared_ptr<const void>& resource, uint64_t bytes);
+
+	Snapshot snapshot();
+
+	static std::string report(const Snapshot& snapshot);
+	static std::string diff(const Snapshot& before, const Snapshot& after);
+
+	static std::string format_bytes(uint64_t bytes);
+
+private:
+	friend class TrackedMemory;
+
+	struct Counter {
+		std::atomic<uint64_t> current{0};
+		std::atomic<uint64_t> peak{0};
+		std::atomic<uint64_t> handles{0};
+		std::atomic<uint64_t> budget{0};
+		std::atomic<bool> warned{false};
+	};
+
+	struct SharedEntry {
+		Tag tag;
+		uint64_t bytes;
+		std::weak_ptr<const void> resource;
+	};
+
+	MemoryTracker();
+
+	void add_handles(Tag tag, int64_t count);
+	void check_budget(Tag tag, uint64_t current);
+	void collect_shared();
+
+	std::array<Counter, kTagCount> mCounters;
+
+	std::mutex mSharedMutex;
+	std::unordered_map<const void*, SharedEntry> mShared;
+};
+
+/**
+ * @brief Owns a tracked byte count for a single container or resource.
+ *
+ * Copies account their bytes again, moves transfer them, and destruction
+ * releases them, so the handle can sit next to the data it describes.
+ */
+class TrackedMemory {
+public:
+	explicit TrackedMemory(MemoryTracker::Tag tag, uint64_t bytes = 0);
+	~TrackedMemory();
+
+	TrackedMemory(const TrackedMemory& other);
+	TrackedMemory& operator=(const TrackedMemory& other);
+	TrackedMemory(TrackedMemory&& other) noexcept;
+	TrackedMemory& operator=(TrackedMemory&& other) noexcept;
+
+	void set(uint64_t bytes);
+
+	uint64_t bytes() const {
+		return mBytes;
+	}
+
+private:
+	MemoryTracker::Tag mTag;
+	uint64_t mBytes = 0;
+};
+
+template<typename T>
+uint64_t tracked_capacity(const std::vector<T>& vector) {
+	return static_cast<uint64_t>(vector.capacity()) * sizeof(T);
+}
@@ -0,0 +1,432 @@
+#include "profiling/Profiler.hpp"
+
+#if defined(POWER_ENGINE_PROFILER) && POWER_ENGINE_PROFILER
+
+#if defined(NANOGUI_USE_OPENGL)
+#include <nanogui/opengl.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+namespace {
+constexpr size_t kFrameHistory = 240;
+constexpr size_t kThreadBufferCapacity = 1 << 13;
+
+constexpr uint32_t kFrameTrack = 100000;
+constexpr uint32_t kGpuTrack = 100001;
+
+std::string escape_trace_string(const char* value) {
+	std::string escaped;
+
+	for (const char* c = value; *c; ++c) {
+		if (*c == '"' || *c == '\\') {
+			escaped.push_back('\\');
+		}
+
+		if (static_cast<unsigned char>(*c) >= 0x20) {
+			escaped.push_back(*c);
+		}
+	}
+
+	return escaped;
+}
+} // unnamed namespace
+
+// Single producer (the owning thread), drained by the main thread at frame end
+struct Profiler::ThreadBuffer {
+	std::array<Zone, kThreadBufferCapacity> zones;
+	std::atomic<uint64_t> written{0};
+	uint64_t drained = 0;
+	uint32_t depth = 0;
+	uint32_t id = 0;
+	std::string name;
+};
+
+#if defined(NANOGUI_USE_OPENGL)
+// Timestamp queries nest freely, unlike GL_TIME_ELAPSED, and are read back a few frames later
+class Profiler::GpuTimer {
+public:
+	struct Result {
+		uint64_t frame;
+		GpuZone zone;
+	};
+
+	void begin(const char* name, uint64_t frame) {
+		GLuint query = acquire();
+		glQueryCounter(query, GL_TIMESTAMP);
+		mOpen.push_back(Pending{name, query, 0, frame});
+	}
+
+	void end() {
+		if (mOpen.empty()) {
+			return;
+		}
+
+		Pending pending = mOpen.back();
+		mOpen.pop_back();
+
+		pending.end = acquire();
+		glQueryCounter(pending.end, GL_TIMESTAMP);
+		mPending.push_back(pending);
+	}
+
+	// Results complete in submission order, so polling stops at the first unfinished query
+	void collect(std::vector<Result>& results) {
+		while (!mPending.empty()) {
+			const Pending& pending = mPending.front();
+
+			GLint available = 0;
+			glGetQueryObjectiv(pending.end, GL_QUERY_RESULT_AVAILABLE, &available);
+
+			if (!available) {
+				break;
+			}
+
+			GLuint64 start = 0;
+			GLuint64 end = 0;
+			glGetQueryObjectui64v(pending.begin, GL_QUERY_RESULT, &start);
+			glGetQueryObjectui64v(pending.end, GL_QUERY_RESULT, &end);
+
+			results.push_back(Result{pending.frame, GpuZone{pending.name, start, end > start ? end - start : 0}});
+
+			mFreeQueries.push_back(pending.begin);
+			mFreeQueries.push_back(pending.end);
+			mPending.pop_front();
+		}
+	}
+
+	// Frames before this one have no outstanding queries
+	uint64_t oldest_pending_frame(uint64_t currentFrame) const {
+		if (!mOpen.empty()) {
+			return std::min(mOpen.front().frame, mPending.empty() ? currentFrame : mPending.front().frame);
+		}
+
+		return mPending.empty() ? currentFrame : mPending.front().frame;
+	}
+
+private:
+	struct Pending {
+		const char* name;
+		GLuint begin;
+		GLuint end;
+		uint64_t frame;
+	};
+
+	GLuint acquire() {
+		if (mFreeQueries.empty()) {
+			GLuint queries[16];
+			glGenQueries(16, queries);
+			mFreeQueries.insert(mFreeQueries.end(), std::begin(queries), std::end(queries));
+		}
+
+		GLuint query = mFreeQueries.back();
+		mFreeQueries.pop_back();
+		return query;
+	}
+
+	// Queries are not deleted; the context is already gone when the profiler is destroyed
+	std::vector<GLuint> mFreeQueries;
+	std::vector<Pending> mOpen;
+	std::deque<Pending> mPending;
+};
+#else
+// No portable timer queries on GLES 2 or through the Metal backend; GPU zones are ignored
+class Profiler::GpuTimer {
+public:
+	struct Result {
+		uint64_t frame;
+		GpuZone zone;
+	};
+
+	void begin(const char*, uint64_t) {}
+	void end() {}
+	void collect(std::vector<Result>&) {}
+
+	uint64_t oldest_pending_frame(uint64_t currentFrame) const {
+		return currentFrame;
+	}
+};
+#endif
+
+Profiler& Profiler::instance() {
+	static Profiler profiler;
+	return profiler;
+}
+
+Profiler::Profiler()
+: mEpoch(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count())) {
+}
+
+Profiler::~Profiler() = default;
+
+const char* Profiler::counter_name(Counter counter) {
+	switch (counter) {
+		case Counter::DrawCalls: return "Draw calls";
+		case Counter::Triangles: return "Triangles";
+		case Counter::BufferBytesUploaded: return "Buffer bytes uploaded";
+		case Counter::LightClusterIndices: return "Clustered light indices";
+		default: return "Unknown";
+	}
+}
+
+uint64_t Profiler::now() const {
+	auto time = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+	return time - mEpoch;
+}
+
+Profiler::ThreadBuffer& Profiler::thread_buffer() {
+	thread_local std::shared_ptr<ThreadBuffer> buffer;
+
+	if (!buffer) {
+		buffer = std::make_shared<ThreadBuffer>();
+
+		std::unique_lock<std::mutex> lock(mBuffersMutex);
+		buffer->id = mNextThreadId++;
+		buffer->name = "Thread " + std::to_string(buffer->id);
+		mBuffers.push_back(buffer);
+	}
+
+	return *buffer;
+}
+
+void Profiler::begin_zone() {
+	++thread_buffer().depth;
+}
+
+void Profiler::end_zone(const char* name, uint64_t start) {
+	uint64_t end = now();
+	ThreadBuffer& buffer = thread_buffer();
+
+	buffer.depth = buffer.depth > 0 ? buffer.depth - 1 : 0;
+
+	uint64_t index = buffer.written.load(std::memory_order_relaxed);
+	buffer.zones[index % kThreadBufferCapacity] = Zone{name, start, end, buffer.depth, buffer.id};
+	buffer.written.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::begin_gpu_zone(const char* name) {
+	if (!mGpuTimer) {
+		mGpuTimer = std::make_unique<GpuTimer>();
+	}
+
+	mGpuTimer->begin(name, mFrameIndex);
+}
+
+void Profiler::end_gpu_zone() {
+	if (mGpuTimer) {
+		mGpuTimer->end();
+	}
+}
+
+void Profiler::set_thread_name(const std::string& name) {
+	ThreadBuffer& buffer = thread_buffer();
+
+	std::unique_lock<std::mutex> lock(mBuffersMutex);
+	buffer.name = name;
+}
+
+void Profiler::drain(ThreadBuffer& buffer, Frame& frame) {
+	uint64_t written = buffer.written.load(std::memory_order_acquire);
+	uint64_t first = buffer.drained;
+
+	if (written - first > kThreadBufferCapacity) {
+		frame.dropped_zones += written - kThreadBufferCapacity - first;
+		first = written - kThreadBufferCapacity;
+	}
+
+	size_t copiedFrom = frame.zones.size();
+
+	for (uint64_t i = first; i < written; ++i) {
+		frame.zones.push_back(buffer.zones[i % kThreadBufferCapacity]);
+	}
+
+	// Slots the producer lapped while they were being copied may be torn
+	uint64_t after = buffer.written.load(std::memory_order_acquire);
+
+	if (after > kThreadBufferCapacity && after - kThreadBufferCapacity > first) {
+		uint64_t torn = std::min(after - kThreadBufferCapacity, written) - first;
+		frame.zones.erase(frame.zones.begin() + copiedFrom, frame.zones.begin() + copiedFrom + torn);
+		frame.dropped_zones += torn;
+	}
+
+	buffer.drained = written;
+}
+
+void Profiler::end_frame() {
+	Frame frame;
+	frame.index = mFrameIndex++;
+	frame.start = mFrameStart;
+	frame.end = now();
+	mFrameStart = frame.end;
+
+	{
+		std::unique_lock<std::mutex> lock(mBuffersMutex);
+
+		for (auto& buffer : mBuffers) {
+			drain(*buffer, frame);
+		}
+	}
+
+	std::sort(frame.zones.begin(), frame.zones.end(), [](const Zone& a, const Zone& b) {
+		return a.start < b.start;
+	});
+
+	for (size_t i = 0; i < frame.counters.size(); ++i) {
+		frame.counters[i] = mCounters[i].exchange(0, std::memory_order_relaxed);
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(mFramesMutex);
+
+		mFrames.push_back(std::move(frame));
+
+		while (mFrames.size() > kFrameHistory) {
+			mFrames.pop_front();
+		}
+	}
+
+	resolve_gpu_zones();
+}
+
+void Profiler::resolve_gpu_zones() {
+	if (!mGpuTimer) {
+		return;
+	}
+
+	std::vector<GpuTimer::Result> results;
+	mGpuTimer->collect(results);
+
+	uint64_t oldestPending = mGpuTimer->oldest_pending_frame(mFrameIndex);
+
+	std::unique_lock<std::mutex> lock(mFramesMutex);
+
+	for (const auto& result : results) {
+		auto it = std::find_if(mFrames.rbegin(), mFrames.rend(), [&result](const Frame& frame) {
+			return frame.index == result.frame;
+		});
+
+		if (it != mFrames.rend()) {
+			it->gpu_zones.push_back(result.zone);
+		}
+	}
+
+	for (auto& frame : mFrames) {
+		if (frame.index < oldestPending) {
+			frame.gpu_resolved = true;
+		}
+	}
+}
+
+std::vector<Profiler::Frame> Profiler::frames() const {
+	std::unique_lock<std::mutex> lock(mFramesMutex);
+	return std::vector<Frame>(mFrames.begin(), mFrames.end());
+}
+
+bool Profiler::latest_frame(Frame& frame, bool requireGpu) const {
+	std::unique_lock<std::mutex> lock(mFramesMutex);
+
+	for (auto it = mFrames.rbegin(); it != mFrames.rend(); ++it) {
+		if (!requireGpu || it->gpu_resolved) {
+			frame = *it;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+std::vector<float> Profiler::frame_times() const {
+	std::unique_lock<std::mutex> lock(mFramesMutex);
+
+	std::vector<float> times;
+	times.reserve(mFrames.size());
+
+	for (const auto& frame : mFrames) {
+		times.push_back(static_cast<float>(frame.milliseconds()));
+	}
+
+	return times;
+}
+
+std::vector<std::pair<uint32_t, std::string>> Profiler::thread_names() const {
+	std::unique_lock<std::mutex> lock(mBuffersMutex);
+
+	std::vector<std::pair<uint32_t, std::string>> names;
+
+	for (const auto& buffer : mBuffers) {
+		names.emplace_back(buffer->id, buffer->name);
+	}
+
+	return names;
+}
+
+bool Profiler::export_chrome_trace(const std::string& path) const {
+	std::ofstream stream(path, std::ios::trunc);
+
+	if (!stream.is_open()) {
+		std::cerr << "Failed to write trace: " << path << std::endl;
+		return false;
+	}
+
+	auto frames = this->frames();
+	auto names = thread_names();
+
+	// Chrome trace timestamps are microseconds
+	auto micros = [](uint64_t nanoseconds) {
+		return static_cast<double>(nanoseconds) / 1000.0;
+	};
+
+	stream << std::fixed;
+	stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+	bool first = true;
+	auto separator = [&stream, &first]() -> std::ostream& {
+		stream << (first ? "" : ",\n");
+		first = false;
+		return stream;
+	};
+
+	for (const auto& [id, name] : names) {
+		separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << id
+					<< ",\"args\":{\"name\":\"" << escape_trace_string(name.c_str()) << "\"}}";
+	}
+
+	separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << kFrameTrack << ",\"args\":{\"name\":\"Frames\"}}";
+	separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << kGpuTrack << ",\"args\":{\"name\":\"GPU\"}}";
+
+	for (const auto& frame : frames) {
+		separator() << "{\"name\":\"Frame " << frame.index << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << kFrameTrack
+					<< ",\"ts\":" << micros(frame.start) << ",\"dur\":" << micros(frame.end - frame.start) << "}";
+
+		for (const auto& zone : frame.zones) {
+			separator() << "{\"name\":\"" << escape_trace_string(zone.name) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << zone.thread
+						<< ",\"ts\":" << micros(zone.start) << ",\"dur\":" << micros(zone.end - zone.start) << "}";
+		}
+
+		// The GPU clock is unrelated to ours; align each frame's GPU work with the frame start
+		uint64_t gpuBase = UINT64_MAX;
+		for (const auto& zone : frame.gpu_zones) {
+			gpuBase = std::min(gpuBase, zone.start);
+		}
+
+		for (const auto& zone : frame.gpu_zones) {
+			separator() << "{\"name\":\"" << escape_trace_string(zone.name) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << kGpuTrack
+						<< ",\"ts\":" << micros(frame.start + (zone.start - gpuBase)) << ",\"dur\":" << micros(zone.duration) << "}";
+		}
+
+		for (size_t i = 0; i < frame.counters.size(); ++i) {
+			separator() << "{\"name\":\"" << counter_name(static_cast<Counter>(i)) << "\",\"ph\":\"C\",\"pid\":1"
+						<< ",\"ts\":" << micros(frame.start) << ",\"args\":{\"value\":" << frame.counters[i] << "}}";
+		}
+	}
+
+	stream << "\n]}\n";
+
+	return stream.good();
+}
+
+#endif
@@ -0,0 +1,184 @@
+#pragma once
+
+/**
+ * @brief Frame profiler: scoped CPU zones, GPU timer queries and per-frame counters.
+ *
+ * Everything is reached through the POWER_PROFILE_* macros, which expand to nothing
+ * unless the build defines POWER_ENGINE_PROFILER (CMake option of the same name), so
+ * instrumented code carries no cost in regular builds.
+ *
+ *   POWER_PROFILE_ZONE("ActorManager::draw");      // CPU zone until the end of scope
+ *   POWER_PROFILE_GPU_ZONE("Scene");               // GPU time of the enclosed commands
+ *   POWER_PROFILE_COUNT(DrawCalls, 1);             // adds to a per-frame counter
+ *   POWER_PROFILE_THREAD("Thumbnail worker");      // names the calling thread in traces
+ *   POWER_PROFILE_FRAME();                         // closes the frame, main thread only
+ *
+ * Zone names must be string literals; only the pointer is recorded.
+ */
+
+#if defined(POWER_ENGINE_PROFILER) && POWER_ENGINE_PROFILER
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class Profiler {
+public:
+	enum class Counter {
+		DrawCalls,
+		Triangles,
+		BufferBytesUploaded,
+		LightClusterIndices,
+		Count
+	};
+
+	struct Zone {
+		const char* name;
+		uint64_t start; // nanoseconds since profiler start
+		uint64_t end;
+		uint32_t depth;
+		uint32_t thread;
+	};
+
+	struct GpuZone {
+		const char* name;
+		uint64_t start; // GPU clock in nanoseconds, only comparable within a frame
+		uint64_t duration;
+	};
+
+	struct Frame {
+		uint64_t index = 0;
+		uint64_t start = 0;
+		uint64_t end = 0;
+		std::vector<Zone> zones;
+		std::vector<GpuZone> gpu_zones;
+		std::array<uint64_t, static_cast<size_t>(Counter::Count)> counters{};
+		// Zones lost because a thread buffer wrapped before it was drained
+		uint64_t dropped_zones = 0;
+		// GPU results arrive a few frames late; set once they are all in
+		bool gpu_resolved = false;
+
+		double milliseconds() const {
+			return static_cast<double>(end - start) / 1e6;
+		}
+	};
+
+	static Profiler& instance();
+
+	static const char* counter_name(Counter counter);
+
+	uint64_t now() const;
+
+	void begin_zone();
+	void end_zone(const char* name, uint64_t start);
+
+	void begin_gpu_zone(const char* name);
+	void end_gpu_zone();
+
+	void add_counter(Counter counter, uint64_t value) {
+		mCounters[static_cast<size_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+	}
+
+	void set_thread_name(const std::string& name);
+
+	// Collects zones from every thread and starts the next frame
+	void end_frame();
+
+	// Copies of the most recent frames, oldest first
+	std::vector<Frame> frames() const;
+
+	// Newest frame, or the newest one with resolved GPU zones; false if there is none yet
+	bool latest_frame(Frame& frame, bool requireGpu = false) const;
+
+	// Durations of the recorded frames in milliseconds, oldest first
+	std::vector<float> frame_times() const;
+
+	std::vector<std::pair<uint32_t, std::string>> thread_names() const;
+
+	bool export_chrome_trace(const std::string& path) const;
+
+private:
+	struct ThreadBuffer;
+	class GpuTimer;
+
+	Profiler();
+	~Profiler();
+
+	ThreadBuffer& thread_buffer();
+	void drain(ThreadBuffer& buffer, Frame& frame);
+	void resolve_gpu_zones();
+
+	uint64_t mEpoch;
+	uint64_t mFrameStart = 0;
+	uint64_t mFrameIndex = 0;
+
+	std::array<std::atomic<uint64_t>, static_cast<size_t>(Counter::Count)> mCounters{};
+
+	mutable std::mutex mBuffersMutex;
+	std::vector<std::shared_ptr<ThreadBuffer>> mBuffers;
+	uint32_t mNextThreadId = 0;
+
+	std::unique_ptr<GpuTimer> mGpuTimer;
+
+	mutable std::mutex mFramesMutex;
+	std::deque<Frame> mFrames;
+};
+
+class ProfileZone {
+public:
+	explicit ProfileZone(const char* name)
+	: mName(name) {
+		Profiler& profiler = Profiler::instance();
+		profiler.begin_zone();
+		mStart = profiler.now();
+	}
+
+	~ProfileZone() {
+		Profiler::instance().end_zone(mName, mStart);
+	}
+
+	ProfileZone(const ProfileZone&) = delete;
+	ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+	const char* mName;
+	uint64_t mStart;
+};
+
+class GpuProfileZone {
+public:
+	explicit GpuProfileZone(const char* name) {
+		Profiler::instance().begin_gpu_zone(name);
+	}
+
+	~GpuProfileZone() {
+		Profiler::instance().end_gpu_zone();
+	}
+
+	GpuProfileZone(const GpuProfileZone&) = delete;
+	GpuProfileZone& operator=(const GpuProfileZone&) = delete;
+};
+
+#define POWER_PROFILE_CONCAT_INNER(a, b) a##b
+#define POWER_PROFILE_CONCAT(a, b) POWER_PROFILE_CONCAT_INNER(a, b)
+
+#define POWER_PROFILE_ZONE(name) ProfileZone POWER_PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define POWER_PROFILE_GPU_ZONE(name) GpuProfileZone POWER_PROFILE_CONCAT(gpuProfileZone, __LINE__)(name)
+#define POWER_PROFILE_COUNT(counter, value) Profiler::instance().add_counter(Profiler::Counter::counter, static_cast<uint64_t>(value))
+#define POWER_PROFILE_THREAD(name) Profiler::instance().set_thread_name(name)
+#define POWER_PROFILE_FRAME() Profiler::instance().end_frame()
+
+#else
+
+#define POWER_PROFILE_ZONE(name) ((void)0)
+#define POWER_PROFILE_GPU_ZONE(name) ((void)0)
+#define POWER_PROFILE_COUNT(counter, value) ((void)0)
+#define POWER_PROFILE_THREAD(name) ((void)0)
+#define POWER_PROFILE_FRAME() ((void)0)
+
+#endif
@@ -20,10 +20,12 @@ struct Material {
     float shininess;
     float opacity;
     bool has_diffuse_texture;
+    float texture_layer;
+    int texture_slot;
 };
 
 struct Textures {
-    sampler2D diffuse;
+    sampler2DArray diffuse;
 };
 
 
@@ -39,8 +41,8 @@ void main() {
     vec3 mat_diffuse;
     if (mat.has_diffuse_texture) {
         // **Optimization 3: Combine texture sampling and averaging in one step**
-        mat_diffuse = (texture(textures[TextureId].diffuse, TexCoords1).rgb +
-                      texture(textures[TextureId].diffuse, TexCoords2).rgb) * 0.5;
+        mat_diffuse = (texture(textures[mat.texture_slot].diffuse, vec3(TexCoords1, mat.texture_layer)).rgb +
+                      texture(textures[mat.texture_slot].diffuse, vec3(TexCoords2, mat.texture_layer)).rgb) * 0.5;
     } else {
         mat_diffuse = mat.diffuse + mat.specular;
     }
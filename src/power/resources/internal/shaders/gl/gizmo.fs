@@ -3,10 +3,10 @@
 layout(location = 0) out vec4 FragColor;
 layout(location = 1) out int EntityID;
 
-uniform vec3 u_color;
-uniform int identifier;
+in vec3 vColor;
+flat in int vAxisId;
 
 void main() {
-    FragColor = vec4(u_color, 1.0);
-    EntityID = identifier;
+    FragColor = vec4(vColor, 1.0);
+    EntityID = vAxisId;
 }
@@ -6,6 +6,19 @@ uniform mat4 aProjection;
 uniform mat4 aView;
 uniform mat4 aModel;
 
+// One axis handle per instance, uploaded once by GizmoManager: axis transform columns, color, picking id in x
+uniform vec4 aInstances[18];
+
+out vec3 vColor;
+flat out int vAxisId;
+
 void main() {
-    gl_Position = aProjection * aView * aModel * vec4(aPosition, 1.0);
+    int base = gl_InstanceID * 6;
+    mat4 axis = mat4(aInstances[base], aInstances[base + 1], aInstances[base + 2], aInstances[base + 3]);
+
+    vColor = aInstances[base + 4].rgb;
+    vAxisId = int(aInstances[base + 5].x);
+
+    // The handle is authored along +X, the instance turns it onto its axis
+    gl_Position = aProjection * aView * aModel * axis * vec4(aPosition, 1.0);
 }
@@ -14,7 +14,6 @@ in vec3 far;
 uniform float u_far;
 uniform float u_near;
 uniform mat4 aView;
-uniform mat4 aProjection;
 
 vec4 grid(vec3 point, float scale, bool is_axis) {
     vec2 coord = point.xz / scale;
@@ -34,33 +33,18 @@ vec4 grid(vec3 point, float scale, bool is_axis) {
     return col;
 }
 
-float compute_depth(vec3 point) {
-    vec4 clip_space = aProjection * aView * vec4(point, 1.0);
-    float clip_space_depth = clip_space.z / clip_space.w;
-    float far = gl_DepthRange.far;
-    float near = gl_DepthRange.near;
-    float depth = (((far - near) * clip_space_depth) + near + far) / 2.0;
-    return depth;
-}
-
-float compute_fade(vec3 point) {
-    vec4 clip_space = aProjection * aView * vec4(point, 1.0);
-    float clip_space_depth = (clip_space.z / clip_space.w) * 2.0 - 1.0;
-    float near = u_near;
-    float far = u_far;
-    float linear_depth = (2.0 * near * far) / (far + near - clip_space_depth * (far - near));
-    return linear_depth / far;
-}
-
 void main() {
     float t = -near.y / (far.y - near.y);
     vec3 R = near + t * (far - near);
-    float is_on = float(t > 0);
 
-    float fade = smoothstep(0.32, 0.0, compute_fade(R));
+    // Distance along the view direction, the same depth the Metal grid writes
+    float view_distance = -(aView * vec4(R, 1.0)).z;
+
+    if (t <= 0.0 || view_distance > u_far || view_distance < u_near)
+        discard;
+
     o_color = grid(R, 32, true);
-    o_color *= fade;
+    o_color.a *= 1.0 - smoothstep(0.0, 0.32, view_distance / u_far);
 
-    o_color *= is_on;
-    gl_FragDepth = compute_depth(R);
+    gl_FragDepth = (view_distance - u_near) / (u_far - u_near);
 }
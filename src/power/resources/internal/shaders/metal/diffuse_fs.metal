@@ -8,6 +8,24 @@ struct Material {
     float shininess;
     float opacity;
     float diffuse_texture;
+    float texture_layer;
+    float texture_slot;
+    float padding[3];
+};
+
+// Matches LightClusters::GpuLight
+struct Light {
+    float4 position_range;
+    float4 color_intensity;
+    float4 direction_spot;
+    float4 cone; // cos outer, cos inner
+};
+
+// Matches LightClusters::GpuParams
+struct ClusterParams {
+    float4 viewport;   // offset and size in framebuffer pixels
+    float4 slicing;    // depth scale, depth bias, 1 for logarithmic slices, light count
+    float4 dimensions; // tiles x, tiles y, depth slices
 };
 
 struct VertexOut {
@@ -17,9 +35,61 @@ struct VertexOut {
     float3 Normal;
     float4 Color;
     float3 FragPos;
+    float ViewDepth;
     int MaterialId;
 };
 
+// Sums the lights assigned to this fragment's cluster
+float3 clustered_lighting(VertexOut vert,
+                          const device Light *lights,
+                          const device uint2 *lightGrid,
+                          const device uint *lightIndices,
+                          constant ClusterParams &params) {
+    if (params.slicing.w < 0.5) {
+        return float3(0.0);
+    }
+
+    float2 screen = (vert.Position.xy - params.viewport.xy) / params.viewport.zw;
+    uint tileX = uint(clamp(screen.x * params.dimensions.x, 0.0, params.dimensions.x - 1.0));
+    uint tileY = uint(clamp((1.0 - screen.y) * params.dimensions.y, 0.0, params.dimensions.y - 1.0));
+
+    float depth = params.slicing.z > 0.5 ? log(max(vert.ViewDepth, 1e-4)) : vert.ViewDepth;
+    uint slice = uint(clamp(floor(depth * params.slicing.x + params.slicing.y), 0.0, params.dimensions.z - 1.0));
+
+    uint cluster = (slice * uint(params.dimensions.y) + tileY) * uint(params.dimensions.x) + tileX;
+    uint2 range = lightGrid[cluster];
+
+    float3 normal = normalize(vert.Normal);
+    float3 lighting = float3(0.0);
+
+    for (uint i = 0; i < range.y; ++i) {
+        Light light = lights[lightIndices[range.x + i]];
+
+        float3 toLight = light.position_range.xyz - vert.FragPos;
+        float distanceSquared = dot(toLight, toLight);
+        float rangeSquared = light.position_range.w * light.position_range.w;
+
+        if (distanceSquared >= rangeSquared) {
+            continue;
+        }
+
+        float3 direction = toLight * rsqrt(max(distanceSquared, 1e-8));
+
+        // Windowed falloff reaching exactly zero at the light's range
+        float window = saturate(1.0 - (distanceSquared / rangeSquared) * (distanceSquared / rangeSquared));
+        float attenuation = window * window;
+
+        if (light.direction_spot.w > 0.5) {
+            float cosAngle = dot(-direction, light.direction_spot.xyz);
+            attenuation *= smoothstep(light.cone.x, light.cone.y, cosAngle);
+        }
+
+        lighting += light.color_intensity.rgb * light.color_intensity.w * attenuation * max(dot(normal, direction), 0.0);
+    }
+
+    return lighting;
+}
+
 struct FragmentOut {
     float4 color [[color(0)]];  // First attachment: Color
     int entityId [[color(1)]];  // Second attachment: Entity ID
@@ -29,17 +99,24 @@ fragment FragmentOut fragment_main(VertexOut vert [[stage_in]],
                               constant Material *materials [[buffer(0)]],  
                               constant float4 &color [[buffer(1)]],
                               constant int &identifier [[buffer(2)]],
-                              array<texture2d<float, access::sample>, 16> textures,
+                              const device Light *lights [[buffer(3)]],
+                              const device uint2 *lightGrid [[buffer(4)]],
+                              const device uint *lightIndices [[buffer(5)]],
+                              constant ClusterParams &clusterParams [[buffer(6)]],
+                              array<texture2d_array<float, access::sample>, 16> textures,
                               array<sampler, 16> textures_sampler) {
     Material mat = materials[vert.MaterialId];
-    texture2d<float> diffuse_texture = textures[vert.MaterialId];
-    sampler diffuse_sampler = textures_sampler[vert.MaterialId];
+    // Materials whose images share an array share its slot, and differ by layer
+    uint slot = uint(mat.texture_slot);
+    texture2d_array<float> diffuse_texture = textures[slot];
+    sampler diffuse_sampler = textures_sampler[slot];
+    uint layer = uint(mat.texture_layer);
 
     float4 mat_diffuse;
     if (mat.diffuse_texture > 0.5) {
         // Accessing textures and sampling RGBA (float4)
-        float4 tex1 = diffuse_texture.sample(diffuse_sampler, vert.TexCoords1);  // sample rgba
-        float4 tex2 = diffuse_texture.sample(diffuse_sampler, vert.TexCoords2);  // sample rgba
+        float4 tex1 = diffuse_texture.sample(diffuse_sampler, vert.TexCoords1, layer);  // sample rgba
+        float4 tex2 = diffuse_texture.sample(diffuse_sampler, vert.TexCoords2, layer);  // sample rgba
         mat_diffuse = (tex1 + tex2) * 0.5;  // Average the two textures
     } else {
         mat_diffuse = float4(mat.diffuse * mat.specular);  // Use material opacity
@@ -50,7 +127,8 @@ fragment FragmentOut fragment_main(VertexOut vert [[stage_in]],
 
     mat_diffuse = mix(mat_diffuse, color, 0.25);
 
-    float3 final_color = mat_diffuse.rgb;
+    // Dynamic lights add on top of the unlit base color
+    float3 final_color = mat_diffuse.rgb * (1.0 + clustered_lighting(vert, lights, lightGrid, lightIndices, clusterParams));
     float selectionOpacity = mat_diffuse.a;  // Use the alpha from the texture
 
     if (length(color.rgba) != 2.0) { 
@@ -8,6 +8,7 @@ struct VertexOut {
     float3 Normal;
     float4 Color;
     float3 FragPos;
+    float ViewDepth;
     int MaterialId;
 };
 
@@ -70,6 +71,7 @@ vertex VertexOut vertex_main(
 
     // Position in world space for fragment shader calculations
     vert.FragPos = worldPosition.xyz;
+    vert.ViewDepth = -(aView * worldPosition).z;
 
     vert.TexCoords1 = aTexcoords1[id];
     vert.TexCoords2 = aTexcoords2[id];
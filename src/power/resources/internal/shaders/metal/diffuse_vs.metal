@@ -8,6 +8,7 @@ struct VertexOut {
     float3 Normal;
     float4 Color;
     float3 FragPos;
+    float ViewDepth;
     int MaterialId;
 };
 
@@ -33,6 +34,7 @@ vertex VertexOut vertex_main(const device packed_float3 *const aPosition [[buffe
     vert.Normal = normalMatrix * float3(aNormal[id]);
     
     vert.FragPos = worldPosition.xyz;
+    vert.ViewDepth = -(aView * worldPosition).z;
     vert.TexCoords1 = aTexcoords1[id];
     vert.TexCoords2 = aTexcoords2[id];
     
@@ -8,6 +8,9 @@ struct Material {
     float shininess;
     float opacity;
     float diffuse_texture;
+    float texture_layer;
+    float texture_slot;
+    float padding[3];
 };
 
 struct VertexOut {
@@ -18,6 +21,7 @@ struct VertexOut {
     float4 Color;
     float3 FragPos;
     int MaterialId;
+    int AxisId [[flat]];
 };
 
 struct FragmentOut {
@@ -30,35 +34,12 @@ fragment FragmentOut fragment_main(VertexOut vert [[stage_in]],
                               constant Material *materials [[buffer(0)]], 
                               constant float4 &color [[buffer(1)]],
                               constant int &identifier [[buffer(2)]],
-                              array<texture2d<float, access::sample>, 4> textures,
+                              array<texture2d_array<float, access::sample>, 4> textures,
                               array<sampler, 4> textures_sampler) {
-    Material mat = materials[vert.MaterialId];
+    // Handles are flat colored; each instance picks as its own axis
+    float4 mat_diffuse = vert.Color;
 
-    texture2d<float> diffuse_texture = textures[vert.MaterialId];
-    sampler diffuse_sampler = textures_sampler[vert.MaterialId];
-
-    float4 mat_diffuse;
-    if (mat.diffuse_texture > 0.5) {
-        // Accessing textures and sampling RGBA (float4)
-        float4 tex1 = diffuse_texture.sample(diffuse_sampler, vert.TexCoords1);  // sample rgba
-        float4 tex2 = diffuse_texture.sample(diffuse_sampler, vert.TexCoords2);  // sample rgba
-        mat_diffuse = (tex1 + tex2) * 0.5;  // Average the two textures
-    } else {
-        mat_diffuse = float4(mat.diffuse * mat.specular);  // Use material opacity
-        mat_diffuse.a = mat.opacity;
-    }
-
-    mat_diffuse = mix(mat_diffuse, vert.Color, 0.5);
-
-    int entityId = identifier;
-
-    if (mat.diffuse.r != 0.0) {
-        entityId = -1;
-    } else if (mat.diffuse.b != 0.0) {
-        entityId = -2;
-    }  else if (mat.diffuse.g != 0.0) {
-        entityId = -3;
-    }
+    int entityId = vert.AxisId;
 
     FragmentOut out;
 
@@ -9,6 +9,14 @@ struct VertexOut {
     float4 Color;
     float3 FragPos;
     int MaterialId;
+    int AxisId [[flat]];
+};
+
+// One per axis handle, uploaded once by GizmoManager
+struct GizmoInstance {
+    float4x4 axis;
+    float4 color;
+    float4 identifier; // x: picking id of the axis
 };
 
 vertex VertexOut vertex_main(const device packed_float3 *const aPosition [[buffer(0)]],
@@ -20,15 +28,20 @@ vertex VertexOut vertex_main(const device packed_float3 *const aPosition [[buffe
                              constant float4x4 &aProjection [[buffer(6)]],
                              constant float4x4 &aView [[buffer(7)]],
                              constant float4x4 &aModel [[buffer(8)]],
-                             uint id [[vertex_id]]) {
+                             const device GizmoInstance *const aInstances [[buffer(9)]],
+                             uint id [[vertex_id]],
+                             uint instance [[instance_id]]) {
     VertexOut vert;
 
+    // The handle is authored along +X, the instance turns it onto its axis
+    float4x4 model = aModel * aInstances[instance].axis;
+
     // Transform the vertex position
-    float4 worldPosition = aModel * float4(aPosition[id], 1.0);
+    float4 worldPosition = model * float4(aPosition[id], 1.0);
     vert.Position = aProjection * aView * worldPosition;
     
     // Extract the upper-left 3x3 submatrix from the model matrix for normal transformation
-    float3x3 normalMatrix = float3x3(float3(aModel[0].xyz), float3(aModel[1].xyz), float3(aModel[2].xyz));
+    float3x3 normalMatrix = float3x3(float3(model[0].xyz), float3(model[1].xyz), float3(model[2].xyz));
     // Cast packed_float3 to float3 for the matrix multiplication
     vert.Normal = normalMatrix * float3(aNormal[id]);
     
@@ -36,9 +49,10 @@ vertex VertexOut vertex_main(const device packed_float3 *const aPosition [[buffe
     vert.TexCoords1 = aTexcoords1[id];
     vert.TexCoords2 = aTexcoords2[id];
     
-    vert.MaterialId = aMaterialId[id]; // Access the x component of packed_int2 at index id
+    vert.MaterialId = aMaterialId[id];
 
-    vert.Color = aColor[id];
+    vert.Color = aInstances[instance].color;
+    vert.AxisId = int(aInstances[instance].identifier.x);
     
     return vert;
 }
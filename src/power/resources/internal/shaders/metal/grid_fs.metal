@@ -91,6 +91,9 @@ fragment FragmentOutput fragment_main(VertexIO in [[stage_in]],
     // Compute the grid pattern color based on the world position.
     float4 o_color = compute_grid(R, 32.0, true);
 
+    // Fade the lines out with distance, before they thin into aliasing at the horizon.
+    o_color.a *= 1.0 - smoothstep(0.0, 0.32, view_distance / u_far);
+
     FragmentOutput out;
     out.color = o_color;
     
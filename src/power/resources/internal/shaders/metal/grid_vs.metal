@@ -21,15 +21,15 @@ float3 unproject_point(float x, float y, float z, constant float4x4 &invProjView
     return unproj_point.xyz / unproj_point.w;
 }
 
-// The vertex shader's main function. It runs for each vertex of a full-screen quad
-// and calculates the world-space view ray for that vertex.
-vertex VertexIO vertex_main(const device packed_float2 *const aPosition [[buffer(0)]],
-                           constant float4x4 &aInvProjectionView [[buffer(1)]],
+// The vertex shader's main function. It runs for the three vertices of a triangle
+// that covers the screen, generated from the vertex index so no buffer is bound,
+// and calculates the world-space view ray for each vertex.
+vertex VertexIO vertex_main(constant float4x4 &aInvProjectionView [[buffer(0)]],
                            uint id [[vertex_id]]) {
     VertexIO out;
     
-    // Get the 2D position of the current vertex from the input buffer.
-    float2 p = aPosition[id];
+    // (-1, -1), (3, -1), (-1, 3): the part inside clip space is the whole screen.
+    float2 p = float2(float((id << 1) & 2u), float(id & 2u)) * 2.0 - 1.0;
 
     // Calculate the world-space positions on the near and far clipping planes
     // that correspond to this vertex. These two points define the view ray.
@@ -37,7 +37,6 @@ vertex VertexIO vertex_main(const device packed_float2 *const aPosition [[buffer
     out.near = unproject_point(p.x, p.y, -1.0, aInvProjectionView);
     out.far  = unproject_point(p.x, p.y, 1.0, aInvProjectionView);
     
-    // Pass the vertex position through unmodified for the full-screen quad.
     out.position = float4(p, 0.0, 1.0);
 
     return out;
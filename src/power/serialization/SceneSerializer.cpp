@@ -4,6 +4,7 @@
 // Your actual component headers
 #include "components/TransformComponent.hpp"
 #include "components/CameraComponent.hpp"
+#include "components/DetachedComponent.hpp"
 #include "components/ModelMetadataComponent.hpp"
 #include "components/BlueprintComponent.hpp"
 #include "components/BlueprintMetadataComponent.hpp"
@@ -202,7 +203,8 @@ void SceneSerializer::serialize(entt::registry& registry, const std::string& fil
 	flatbuffers::FlatBufferBuilder builder;
 	std::vector<flatbuffers::Offset<Power::Schema::Entity>> entity_offsets;
 	
-	auto id_view = registry.view<const IDComponent>();
+	// Detached actors are only kept alive by the undo history
+	auto id_view = registry.view<const IDComponent>(entt::exclude<DetachedComponent>);
 	for (auto entity_handle : id_view) {
 		std::vector<flatbuffers::Offset<Power::Schema::Component>> component_offsets;
 		
@@ -43,6 +43,19 @@ public:
 
 		
 
+		// Guest address of the shared actor arrays, see SharedActorCommon.hpp
+		mVirtualMachine.register_callback(0, "GetSharedActors",
+										  [](uint64_t this_ptr, const std::vector<std::any>& args, std::vector<unsigned char>& output_buffer) {
+			if (!args.empty()) {
+				throw std::runtime_error("Argument count mismatch for GetSharedActors");
+			}
+			uint64_t result = SharedActorState::kGuestAddress;
+			
+			// Copy result into output_buffer
+			unsigned char* data_ptr = reinterpret_cast<unsigned char*>(&result);
+			std::memcpy(output_buffer.data(), data_ptr, sizeof(uint64_t));
+		});
+		
 		mVirtualMachine.register_callback(reinterpret_cast<uint64_t>(this), "Cartridge::GetActorLoader",
 										  [](uint64_t this_ptr, const std::vector<std::any>& args, std::vector<unsigned char>& output_buffer) {
 			if (!args.empty()) {
@@ -7,7 +7,7 @@
 
 #include "MeshActorLoader.hpp"
 
-CartridgeActorLoader::CartridgeActorLoader(VirtualMachine& virtualMachine, MeshActorLoader& meshActorLoader, IActorManager& actorManager, IActorVisualManager& actorVisualManager, AnimationTimeProvider& animationTimeProvider, ShaderWrapper& meshShader, ShaderWrapper& skinnedShader) :
+CartridgeActorLoader::CartridgeActorLoader(VirtualMachine& virtualMachine, MeshActorLoader& meshActorLoader, ActorManager& actorManager, IActorVisualManager& actorVisualManager, AnimationTimeProvider& animationTimeProvider, ShaderWrapper& meshShader, ShaderWrapper& skinnedShader) :
 mVirtualMachine(virtualMachine)
 , mMeshActorLoader(meshActorLoader)
 , mActorManager(actorManager)
@@ -35,6 +35,8 @@ mVirtualMachine(virtualMachine)
 }
 
 void CartridgeActorLoader::cleanup() {
+	mVirtualMachine.shared_actors().clear();
+	
 	mActorVisualManager.remove_actors(mLoadedActors);
 	mLoadedActors.clear();
 }
@@ -46,6 +48,8 @@ Actor& CartridgeActorLoader::create_actor(const std::string& filePath) {
 	
 	mLoadedActors.push_back(actor);
 	
+	mVirtualMachine.shared_actors().add(mActorManager, actor);
+	
 	return actor;
 }
 
@@ -56,6 +60,9 @@ Primitive* CartridgeActorLoader::create_actor(PrimitiveShape primitiveShape) {
 	
 	mLoadedActors.push_back(actor);
 
+	// The cartridge can animate the primitive through the shared arrays without calling back per value
+	mVirtualMachine.shared_actors().add(mActorManager, actor);
+
 	mLoadedPrimitives.push_back(std::make_unique<Primitive>(actor));
 	
 	// register here
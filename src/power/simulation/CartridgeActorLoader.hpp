@@ -2,7 +2,7 @@
 
 #include "simulation/ICartridgeActorLoader.hpp"
 
-class IActorManager;
+class ActorManager;
 class IActorVisualManager;
 class Actor;
 class AnimationTimeProvider;
@@ -13,7 +13,7 @@ class VirtualMachine;
 
 class CartridgeActorLoader : public ICartridgeActorLoader {
 public:
-	CartridgeActorLoader(VirtualMachine& virtualMachine, MeshActorLoader& meshActorLoader, IActorManager& actorManager, IActorVisualManager& actorVisualManager, AnimationTimeProvider& animationTimeProvider, ShaderWrapper& meshShader, ShaderWrapper& skinnedMeshShader);
+	CartridgeActorLoader(VirtualMachine& virtualMachine, MeshActorLoader& meshActorLoader, ActorManager& actorManager, IActorVisualManager& actorVisualManager, AnimationTimeProvider& animationTimeProvider, ShaderWrapper& meshShader, ShaderWrapper& skinnedMeshShader);
 	
 	Primitive* create_actor(PrimitiveShape primitiveShape) override;
 	
@@ -24,7 +24,7 @@ public:
 private:
 	VirtualMachine& mVirtualMachine;
 	MeshActorLoader& mMeshActorLoader;
-	IActorManager& mActorManager;
+	ActorManager& mActorManager;
 	IActorVisualManager& mActorVisualManager;
 	AnimationTimeProvider& mAnimationTimeProvider;
 	ShaderWrapper& mMeshShader;
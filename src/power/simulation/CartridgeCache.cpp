@@ -0,0 +1,250 @@
+#include "simulation/CartridgeCache.hpp"
+
+#include "simulation/MachinePool.hpp"
+
+#include <openssl/evp.h>
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <tuple>
+
+namespace fs = std::filesystem;
+
+namespace {
+constexpr const char* kCartridgeExtension = ".elf";
+constexpr size_t kKeyLength = 32;
+
+// Keys may come from the network and become file names, so only hex digests are accepted
+bool is_valid_key(const std::string& key) {
+	return key.size() == kKeyLength && std::all_of(key.begin(), key.end(), [](char c) {
+		return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f');
+	});
+}
+} // unnamed namespace
+
+CartridgeCache::CartridgeCache(const std::string& directory, size_t residentCount, uint64_t diskBudget)
+: mDirectory(directory)
+, mResidentCount(std::max<size_t>(residentCount, 1))
+, mDiskBudget(diskBudget) {
+	std::error_code error;
+
+	if (mDirectory.empty()) {
+		mDirectory = (fs::temp_directory_path(error) / "PowerEngine" / "cartridges").string();
+	}
+
+	fs::create_directories(mDirectory, error);
+
+	// Rebuilding recency from the previous sessions, oldest first
+	std::vector<std::tuple<fs::file_time_type, std::string, uint64_t>> existing;
+
+	for (fs::directory_iterator it(mDirectory, error), end; !error && it != end; it.increment(error)) {
+		if (it->path().extension() != kCartridgeExtension) {
+			continue;
+		}
+
+		std::error_code entryError;
+		auto time = it->last_write_time(entryError);
+		auto size = it->file_size(entryError);
+
+		if (!entryError) {
+			existing.emplace_back(time, it->path().stem().string(), size);
+		}
+	}
+
+	std::sort(existing.begin(), existing.end());
+
+	for (const auto& [time, key, size] : existing) {
+		mStoredRecency.push_front(key);
+		mStored[key] = Stored{size, mStoredRecency.begin()};
+		mStoredSize += size;
+	}
+
+	evict_stored();
+}
+
+std::string CartridgeCache::hash(const std::vector<uint8_t>& executable) {
+	std::array<unsigned char, EVP_MAX_MD_SIZE> digest{};
+	unsigned int digestLength = 0;
+
+	if (EVP_Digest(executable.data(), executable.size(), digest.data(), &digestLength, EVP_md5(), nullptr) != 1) {
+		return "";
+	}
+
+	std::ostringstream hex;
+	for (unsigned int i = 0; i < digestLength; ++i) {
+		hex << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(digest[i]);
+	}
+
+	return hex.str();
+}
+
+std::shared_ptr<MachinePool> CartridgeCache::acquire(std::vector<uint8_t> executable) {
+	std::string key = hash(executable);
+
+	if (key.empty()) {
+		auto pool = std::make_shared<MachinePool>();
+		return pool->load(std::move(executable)) ? pool : nullptr;
+	}
+
+	if (auto pool = find_resident(key)) {
+		touch_stored(key);
+		return pool;
+	}
+
+	if (mStored.find(key) == mStored.end()) {
+		store(key, executable);
+	} else {
+		touch_stored(key);
+	}
+
+	return load(key, std::move(executable));
+}
+
+std::shared_ptr<MachinePool> CartridgeCache::acquire(const std::string& key) {
+	if (!is_valid_key(key)) {
+		return nullptr;
+	}
+
+	if (auto pool = find_resident(key)) {
+		touch_stored(key);
+		return pool;
+	}
+
+	std::vector<uint8_t> executable;
+
+	if (!read_stored(key, executable)) {
+		return nullptr;
+	}
+
+	// A damaged or replaced file is not trusted under the key it was stored with
+	if (hash(executable) != key) {
+		std::cerr << "Cached cartridge does not match its hash: " << path_for(key) << std::endl;
+		return nullptr;
+	}
+
+	touch_stored(key);
+
+	return load(key, std::move(executable));
+}
+
+std::shared_ptr<MachinePool> CartridgeCache::find_resident(const std::string& key) {
+	auto it = mResident.find(key);
+
+	if (it == mResident.end()) {
+		return nullptr;
+	}
+
+	mResidentRecency.splice(mResidentRecency.begin(), mResidentRecency, it->second.recency);
+	++mHits;
+
+	return it->second.pool;
+}
+
+std::shared_ptr<MachinePool> CartridgeCache::load(const std::string& key, std::vector<uint8_t> executable) {
+	++mMisses;
+
+	auto pool = std::make_shared<MachinePool>();
+
+	if (!pool->load(std::move(executable))) {
+		return nullptr;
+	}
+
+	mResidentRecency.push_front(key);
+	mResident[key] = Resident{pool, mResidentRecency.begin()};
+
+	// Evicted pools stay alive for as long as a running instance holds them
+	while (mResident.size() > mResidentCount) {
+		mResident.erase(mResidentRecency.back());
+		mResidentRecency.pop_back();
+	}
+
+	return pool;
+}
+
+bool CartridgeCache::read_stored(const std::string& key, std::vector<uint8_t>& executable) {
+	if (mStored.find(key) == mStored.end()) {
+		return false;
+	}
+
+	std::ifstream stream(path_for(key), std::ios::binary | std::ios::ate);
+
+	if (!stream.is_open()) {
+		return false;
+	}
+
+	executable.resize(static_cast<size_t>(stream.tellg()));
+	stream.seekg(0);
+	stream.read(reinterpret_cast<char*>(executable.data()), executable.size());
+
+	return static_cast<bool>(stream);
+}
+
+void CartridgeCache::store(const std::string& key, const std::vector<uint8_t>& executable) {
+	std::string path = path_for(key);
+	std::string temporaryPath = path + ".tmp";
+
+	{
+		std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+
+		if (!stream.is_open()) {
+			std::cerr << "Failed to write cartridge: " << temporaryPath << std::endl;
+			return;
+		}
+
+		stream.write(reinterpret_cast<const char*>(executable.data()), executable.size());
+
+		if (!stream.good()) {
+			return;
+		}
+	}
+
+	std::error_code error;
+	fs::rename(temporaryPath, path, error);
+
+	if (error) {
+		return;
+	}
+
+	mStoredRecency.push_front(key);
+	mStored[key] = Stored{executable.size(), mStoredRecency.begin()};
+	mStoredSize += executable.size();
+
+	evict_stored();
+}
+
+void CartridgeCache::touch_stored(const std::string& key) {
+	auto it = mStored.find(key);
+
+	if (it == mStored.end()) {
+		return;
+	}
+
+	mStoredRecency.splice(mStoredRecency.begin(), mStoredRecency, it->second.recency);
+
+	// The modification time carries recency over to the next session
+	std::error_code error;
+	fs::last_write_time(path_for(key), fs::file_time_type::clock::now(), error);
+}
+
+void CartridgeCache::evict_stored() {
+	while (mStoredSize > mDiskBudget && !mStoredRecency.empty()) {
+		const std::string& key = mStoredRecency.back();
+		auto it = mStored.find(key);
+
+		std::error_code error;
+		fs::remove(path_for(key), error);
+
+		mStoredSize -= it->second.size;
+		mStored.erase(it);
+		mStoredRecency.pop_back();
+	}
+}
+
+std::string CartridgeCache::path_for(const std::string& key) const {
+	return (fs::path(mDirectory) / (key + kCartridgeExtension)).string();
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class MachinePool;
+
+/**
+ * @brief Loaded cartridges keyed by the MD5 of their ELF image.
+ *
+ * The most recently launched cartridges stay resident as primed MachinePools, so
+ * relaunching an unchanged ELF skips parsing, loading and execute segment decoding
+ * and only forks a new instance. ELF images are also kept on disk under the same
+ * key, which lets a later session or a client that only sends the hash launch a
+ * cartridge without transferring it again. Both tiers are evicted least recently
+ * used first. Not thread-safe; it belongs to the thread that starts cartridges.
+ */
+class CartridgeCache {
+public:
+	static constexpr size_t kDefaultResidentCount = 4;
+	static constexpr uint64_t kDefaultDiskBudget = 256ull * 1024 * 1024;
+
+	/**
+	 * @param directory      ELF store; empty selects PowerEngine/cartridges in the temp directory.
+	 * @param residentCount  Cartridges kept loaded in memory.
+	 * @param diskBudget     Maximum total size of the ELF store in bytes.
+	 */
+	explicit CartridgeCache(const std::string& directory = "", size_t residentCount = kDefaultResidentCount, uint64_t diskBudget = kDefaultDiskBudget);
+
+	CartridgeCache(const CartridgeCache&) = delete;
+	CartridgeCache& operator=(const CartridgeCache&) = delete;
+
+	// Hex MD5 of an ELF image
+	static std::string hash(const std::vector<uint8_t>& executable);
+
+	// Pool for the executable, loading and storing it only when its contents were not seen before; null on failure
+	std::shared_ptr<MachinePool> acquire(std::vector<uint8_t> executable);
+
+	// Pool for a cartridge stored earlier; null when the key is neither resident nor on disk
+	std::shared_ptr<MachinePool> acquire(const std::string& key);
+
+	uint64_t hits() const {
+		return mHits;
+	}
+
+	uint64_t misses() const {
+		return mMisses;
+	}
+
+private:
+	struct Resident {
+		std::shared_ptr<MachinePool> pool;
+		std::list<std::string>::iterator recency;
+	};
+
+	struct Stored {
+		uint64_t size;
+		std::list<std::string>::iterator recency;
+	};
+
+	std::shared_ptr<MachinePool> find_resident(const std::string& key);
+	std::shared_ptr<MachinePool> load(const std::string& key, std::vector<uint8_t> executable);
+
+	bool read_stored(const std::string& key, std::vector<uint8_t>& executable);
+	void store(const std::string& key, const std::vector<uint8_t>& executable);
+	void touch_stored(const std::string& key);
+	void evict_stored();
+
+	std::string path_for(const std::string& key) const;
+
+	std::string mDirectory;
+	size_t mResidentCount;
+	uint64_t mDiskBudget;
+
+	// Fronts are most recently used
+	std::list<std::string> mResidentRecency;
+	std::unordered_map<std::string, Resident> mResident;
+
+	std::list<std::string> mStoredRecency;
+	std::unordered_map<std::string, Stored> mStored;
+	uint64_t mStoredSize = 0;
+
+	uint64_t mHits = 0;
+	uint64_t mMisses = 0;
+};
@@ -0,0 +1,83 @@
+#include "simulation/CommandChannel.hpp"
+
+#include <utility>
+
+CommandChannel::CommandChannel(size_t slotCount)
+: mSlots(slotCount)
+, mReady(slotCount)
+, mFree(slotCount) {
+	for (uint32_t i = 0; i < slotCount; ++i) {
+		mFree.try_push(i);
+	}
+}
+
+CommandChannel::SubmitResult CommandChannel::submit(std::weak_ptr<void> connection, std::string& bytes) {
+	// A slot left over from a malformed message is used before taking another one
+	if (mSpareSlot == kNoBatch && !mFree.try_pop(mSpareSlot)) {
+		mSpareSlot = kNoBatch;
+		mBatchesRejected.fetch_add(1, std::memory_order_relaxed);
+		return SubmitResult::Busy;
+	}
+
+	uint32_t index = mSpareSlot;
+
+	Batch& batch = mSlots[index];
+
+	// The pool keeps the message buffer and the caller gets the one a drained batch left behind
+	std::swap(batch.bytes, bytes);
+
+	bool parsed;
+
+	if (DebugCommandBatch::is_batch(batch.bytes.data(), batch.bytes.size())) {
+		uint16_t flags;
+		parsed = DebugCommandBatch::parse(batch.bytes.data(), batch.bytes.size(), flags, batch.commands);
+		batch.legacy = false;
+	} else {
+		batch.commands.clear();
+		parsed = DebugCommandBatch::parse_command(batch.bytes.data(), batch.bytes.size(), batch.commands);
+		batch.legacy = true;
+	}
+
+	if (!parsed) {
+		std::swap(batch.bytes, bytes);
+		batch.commands.clear();
+
+		// Kept for the next message; only the frame loop pushes to the free queue
+		return SubmitResult::Malformed;
+	}
+
+	batch.connection = std::move(connection);
+
+	mSpareSlot = kNoBatch;
+
+	// Both queues are as large as the pool, so a popped slot always fits
+	mReady.try_push(index);
+	return SubmitResult::Queued;
+}
+
+bool CommandChannel::acquire() {
+	if (mCurrent != kNoBatch) {
+		return true;
+	}
+
+	if (!mReady.try_pop(mCurrent)) {
+		mCurrent = kNoBatch;
+		return false;
+	}
+
+	mCursor = 0;
+	return true;
+}
+
+void CommandChannel::release() {
+	Batch& batch = mSlots[mCurrent];
+
+	// Views and buffer keep their capacity for the next message that lands in this slot
+	batch.commands.clear();
+	batch.connection.reset();
+
+	mFree.try_push(mCurrent);
+
+	mCurrent = kNoBatch;
+	mCursor = 0;
+}
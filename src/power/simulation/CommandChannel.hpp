@@ -0,0 +1,110 @@
+#pragma once
+
+#include "simulation/DebugBridgeCommon.hpp"
+#include "simulation/SpscQueue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Hands debug bridge messages from the network thread to the frame loop.
+ *
+ * Messages are kept in a fixed pool of batch slots. submit() takes the message
+ * buffer over by swapping it with the slot's previous one and splits it into
+ * command views in place, so payloads are never copied. Filled slot indices go
+ * to the frame loop over one SPSC queue and come back over another once every
+ * command in them has run. drain() runs a bounded number of commands per call
+ * and resumes a partially drained batch on the next one.
+ */
+class CommandChannel {
+public:
+	struct Batch {
+		std::weak_ptr<void> connection;
+		std::string bytes;
+		std::vector<DebugCommandView> commands;
+
+		// Sent as a single DebugCommand without the batch header, answered the same way
+		bool legacy = false;
+	};
+
+	enum class SubmitResult {
+		Queued,
+		Busy,
+		Malformed
+	};
+
+	static constexpr size_t kDefaultSlotCount = 256;
+
+	explicit CommandChannel(size_t slotCount = kDefaultSlotCount);
+
+	CommandChannel(const CommandChannel&) = delete;
+	CommandChannel& operator=(const CommandChannel&) = delete;
+
+	// Network thread. When queued, bytes is left holding a recycled buffer of the pool
+	SubmitResult submit(std::weak_ptr<void> connection, std::string& bytes);
+
+	// Frame loop. Calls handle(batch, command) for at most maxCommands commands and
+	// complete(batch) once a batch has been fully handled; returns the commands run
+	template<typename Handle, typename Complete>
+	size_t drain(size_t maxCommands, Handle&& handle, Complete&& complete) {
+		size_t processed = 0;
+
+		while (processed < maxCommands && acquire()) {
+			Batch& batch = mSlots[mCurrent];
+
+			size_t end = std::min(batch.commands.size(), mCursor + (maxCommands - processed));
+
+			processed += end - mCursor;
+
+			for (; mCursor < end; ++mCursor) {
+				handle(batch, batch.commands[mCursor]);
+			}
+
+			if (mCursor == batch.commands.size()) {
+				complete(batch);
+				release();
+			}
+		}
+
+		mCommandsProcessed += processed;
+
+		return processed;
+	}
+
+	size_t slot_count() const {
+		return mSlots.size();
+	}
+
+	uint64_t batches_rejected() const {
+		return mBatchesRejected.load(std::memory_order_relaxed);
+	}
+
+	uint64_t commands_processed() const {
+		return mCommandsProcessed;
+	}
+
+private:
+	static constexpr uint32_t kNoBatch = UINT32_MAX;
+
+	bool acquire();
+	void release();
+
+	std::vector<Batch> mSlots;
+
+	SpscQueue<uint32_t> mReady;
+	SpscQueue<uint32_t> mFree;
+
+	// Network thread side: a popped slot whose message was rejected
+	uint32_t mSpareSlot = kNoBatch;
+
+	// Frame loop side: the batch being drained and the next command in it
+	uint32_t mCurrent = kNoBatch;
+	size_t mCursor = 0;
+	uint64_t mCommandsProcessed = 0;
+
+	std::atomic<uint64_t> mBatchesRejected{0};
+};
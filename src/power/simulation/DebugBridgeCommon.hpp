@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <cstdint>
 #include <cstring>
@@ -57,3 +58,139 @@ public:
         return DebugCommand(static_cast<CommandType>(cmd_type), payload_data);
     }
 };
+
+// A command inside a received batch; the payload points into the message it arrived in
+struct DebugCommandView {
+    DebugCommand::CommandType type;
+    const char* data;
+    uint32_t size;
+
+    std::string_view payload() const {
+        return std::string_view(data, size);
+    }
+};
+
+/**
+ * Versioned framing that packs many commands into one websocket message:
+ *
+ *   header   'PWRB' | version u16 | flags u16 | count u32
+ *   command  type u32 | size u32 | payload
+ *
+ * Each command record is laid out as a single DebugCommand, so a one-command
+ * message without the header is still understood. The encoder keeps its buffer
+ * between batches; reset() starts a new one without releasing memory.
+ */
+class DebugCommandBatch {
+public:
+    static constexpr char kMagic[4] = {'P', 'W', 'R', 'B'};
+    static constexpr uint16_t kVersion = 1;
+    static constexpr size_t kHeaderSize = 12;
+    static constexpr size_t kCommandHeaderSize = sizeof(uint32_t) * 2;
+
+    // Set on a reply to a batch the server had no room for; nothing in it was run
+    static constexpr uint16_t kFlagRejected = 1 << 0;
+
+    DebugCommandBatch() {
+        reset();
+    }
+
+    void reset(uint16_t flags = 0) {
+        m_bytes.resize(kHeaderSize);
+        m_count = 0;
+
+        uint16_t version = kVersion;
+        std::memcpy(m_bytes.data(), kMagic, sizeof(kMagic));
+        std::memcpy(m_bytes.data() + 4, &version, sizeof(uint16_t));
+        std::memcpy(m_bytes.data() + 6, &flags, sizeof(uint16_t));
+        std::memcpy(m_bytes.data() + 8, &m_count, sizeof(uint32_t));
+    }
+
+    void add(DebugCommand::CommandType type, std::string_view payload) {
+        uint32_t cmd_type = static_cast<uint32_t>(type);
+        uint32_t payload_size = static_cast<uint32_t>(payload.size());
+
+        size_t offset = m_bytes.size();
+        m_bytes.resize(offset + kCommandHeaderSize + payload.size());
+
+        std::memcpy(m_bytes.data() + offset, &cmd_type, sizeof(uint32_t));
+        std::memcpy(m_bytes.data() + offset + sizeof(uint32_t), &payload_size, sizeof(uint32_t));
+        std::memcpy(m_bytes.data() + offset + kCommandHeaderSize, payload.data(), payload.size());
+
+        ++m_count;
+        std::memcpy(m_bytes.data() + 8, &m_count, sizeof(uint32_t));
+    }
+
+    size_t count() const {
+        return m_count;
+    }
+
+    const std::string& bytes() const {
+        return m_bytes;
+    }
+
+    static bool is_batch(const char* data, size_t size) {
+        return size >= kHeaderSize && std::memcmp(data, kMagic, sizeof(kMagic)) == 0;
+    }
+
+    // Splits a batch into views over its bytes; false if it is truncated or of another version
+    static bool parse(const char* data, size_t size, uint16_t& flags, std::vector<DebugCommandView>& commands) {
+        commands.clear();
+
+        if (!is_batch(data, size)) {
+            return false;
+        }
+
+        uint16_t version;
+        uint32_t count;
+        std::memcpy(&version, data + 4, sizeof(uint16_t));
+        std::memcpy(&flags, data + 6, sizeof(uint16_t));
+        std::memcpy(&count, data + 8, sizeof(uint32_t));
+
+        if (version != kVersion) {
+            return false;
+        }
+
+        // Every command needs at least its header, which bounds the count before reserving
+        if (count > (size - kHeaderSize) / kCommandHeaderSize) {
+            return false;
+        }
+
+        commands.reserve(count);
+
+        size_t offset = kHeaderSize;
+
+        for (uint32_t i = 0; i < count; ++i) {
+            if (!parse_command(data + offset, size - offset, commands)) {
+                commands.clear();
+                return false;
+            }
+
+            offset += kCommandHeaderSize + commands.back().size;
+        }
+
+        return offset == size;
+    }
+
+    // Reads one command record, the whole of a message sent without the batch header
+    static bool parse_command(const char* data, size_t size, std::vector<DebugCommandView>& commands) {
+        if (size < kCommandHeaderSize) {
+            return false;
+        }
+
+        uint32_t cmd_type;
+        uint32_t payload_size;
+        std::memcpy(&cmd_type, data, sizeof(uint32_t));
+        std::memcpy(&payload_size, data + sizeof(uint32_t), sizeof(uint32_t));
+
+        if (size - kCommandHeaderSize < payload_size) {
+            return false;
+        }
+
+        commands.push_back({static_cast<DebugCommand::CommandType>(cmd_type), data + kCommandHeaderSize, payload_size});
+        return true;
+    }
+
+private:
+    std::string m_bytes;
+    uint32_t m_count = 0;
+};
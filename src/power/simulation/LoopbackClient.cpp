@@ -0,0 +1,128 @@
+#include "simulation/LoopbackClient.hpp"
+
+#include "simulation/DebugBridgeCommon.hpp"
+
+#include <websocketpp/config/asio_no_tls_client.hpp>
+#include <websocketpp/client.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace {
+typedef websocketpp::client<websocketpp::config::asio_client> loopback_client;
+}
+
+LoopbackClient::Result LoopbackClient::run(const Options& options) {
+	Result result;
+
+	if (options.batches == 0) {
+		result.completed = true;
+		return result;
+	}
+
+	loopback_client endpoint;
+	endpoint.clear_access_channels(websocketpp::log::alevel::all);
+	endpoint.clear_error_channels(websocketpp::log::elevel::all);
+	endpoint.init_asio();
+
+	// Every batch carries the same commands, so it is encoded once
+	DebugCommandBatch request;
+	std::string payload(options.payloadSize, 'x');
+
+	for (size_t i = 0; i < options.commandsPerBatch; ++i) {
+		request.add(DebugCommand::CommandType::EXECUTE, payload);
+	}
+
+	std::vector<DebugCommandView> responses;
+	size_t received = 0;
+
+	std::chrono::steady_clock::time_point start;
+	loopback_client::timer_ptr timeout;
+
+	auto finish = [&](websocketpp::connection_hdl hdl, const std::string& error) {
+		result.error = error;
+		result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		if (timeout) {
+			timeout->cancel();
+		}
+
+		websocketpp::lib::error_code ec;
+		endpoint.close(hdl, websocketpp::close::status::normal, "", ec);
+	};
+
+	auto send_next = [&](websocketpp::connection_hdl hdl) {
+		websocketpp::lib::error_code ec;
+		endpoint.send(hdl, request.bytes(), websocketpp::frame::opcode::binary, ec);
+
+		if (ec) {
+			finish(hdl, "Failed to send batch: " + ec.message());
+			return false;
+		}
+
+		++result.batchesSent;
+		return true;
+	};
+
+	endpoint.set_open_handler([&](websocketpp::connection_hdl hdl) {
+		start = std::chrono::steady_clock::now();
+
+		size_t window = std::min(std::max<size_t>(options.window, 1), options.batches);
+
+		while (result.batchesSent < window && send_next(hdl)) {
+		}
+	});
+
+	endpoint.set_message_handler([&](websocketpp::connection_hdl hdl, loopback_client::message_ptr msg) {
+		const std::string& bytes = msg->get_payload();
+		uint16_t flags = 0;
+
+		if (!DebugCommandBatch::parse(bytes.data(), bytes.size(), flags, responses)) {
+			finish(hdl, "Received a malformed response batch.");
+			return;
+		}
+
+		if (flags & DebugCommandBatch::kFlagRejected) {
+			++result.batchesRejected;
+		} else {
+			result.responses += responses.size();
+		}
+
+		if (++received == options.batches) {
+			result.completed = true;
+			finish(hdl, "");
+		} else if (result.batchesSent < options.batches) {
+			send_next(hdl);
+		}
+	});
+
+	endpoint.set_fail_handler([&](websocketpp::connection_hdl hdl) {
+		result.error = "Failed to connect: " + endpoint.get_con_from_hdl(hdl)->get_ec().message();
+
+		if (timeout) {
+			timeout->cancel();
+		}
+	});
+
+	websocketpp::lib::error_code ec;
+	auto connection = endpoint.get_connection("ws://127.0.0.1:" + std::to_string(options.port), ec);
+
+	if (ec) {
+		result.error = "Failed to create connection: " + ec.message();
+		return result;
+	}
+
+	endpoint.connect(connection);
+
+	timeout = endpoint.set_timer(options.timeoutMilliseconds, [&](const websocketpp::lib::error_code& timerError) {
+		if (!timerError && !result.completed) {
+			result.error = "Timed out after " + std::to_string(received) + " of " + std::to_string(options.batches) + " batches.";
+			endpoint.stop();
+		}
+	});
+
+	endpoint.run();
+
+	return result;
+}
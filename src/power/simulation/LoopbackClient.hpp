@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Local debug bridge client that measures SimulationServer command throughput.
+ *
+ * Connects to 127.0.0.1, keeps a window of command batches in flight and sends
+ * the next one as each response batch arrives. Blocks until every batch has been
+ * answered, the connection fails or the timeout passes.
+ */
+class LoopbackClient {
+public:
+	struct Options {
+		uint16_t port = 9003;
+		size_t batches = 1000;
+		size_t commandsPerBatch = 64;
+		size_t payloadSize = 32;
+		size_t window = 16;
+		long timeoutMilliseconds = 10000;
+	};
+
+	struct Result {
+		bool completed = false;
+		size_t batchesSent = 0;
+		size_t batchesRejected = 0;
+		size_t responses = 0;
+		double seconds = 0.0;
+		std::string error;
+
+		double commands_per_second() const {
+			return seconds > 0.0 ? static_cast<double>(responses) / seconds : 0.0;
+		}
+	};
+
+	Result run(const Options& options);
+};
@@ -0,0 +1,143 @@
+#include "simulation/MachinePool.hpp"
+
+#include "simulation/VirtualMachine.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <stdexcept>
+
+MachinePool::~MachinePool() {
+	unload();
+}
+
+bool MachinePool::load(std::vector<uint8_t> executable, uint64_t primeInstructions) {
+	unload();
+
+	mExecutable = std::move(executable);
+
+	try {
+		mTemplate = std::make_unique<Machine>(mExecutable, mOptions);
+
+		// Syscall handlers are shared by every machine, the environment and stack are copied on write
+		mTemplate->setup_linux({});
+		mTemplate->setup_linux_syscalls();
+		setup_syscall_handler(*mTemplate);
+
+		if (primeInstructions > 0) {
+			mTemplate->simulate<false>(primeInstructions);
+		}
+	} catch (const std::exception& ex) {
+		std::cerr << "Failed to load cartridge into the machine pool >> " << ex.what() << std::endl;
+
+		mTemplate.reset();
+		mExecutable.clear();
+		return false;
+	}
+
+	mTemplateBytes = mTemplate->memory.memory_usage_total();
+
+	measure();
+
+	return true;
+}
+
+void MachinePool::unload() {
+	// Forks borrow the template's memory and must go first
+	mIdle.clear();
+	mInstances.clear();
+
+	mTemplate.reset();
+	mExecutable.clear();
+
+	mTemplateBytes = 0;
+	mResidentBytes = 0;
+	mMemory.set(0);
+}
+
+MachinePool::Machine& MachinePool::acquire() {
+	if (!mTemplate) {
+		throw std::runtime_error("No cartridge is loaded in the machine pool");
+	}
+
+	if (!mIdle.empty()) {
+		Machine* machine = mIdle.back();
+		mIdle.pop_back();
+		return *machine;
+	}
+
+	mInstances.push_back(std::make_unique<Machine>(*mTemplate, mOptions));
+
+	return *mInstances.back();
+}
+
+void MachinePool::release(Machine& machine) {
+	// Re-forking now returns the instance's pages immediately instead of on the next acquire
+	reset(machine);
+
+	mIdle.push_back(&machine);
+}
+
+void MachinePool::destroy(Machine& machine) {
+	auto idle = std::find(mIdle.begin(), mIdle.end(), &machine);
+	if (idle != mIdle.end()) {
+		mIdle.erase(idle);
+	}
+
+	auto it = std::find_if(mInstances.begin(), mInstances.end(), [&machine](const auto& instance) {
+		return instance.get() == &machine;
+	});
+
+	if (it != mInstances.end()) {
+		mInstances.erase(it);
+	}
+}
+
+void MachinePool::reset(Machine& machine) {
+	// Constructed over the old instance so that references held by callers remain valid
+	std::destroy_at(&machine);
+
+	try {
+		std::construct_at(&machine, *mTemplate, mOptions);
+	} catch (...) {
+		// The storage no longer holds a machine, so it is freed without running the destructor again
+		auto idle = std::find(mIdle.begin(), mIdle.end(), &machine);
+		if (idle != mIdle.end()) {
+			mIdle.erase(idle);
+		}
+
+		auto it = std::find_if(mInstances.begin(), mInstances.end(), [&machine](const auto& instance) {
+			return instance.get() == &machine;
+		});
+
+		if (it != mInstances.end()) {
+			Machine* storage = it->release();
+			mInstances.erase(it);
+
+			if constexpr (alignof(Machine) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+				::operator delete(static_cast<void*>(storage), std::align_val_t(alignof(Machine)));
+			} else {
+				::operator delete(static_cast<void*>(storage));
+			}
+		}
+
+		throw;
+	}
+}
+
+void MachinePool::measure() {
+	uint64_t total = mTemplateBytes;
+
+	for (const auto& instance : mInstances) {
+		total += instance_bytes(*instance);
+	}
+
+	mResidentBytes = total;
+	mMemory.set(total);
+}
+
+uint64_t MachinePool::instance_bytes(const Machine& machine) {
+	// Pages still loaned from the template are not counted, nor are the shared execute segments
+	return sizeof(Machine) + machine.memory.owned_pages_active() * riscv::Page::size();
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "profiling/MemoryTracker.hpp"
+
+#include <libriscv/machine.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Many instances of one cartridge, forked from a single primed machine.
+ *
+ * load() parses the ELF, sets up the Linux environment and optionally runs the
+ * cartridge's start-up code once, in a template machine. Instances are libriscv
+ * copy-on-write forks of that template: they share its pages, execute segments
+ * and decoder cache and only own the pages they write to. Resetting an instance
+ * re-forks it in place, and released instances are kept re-forked for the next
+ * acquire(). The template is never run after load(), so forks may run on
+ * separate threads, but acquire/release/reset belong to one thread.
+ */
+class MachinePool {
+public:
+	using Machine = riscv::Machine<riscv::RISCV64>;
+
+	MachinePool() = default;
+	~MachinePool();
+
+	MachinePool(const MachinePool&) = delete;
+	MachinePool& operator=(const MachinePool&) = delete;
+
+	// Instructions of start-up code the template runs before it is forked; none by default
+	bool load(std::vector<uint8_t> executable, uint64_t primeInstructions = 0);
+
+	// Destroys every instance, then the template; outstanding references become invalid
+	void unload();
+
+	bool loaded() const {
+		return mTemplate != nullptr;
+	}
+
+	// Throws std::runtime_error when no cartridge is loaded
+	Machine& acquire();
+
+	void release(Machine& machine);
+
+	// Returns the instance's pages and forgets it, so the next acquire() forks anew; the reference becomes invalid
+	void destroy(Machine& machine);
+
+	// Discards everything the instance wrote since it was forked; the reference stays valid.
+	// If the new fork throws, the instance is gone as after destroy() and the exception propagates
+	void reset(Machine& machine);
+
+	size_t active_count() const {
+		return mInstances.size() - mIdle.size();
+	}
+
+	size_t idle_count() const {
+		return mIdle.size();
+	}
+
+	// Bytes owned by the template alone, i.e. the cost of one fully loaded machine
+	uint64_t template_bytes() const {
+		return mTemplateBytes;
+	}
+
+	// Template plus the pages each instance owns; refreshed by measure()
+	uint64_t resident_bytes() const {
+		return mResidentBytes;
+	}
+
+	void measure();
+
+private:
+	static uint64_t instance_bytes(const Machine& machine);
+
+	// Kept alive for the template and its forks, which refer to it for symbols
+	std::vector<uint8_t> mExecutable;
+
+	riscv::MachineOptions<riscv::RISCV64> mOptions;
+	std::unique_ptr<Machine> mTemplate;
+
+	std::vector<std::unique_ptr<Machine>> mInstances;
+	std::vector<Machine*> mIdle;
+
+	uint64_t mTemplateBytes = 0;
+	uint64_t mResidentBytes = 0;
+
+	TrackedMemory mMemory{MemoryTracker::Tag::VirtualMachine};
+};
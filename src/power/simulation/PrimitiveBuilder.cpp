@@ -8,6 +8,7 @@
 #include "components/TransformComponent.hpp"
 #include "graphics/drawing/Mesh.hpp"
 #include "graphics/shading/MaterialProperties.hpp"
+#include "graphics/shading/TextureRegistry.hpp"
 #include "filesystem/ImageUtils.hpp"
 
 #include <glm/glm.hpp>
@@ -303,6 +304,8 @@ static void add_cone(std::vector<std::unique_ptr<MeshVertex>>& vertices,
 	}
 }
 
+// Gizmos hold a single handle along +X; GizmoManager draws it three times, once per axis, from per-instance transforms and colors
+
 // Generates MeshData for the Translation Gizmo
 std::unique_ptr<MeshData> create_translation_gizmo_mesh_data() {
 	auto meshData = std::make_unique<MeshData>();
@@ -314,28 +317,14 @@ std::unique_ptr<MeshData> create_translation_gizmo_mesh_data() {
 	const float headLength = 0.4f;
 	const float headRadius = 0.1f;
 	
-	// Materials: 0=Red(X), 1=Green(Y), 2=Blue(Z)
-	meshData->get_material_properties().push_back(create_material({1, 0, 0, 1}));
-	meshData->get_material_properties().push_back(create_material({0, 1, 0, 1}));
-	meshData->get_material_properties().push_back(create_material({0, 0, 1, 1}));
-	
-	// X-Axis Arrow
-	glm::mat4 shaftX = glm::translate(glm::mat4(1.0f), {shaftLength * 0.5f, 0, 0}) * glm::scale(glm::mat4(1.0f), {shaftLength, shaftRadius, shaftRadius});
-	add_cube(vertices, indices, 0, shaftX);
-	glm::mat4 headX = glm::translate(glm::mat4(1.0f), {shaftLength, 0, 0}) * glm::rotate(glm::mat4(1.0f), -glm::half_pi<float>(), {0, 0, 1}) * glm::scale(glm::mat4(1.0f), {headLength, headRadius * 2, headRadius * 2});
-	add_cone(vertices, indices, 0, headX);
-	
-	// Y-Axis Arrow
-	glm::mat4 shaftY = glm::translate(glm::mat4(1.0f), {0, shaftLength * 0.5f, 0}) * glm::scale(glm::mat4(1.0f), {shaftRadius, shaftLength, shaftRadius});
-	add_cube(vertices, indices, 1, shaftY);
-	glm::mat4 headY = glm::translate(glm::mat4(1.0f), {0, shaftLength, 0}) * glm::scale(glm::mat4(1.0f), {headRadius * 2, headLength, headRadius * 2});
-	add_cone(vertices, indices, 1, headY);
-	
-	// Z-Axis Arrow
-	glm::mat4 shaftZ = glm::translate(glm::mat4(1.0f), {0, 0, shaftLength * 0.5f}) * glm::scale(glm::mat4(1.0f), {shaftRadius, shaftRadius, shaftLength});
-	add_cube(vertices, indices, 2, shaftZ);
-	glm::mat4 headZ = glm::translate(glm::mat4(1.0f), {0, 0, shaftLength}) * glm::rotate(glm::mat4(1.0f), glm::half_pi<float>(), {1, 0, 0}) * glm::scale(glm::mat4(1.0f), {headRadius * 2, headLength, headRadius * 2});
-	add_cone(vertices, indices, 2, headZ);
+	// The color comes from the instance
+	meshData->get_material_properties().push_back(create_material({1, 1, 1, 1}));
+	
+	// Arrow
+	glm::mat4 shaft = glm::translate(glm::mat4(1.0f), {shaftLength * 0.5f, 0, 0}) * glm::scale(glm::mat4(1.0f), {shaftLength, shaftRadius, shaftRadius});
+	add_cube(vertices, indices, 0, shaft);
+	glm::mat4 head = glm::translate(glm::mat4(1.0f), {shaftLength, 0, 0}) * glm::rotate(glm::mat4(1.0f), -glm::half_pi<float>(), {0, 0, 1}) * glm::scale(glm::mat4(1.0f), {headLength, headRadius * 2, headRadius * 2});
+	add_cone(vertices, indices, 0, head);
 	
 	return meshData;
 }
@@ -350,63 +339,48 @@ std::unique_ptr<MeshData> create_rotation_gizmo_mesh_data() {
 	const int ringSegments = 48;
 	const int tubeSegments = 12;
 	
-	// Materials: 0=Red(X), 1=Green(Y), 2=Blue(Z)
-	meshData->get_material_properties().push_back(create_material({1, 0, 0, 1}));
-	meshData->get_material_properties().push_back(create_material({0, 1, 0, 1}));
-	meshData->get_material_properties().push_back(create_material({0, 0, 1, 1}));
-	
-	auto create_torus = [&](uint32_t materialId, const glm::quat& rotation) {
-		uint32_t base_vertex = vertices.size();
-		// Generate vertices
-		for (int i = 0; i <= ringSegments; i++) { // Main ring segments
-			float u = (float)i / ringSegments * 2.0f * glm::pi<float>();
-			float cos_u = cos(u);
-			float sin_u = sin(u);
-			
-			for (int j = 0; j <= tubeSegments; j++) { // Tube segments
-				float v = (float)j / tubeSegments * 2.0f * glm::pi<float>();
-				float cos_v = cos(v);
-				float sin_v = sin(v);
-				
-				// Parametric equation for a torus centered at the origin
-				glm::vec3 pos;
-				pos.x = (ringRadius + tubeRadius * cos_v) * cos_u;
-				pos.y = (ringRadius + tubeRadius * cos_v) * sin_u;
-				pos.z = tubeRadius * sin_v;
-				
-				// Apply the overall rotation to orient the torus in space
-				pos = rotation * pos;
-				
-				auto vertex = std::make_unique<MeshVertex>(pos);
-				vertex->set_material_id(materialId);
-				vertices.emplace_back(std::move(vertex));
-			}
-		}
-		
-		// Generate indices for the torus surface
-		for (int i = 0; i < ringSegments; i++) {
-			for (int j = 0; j < tubeSegments; j++) {
-				int p1 = base_vertex + i * (tubeSegments + 1) + j;
-				int p2 = base_vertex + i * (tubeSegments + 1) + (j + 1);
-				int p3 = base_vertex + (i + 1) * (tubeSegments + 1) + (j + 1);
-				int p4 = base_vertex + (i + 1) * (tubeSegments + 1) + j;
-				indices.insert(indices.end(), { (unsigned)p1, (unsigned)p2, (unsigned)p3 });
-				indices.insert(indices.end(), { (unsigned)p1, (unsigned)p3, (unsigned)p4 });
-			}
-		}
-	};
+	// The color comes from the instance
+	meshData->get_material_properties().push_back(create_material({1, 1, 1, 1}));
 	
-	// X-Axis Ring (Red): Circles the X-axis, lies in the YZ plane.
-	// Achieved by rotating the default XY-plane torus 90 degrees around the Y-axis.
-	create_torus(0, glm::angleAxis(glm::half_pi<float>(), glm::vec3(0, 1, 0)));
+	// Circles the X-axis, lies in the YZ plane: the default XY-plane torus rotated 90 degrees around the Y-axis
+	const glm::quat rotation = glm::angleAxis(glm::half_pi<float>(), glm::vec3(0, 1, 0));
 	
-	// Y-Axis Ring (Green): Circles the Y-axis, lies in the XZ plane.
-	// Achieved by rotating the default XY-plane torus 90 degrees around the X-axis.
-	create_torus(1, glm::angleAxis(glm::half_pi<float>(), glm::vec3(1, 0, 0)));
+	// Generate vertices
+	for (int i = 0; i <= ringSegments; i++) { // Main ring segments
+		float u = (float)i / ringSegments * 2.0f * glm::pi<float>();
+		float cos_u = cos(u);
+		float sin_u = sin(u);
+		
+		for (int j = 0; j <= tubeSegments; j++) { // Tube segments
+			float v = (float)j / tubeSegments * 2.0f * glm::pi<float>();
+			float cos_v = cos(v);
+			float sin_v = sin(v);
+			
+			// Parametric equation for a torus centered at the origin
+			glm::vec3 pos;
+			pos.x = (ringRadius + tubeRadius * cos_v) * cos_u;
+			pos.y = (ringRadius + tubeRadius * cos_v) * sin_u;
+			pos.z = tubeRadius * sin_v;
+			
+			pos = rotation * pos;
+			
+			auto vertex = std::make_unique<MeshVertex>(pos);
+			vertex->set_material_id(0);
+			vertices.emplace_back(std::move(vertex));
+		}
+	}
 	
-	// Z-Axis Ring (Blue): Circles the Z-axis, lies in the XY plane.
-	// No rotation needed for the default torus.
-	create_torus(2, glm::quat(1, 0, 0, 0));
+	// Generate indices for the torus surface
+	for (int i = 0; i < ringSegments; i++) {
+		for (int j = 0; j < tubeSegments; j++) {
+			int p1 = i * (tubeSegments + 1) + j;
+			int p2 = i * (tubeSegments + 1) + (j + 1);
+			int p3 = (i + 1) * (tubeSegments + 1) + (j + 1);
+			int p4 = (i + 1) * (tubeSegments + 1) + j;
+			indices.insert(indices.end(), { (unsigned)p1, (unsigned)p2, (unsigned)p3 });
+			indices.insert(indices.end(), { (unsigned)p1, (unsigned)p3, (unsigned)p4 });
+		}
+	}
 	
 	return meshData;
 }
@@ -421,28 +395,14 @@ std::unique_ptr<MeshData> create_scale_gizmo_mesh_data() {
 	const float shaftRadius = 0.03f;
 	const float headSize = 0.15f;
 	
-	// Materials: 0=Red(X), 1=Green(Y), 2=Blue(Z)
-	meshData->get_material_properties().push_back(create_material({1, 0, 0, 1}));
-	meshData->get_material_properties().push_back(create_material({0, 1, 0, 1}));
-	meshData->get_material_properties().push_back(create_material({0, 0, 1, 1}));
-	
-	// X-Axis Handle
-	glm::mat4 shaftX = glm::translate(glm::mat4(1.0f), {shaftLength * 0.5f, 0, 0}) * glm::scale(glm::mat4(1.0f), {shaftLength, shaftRadius, shaftRadius});
-	add_cube(vertices, indices, 0, shaftX);
-	glm::mat4 headX = glm::translate(glm::mat4(1.0f), {shaftLength, 0, 0}) * glm::scale(glm::mat4(1.0f), glm::vec3(headSize));
-	add_cube(vertices, indices, 0, headX);
-	
-	// Y-Axis Handle
-	glm::mat4 shaftY = glm::translate(glm::mat4(1.0f), {0, shaftLength * 0.5f, 0}) * glm::scale(glm::mat4(1.0f), {shaftRadius, shaftLength, shaftRadius});
-	add_cube(vertices, indices, 1, shaftY);
-	glm::mat4 headY = glm::translate(glm::mat4(1.0f), {0, shaftLength, 0}) * glm::scale(glm::mat4(1.0f), glm::vec3(headSize));
-	add_cube(vertices, indices, 1, headY);
-	
-	// Z-Axis Handle
-	glm::mat4 shaftZ = glm::translate(glm::mat4(1.0f), {0, 0, shaftLength * 0.5f}) * glm::scale(glm::mat4(1.0f), {shaftRadius, shaftRadius, shaftLength});
-	add_cube(vertices, indices, 2, shaftZ);
-	glm::mat4 headZ = glm::translate(glm::mat4(1.0f), {0, 0, shaftLength}) * glm::scale(glm::mat4(1.0f), glm::vec3(headSize));
-	add_cube(vertices, indices, 2, headZ);
+	// The color comes from the instance
+	meshData->get_material_properties().push_back(create_material({1, 1, 1, 1}));
+	
+	// Handle
+	glm::mat4 shaft = glm::translate(glm::mat4(1.0f), {shaftLength * 0.5f, 0, 0}) * glm::scale(glm::mat4(1.0f), {shaftLength, shaftRadius, shaftRadius});
+	add_cube(vertices, indices, 0, shaft);
+	glm::mat4 head = glm::translate(glm::mat4(1.0f), {shaftLength, 0, 0}) * glm::scale(glm::mat4(1.0f), glm::vec3(headSize));
+	add_cube(vertices, indices, 0, head);
 	
 	return meshData;
 }
@@ -549,15 +509,8 @@ std::unique_ptr<MeshData> create_sprite_mesh_data(float width, float height, con
 	// If a valid path was provided, try to load the texture file.
 	if (!texturePath.empty() && std::filesystem::exists(texturePath)) {
 		std::cout << "Found texture file, loading: " << texturePath << std::endl;
-		std::ifstream file(texturePath, std::ios::binary);
-		if (file) {
-			// Read file into a buffer
-			std::vector<uint8_t> buffer(std::istreambuf_iterator<char>(file), {});
-			// Create texture from the file data in memory.
-			material->mTextureDiffuse =  std::make_shared<nanogui::Texture>(buffer.data(), buffer.size());
-			
-			material->mHasDiffuseTexture = true;
-		}
+		material->mTextureDiffuse = TextureRegistry::instance().load_file(texturePath);
+		material->mHasDiffuseTexture = material->mTextureDiffuse != nullptr;
 	}
 	
 	// A hint for the renderer to disable back-face culling could be set here
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Layout of the actor state region the host maps into a cartridge's address space.
+ *
+ * Slot i belongs to the i-th actor the cartridge created. The cartridge reads
+ * and writes the arrays in place and marks each slot it changed in the dirty
+ * bitmap; once per frame, after the cartridge has run, the host applies the marked
+ * slots to their actors and clears the marks. Changes the editor makes to those
+ * actors' transforms are written back into the arrays as they happen.
+ *
+ * Shared with cartridge code, so it only depends on <cstdint>. Cartridges reach
+ * it through SharedActorGuest.hpp.
+ */
+struct SharedActorHeader {
+	static constexpr uint32_t kMagic = 0x53525750; // "PWRS"
+	static constexpr uint32_t kVersion = 1;
+
+	uint32_t magic;
+	uint32_t version;
+	uint32_t capacity;
+	uint32_t count;             ///< Slots in use, written by the host.
+	uint64_t frame;             ///< Host synchronizations so far.
+
+	// Byte offsets from the start of the region
+	uint32_t translationOffset; ///< float[4] per slot, w unused.
+	uint32_t rotationOffset;    ///< float[4] per slot, quaternion x, y, z, w.
+	uint32_t scaleOffset;       ///< float[4] per slot, w unused.
+	uint32_t colorOffset;       ///< float[4] per slot, rgba.
+	uint32_t dirtyOffset;       ///< One uint64_t per 64 slots.
+	uint32_t reserved;
+};
+
+inline void shared_actor_mark_dirty(uint64_t* dirty, uint32_t slot) {
+	dirty[slot >> 6] |= 1ull << (slot & 63);
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "simulation/SharedActorCommon.hpp"
+
+#include <cstdint>
+
+/**
+ * Cartridge-side access to the shared actor arrays.
+ *
+ * Compiled into cartridges, not the engine: GetSharedActors is the only host
+ * call, made once, and every later access is a plain load or store into the
+ * mapped region. Slot i is the i-th actor the cartridge created. Write a
+ * slot's arrays, then mark_dirty() it for the host to apply after the frame.
+ * A slot whose actor the editor deleted reads back as zeros and is ignored.
+ *
+ *     SharedActors actors = SharedActors::get();
+ *     actors.translation(0)[1] += 0.1f;
+ *     actors.mark_dirty(0);
+ */
+class SharedActors {
+public:
+	// Asks the host for the region; check valid() before use
+	static SharedActors get() {
+		uint64_t address = 0;
+		call_host(shared_actor_hash("GetSharedActors"), &address);
+		return SharedActors(reinterpret_cast<SharedActorHeader*>(address));
+	}
+
+	bool valid() const {
+		return mHeader && mHeader->magic == SharedActorHeader::kMagic && mHeader->version == SharedActorHeader::kVersion;
+	}
+
+	uint32_t count() const { return mHeader->count; }
+	uint32_t capacity() const { return mHeader->capacity; }
+
+	// Host synchronizations so far; advances once per frame
+	uint64_t frame() const { return mHeader->frame; }
+
+	// x, y, z, w unused
+	float* translation(uint32_t slot) const { return array(mHeader->translationOffset, slot); }
+
+	// Quaternion x, y, z, w
+	float* rotation(uint32_t slot) const { return array(mHeader->rotationOffset, slot); }
+
+	// x, y, z, w unused
+	float* scale(uint32_t slot) const { return array(mHeader->scaleOffset, slot); }
+
+	// r, g, b, a
+	float* color(uint32_t slot) const { return array(mHeader->colorOffset, slot); }
+
+	void mark_dirty(uint32_t slot) const {
+		shared_actor_mark_dirty(reinterpret_cast<uint64_t*>(base() + mHeader->dirtyOffset), slot);
+	}
+
+private:
+	explicit SharedActors(SharedActorHeader* header)
+	: mHeader(header) {
+	}
+
+	uint8_t* base() const {
+		return reinterpret_cast<uint8_t*>(mHeader);
+	}
+
+	float* array(uint32_t offset, uint32_t slot) const {
+		return reinterpret_cast<float*>(base() + offset) + slot * 4;
+	}
+
+	// FNV-1a, as the host's FUNCTION_HASH
+	static constexpr uint64_t shared_actor_hash(const char* name, uint64_t hash = 14695981039346656037ull) {
+		return *name ? shared_actor_hash(name + 1, (hash ^ static_cast<uint64_t>(static_cast<unsigned char>(*name))) * 1099511628211ull) : hash;
+	}
+
+	// Same layout as the host's FunctionCallData
+	struct __attribute__((packed)) CallData {
+		uint64_t thisPointer;
+		uint64_t function;
+		uint64_t argumentCount;
+		uint64_t arguments[10];
+		uint64_t output;
+	};
+
+	static void call_host(uint64_t function, uint64_t* result) {
+		// The host reads and writes back 32 bytes of output
+		uint64_t output[4] = {};
+		CallData data{0, function, 0, {}, reinterpret_cast<uint64_t>(output)};
+
+#if defined(__riscv)
+		register uint64_t a0 asm("a0") = reinterpret_cast<uint64_t>(&data);
+		register uint64_t a7 asm("a7") = 386; // SYS_CLASS_FUNCTION_HOOK
+		asm volatile("ecall" : "+r"(a0) : "r"(a7) : "memory");
+#endif
+
+		*result = output[0];
+	}
+
+	SharedActorHeader* mHeader;
+};
@@ -0,0 +1,203 @@
+#include "simulation/SharedActorState.hpp"
+
+#include "actors/Actor.hpp"
+#include "actors/ActorManager.hpp"
+#include "components/ColorComponent.hpp"
+#include "components/TransformComponent.hpp"
+
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+size_t align_to_page(size_t bytes) {
+	size_t page = riscv::Page::size();
+	return (bytes + page - 1) / page * page;
+}
+} // unnamed namespace
+
+SharedActorState::SharedActorState(size_t capacity)
+: mCapacity(capacity) {
+	size_t arrayBytes = mCapacity * sizeof(float) * 4;
+	size_t dirtyBytes = (mCapacity + 63) / 64 * sizeof(uint64_t);
+
+	SharedActorHeader header{};
+	header.magic = SharedActorHeader::kMagic;
+	header.version = SharedActorHeader::kVersion;
+	header.capacity = static_cast<uint32_t>(mCapacity);
+	header.translationOffset = static_cast<uint32_t>(align_to_page(sizeof(SharedActorHeader)));
+	header.rotationOffset = static_cast<uint32_t>(header.translationOffset + arrayBytes);
+	header.scaleOffset = static_cast<uint32_t>(header.rotationOffset + arrayBytes);
+	header.colorOffset = static_cast<uint32_t>(header.scaleOffset + arrayBytes);
+	header.dirtyOffset = static_cast<uint32_t>(header.colorOffset + arrayBytes);
+
+	// Guest pages are inserted one to one, so the region is page aligned and a whole number of pages
+	mSize = align_to_page(header.dirtyOffset + dirtyBytes);
+	mRegion = static_cast<uint8_t*>(std::aligned_alloc(riscv::Page::size(), mSize));
+	std::memset(mRegion, 0, mSize);
+
+	mHeader = reinterpret_cast<SharedActorHeader*>(mRegion);
+	*mHeader = header;
+
+	mActors.reserve(mCapacity);
+
+	mMemory.set(mSize);
+}
+
+SharedActorState::~SharedActorState() {
+	// Not clear(): the actors, and the callbacks registered on them, may already be gone
+	std::free(mRegion);
+}
+
+void SharedActorState::map(riscv::Machine<riscv::RISCV64>& machine) {
+	riscv::PageAttributes attributes;
+	attributes.read = true;
+	attributes.write = true;
+	attributes.exec = false;
+
+	machine.memory.insert_non_owned_memory(kGuestAddress, mRegion, mSize, attributes);
+}
+
+bool SharedActorState::add(ActorManager& manager, Actor& actor) {
+	ActorHandle handle = manager.handle_of(actor);
+
+	if (mActors.size() == mCapacity || !handle.valid()) {
+		return false;
+	}
+
+	mActorManager = &manager;
+
+	uint32_t slot = static_cast<uint32_t>(mActors.size());
+
+	auto& transform = actor.get_component<TransformComponent>();
+
+	// Editor changes reach the cartridge through the arrays it reads
+	// A detached actor keeps its callback, so the slot has to still be its own
+	int callback = transform.register_on_transform_changed_callback([this, slot, handle, &actor](const TransformComponent&) {
+		if (!mApplying && slot < mActors.size() && mActors[slot].handle == handle) {
+			write_transform(actor, slot);
+		}
+	});
+
+	mActors.push_back({handle, callback});
+
+	write_transform(actor, slot);
+
+	if (actor.find_component<ColorComponent>()) {
+		glm::vec4 color = actor.get_component<ColorComponent>().get_color();
+		std::memcpy(array(mHeader->colorOffset, slot), &color, sizeof(float) * 4);
+	}
+
+	mHeader->count = static_cast<uint32_t>(mActors.size());
+
+	return true;
+}
+
+void SharedActorState::clear() {
+	for (uint32_t slot = 0; slot < mActors.size(); ++slot) {
+		// Actors already gone took their callbacks with them
+		if (Actor* actor = resolve(slot)) {
+			actor->get_component<TransformComponent>().unregister_on_transform_changed_callback(mActors[slot].transformCallback);
+		}
+	}
+
+	mActors.clear();
+
+	std::memset(mRegion + mHeader->translationOffset, 0, mSize - mHeader->translationOffset);
+	mHeader->count = 0;
+}
+
+size_t SharedActorState::synchronize() {
+	auto* dirty = reinterpret_cast<uint64_t*>(mRegion + mHeader->dirtyOffset);
+	size_t words = (mActors.size() + 63) / 64;
+	size_t applied = 0;
+
+	mApplying = true;
+
+	for (size_t word = 0; word < words; ++word) {
+		uint64_t bits = dirty[word];
+		dirty[word] = 0;
+
+		while (bits) {
+			uint32_t slot = static_cast<uint32_t>(word * 64 + std::countr_zero(bits));
+			bits &= bits - 1;
+
+			// Marks past the last slot are the cartridge's mistake and are ignored
+			if (slot >= mActors.size()) {
+				continue;
+			}
+
+			Actor* resolved = resolve(slot);
+
+			if (!resolved) {
+				continue;
+			}
+
+			const float* translation = array(mHeader->translationOffset, slot);
+			const float* rotation = array(mHeader->rotationOffset, slot);
+			const float* scale = array(mHeader->scaleOffset, slot);
+			const float* color = array(mHeader->colorOffset, slot);
+
+			Actor& actor = *resolved;
+
+			actor.get_component<TransformComponent>().set_transform(glm::vec3(translation[0], translation[1], translation[2]), glm::quat(rotation[3], rotation[0], rotation[1], rotation[2]), glm::vec3(scale[0], scale[1], scale[2]));
+
+			if (actor.find_component<ColorComponent>()) {
+				actor.get_component<ColorComponent>().set_color(glm::vec4(color[0], color[1], color[2], color[3]));
+			}
+
+			++applied;
+		}
+	}
+
+	mApplying = false;
+
+	++mHeader->frame;
+
+	return applied;
+}
+
+Actor* SharedActorState::resolve(uint32_t slot) {
+	Slot& entry = mActors[slot];
+
+	if (!entry.handle.valid()) {
+		return nullptr;
+	}
+
+	Actor* actor = mActorManager->find_actor(entry.handle);
+
+	if (!actor) {
+		// Deleted or detached by the editor; the arrays stop tracking it until the cartridge is reloaded
+		entry.handle = ActorHandle{};
+		std::memset(array(mHeader->translationOffset, slot), 0, sizeof(float) * 4);
+		std::memset(array(mHeader->rotationOffset, slot), 0, sizeof(float) * 4);
+		std::memset(array(mHeader->scaleOffset, slot), 0, sizeof(float) * 4);
+		std::memset(array(mHeader->colorOffset, slot), 0, sizeof(float) * 4);
+	}
+
+	return actor;
+}
+
+void SharedActorState::write_transform(Actor& actor, uint32_t slot) {
+	const auto& transform = actor.get_component<TransformComponent>();
+
+	glm::vec3 translation = transform.get_translation();
+	glm::quat rotation = transform.get_rotation();
+	glm::vec3 scale = transform.get_scale();
+
+	float* target = array(mHeader->translationOffset, slot);
+	target[0] = translation.x;
+	target[1] = translation.y;
+	target[2] = translation.z;
+
+	target = array(mHeader->rotationOffset, slot);
+	target[0] = rotation.x;
+	target[1] = rotation.y;
+	target[2] = rotation.z;
+	target[3] = rotation.w;
+
+	target = array(mHeader->scaleOffset, slot);
+	target[0] = scale.x;
+	target[1] = scale.y;
+	target[2] = scale.z;
+}
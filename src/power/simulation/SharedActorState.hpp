@@ -0,0 +1,87 @@
+#pragma once
+
+#include "components/ActorHandleComponent.hpp"
+#include "profiling/MemoryTracker.hpp"
+#include "simulation/SharedActorCommon.hpp"
+
+#include <libriscv/machine.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Actor;
+class ActorManager;
+
+/**
+ * @brief Host-owned transform and color arrays mapped into a cartridge's memory.
+ *
+ * The region is page aligned and inserted into the guest's page table as
+ * non-owned pages, so cartridge loads and stores reach it without a host call.
+ * synchronize() is the per-frame point where slots the cartridge marked dirty
+ * are applied to the actors' components. Slots refer to their actors by handle,
+ * so an actor the editor deletes or detaches meanwhile only empties its slot.
+ * See SharedActorCommon.hpp for the layout and SharedActorGuest.hpp for cartridges.
+ */
+class SharedActorState {
+public:
+	static constexpr size_t kDefaultCapacity = 4096;
+
+	// Above the flat read-write arena, whose accesses bypass the page table, and any guest mmap
+	static constexpr uint64_t kGuestAddress = 0x4000000000ull;
+
+	explicit SharedActorState(size_t capacity = kDefaultCapacity);
+	~SharedActorState();
+
+	SharedActorState(const SharedActorState&) = delete;
+	SharedActorState& operator=(const SharedActorState&) = delete;
+
+	// Inserts the region into the machine's page table, needed again after the machine is re-forked
+	void map(riscv::Machine<riscv::RISCV64>& machine);
+
+	// Gives the actor, which the manager must own, the next slot and seeds it from its components; false when every slot is taken
+	// Every actor added until clear() must belong to the same manager
+	bool add(ActorManager& manager, Actor& actor);
+
+	void clear();
+
+	// Applies the slots marked dirty since the last call and clears the marks; returns how many were applied
+	// Slots whose actor is gone are emptied and their marks dropped
+	size_t synchronize();
+
+	size_t count() const {
+		return mActors.size();
+	}
+
+	size_t capacity() const {
+		return mCapacity;
+	}
+
+private:
+	struct Slot {
+		ActorHandle handle;
+		int transformCallback;
+	};
+
+	float* array(uint32_t offset, uint32_t slot) const {
+		return reinterpret_cast<float*>(mRegion + offset) + slot * 4;
+	}
+
+	// Null, after emptying the slot, when the manager no longer has the slot's actor
+	Actor* resolve(uint32_t slot);
+
+	void write_transform(Actor& actor, uint32_t slot);
+
+	size_t mCapacity;
+	size_t mSize;
+	uint8_t* mRegion = nullptr;
+	SharedActorHeader* mHeader = nullptr;
+
+	ActorManager* mActorManager = nullptr;
+	std::vector<Slot> mActors;
+
+	// Set while guest writes are applied, so that the transform callbacks do not write them back
+	bool mApplying = false;
+
+	TrackedMemory mMemory{MemoryTracker::Tag::VirtualMachine};
+};
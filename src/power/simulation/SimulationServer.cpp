@@ -135,44 +135,94 @@ bool SimulationServer::validate_connection(websocketpp::connection_hdl hdl) {
 }
 
 void SimulationServer::on_message(websocketpp::connection_hdl hdl, server::message_ptr msg) {
-	std::lock_guard<std::mutex> lock(m_mutex);
 	try {
 		if (msg->get_opcode() != websocketpp::frame::opcode::binary) {
 			std::cerr << "Received non-binary message. Ignoring." << std::endl;
 			return;
 		}
 		
-		std::vector<uint8_t> data(msg->get_payload().begin(), msg->get_payload().end());
+		std::string& payload = msg->get_raw_payload();
 		
 		// Check for magic number 'SOLO' at the start (optional)
-		if (data.size() >= 4 && data[0] == 'S' && data[1] == 'O' && data[2] == 'L' && data[3] == 'O') {
+		if (payload.size() >= 4 && payload.compare(0, 4, "SOLO") == 0) {
+			std::lock_guard<std::mutex> lock(m_mutex);
+			
+			std::vector<uint8_t> data(payload.begin(), payload.end());
 			execute_elf(data);
 			std::string ack = "Elf object executed successfully.";
 			m_server.send(hdl, ack, websocketpp::frame::opcode::text);
-		} else {
-			// Assume it's a DebugCommand
-			DebugCommand cmd = DebugCommand::deserialize(data);
-			
-			std::cout << "Received command of type " << static_cast<int>(cmd.type)
-			<< " with payload: " << cmd.payload << std::endl;
-			
-			DebugCommand response = process_command(cmd);
+			return;
+		}
+		
+		// 'SOLH' followed by the hex MD5 of an ELF sent before relaunches it without the transfer
+		if (payload.size() >= 4 && payload.compare(0, 4, "SOLH") == 0) {
+			std::lock_guard<std::mutex> lock(m_mutex);
 			
-			std::vector<uint8_t> response_bytes = response.serialize();
-			m_server.send(hdl, response_bytes.data(), response_bytes.size(), websocketpp::frame::opcode::binary);
+			execute_cached(hdl, payload.substr(4));
+			return;
+		}
+		
+		// Commands run on the frame loop; the payload moves into the channel without a copy
+		bool legacy = !DebugCommandBatch::is_batch(payload.data(), payload.size());
+		
+		switch (m_commands.submit(hdl, payload)) {
+			case CommandChannel::SubmitResult::Queued:
+				break;
+			case CommandChannel::SubmitResult::Busy:
+				if (legacy) {
+					std::vector<uint8_t> busy = DebugCommand(DebugCommand::CommandType::RESPONSE, "Server busy.").serialize();
+					m_server.send(hdl, busy.data(), busy.size(), websocketpp::frame::opcode::binary);
+				} else {
+					DebugCommandBatch busy;
+					busy.reset(DebugCommandBatch::kFlagRejected);
+					m_server.send(hdl, busy.bytes(), websocketpp::frame::opcode::binary);
+				}
+				break;
+			case CommandChannel::SubmitResult::Malformed:
+				std::cerr << "Received malformed debug command. Ignoring." << std::endl;
+				break;
 		}
 	} catch (const std::exception& e) {
 		std::cerr << "Error handling message: " << e.what() << std::endl;
 	}
 }
 
-DebugCommand SimulationServer::process_command(const DebugCommand& cmd) {
+size_t SimulationServer::process_commands(size_t maxCommands) {
+	return m_commands.drain(maxCommands, [this](const CommandChannel::Batch& batch, const DebugCommandView& cmd) {
+		process_command(cmd, m_responses);
+	}, [this](const CommandChannel::Batch& batch) {
+		send_responses(batch);
+	});
+}
+
+void SimulationServer::process_command(const DebugCommandView& cmd, DebugCommandBatch& responses) {
 	if (cmd.type == DebugCommand::CommandType::EXECUTE) {
-		std::string result = "Executed command: " + cmd.payload;
-		return DebugCommand(DebugCommand::CommandType::RESPONSE, result);
+		std::string result = "Executed command: ";
+		result.append(cmd.payload());
+		responses.add(DebugCommand::CommandType::RESPONSE, result);
+		return;
 	}
 	
-	return DebugCommand(DebugCommand::CommandType::RESPONSE, "Unknown command type.");
+	responses.add(DebugCommand::CommandType::RESPONSE, "Unknown command type.");
+}
+
+void SimulationServer::send_responses(const CommandChannel::Batch& batch) {
+	const std::string& bytes = m_responses.bytes();
+	
+	// A legacy command is answered with its single response record, which is a serialized DebugCommand
+	const char* data = bytes.data();
+	size_t size = bytes.size();
+	
+	if (batch.legacy) {
+		data += DebugCommandBatch::kHeaderSize;
+		size -= DebugCommandBatch::kHeaderSize;
+	}
+	
+	// The client may have gone away while the batch was queued
+	websocketpp::lib::error_code ec;
+	m_server.send(batch.connection, data, size, websocketpp::frame::opcode::binary, ec);
+	
+	m_responses.reset();
 }
 
 void SimulationServer::execute_elf(const std::vector<uint8_t>& data) {
@@ -234,6 +284,36 @@ void SimulationServer::execute_elf(const std::vector<uint8_t>& data) {
 	
 }
 
+void SimulationServer::execute_cached(websocketpp::connection_hdl hdl, const std::string& key) {
+	mOnVirtualMachineLoadedCallback(std::nullopt); // Eject cartridge to prevent updating
+	mActorLoader.cleanup();
+	
+	// The cartridge cache belongs to the main thread, so the lookup happens there too
+	nanogui::async([this, hdl, key](){
+		std::string ack = "Elf object executed successfully.";
+		
+		try {
+			mOnVirtualMachineLoadedCallback(std::nullopt); // Eject cartridge to prevent updating
+			
+			if (mVirtualMachine.start_cached(key)) {
+				mOnVirtualMachineLoadedCallback(mVirtualMachine);
+			} else {
+				// The client falls back to sending the whole ELF
+				ack = "Cartridge not cached.";
+			}
+		}
+		catch (std::exception& ex) {
+			std::cerr << "Exception occurred while executing load_cartridge >> " << ex.what() << std::endl;
+			mOnVirtualMachineLoadedCallback(std::nullopt); // Eject cartridge to prevent updating
+			mVirtualMachine.reset();
+			ack = "Elf object failed to execute.";
+		}
+		
+		websocketpp::lib::error_code ec;
+		m_server.send(hdl, ack, websocketpp::frame::opcode::text, ec);
+	});
+}
+
 void SimulationServer::eject() {
 	// Existing elf unloading logic
 	// If a cartridge was loaded, reset it
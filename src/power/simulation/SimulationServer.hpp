@@ -4,13 +4,13 @@
 #include <websocketpp/config/asio_no_tls.hpp>
 #include <websocketpp/server.hpp>
 #include <mutex>
-#include <queue>
 #include <functional>
 #include <string>
 #include <thread>  // For std::thread
 #include <vector>
 #include <atomic>  // For std::atomic<bool>
 #include "DebugBridgeCommon.hpp"
+#include "simulation/CommandChannel.hpp"
 #include "simulation/Cartridge.hpp"
 
 typedef websocketpp::server<websocketpp::config::asio> server;
@@ -47,6 +47,15 @@ public:
 	
 	void eject();
 	
+	/**
+	 * @brief Runs queued debug commands on the calling (frame) thread and sends their responses.
+	 *
+	 * At most maxCommands commands run per call; the rest of a batch waits for the next frame.
+	 */
+	size_t process_commands(size_t maxCommands = kMaxCommandsPerFrame);
+	
+	static constexpr size_t kMaxCommandsPerFrame = 1024;
+	
 private:
 	// WebSocket++ server instance
 	typedef websocketpp::server<websocketpp::config::asio> server;
@@ -55,12 +64,15 @@ private:
 	// Server configuration
 	uint16_t m_port;                            ///< Port number for the server to listen on.
 	std::mutex m_mutex;                         ///< Mutex for thread-safe operations.
-	std::queue<DebugCommand> m_command_queue;   ///< Queue to store incoming DebugCommands.
+	CommandChannel m_commands;                  ///< Batches handed from the network thread to the frame loop.
+	DebugCommandBatch m_responses;              ///< Responses to the batch being drained, reused across batches.
 	bool validate_connection(websocketpp::connection_hdl hdl);
 	void on_message(websocketpp::connection_hdl hdl, server::message_ptr msg);
-	DebugCommand process_command(const DebugCommand& cmd);
+	void process_command(const DebugCommandView& cmd, DebugCommandBatch& responses);
+	void send_responses(const CommandChannel::Batch& batch);
 	
 	void execute_elf(const std::vector<uint8_t>& data);
+	void execute_cached(websocketpp::connection_hdl hdl, const std::string& key);
 	
 private:
 	// Callback function invoked when a cartridge is inserted or ejected
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Bounded lock-free queue between exactly one producer and one consumer thread.
+ *
+ * The capacity is rounded up to a power of two. Each side keeps a cached copy of
+ * the other side's index, so the shared atomics are only read again when the queue
+ * looks full (producer) or empty (consumer).
+ */
+template<typename T>
+class SpscQueue {
+public:
+	explicit SpscQueue(size_t capacity)
+	: mSlots(round_up(capacity))
+	, mMask(mSlots.size() - 1) {
+	}
+
+	SpscQueue(const SpscQueue&) = delete;
+	SpscQueue& operator=(const SpscQueue&) = delete;
+
+	// Producer thread only; false when the queue is full
+	bool try_push(T value) {
+		size_t tail = mTail.load(std::memory_order_relaxed);
+
+		if (tail - mCachedHead == mSlots.size()) {
+			mCachedHead = mHead.load(std::memory_order_acquire);
+
+			if (tail - mCachedHead == mSlots.size()) {
+				return false;
+			}
+		}
+
+		mSlots[tail & mMask] = std::move(value);
+		mTail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer thread only; false when the queue is empty
+	bool try_pop(T& value) {
+		size_t head = mHead.load(std::memory_order_relaxed);
+
+		if (head == mCachedTail) {
+			mCachedTail = mTail.load(std::memory_order_acquire);
+
+			if (head == mCachedTail) {
+				return false;
+			}
+		}
+
+		value = std::move(mSlots[head & mMask]);
+		mHead.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	size_t capacity() const {
+		return mSlots.size();
+	}
+
+private:
+	static size_t round_up(size_t capacity) {
+		size_t size = 1;
+
+		while (size < capacity) {
+			size <<= 1;
+		}
+
+		return size;
+	}
+
+	static constexpr size_t kCacheLine = 64;
+
+	std::vector<T> mSlots;
+	size_t mMask;
+
+	// Written by the consumer
+	alignas(kCacheLine) std::atomic<size_t> mHead{0};
+	size_t mCachedTail = 0;
+
+	// Written by the producer
+	alignas(kCacheLine) std::atomic<size_t> mTail{0};
+	size_t mCachedHead = 0;
+};
@@ -1,11 +1,19 @@
 #include "VirtualMachine.hpp"
+
+#include "profiling/Profiler.hpp"
+
 #include <cstring> // for memcpy
+#include <iostream>
 #include <stdexcept>
 
+namespace {
+constexpr uint32_t kMemoryMeasureInterval = 60;
+} // unnamed namespace
+
 // Definition of function_map
 std::unordered_map<uint64_t, FunctionHandler> function_map;
 
-VirtualMachine::VirtualMachine() : mMachine(nullptr) {
+VirtualMachine::VirtualMachine() {
 }
 
 VirtualMachine::~VirtualMachine() {
@@ -15,18 +23,41 @@ VirtualMachine::~VirtualMachine() {
 }
 
 void VirtualMachine::start(std::vector<uint8_t> executable_data) {
-	stop();
+	auto pool = mCartridges.acquire(std::move(executable_data));
+	
+	if (!pool) {
+		throw std::runtime_error("Failed to load cartridge executable");
+	}
+	
+	launch(std::move(pool));
+}
+
+bool VirtualMachine::start_cached(const std::string& key) {
+	auto pool = mCartridges.acquire(key);
+	
+	if (!pool) {
+		return false;
+	}
 	
-	mMachine = std::make_unique<riscv::Machine<riscv::RISCV64>>(executable_data);
+	launch(std::move(pool));
+	return true;
+}
+
+void VirtualMachine::launch(std::shared_ptr<MachinePool> pool) {
+	stop();
 	
-	// Set up Linux environment
-	mMachine->setup_linux({});
+	// The debugger refers to the machine that is about to be handed back
+	mDebugClient.reset();
+	mDebugServer.reset();
 	
-	// Add basic Linux system calls
-	mMachine->setup_linux_syscalls();
+	if (mMachine) {
+		mPool->release(*mMachine);
+		mMachine = nullptr;
+	}
 	
-	// Set up the custom syscall handler
-	setup_syscall_handler(*mMachine);
+	mPool = std::move(pool);
+	mMachine = &mPool->acquire();
+	mSharedActors.map(*mMachine);
 	
 	// start debugging session
 	printf("GDB server is listening on localhost:%u\n", 3333);
@@ -34,10 +65,17 @@ void VirtualMachine::start(std::vector<uint8_t> executable_data) {
 	
 
 	mMachine->simulate(0);
+	
+	mPool->measure();
+	mUpdatesSinceMeasure = 0;
 }
 
 void VirtualMachine::gdb_poll()
 {
+	if (!mDebugServer) {
+		return;
+	}
+	
 	// Accept new client if any
 	auto client = mDebugServer->accept(0); // 0 timeout for non-blocking
 	if (client) {
@@ -57,7 +95,22 @@ void VirtualMachine::gdb_poll()
 
 void VirtualMachine::reset() {
 	if (mMachine) {
-		mMachine->reset();
+		// Discards every page the cartridge wrote; the debugger keeps pointing at the same machine
+		try {
+			mPool->reset(*mMachine);
+		} catch (const std::exception& e) {
+			std::cerr << "Failed to reset the cartridge machine: " << e.what() << std::endl;
+			
+			// The pool has dropped the instance
+			mDebugClient.reset();
+			mDebugServer.reset();
+			mMachine = nullptr;
+			mPool->measure();
+			return;
+		}
+		
+		mSharedActors.map(*mMachine);
+		mPool->measure();
 	}
 }
 
@@ -68,11 +121,21 @@ void VirtualMachine::stop() {
 }
 
 void VirtualMachine::update() {
+	POWER_PROFILE_ZONE("VirtualMachine::update");
+	
 	if (mMachine) {
 		for (int i = 0; i < 960; ++i) { // machine is simulated with 8 cores times 30 frames per core
 			mMachine->cpu.step_one(false); // We do not care for the length of its execution, otherwise the instruction counter will overflow eventually
 		}
 		gdb_poll();
+		
+		// What the cartridge wrote into the shared actor arrays this frame reaches the components here
+		mSharedActors.synchronize();
+		
+		if (++mUpdatesSinceMeasure >= kMemoryMeasureInterval) {
+			mPool->measure();
+			mUpdatesSinceMeasure = 0;
+		}
 	}
 }
 
@@ -14,6 +14,11 @@
 #include <libriscv/machine.hpp>
 #include <libriscv/rsp_server.hpp>
 
+#include "profiling/MemoryTracker.hpp"
+#include "simulation/CartridgeCache.hpp"
+#include "simulation/MachinePool.hpp"
+#include "simulation/SharedActorState.hpp"
+
 #define SYS_CLASS_FUNCTION_HOOK 386
 
 // Structure matching FunctionCallData
@@ -91,18 +96,39 @@ public:
 	~VirtualMachine();
 	
 	void start(std::vector<uint8_t> executable_data);
+	
+	// Starts a cartridge that was launched before by the MD5 of its ELF; false if it is no longer cached
+	bool start_cached(const std::string& key);
+	
 	void gdb_poll();
 	void reset();
 	void stop();
 	void update();
 	
+	// Actor arrays the running cartridge reads and writes without host calls, at SharedActorState::kGuestAddress
+	SharedActorState& shared_actors() {
+		return mSharedActors;
+	}
+	
 	// Function to register callbacks
 	void register_callback(uint64_t this_ptr, const std::string& function_name,
 						   std::function<void(uint64_t, const std::vector<std::any>&, std::vector<unsigned char>&)> func);
 	
 private:
-	std::unique_ptr<riscv::Machine<riscv::RISCV64>> mMachine;
+	void launch(std::shared_ptr<MachinePool> pool);
+	
+	// Unchanged cartridges are launched from their already loaded template
+	CartridgeCache mCartridges;
+	
+	// The running machine is a fork of the pool's template, so reset() re-forks it instead of reloading the ELF
+	std::shared_ptr<MachinePool> mPool;
+	riscv::Machine<riscv::RISCV64>* mMachine = nullptr;
 	CartridgeHook mCartridgeHook;
 	std::unique_ptr<riscv::RSP<riscv::RISCV64>> mDebugServer;
 	std::unique_ptr<riscv::RSPClient<riscv::RISCV64>> mDebugClient;
+	
+	SharedActorState mSharedActors;
+	
+	// Guest memory grows as pages are touched, so the pool is re-measured periodically
+	uint32_t mUpdatesSinceMeasure = 0;
 };
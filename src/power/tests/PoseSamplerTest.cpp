@@ -0,0 +1,210 @@
+// Checks PoseSampler against the scalar Animation paths. Built once for the
+// host's vector ISA and once with POWER_POSE_FORCE_SCALAR, so both the SIMD
+// lanes and the scalar fallback are covered on every host.
+
+#include "animation/Animation.hpp"
+#include "animation/PoseSampler.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+// Not a multiple of any lane count, so the last batch is only partly filled
+constexpr int kBoneCount = 37;
+constexpr int kKeyframeCount = 12;
+constexpr float kKeyframeSpacing = 0.5f;
+
+// Rotation error as 1 - |dot|, which also accepts the same rotation with flipped sign
+constexpr float kRotationTolerance = 5e-6f;
+constexpr float kVectorTolerance = 1e-5f;
+constexpr float kMatrixTolerance = 1e-4f;
+
+int gFailures = 0;
+
+void fail(const char* what, int bone, float time, float error) {
+	if (gFailures++ < 20) {
+		std::fprintf(stderr, "FAIL %s: bone %d at time %.4f, error %g\n", what, bone, time, error);
+	}
+}
+
+float vector_error(const glm::vec3& a, const glm::vec3& b) {
+	return glm::length(a - b);
+}
+
+float rotation_error(const glm::quat& a, const glm::quat& b) {
+	return 1.0f - std::abs(glm::dot(glm::normalize(a), glm::normalize(b)));
+}
+
+glm::mat4 compose(const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale) {
+	return glm::translate(glm::mat4(1.0f), translation) * glm::mat4_cast(rotation) * glm::scale(glm::mat4(1.0f), scale);
+}
+
+float matrix_error(const glm::mat4& a, const glm::mat4& b) {
+	float error = 0.0f;
+	for (int column = 0; column < 4; ++column) {
+		for (int row = 0; row < 4; ++row) {
+			error = std::max(error, std::abs(a[column][row] - b[column][row]));
+		}
+	}
+	return error;
+}
+
+/**
+ * Consecutive rotation keys alternate between steps well inside and well outside
+ * the nlerp threshold, and between the same and the opposite hemisphere, so
+ * every sampled pair exercises one of the four combinations.
+ */
+Animation build_animation() {
+	std::mt19937 random(1234);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+	std::uniform_real_distribution<float> positive(0.5f, 2.0f);
+
+	Animation animation;
+
+	for (int bone = 0; bone < kBoneCount; ++bone) {
+		std::vector<Animation::KeyFrame> keyframes;
+		glm::vec3 axis = glm::normalize(glm::vec3(unit(random), unit(random), unit(random)) + glm::vec3(0.0f, 0.0f, 1e-3f));
+		glm::quat rotation = glm::angleAxis(unit(random) * 3.0f, axis);
+
+		for (int key = 0; key < kKeyframeCount; ++key) {
+			Animation::KeyFrame keyframe;
+			keyframe.time = key * kKeyframeSpacing;
+			keyframe.translation = glm::vec3(unit(random), unit(random), unit(random)) * 10.0f;
+			keyframe.scale = glm::vec3(positive(random), positive(random), positive(random));
+
+			// 0.01 radians keeps |dot| near 0.99999, 1.2 radians near 0.8
+			float step = (key + bone) % 2 == 0 ? 0.01f : 1.2f;
+			rotation = glm::normalize(glm::angleAxis(step, axis) * rotation);
+			keyframe.rotation = (key + bone / 2) % 3 == 0 ? -rotation : rotation;
+
+			keyframes.push_back(keyframe);
+		}
+
+		animation.add_bone_keyframes(bone, keyframes);
+	}
+
+	return animation;
+}
+
+// Pair surrounding time in the bone's track, found the same way as the sampler
+bool surrounding_keyframes(const Animation::BoneAnimation& track, float time, Animation::KeyFrame& a, Animation::KeyFrame& b, float& factor) {
+	const auto& keyframes = track.keyframes;
+
+	if (time <= keyframes.front().time || time >= keyframes.back().time) {
+		return false;
+	}
+
+	auto it1 = std::lower_bound(keyframes.begin(), keyframes.end(), time, [](const Animation::KeyFrame& kf, float t) {
+		return kf.time < t;
+	});
+	auto it0 = std::prev(it1);
+
+	a = *it0;
+	b = *it1;
+	factor = (time - it0->time) / (it1->time - it0->time);
+	return true;
+}
+} // unnamed namespace
+
+int main() {
+	Animation animation = build_animation();
+
+	std::vector<float> times = {-1.0f, 0.0f, 0.001f, kKeyframeSpacing, kKeyframeSpacing * 3.5f};
+
+	for (int i = 0; i < 64; ++i) {
+		times.push_back(0.0173f + i * (kKeyframeSpacing * (kKeyframeCount - 1)) / 64.0f);
+	}
+
+	times.push_back(kKeyframeSpacing * (kKeyframeCount - 1));
+	times.push_back(kKeyframeSpacing * kKeyframeCount);
+
+	LocalPose sampled;
+	LocalPose reference;
+	sampled.resize(kBoneCount);
+	reference.resize(kBoneCount);
+
+	size_t nlerpPairs = 0;
+	size_t slerpPairs = 0;
+
+	for (float time : times) {
+		sampled.set_identity();
+		reference.set_identity();
+
+		PoseSampler::sample(animation, time, sampled);
+		animation.sample_local_pose(time, reference);
+
+		std::vector<Animation::KeyFrame> evaluatedKeyframes = animation.evaluate_keyframes(time);
+		std::vector<glm::mat4> evaluated = animation.evaluate(time);
+
+		for (const auto& track : animation.get_bone_animations()) {
+			const int bone = track.bone_index;
+
+			// Translation and scale share glm::mix's operation order, so they match exactly
+			if (sampled.translations[bone] != reference.translations[bone]) {
+				fail("translation vs sample_local_pose", bone, time, vector_error(sampled.translations[bone], reference.translations[bone]));
+			}
+
+			if (sampled.scales[bone] != reference.scales[bone]) {
+				fail("scale vs sample_local_pose", bone, time, vector_error(sampled.scales[bone], reference.scales[bone]));
+			}
+
+			float error = rotation_error(sampled.rotations[bone], reference.rotations[bone]);
+
+			if (error > kRotationTolerance) {
+				fail("rotation vs sample_local_pose", bone, time, error);
+			}
+
+			const Animation::KeyFrame& evaluatedKeyframe = evaluatedKeyframes[bone];
+
+			if ((error = rotation_error(sampled.rotations[bone], evaluatedKeyframe.rotation)) > kRotationTolerance) {
+				fail("rotation vs evaluate_keyframes", bone, time, error);
+			}
+
+			if ((error = matrix_error(compose(sampled.translations[bone], sampled.rotations[bone], sampled.scales[bone]), evaluated[bone])) > kMatrixTolerance) {
+				fail("transform vs evaluate", bone, time, error);
+			}
+
+			Animation::KeyFrame a, b;
+			float factor = 0.0f;
+
+			if (!surrounding_keyframes(track, time, a, b, factor)) {
+				continue;
+			}
+
+			if (std::abs(glm::dot(a.rotation, b.rotation)) >= PoseSampler::kNlerpDotThreshold) {
+				++nlerpPairs;
+			} else {
+				++slerpPairs;
+			}
+
+			Animation::KeyFrame blended = Animation::blendKeyframes(a, b, factor);
+
+			if ((error = vector_error(sampled.translations[bone], blended.translation)) > kVectorTolerance) {
+				fail("translation vs blendKeyframes", bone, time, error);
+			}
+
+			if ((error = vector_error(sampled.scales[bone], blended.scale)) > kVectorTolerance) {
+				fail("scale vs blendKeyframes", bone, time, error);
+			}
+
+			if ((error = rotation_error(sampled.rotations[bone], blended.rotation)) > kRotationTolerance) {
+				fail("rotation vs blendKeyframes", bone, time, error);
+			}
+		}
+	}
+
+	// Both sides of the threshold must have been sampled for the check to mean anything
+	if (nlerpPairs == 0 || slerpPairs == 0) {
+		std::fprintf(stderr, "FAIL coverage: %zu nlerp and %zu slerp pairs\n", nlerpPairs, slerpPairs);
+		++gFailures;
+	}
+
+	std::printf("PoseSampler (%s, %zu lanes): %zu nlerp and %zu slerp pairs over %zu times, %d failures\n",
+				PoseSampler::backend_name(), PoseSampler::lane_count(), nlerpPairs, slerpPairs, times.size(), gFailures);
+
+	return gFailures == 0 ? 0 : 1;
+}
@@ -10,11 +10,14 @@
 
 #include "FileView.hpp"
 #include "filesystem/DirectoryNode.hpp"
+#include "ui/ThumbnailButton.hpp"
+#include "ui/ThumbnailService.hpp"
 
 #include <nanogui/button.h>
 #include <nanogui/icons.h>
 #include <nanogui/label.h>
 #include <nanogui/layout.h>
+#include <nanogui/opengl.h>
 #include <nanogui/screen.h>
 #include <nanogui/vscrollpanel.h>
 
@@ -100,13 +103,17 @@ void FileView::refresh() {
 	
 	m_content_panel->shed_children();
 	m_file_buttons.clear();
+	m_pending_thumbnails.clear();
+	m_displayed_paths.clear();
 	m_selected_button = nullptr;
 	m_selected_node = nullptr;
 	
-	// Refresh the root node from the filesystem
+	// Refresh the root node from the directory index
+	m_index_generation = m_initial_root_node->index_generation();
 	m_initial_root_node->refresh(m_allowed_extensions);
 	
 	populate_file_view();
+	release_unused_thumbnails();
 	perform_layout(screen().nvg_context());
 }
 
@@ -154,7 +161,7 @@ void FileView::populate_file_view() {
 }
 
 void FileView::create_file_item(const std::shared_ptr<DirectoryNode>& node) {
-	auto item_button = std::make_shared<nanogui::Button>(*m_content_panel, node->FileName, get_icon_for_file(*node));
+	auto item_button = std::make_shared<ThumbnailButton>(*m_content_panel, node->FileName, get_icon_for_file(*node));
 	item_button->set_fixed_height(28);
 	item_button->set_icon_position(nanogui::Button::IconPosition::Left);
 	item_button->set_background_color(m_normal_button_color);
@@ -162,6 +169,13 @@ void FileView::create_file_item(const std::shared_ptr<DirectoryNode>& node) {
 	
 	m_file_buttons.push_back(item_button);
 	
+	m_displayed_paths.insert(node->FullPath);
+	
+	// The type icon stays as a placeholder until the thumbnail is ready
+	if (m_thumbnail_service && !node->IsDirectory && !apply_thumbnail(*item_button, node->FullPath)) {
+		m_pending_thumbnails.emplace_back(item_button, node->FullPath);
+	}
+	
 	item_button->set_change_callback([this, item_button, node](bool state) {
 		if (m_selected_button) {
 			m_selected_button->set_background_color(m_normal_button_color);
@@ -222,6 +236,68 @@ void FileView::collect_nodes_recursive(std::shared_ptr<DirectoryNode> node, std:
 	}
 }
 
+void FileView::set_thumbnail_service(std::shared_ptr<ThumbnailService> thumbnail_service) {
+	m_thumbnail_service = thumbnail_service;
+	refresh();
+}
+
+bool FileView::apply_thumbnail(ThumbnailButton& button, const std::string& path) {
+	auto existing = m_thumbnail_images.find(path);
+	
+	if (existing != m_thumbnail_images.end()) {
+		button.set_thumbnail(existing->second);
+		return true;
+	}
+	
+	auto thumbnail = m_thumbnail_service->request(path);
+	
+	if (!thumbnail) {
+		return false;
+	}
+	
+	NVGcontext* ctx = screen().nvg_context();
+	int image = std::max(nvgCreateImageRGBA(ctx, thumbnail->width, thumbnail->height, 0, thumbnail->pixels.data()), 0);
+	
+	// The button paints the image itself, so any id NanoVG hands out can be shown
+	m_thumbnail_images[path] = image;
+	button.set_thumbnail(image);
+	
+	return true;
+}
+
+void FileView::release_unused_thumbnails() {
+	NVGcontext* ctx = screen().nvg_context();
+	
+	for (auto it = m_thumbnail_images.begin(); it != m_thumbnail_images.end();) {
+		if (m_displayed_paths.count(it->first) == 0) {
+			if (it->second > 0) {
+				nvgDeleteImage(ctx, it->second);
+			}
+			it = m_thumbnail_images.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
 void FileView::ProcessEvents() {
-	// No async processing needed
+	if (m_thumbnail_service) {
+		m_thumbnail_service->process_main_thread();
+		
+		uint64_t generation = m_thumbnail_service->generation();
+		
+		if (generation != m_thumbnail_generation) {
+			m_thumbnail_generation = generation;
+			
+			std::erase_if(m_pending_thumbnails, [this](const auto& pending) {
+				return apply_thumbnail(*pending.first, pending.second);
+			});
+		}
+	}
+	
+
+	// The directory index publishes changes from its own thread; rebuild once per new snapshot
+	if (m_initial_root_node && !m_is_dragging && m_initial_root_node->index_generation() != m_index_generation) {
+		refresh();
+	}
 }
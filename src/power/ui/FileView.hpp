@@ -1,10 +1,14 @@
 #pragma once
 
 #include <nanogui/widget.h>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 // Forward declarations
@@ -14,6 +18,8 @@ class Label;
 class VScrollPanel;
 }
 class DirectoryNode;
+class ThumbnailButton;
+class ThumbnailService;
 
 class FileView : public nanogui::Widget {
 public:
@@ -34,11 +40,16 @@ public:
 	void set_filter_text(const std::string& filter);
 	void ProcessEvents();
 	
+	// Shows generated previews in place of file icons once they are ready
+	void set_thumbnail_service(std::shared_ptr<ThumbnailService> thumbnail_service);
+	
 private:
 	void populate_file_view();
 	void create_file_item(const std::shared_ptr<DirectoryNode>& node);
 	int get_icon_for_file(const DirectoryNode& node) const;
 	// MODIFIED: Takes a shared_ptr to align with the rest of the memory management strategy.
+	bool apply_thumbnail(ThumbnailButton& button, const std::string& path);
+	void release_unused_thumbnails();
 	void collect_nodes_recursive(std::shared_ptr<DirectoryNode> node, std::vector<std::shared_ptr<DirectoryNode>>& collected_nodes);
 	
 	// MODIFIED: Handlers now take a const shared_ptr reference for consistency and safety.
@@ -68,11 +79,21 @@ private:
 	std::set<std::string> m_allowed_extensions;
 	bool m_recursive;
 	bool m_is_dragging = false;
+	uint64_t m_index_generation = 0;
 	
 	// Selection management
 	std::shared_ptr<nanogui::Button> m_selected_button = nullptr;
 	std::shared_ptr<DirectoryNode> m_selected_node = nullptr;
 	
+	// Thumbnails
+	std::shared_ptr<ThumbnailService> m_thumbnail_service;
+	uint64_t m_thumbnail_generation = 0;
+	// Buttons still showing their placeholder icon
+	std::vector<std::pair<std::shared_ptr<ThumbnailButton>, std::string>> m_pending_thumbnails;
+	// NanoVG image per displayed path; 0 marks a thumbnail that could not be uploaded
+	std::unordered_map<std::string, int> m_thumbnail_images;
+	std::unordered_set<std::string> m_displayed_paths;
+	
 	// Colors
 	nanogui::Color m_normal_button_color;
 	nanogui::Color m_selected_button_color;
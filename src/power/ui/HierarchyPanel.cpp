@@ -48,8 +48,7 @@ HierarchyPanel::HierarchyPanel(nanogui::Widget& parent, std::shared_ptr<ScenePan
 		
 		// Determine the new actor's name based on the current number of actors.
 		// We get the count of actors that already have a name via the MetadataComponent.
-		const auto& actors = mActorManager.get_actors_with_component<MetadataComponent>();
-		const size_t actorCount = actors.size();
+		const size_t actorCount = mActorManager.query<MetadataComponent>().count();
 		
 		std::string actorName = "Actor";
 		if (actorCount > 0) {
@@ -61,6 +60,13 @@ HierarchyPanel::HierarchyPanel(nanogui::Widget& parent, std::shared_ptr<ScenePan
 		auto& metadataComponent = actor.add_component<MetadataComponent>(actor.identifier(), actorName);
 		
 		add_actor(std::ref(actor));
+		
+		mActorManager.record_actor_added(actor);
+	});
+	
+	// Undo and redo add or remove actors behind the tree's back
+	mActorManager.set_actors_changed_callback([this]() {
+		refresh();
 	});
 	
 	mScrollPanel = std::make_shared<nanogui::VScrollPanel>(*this);
@@ -141,7 +147,8 @@ void HierarchyPanel::remove_actor(std::reference_wrapper<Actor> actor) {
 	
 	fire_actor_selected_event(std::nullopt);
 	
-	mActorManager.remove_actor(actor);
+	// Deleted from the editor, so kept in the undo history instead of destroyed
+	mActorManager.delete_actors({actor});
 	
 	auto actors = mActorManager.get_actors_with_component<UiComponent>();
 	
@@ -151,6 +158,18 @@ void HierarchyPanel::remove_actor(std::reference_wrapper<Actor> actor) {
 	
 }
 
+void HierarchyPanel::refresh() {
+	mTreeView->clear();
+	
+	fire_actor_selected_event(std::nullopt);
+	
+	auto actors = mActorManager.get_actors_with_component<UiComponent>();
+	
+	for (auto& actor : actors) {
+		populate_tree(actor);
+	}
+}
+
 void HierarchyPanel::remove_actors(const std::vector<std::reference_wrapper<Actor>>& actors) {
 	nanogui::async([this, actors](){
 		mTreeView->clear();
@@ -55,6 +55,9 @@ public:
 	
 	void reload();
 	
+	// Rebuilds the tree from the actors in the scene and clears the selection
+	void refresh();
+	
 private:
 	std::vector<std::reference_wrapper<IActorSelectedCallback>> mActorSelectedCallbacks;
 	std::optional<std::reference_wrapper<Actor>> mSelectedActor;
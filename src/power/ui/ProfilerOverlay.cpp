@@ -0,0 +1,162 @@
+#include "ui/ProfilerOverlay.hpp"
+
+#if defined(POWER_ENGINE_PROFILER) && POWER_ENGINE_PROFILER
+
+#include <nanogui/opengl.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+constexpr float kWidth = 380.0f;
+constexpr float kMargin = 10.0f;
+constexpr float kPadding = 8.0f;
+constexpr float kLineHeight = 16.0f;
+constexpr float kGraphHeight = 60.0f;
+constexpr float kGraphBudget = 33.3f; // milliseconds at the top of the graph
+constexpr size_t kTopZones = 8;
+
+void draw_line(NVGcontext* ctx, float x, float& y, const char* text, NVGcolor color) {
+	nvgFillColor(ctx, color);
+	nvgText(ctx, x, y, text, nullptr);
+	y += kLineHeight;
+}
+} // unnamed namespace
+
+void ProfilerOverlay::draw(NVGcontext* ctx, const nanogui::Vector2i& viewport) {
+	if (!mVisible) {
+		return;
+	}
+
+	Profiler& profiler = Profiler::instance();
+
+	std::vector<float> times = profiler.frame_times();
+
+	Profiler::Frame frame;
+	bool hasFrame = profiler.latest_frame(frame);
+
+	Profiler::Frame gpuFrame;
+	bool hasGpuFrame = profiler.latest_frame(gpuFrame, true) && !gpuFrame.gpu_zones.empty();
+
+	// Inclusive time per zone name over the latest frame
+	std::unordered_map<const char*, uint64_t> totals;
+	if (hasFrame) {
+		for (const auto& zone : frame.zones) {
+			totals[zone.name] += zone.end - zone.start;
+		}
+	}
+
+	std::vector<std::pair<const char*, uint64_t>> zones(totals.begin(), totals.end());
+	std::sort(zones.begin(), zones.end(), [](const auto& a, const auto& b) {
+		return a.second > b.second;
+	});
+	zones.resize(std::min(zones.size(), kTopZones));
+
+	size_t lineCount = 1 + static_cast<size_t>(Profiler::Counter::Count) + 1 + zones.size();
+	if (hasGpuFrame) {
+		lineCount += 1 + std::min(gpuFrame.gpu_zones.size(), kTopZones);
+	}
+
+	float height = kPadding * 3 + kGraphHeight + lineCount * kLineHeight;
+	float left = viewport.x() - kWidth - kMargin;
+	float top = kMargin;
+
+	nvgSave(ctx);
+
+	nvgBeginPath(ctx);
+	nvgRoundedRect(ctx, left, top, kWidth, height, 4.0f);
+	nvgFillColor(ctx, nvgRGBA(20, 20, 24, 220));
+	nvgFill(ctx);
+
+	// Frame time graph, newest on the right; the line marks 60 Hz
+	float graphLeft = left + kPadding;
+	float graphTop = top + kPadding;
+	float graphWidth = kWidth - kPadding * 2;
+
+	if (!times.empty()) {
+		float barWidth = graphWidth / static_cast<float>(times.size());
+
+		nvgBeginPath(ctx);
+		for (size_t i = 0; i < times.size(); ++i) {
+			float barHeight = std::min(times[i] / kGraphBudget, 1.0f) * kGraphHeight;
+			nvgRect(ctx, graphLeft + i * barWidth, graphTop + kGraphHeight - barHeight, std::max(barWidth - 1.0f, 1.0f), barHeight);
+		}
+		nvgFillColor(ctx, nvgRGBA(110, 180, 255, 255));
+		nvgFill(ctx);
+	}
+
+	float targetY = graphTop + kGraphHeight - (16.6f / kGraphBudget) * kGraphHeight;
+	nvgBeginPath(ctx);
+	nvgMoveTo(ctx, graphLeft, targetY);
+	nvgLineTo(ctx, graphLeft + graphWidth, targetY);
+	nvgStrokeColor(ctx, nvgRGBA(255, 200, 80, 160));
+	nvgStroke(ctx);
+
+	nvgFontSize(ctx, 14.0f);
+	nvgFontFace(ctx, "sans");
+	nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_TOP);
+
+	NVGcolor header = nvgRGBA(255, 255, 255, 255);
+	NVGcolor body = nvgRGBA(200, 200, 200, 255);
+
+	float x = left + kPadding;
+	float y = graphTop + kGraphHeight + kPadding;
+	char text[160];
+
+	float average = 0.0f;
+	float worst = 0.0f;
+	for (float time : times) {
+		average += time;
+		worst = std::max(worst, time);
+	}
+	average = times.empty() ? 0.0f : average / static_cast<float>(times.size());
+
+	std::snprintf(text, sizeof(text), "Frame %.2f ms avg, %.2f ms max (%zu frames)", average, worst, times.size());
+	draw_line(ctx, x, y, text, header);
+
+	for (size_t i = 0; i < static_cast<size_t>(Profiler::Counter::Count); ++i) {
+		std::snprintf(text, sizeof(text), "%s: %llu", Profiler::counter_name(static_cast<Profiler::Counter>(i)),
+					  hasFrame ? static_cast<unsigned long long>(frame.counters[i]) : 0ull);
+		draw_line(ctx, x, y, text, body);
+	}
+
+	draw_line(ctx, x, y, "CPU zones (last frame, inclusive)", header);
+
+	for (const auto& [name, duration] : zones) {
+		std::snprintf(text, sizeof(text), "  %-36s %7.3f ms", name, static_cast<double>(duration) / 1e6);
+		draw_line(ctx, x, y, text, body);
+	}
+
+	if (hasGpuFrame) {
+		std::snprintf(text, sizeof(text), "GPU zones (frame %llu)", static_cast<unsigned long long>(gpuFrame.index));
+		draw_line(ctx, x, y, text, header);
+
+		for (size_t i = 0; i < std::min(gpuFrame.gpu_zones.size(), kTopZones); ++i) {
+			const auto& zone = gpuFrame.gpu_zones[i];
+			std::snprintf(text, sizeof(text), "  %-36s %7.3f ms", zone.name, static_cast<double>(zone.duration) / 1e6);
+			draw_line(ctx, x, y, text, body);
+		}
+	}
+
+	nvgRestore(ctx);
+}
+
+std::string ProfilerOverlay::export_trace() {
+	std::error_code error;
+	auto directory = std::filesystem::temp_directory_path(error) / "PowerEngine";
+	std::filesystem::create_directories(directory, error);
+
+	auto path = (directory / ("trace_" + std::to_string(mExportCounter++) + ".json")).string();
+
+	if (!Profiler::instance().export_chrome_trace(path)) {
+		return "";
+	}
+
+	return path;
+}
+
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "profiling/Profiler.hpp"
+
+#if defined(POWER_ENGINE_PROFILER) && POWER_ENGINE_PROFILER
+
+#include <nanogui/vector.h>
+
+#include <string>
+
+struct NVGcontext;
+
+/**
+ * @brief Draws the profiler's frame graph, counters and heaviest zones over the editor.
+ *
+ * Not a widget, so the screen layout never moves it; the owner calls draw() after the
+ * rest of the UI has been drawn.
+ */
+class ProfilerOverlay {
+public:
+	void set_visible(bool visible) {
+		mVisible = visible;
+	}
+
+	bool visible() const {
+		return mVisible;
+	}
+
+	void draw(NVGcontext* ctx, const nanogui::Vector2i& viewport);
+
+	// Writes the recorded frames as Chrome trace JSON into the temp directory
+	std::string export_trace();
+
+private:
+	bool mVisible = false;
+	int mExportCounter = 0;
+};
+
+#endif
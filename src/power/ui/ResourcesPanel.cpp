@@ -12,8 +12,10 @@
 #include "ui/ResourcesPanel.hpp"
 #include "ui/FileView.hpp"
 #include "ui/ImportWindow.hpp"
+#include "ui/ThumbnailService.hpp"
 #include "ui/UiManager.hpp"
 #include "filesystem/DirectoryNode.hpp" // Make sure this is included
+#include "graphics/drawing/ModelThumbnailRenderer.hpp"
 
 #include <nanogui/nanogui.h>
 #include <nanogui/icons.h>
@@ -82,6 +84,23 @@ mUiManager(uiManager)
 	}
 										   );
 	
+	// Image previews are decoded off the UI thread and cached on disk between sessions
+	mThumbnailService = std::make_shared<ThumbnailService>();
+	
+#if defined(NANOGUI_USE_METAL)
+	// Models are imported on the service's workers and rendered offscreen on the main thread;
+	// the service may outlive the panel through the file view. The GL backend cannot create
+	// material textures off its context thread, so it keeps the placeholder icons
+	auto modelRenderer = std::make_shared<ModelThumbnailRenderer>();
+	mThumbnailService->set_model_renderer([](const std::string& path) -> ThumbnailService::LoadedModel {
+		return ModelThumbnailRenderer::load(path);
+	}, [modelRenderer](const ThumbnailService::LoadedModel& model, int size, ThumbnailService::Thumbnail& thumbnail) {
+		return modelRenderer->render(*std::static_pointer_cast<ModelThumbnailRenderer::Model>(model), size, thumbnail);
+	});
+#endif
+	
+	mFileView->set_thumbnail_service(mThumbnailService);
+	
 	mFilterText = "";
 	refresh_file_view();
 }
@@ -114,6 +133,8 @@ void ResourcesPanel::import_assets() {
 				if (mRootDirectoryNode && !mRootDirectoryNode->FullPath.empty()) {
 					fs::path destinationPath = fs::path(mRootDirectoryNode->FullPath) / fs::path(file).filename();
 					fs::copy(file, destinationPath, fs::copy_options::overwrite_existing);
+					mRootDirectoryNode->invalidate(destinationPath.string());
+					mThumbnailService->invalidate(destinationPath.string());
 					mImportWindow->Preview(file, mRootDirectoryNode->FullPath);
 				}
 			} catch (const std::exception& e) {
@@ -130,7 +151,7 @@ void ResourcesPanel::import_assets() {
 }
 
 void ResourcesPanel::export_assets() {
-	nanogui::file_dialog_async({{"mp4", "MP4 Video"}}, true, false, [this](const std::vector<std::string>& files) {
+	nanogui::file_dialog_async({{"mp4", "MP4 Video"}, {"avi", "MJPEG AVI"}}, true, false, [this](const std::vector<std::string>& files) {
 		if (files.empty()) {
 			return; // User canceled
 		}
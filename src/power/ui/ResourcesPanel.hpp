@@ -11,6 +11,7 @@
 class DirectoryNode;
 class FileView;
 class ImportWindow;
+class ThumbnailService;
 class UiManager;
 namespace nanogui {
 class Screen;
@@ -48,6 +49,7 @@ private:
 	std::string mSelectedDirectoryPath;
 	
 	std::shared_ptr<FileView> mFileView;
+	std::shared_ptr<ThumbnailService> mThumbnailService;
 	
 	// UI elements
 	std::shared_ptr<nanogui::Widget> mToolbar;
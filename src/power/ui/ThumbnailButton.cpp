@@ -0,0 +1,47 @@
+#include "ui/ThumbnailButton.hpp"
+
+#include <nanogui/opengl.h>
+
+namespace {
+// Matches the inset Button uses for an icon on the left
+constexpr float kThumbnailInset = 8.0f;
+constexpr float kThumbnailMargin = 3.0f;
+} // unnamed namespace
+
+ThumbnailButton::ThumbnailButton(nanogui::Widget& parent, const std::string& caption, int icon)
+: nanogui::Button(parent, caption, icon)
+, mPlaceholderIcon(icon) {
+}
+
+void ThumbnailButton::set_thumbnail(int image) {
+	mThumbnail = image;
+	set_icon(image > 0 ? 0 : mPlaceholderIcon);
+}
+
+void ThumbnailButton::draw(NVGcontext* ctx) {
+	nanogui::Button::draw(ctx);
+	
+	if (mThumbnail <= 0) {
+		return;
+	}
+	
+	int width = 0;
+	int height = 0;
+	nvgImageSize(ctx, mThumbnail, &width, &height);
+	
+	if (width <= 0 || height <= 0) {
+		return;
+	}
+	
+	float ih = m_size.y() - kThumbnailMargin * 2.0f;
+	float iw = width * ih / height;
+	float x = m_pos.x() + kThumbnailInset;
+	float y = m_pos.y() + kThumbnailMargin;
+	
+	NVGpaint paint = nvgImagePattern(ctx, x, y, iw, ih, 0.0f, mThumbnail, m_enabled ? 1.0f : 0.5f);
+	
+	nvgBeginPath(ctx);
+	nvgRect(ctx, x, y, iw, ih);
+	nvgFillPaint(ctx, paint);
+	nvgFill(ctx);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <nanogui/button.h>
+
+#include <string>
+
+/**
+ * @brief File view button that paints a NanoVG image in place of its icon.
+ *
+ * Button::set_icon reads values past the image range as font glyphs, so image
+ * ids handed out late in a session could not be shown through it. This button
+ * keeps its type icon as a placeholder and draws the thumbnail with an image
+ * pattern itself, which works for any id.
+ */
+class ThumbnailButton : public nanogui::Button {
+public:
+	ThumbnailButton(nanogui::Widget& parent, const std::string& caption, int icon);
+	
+	// Replaces the placeholder icon; 0 shows the placeholder again. The image is not owned
+	void set_thumbnail(int image);
+	
+	int thumbnail() const {
+		return mThumbnail;
+	}
+	
+	void draw(NVGcontext* ctx) override;
+	
+private:
+	int mPlaceholderIcon;
+	int mThumbnail = 0;
+};
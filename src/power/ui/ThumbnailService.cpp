@@ -0,0 +1,319 @@
+#include "ThumbnailService.hpp"
+
+#include "filesystem/HashCache.hpp"
+#include "profiling/Profiler.hpp"
+
+#include "stb_image.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+namespace {
+std::string lowercase_extension(const std::string& path) {
+	std::string extension = std::filesystem::path(path).extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+	return extension;
+}
+
+// Area-averaging downscale of an RGBA image so that it fits in size x size
+void downscale(const uint8_t* source, int sourceWidth, int sourceHeight, int size, ThumbnailCache::Image& target) {
+	float scale = std::min(1.0f, static_cast<float>(size) / static_cast<float>(std::max(sourceWidth, sourceHeight)));
+
+	target.width = std::max(1, static_cast<int>(sourceWidth * scale));
+	target.height = std::max(1, static_cast<int>(sourceHeight * scale));
+	target.pixels.assign(static_cast<size_t>(target.width) * target.height * 4, 0);
+
+	for (int y = 0; y < target.height; ++y) {
+		int y0 = y * sourceHeight / target.height;
+		int y1 = std::max(y0 + 1, (y + 1) * sourceHeight / target.height);
+
+		for (int x = 0; x < target.width; ++x) {
+			int x0 = x * sourceWidth / target.width;
+			int x1 = std::max(x0 + 1, (x + 1) * sourceWidth / target.width);
+
+			uint32_t sum[4] = {0, 0, 0, 0};
+
+			for (int sy = y0; sy < y1; ++sy) {
+				const uint8_t* row = source + (static_cast<size_t>(sy) * sourceWidth + x0) * 4;
+
+				for (int sx = x0; sx < x1; ++sx, row += 4) {
+					sum[0] += row[0];
+					sum[1] += row[1];
+					sum[2] += row[2];
+					sum[3] += row[3];
+				}
+			}
+
+			uint32_t count = static_cast<uint32_t>((y1 - y0) * (x1 - x0));
+			uint8_t* pixel = target.pixels.data() + (static_cast<size_t>(y) * target.width + x) * 4;
+
+			for (int c = 0; c < 4; ++c) {
+				pixel[c] = static_cast<uint8_t>(sum[c] / count);
+			}
+		}
+	}
+}
+} // unnamed namespace
+
+ThumbnailService::ThumbnailService(int size, size_t workerCount, size_t memoryCapacity)
+: mSize(size)
+, mMemoryCapacity(std::max<size_t>(memoryCapacity, 1)) {
+	for (size_t i = 0; i < std::max<size_t>(workerCount, 1); ++i) {
+		mWorkers.emplace_back([this]() {
+			worker_loop();
+		});
+	}
+}
+
+ThumbnailService::~ThumbnailService() {
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mStopping = true;
+	}
+
+	mJobAvailable.notify_all();
+
+	for (auto& worker : mWorkers) {
+		if (worker.joinable()) {
+			worker.join();
+		}
+	}
+}
+
+bool ThumbnailService::is_image(const std::string& path) {
+	static const std::vector<std::string> extensions = {".png", ".jpg", ".jpeg", ".tga", ".bmp"};
+	return std::find(extensions.begin(), extensions.end(), lowercase_extension(path)) != extensions.end();
+}
+
+bool ThumbnailService::is_model(const std::string& path) {
+	static const std::vector<std::string> extensions = {".fbx", ".psk", ".pma"};
+	return std::find(extensions.begin(), extensions.end(), lowercase_extension(path)) != extensions.end();
+}
+
+std::shared_ptr<const ThumbnailService::Thumbnail> ThumbnailService::request(const std::string& path) {
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	auto it = mRecords.find(path);
+
+	if (it != mRecords.end()) {
+		if (it->second.state == State::Ready) {
+			mRecency.splice(mRecency.begin(), mRecency, it->second.recency);
+			return it->second.thumbnail;
+		}
+
+		// Pending, or failed and not worth retrying until invalidated
+		return nullptr;
+	}
+
+	if (!is_image(path) && !is_model(path)) {
+		mRecords[path].state = State::Failed;
+		return nullptr;
+	}
+
+	mRecords[path].state = State::Pending;
+	mJobs.push_back(path);
+	mJobAvailable.notify_one();
+
+	return nullptr;
+}
+
+void ThumbnailService::invalidate(const std::string& path) {
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	auto it = mRecords.find(path);
+
+	// Pending work finishes normally; dropping it here would only queue a duplicate
+	if (it == mRecords.end() || it->second.state == State::Pending) {
+		return;
+	}
+
+	if (it->second.in_recency) {
+		mRecency.erase(it->second.recency);
+	}
+
+	mRecords.erase(it);
+}
+
+void ThumbnailService::set_model_renderer(ModelLoader loader, ModelRenderer renderer) {
+	std::unique_lock<std::mutex> lock(mMutex);
+	mModelLoader = std::move(loader);
+	mModelRenderer = std::move(renderer);
+}
+
+void ThumbnailService::process_main_thread(std::chrono::microseconds budget) {
+	auto start = std::chrono::steady_clock::now();
+
+	while (std::chrono::steady_clock::now() - start < budget) {
+		ModelJob job;
+		ModelRenderer renderer;
+
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+
+			if (mModelJobs.empty()) {
+				return;
+			}
+
+			job = std::move(mModelJobs.front());
+			mModelJobs.pop_front();
+			renderer = mModelRenderer;
+		}
+
+		auto thumbnail = std::make_shared<Thumbnail>();
+
+		if (!renderer || !renderer(job.model, mSize, *thumbnail)) {
+			fail(job.path);
+			continue;
+		}
+
+		mCache.store(job.key, *thumbnail);
+		complete(job.path, std::move(thumbnail));
+	}
+}
+
+void ThumbnailService::worker_loop() {
+	POWER_PROFILE_THREAD("Thumbnail worker");
+	
+	while (true) {
+		std::string path;
+
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mJobAvailable.wait(lock, [this]() {
+				return mStopping || !mJobs.empty();
+			});
+
+			if (mStopping) {
+				return;
+			}
+
+			// Most recent requests first, they are what the user is looking at
+			path = std::move(mJobs.back());
+			mJobs.pop_back();
+		}
+
+		generate(path);
+
+		bool idle;
+
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			idle = mJobs.empty();
+		}
+
+		// The batch is done, so the file hashes it added are written out once for all of it
+		if (idle) {
+			HashCache::instance().save();
+		}
+	}
+}
+
+void ThumbnailService::generate(const std::string& path) {
+	POWER_PROFILE_ZONE("ThumbnailService::generate");
+	
+	std::string hash = ThumbnailCache::hash_file(path);
+
+	if (hash.empty()) {
+		fail(path);
+		return;
+	}
+
+	std::string key = cache_key(hash);
+	auto thumbnail = std::make_shared<Thumbnail>();
+
+	if (mCache.load(key, *thumbnail)) {
+		complete(path, std::move(thumbnail));
+		return;
+	}
+
+	if (is_image(path)) {
+		if (!decode_image(path, *thumbnail)) {
+			fail(path);
+			return;
+		}
+
+		mCache.store(key, *thumbnail);
+		complete(path, std::move(thumbnail));
+		return;
+	}
+
+	ModelLoader loader;
+
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		loader = mModelLoader;
+	}
+
+	// Importing is the slow part, done here so the main thread only draws
+	LoadedModel model = loader ? loader(path) : nullptr;
+
+	if (!model) {
+		fail(path);
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	mModelJobs.push_back(ModelJob{path, key, std::move(model)});
+}
+
+bool ThumbnailService::decode_image(const std::string& path, Thumbnail& thumbnail) const {
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+
+	unsigned char* pixels = stbi_load(path.c_str(), &width, &height, &channels, 4);
+
+	if (!pixels) {
+		std::cerr << "Failed to decode thumbnail source " << path << ": " << stbi_failure_reason() << std::endl;
+		return false;
+	}
+
+	downscale(pixels, width, height, mSize, thumbnail);
+	stbi_image_free(pixels);
+
+	return true;
+}
+
+void ThumbnailService::complete(const std::string& path, std::shared_ptr<const Thumbnail> thumbnail) {
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+
+		Record& record = mRecords[path];
+		record.state = State::Ready;
+		record.thumbnail = std::move(thumbnail);
+
+		if (record.in_recency) {
+			mRecency.splice(mRecency.begin(), mRecency, record.recency);
+		} else {
+			mRecency.push_front(path);
+			record.recency = mRecency.begin();
+			record.in_recency = true;
+		}
+
+		trim_memory();
+	}
+
+	mGeneration.fetch_add(1, std::memory_order_release);
+}
+
+void ThumbnailService::fail(const std::string& path) {
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	auto it = mRecords.find(path);
+	if (it != mRecords.end()) {
+		it->second.state = State::Failed;
+	}
+}
+
+void ThumbnailService::trim_memory() {
+	// Evicted thumbnails fall back to the disk cache on their next request
+	while (mRecency.size() > mMemoryCapacity) {
+		mRecords.erase(mRecency.back());
+		mRecency.pop_back();
+	}
+}
+
+std::string ThumbnailService::cache_key(const std::string& hash) const {
+	return hash + "_" + std::to_string(mSize);
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "filesystem/ThumbnailCache.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Generates asset thumbnails for the resources browser without blocking the UI.
+ *
+ * Images are hashed, decoded and downscaled on worker threads. Models are
+ * imported on the workers through the registered ModelLoader too; only drawing
+ * needs the graphics context, so loaded models are queued for the main thread
+ * and rendered through the ModelRenderer within a per-frame time budget. Results go to a
+ * content-hash keyed ThumbnailCache on disk and to an in-memory LRU. Until a
+ * result arrives, request() returns nullptr and panels keep their placeholder.
+ */
+class ThumbnailService {
+public:
+	using Thumbnail = ThumbnailCache::Image;
+
+	// Whatever the loader produced, handed back to the renderer untouched
+	using LoadedModel = std::shared_ptr<void>;
+
+	// Imports a model; called on a worker thread, returns nullptr on failure
+	using ModelLoader = std::function<LoadedModel(const std::string& path)>;
+
+	// Renders a loaded model into a size x size RGBA image; called on the main thread only
+	using ModelRenderer = std::function<bool(const LoadedModel& model, int size, Thumbnail& thumbnail)>;
+
+	explicit ThumbnailService(int size = 64, size_t workerCount = 2, size_t memoryCapacity = 512);
+	~ThumbnailService();
+
+	ThumbnailService(const ThumbnailService&) = delete;
+	ThumbnailService& operator=(const ThumbnailService&) = delete;
+
+	// Returns the thumbnail if it is ready, otherwise queues it and returns nullptr
+	std::shared_ptr<const Thumbnail> request(const std::string& path);
+
+	// Drops the in-memory result so the next request regenerates or reloads it
+	void invalidate(const std::string& path);
+
+	void set_model_renderer(ModelLoader loader, ModelRenderer renderer);
+
+	// Runs queued model renders until the budget is used; call once per frame
+	void process_main_thread(std::chrono::microseconds budget = std::chrono::microseconds(2000));
+
+	// Bumped whenever a thumbnail becomes ready
+	uint64_t generation() const {
+		return mGeneration.load(std::memory_order_acquire);
+	}
+
+	static bool is_image(const std::string& path);
+	static bool is_model(const std::string& path);
+
+private:
+	enum class State {
+		Pending,
+		Ready,
+		Failed
+	};
+
+	struct Record {
+		State state = State::Pending;
+		std::shared_ptr<const Thumbnail> thumbnail;
+		std::list<std::string>::iterator recency;
+		bool in_recency = false;
+	};
+
+	struct ModelJob {
+		std::string path;
+		std::string key;
+		LoadedModel model;
+	};
+
+	void worker_loop();
+	void generate(const std::string& path);
+	bool decode_image(const std::string& path, Thumbnail& thumbnail) const;
+
+	void complete(const std::string& path, std::shared_ptr<const Thumbnail> thumbnail);
+	void fail(const std::string& path);
+	void trim_memory();
+
+	std::string cache_key(const std::string& hash) const;
+
+	int mSize;
+	size_t mMemoryCapacity;
+	ThumbnailCache mCache;
+
+	std::mutex mMutex;
+	std::condition_variable mJobAvailable;
+	std::deque<std::string> mJobs;
+	std::deque<ModelJob> mModelJobs;
+	std::unordered_map<std::string, Record> mRecords;
+	// Front is most recently used; only ready thumbnails are tracked
+	std::list<std::string> mRecency;
+	bool mStopping = false;
+
+	ModelLoader mModelLoader;
+	ModelRenderer mModelRenderer;
+
+	std::atomic<uint64_t> mGeneration{0};
+	std::vector<std::thread> mWorkers;
+};
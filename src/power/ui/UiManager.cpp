@@ -21,6 +21,7 @@
 #include "components/TransformComponent.hpp"
 #include "components/UiComponent.hpp"
 #include "gizmo/GizmoManager.hpp"
+#include "graphics/capture/FrameCapture.hpp"
 #include "graphics/drawing/BatchUnit.hpp"
 #include "graphics/drawing/MeshBatch.hpp"
 #include "graphics/drawing/SkinnedMeshBatch.hpp"
@@ -110,11 +111,11 @@ UiManager::UiManager(nanogui::Screen& screen, std::shared_ptr<IActorSelectedRegi
 , mGizmoActorLoader(gizmoActorLoader)
 , mGizmoManager(gizmoManager)
 , mCameraManager(cameraManager)
+, mAnimationTimeProvider(animationTimeProvider)
 , mCanvas(canvas)
 //, mAnimationPanel(animationPanel)
 , mIsMovieExporting(false)
-, mFrameCounter(0)
-, mFramePadding(4) // Initialize with 4 digits (0000)
+, mFinishMovieExport(false)
 {
 	// Register callbacks
 	mRegistry->RegisterOnActorSelectedCallback(*this);
@@ -171,16 +172,14 @@ UiManager::UiManager(nanogui::Screen& screen, std::shared_ptr<IActorSelectedRegi
 			int id = readFromFramebuffer(width, height, x, y);
 			
 			if (id != 0) {
-				auto actors = mActorManager.get_actors_with_component<ColorComponent>();
-				
-				for (auto& actor : actors) {
-					auto color = actor.get().get_component<ColorComponent>();
+				for (auto& actor : mActorManager.query<ColorComponent>()) {
+					auto& color = actor.get_component<ColorComponent>();
 					
 					if (id == color.identifier()) {
-						if (actor.get().find_component<UiComponent>()) {
-							actor.get().get_component<UiComponent>().select();
+						if (actor.find_component<UiComponent>()) {
+							actor.get_component<UiComponent>().select();
 						}
-						OnActorSelected(actor.get());
+						OnActorSelected(actor);
 						mGizmoManager.select(mActiveActor);
 						break;
 					}
@@ -292,6 +291,8 @@ UiManager::UiManager(nanogui::Screen& screen, std::shared_ptr<IActorSelectedRegi
 // UiManager Destructor
 // ==============================
 UiManager::~UiManager() {
+	stop_movie_export();
+	
 	mRegistry->UnregisterOnActorSelectedCallback(*this);
 	mRegistry->UnregisterOnActorSelectedCallback(mCameraManager);
 }
@@ -318,13 +319,48 @@ void UiManager::export_movie(const std::string& path) {
 	//	mSceneTimeBar->toggle_play_pause(true);
 	
 	nanogui::async([this, path]() {
+		stop_movie_export();
+		
+		// Stopping a previous export shows the panel again
+		mStatusBarPanel->resources_panel()->set_visible(false);
+		
 		mIsMovieExporting = true;
 		
 		mMovieExportFile = path;
 		mMovieExportDirectory = std::filesystem::path(path).parent_path().string();
+		
+		FrameCapture::Settings settings;
+		
+		// An .avi destination is written as a single MJPEG movie, anything else as a frame sequence
+		if (std::filesystem::path(path).extension() == ".avi") {
+			settings.format = FrameCapture::OutputFormat::MjpegAvi;
+			settings.path = mMovieExportFile;
+		} else {
+			settings.format = FrameCapture::OutputFormat::JpegSequence;
+			settings.path = mMovieExportDirectory;
+		}
+		
+		mFrameCapture = std::make_unique<FrameCapture>(settings);
 	});
 }
 
+void UiManager::stop_movie_export() {
+	mFinishMovieExport = false;
+	
+	if (mFrameCapture) {
+		// A frame queued but not yet captured would otherwise read the destroyed capture
+		mCanvas->cancel_capture();
+		
+		mFrameCapture->finish();
+		mFrameCapture.reset();
+	}
+	
+	if (mIsMovieExporting) {
+		mIsMovieExporting = false;
+		mStatusBarPanel->resources_panel()->set_visible(true);
+	}
+}
+
 bool UiManager::is_movie_exporting() const {
 	return mIsMovieExporting;
 }
@@ -346,35 +382,15 @@ void UiManager::draw() {
 		mActorManager.visit(batch_unit.mMeshBatch);
 		mActorManager.visit(batch_unit.mSkinnedMeshBatch);
 		
-		// Take snapshot for movie export
-		mCanvas->take_snapshot([this](std::vector<uint8_t>& png_data) {
-			// Generate the frame filename with padded zeros
-			std::ostringstream filename_stream;
-			filename_stream << "frame" << std::setw(mFramePadding) << std::setfill('0') << mFrameCounter << ".jpg";
-			std::string filename = filename_stream.str();
-			
-			// Full path for the frame
-			std::filesystem::path frame_path = std::filesystem::path(mMovieExportDirectory) / filename;
-			
-			// Write the PNG data to the file
-			std::ofstream file(frame_path, std::ios::binary);
-			if (file.is_open()) {
-				file.write(reinterpret_cast<const char*>(png_data.data()), png_data.size());
-				file.close();
-				std::cout << "Saved frame: " << frame_path << std::endl;
-			} else {
-				std::cerr << "Failed to save frame: " << frame_path << std::endl;
-			}
-			
-			mFrameCounter++;
-			
-			// Check if padding needs to be increased
-			int max_frames = static_cast<int>(std::pow(10, mFramePadding) - 1);
-			if (mFrameCounter > max_frames) {
-				mFramePadding += 1; // Increase padding by 1 digit
-				std::cout << "Increased frame padding to: " << mFramePadding << " digits." << std::endl;
-			}
-		});
+		// Capture for movie export; read back, encoding and writing happen off the render thread
+		if (mFrameCapture) {
+			mCanvas->capture_frame(*mFrameCapture);
+		}
+		
+		// The last frame of the timeline is queued, finalize the movie once it is captured
+		if (mAnimationTimeProvider.GetTime() >= mAnimationTimeProvider.GetDuration()) {
+			mFinishMovieExport = true;
+		}
 		
 		//		if (!mSceneTimeBar->is_playing()) {
 		//			mIsMovieExporting = false;
@@ -425,6 +441,9 @@ void UiManager::draw() {
 			if (mActiveActor->get().find_component<ColorComponent>()) {
 				auto& color = mActiveActor->get().get_component<ColorComponent>();
 				color.set_color(mSelectionColor);
+				
+				// Extraction already ran, so the render list carries the highlight itself
+				mActorManager.render_list().set_highlight(color.identifier(), mSelectionColor);
 			}
 		}
 		
@@ -463,6 +482,11 @@ void UiManager::remove_active_actor() {
 
 void UiManager::process_events() {
 	mCanvas->process_events();
+	
+	// The canvas has read back the last frame, so the capture can be finished
+	if (mFinishMovieExport) {
+		stop_movie_export();
+	}
 }
 
 std::shared_ptr<StatusBarPanel> UiManager::status_bar_panel() {
@@ -46,6 +46,7 @@ class AnimationTimeProvider;
 class BatchUnit;
 class Canvas;
 class CameraManager;
+class FrameCapture;
 class GizmoManager;
 class Grid;
 class MeshActorLoader;
@@ -87,6 +88,8 @@ public:
 	// Public Interface
 	std::shared_ptr<StatusBarPanel> status_bar_panel();
 	void export_movie(const std::string& path);
+	// Flushes every captured frame to disk, closes the movie and shows the resources panel again; also runs once playback reaches the end
+	void stop_movie_export();
 	bool is_movie_exporting() const;
 	void remove_active_actor();
 	void process_events();
@@ -104,6 +107,7 @@ private:
 	MeshActorLoader& mGizmoActorLoader;
 	GizmoManager& mGizmoManager;
 	CameraManager& mCameraManager;
+	AnimationTimeProvider& mAnimationTimeProvider;
 	std::shared_ptr<Canvas> mCanvas;
 	std::shared_ptr<AnimationPanel> mAnimationPanel;
 	std::shared_ptr<nanogui::RenderPass> mRenderPass;
@@ -111,10 +115,11 @@ private:
 	glm::vec4 mSelectionColor;
 	std::shared_ptr<StatusBarPanel> mStatusBarPanel;
 	bool mIsMovieExporting;
+	// Set once the last frame is queued; the export is finalized after it is captured
+	bool mFinishMovieExport;
 	std::string mMovieExportFile;
 	std::string mMovieExportDirectory;
-	int mFrameCounter;
-	int mFramePadding; // Number of digits for frame numbering
+	std::unique_ptr<FrameCapture> mFrameCapture;
 	
 	std::optional<std::reference_wrapper<Actor>> mActiveActor;
 